@@ -15,7 +15,11 @@
 #ifndef THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_SET_H_
 #define THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_SET_H_
 
-#include "absl/container/btree_set.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
 #include "absl/types/span.h"
 #include "base/attribute.h"
 
@@ -32,9 +36,14 @@ class UnknownSet;
 
 // AttributeSet is a container for CEL attributes that are identified as
 // unknown during expression evaluation.
+//
+// Attributes are kept in a sorted vector without duplicates, so that the
+// union of two sets is a single linear merge. Attributes share their
+// representation when copied, and equal attributes interned by the evaluator
+// are merged without inspecting their qualifiers.
 class AttributeSet final {
  private:
-  using Container = absl::btree_set<Attribute>;
+  using Container = std::vector<Attribute>;
 
  public:
   using value_type = typename Container::value_type;
@@ -48,17 +57,14 @@ class AttributeSet final {
   AttributeSet& operator=(const AttributeSet&) = default;
   AttributeSet& operator=(AttributeSet&&) = default;
 
-  explicit AttributeSet(absl::Span<const Attribute> attributes) {
-    for (const auto& attr : attributes) {
-      Add(attr);
-    }
+  explicit AttributeSet(absl::Span<const Attribute> attributes)
+      : attributes_(attributes.begin(), attributes.end()) {
+    Normalize();
   }
 
   AttributeSet(const AttributeSet& set1, const AttributeSet& set2)
       : attributes_(set1.attributes_) {
-    for (const auto& attr : set2.attributes_) {
-      Add(attr);
-    }
+    Add(set2);
   }
 
   iterator begin() const { return attributes_.begin(); }
@@ -91,15 +97,51 @@ class AttributeSet final {
   friend class UnknownValue;
   friend class base_internal::UnknownSet;
 
-  void Add(const Attribute& attribute) { attributes_.insert(attribute); }
+  // Takes ownership of `attributes`, which may be unsorted and contain
+  // duplicates.
+  static AttributeSet FromUnsorted(Container attributes) {
+    AttributeSet set;
+    set.attributes_ = std::move(attributes);
+    set.Normalize();
+    return set;
+  }
+
+  // Sorts the attributes and removes duplicates.
+  void Normalize() {
+    std::sort(attributes_.begin(), attributes_.end());
+    attributes_.erase(
+        std::unique(attributes_.begin(), attributes_.end(),
+                    [](const Attribute& lhs, const Attribute& rhs) {
+                      return !(lhs < rhs);
+                    }),
+        attributes_.end());
+  }
+
+  void Add(const Attribute& attribute) {
+    auto it =
+        std::lower_bound(attributes_.begin(), attributes_.end(), attribute);
+    if (it == attributes_.end() || attribute < *it) {
+      attributes_.insert(it, attribute);
+    }
+  }
 
   void Add(const AttributeSet& other) {
-    for (const auto& attribute : other) {
-      Add(attribute);
+    if (this == &other || other.empty()) {
+      return;
+    }
+    if (empty()) {
+      attributes_ = other.attributes_;
+      return;
     }
+    Container merged;
+    merged.reserve(attributes_.size() + other.attributes_.size());
+    std::set_union(attributes_.begin(), attributes_.end(),
+                   other.attributes_.begin(), other.attributes_.end(),
+                   std::back_inserter(merged));
+    attributes_ = std::move(merged);
   }
 
-  // Attribute container.
+  // Attribute container, sorted and without duplicates.
   Container attributes_;
 };
 
@@ -98,6 +98,10 @@ constexpr char kUint[] = "uint";
 // Note, this is a different convention from CEL internal functions where the
 // whole stack needs to be aware of the function id.
 constexpr char kRuntimeListAppend[] = "#list_append";
+// Collects the values of its arguments, including errors and unknowns, into an
+// internal list. Used to evaluate several independent expressions in one
+// program.
+constexpr char kRuntimeCollectResults[] = "#collect_results";
 
 }  // namespace builtin
 
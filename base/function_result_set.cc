@@ -14,15 +14,53 @@
 
 #include "base/function_result_set.h"
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "base/function_result.h"
+
 namespace cel {
 
 // Implementation for merge constructor.
 FunctionResultSet::FunctionResultSet(const FunctionResultSet& lhs,
                                      const FunctionResultSet& rhs)
     : function_results_(lhs.function_results_) {
-  for (const auto& function_result : rhs) {
-    function_results_.insert(function_result);
+  Add(rhs);
+}
+
+void FunctionResultSet::Normalize() {
+  std::sort(function_results_.begin(), function_results_.end());
+  function_results_.erase(
+      std::unique(function_results_.begin(), function_results_.end(),
+                  [](const FunctionResult& lhs, const FunctionResult& rhs) {
+                    return !(lhs < rhs);
+                  }),
+      function_results_.end());
+}
+
+void FunctionResultSet::Add(const FunctionResult& function_result) {
+  auto it = std::lower_bound(function_results_.begin(),
+                             function_results_.end(), function_result);
+  if (it == function_results_.end() || function_result < *it) {
+    function_results_.insert(it, function_result);
+  }
+}
+
+void FunctionResultSet::Add(const FunctionResultSet& other) {
+  if (this == &other || other.empty()) {
+    return;
+  }
+  if (empty()) {
+    function_results_ = other.function_results_;
+    return;
   }
+  Container merged;
+  merged.reserve(function_results_.size() + other.function_results_.size());
+  std::set_union(function_results_.begin(), function_results_.end(),
+                 other.function_results_.begin(), other.function_results_.end(),
+                 std::back_inserter(merged));
+  function_results_ = std::move(merged);
 }
 
 }  // namespace cel
@@ -17,8 +17,8 @@
 
 #include <initializer_list>
 #include <utility>
+#include <vector>
 
-#include "absl/container/btree_set.h"
 #include "base/function_result.h"
 
 namespace google::api::expr::runtime {
@@ -36,9 +36,12 @@ class UnknownSet;
 // execution. Execution should advance further if this set of unknowns are
 // provided. It may not advance if only a subset are provided.
 // Set semantics use |IsEqualTo()| defined on |FunctionResult|.
+//
+// Function results are kept in a sorted vector without duplicates, so that the
+// union of two sets is a single linear merge.
 class FunctionResultSet final {
  private:
-  using Container = absl::btree_set<FunctionResult>;
+  using Container = std::vector<FunctionResult>;
 
  public:
   using value_type = typename Container::value_type;
@@ -60,7 +63,9 @@ class FunctionResultSet final {
       : function_results_{std::move(initial)} {}
 
   FunctionResultSet(std::initializer_list<FunctionResult> il)
-      : function_results_(il) {}
+      : function_results_(il) {
+    Normalize();
+  }
 
   iterator begin() const { return function_results_.begin(); }
 
@@ -87,16 +92,23 @@ class FunctionResultSet final {
   friend class UnknownValue;
   friend class base_internal::UnknownSet;
 
-  void Add(const FunctionResult& function_result) {
-    function_results_.insert(function_result);
+  // Takes ownership of `function_results`, which may be unsorted and contain
+  // duplicates.
+  static FunctionResultSet FromUnsorted(Container function_results) {
+    FunctionResultSet set;
+    set.function_results_ = std::move(function_results);
+    set.Normalize();
+    return set;
   }
 
-  void Add(const FunctionResultSet& other) {
-    for (const auto& function_result : other) {
-      Add(function_result);
-    }
-  }
+  // Sorts the function results and removes duplicates.
+  void Normalize();
+
+  void Add(const FunctionResult& function_result);
+
+  void Add(const FunctionResultSet& other);
 
+  // Function result container, sorted and without duplicates.
   Container function_results_;
 };
 
@@ -0,0 +1,126 @@
+# Copyright 2026 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Provides the `cel_cc_expression` build macro.
+"""
+
+load("@rules_cc//cc:cc_library.bzl", "cc_library")
+load("//bazel:cel_proto_transitive_descriptor_set.bzl", "cel_proto_transitive_descriptor_set")
+
+def _cel_cc_expression_gen(ctx):
+    args = ctx.actions.args()
+    args.add("--expression", ctx.attr.expression)
+    inputs = []
+    if ctx.file.env:
+        args.add("--env", ctx.file.env)
+        inputs.append(ctx.file.env)
+    if ctx.file.descriptor_set:
+        args.add("--descriptor_set", ctx.file.descriptor_set)
+        inputs.append(ctx.file.descriptor_set)
+    args.add("--function_name", ctx.attr.function_name)
+    args.add("--header_include", ctx.outputs.out_header.short_path)
+    args.add("--out_header", ctx.outputs.out_header)
+    args.add("--out_source", ctx.outputs.out_source)
+    ctx.actions.run(
+        mnemonic = "CelCcExpression",
+        outputs = [ctx.outputs.out_header, ctx.outputs.out_source],
+        inputs = inputs,
+        progress_message = "Generating C++ for CEL expression %{label}.",
+        executable = ctx.executable.gen_tool,
+        arguments = [args],
+    )
+
+_cel_cc_expression_gen_rule = rule(
+    implementation = _cel_cc_expression_gen,
+    attrs = {
+        "expression": attr.string(mandatory = True),
+        "env": attr.label(allow_single_file = True),
+        "descriptor_set": attr.label(allow_single_file = True),
+        "function_name": attr.string(mandatory = True),
+        "out_header": attr.output(mandatory = True),
+        "out_source": attr.output(mandatory = True),
+        "gen_tool": attr.label(
+            executable = True,
+            cfg = "exec",
+            allow_files = True,
+            default = Label("//bazel:cel_cc_expression"),
+        ),
+    },
+)
+
+def cel_cc_expression(
+        name,
+        expression,
+        function_name,
+        env = None,
+        proto_deps = [],
+        cc_proto_deps = [],
+        **kwargs):
+    """Compiles a CEL expression to a cc_library.
+
+    The library provides
+
+        absl::StatusOr<std::unique_ptr<cel::Program>> <function_name>(
+            const cel::Runtime& runtime);
+
+    declared in `<name>.h`, which returns a program evaluating `expression`
+    with generated C++. The program is a drop-in replacement for the one
+    `runtime.CreateProgram` plans for the checked expression, see
+    tools/cc_expression_codegen.h.
+
+    Args:
+      name: name of the cc_library.
+      expression: the CEL expression.
+      function_name: fully qualified name of the generated function.
+      env: YAML environment configuration the expression is checked against,
+        see env/env_yaml.h. Standard extensions may be enabled by name.
+      proto_deps: proto_library targets defining the message types used by
+        the expression.
+      cc_proto_deps: cc_proto_library targets for `proto_deps`.
+      **kwargs: passed to the cc_library.
+    """
+    descriptor_set = None
+    if proto_deps:
+        cel_proto_transitive_descriptor_set(
+            name = name + "_descriptor_set",
+            deps = proto_deps,
+        )
+        descriptor_set = ":" + name + "_descriptor_set"
+    _cel_cc_expression_gen_rule(
+        name = name + "_gen",
+        expression = expression,
+        env = env,
+        descriptor_set = descriptor_set,
+        function_name = function_name,
+        out_header = name + ".h",
+        out_source = name + ".cc",
+    )
+    cc_library(
+        name = name,
+        srcs = [name + ".cc"],
+        hdrs = [name + ".h"],
+        deps = cc_proto_deps + [
+            Label("//common:value"),
+            Label("//internal:status_macros"),
+            Label("//runtime"),
+            Label("//runtime/internal:generated_program"),
+            Label("@com_google_absl//absl/memory"),
+            Label("@com_google_absl//absl/status"),
+            Label("@com_google_absl//absl/status:statusor"),
+            Label("@com_google_absl//absl/strings:string_view"),
+            Label("@com_google_absl//absl/types:span"),
+        ],
+        **kwargs
+    )
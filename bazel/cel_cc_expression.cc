@@ -0,0 +1,140 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compiles a CEL expression and generates C++ implementing it. See
+// cel_cc_expression.bzl.
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/initialize.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "compiler/compiler.h"
+#include "env/config.h"
+#include "env/env.h"
+#include "env/env_std_extensions.h"
+#include "env/env_yaml.h"
+#include "internal/minimal_descriptor_pool.h"
+#include "tools/cc_expression_codegen.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor_database.h"
+
+ABSL_FLAG(std::string, expression, "", "The CEL expression.");
+ABSL_FLAG(std::string, env, "",
+          "YAML environment configuration declaring the container, extensions, "
+          "variables and functions of the expression.");
+ABSL_FLAG(std::string, descriptor_set, "",
+          "Serialized FileDescriptorSet containing the message types used by "
+          "the expression.");
+ABSL_FLAG(std::string, function_name, "",
+          "Fully qualified name of the generated function.");
+ABSL_FLAG(std::string, header_include, "",
+          "Path used to include the generated header.");
+ABSL_FLAG(std::string, out_header, "", "");
+ABSL_FLAG(std::string, out_source, "", "");
+
+namespace {
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path, std::ifstream::binary);
+  ABSL_CHECK(file.is_open()) << path;
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  ABSL_CHECK(file.good() || file.eof());
+  return buffer.str();
+}
+
+void WriteFile(const std::string& path, absl::string_view data) {
+  ABSL_CHECK(!path.empty());
+  std::ofstream file(path);
+  ABSL_CHECK(file.is_open()) << path;
+  file.write(data.data(), data.size());
+  file.flush();
+  ABSL_CHECK(file.good());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  {
+    auto args = absl::ParseCommandLine(argc, argv);
+    ABSL_CHECK(args.empty() || args.size() == 1)
+        << "unexpected positional args: " << absl::StrJoin(args, ", ");
+  }
+  absl::InitializeLog();
+
+  // The pool and its database live until exit.
+  google::protobuf::SimpleDescriptorDatabase database;
+  std::shared_ptr<const google::protobuf::DescriptorPool> pool;
+  if (const std::string path = absl::GetFlag(FLAGS_descriptor_set);
+      !path.empty()) {
+    google::protobuf::FileDescriptorSet file_descriptor_set;
+    ABSL_CHECK(file_descriptor_set.ParseFromString(ReadFile(path)));
+    // The set is a concatenation of the transitive sets of each dependency, so
+    // files may repeat.
+    absl::flat_hash_set<std::string> file_names;
+    for (const auto& file : file_descriptor_set.file()) {
+      if (file_names.insert(file.name()).second) {
+        ABSL_CHECK(database.Add(file)) << file.name();
+      }
+    }
+    pool = std::make_shared<google::protobuf::DescriptorPool>(&database);
+  } else {
+    pool = std::shared_ptr<const google::protobuf::DescriptorPool>(
+        cel::internal::GetMinimalDescriptorPool(),
+        [](const google::protobuf::DescriptorPool*) {});
+  }
+
+  cel::Env env;
+  cel::RegisterStandardExtensions(env);
+  env.SetDescriptorPool(std::move(pool));
+  if (const std::string path = absl::GetFlag(FLAGS_env); !path.empty()) {
+    auto config = cel::EnvConfigFromYaml(ReadFile(path));
+    ABSL_CHECK_OK(config.status()) << path;
+    env.SetConfig(*config);
+  }
+  auto compiler = env.NewCompiler();
+  ABSL_CHECK_OK(compiler.status());
+
+  const std::string expression = absl::GetFlag(FLAGS_expression);
+  ABSL_CHECK(!expression.empty()) << "--expression is required";
+  auto result = (*compiler)->Compile(expression);
+  ABSL_CHECK_OK(result.status());
+  ABSL_CHECK(result->IsValid()) << result->FormatError();
+  auto ast = result->ReleaseAst();
+  ABSL_CHECK_OK(ast.status());
+
+  const std::string function_name = absl::GetFlag(FLAGS_function_name);
+  ABSL_CHECK(!function_name.empty()) << "--function_name is required";
+  cel::CcExpression cc_expression{function_name, ast->get(), expression};
+  auto sources = cel::GenerateCcExpressions(
+      {cc_expression}, absl::GetFlag(FLAGS_header_include));
+  ABSL_CHECK_OK(sources.status());
+
+  WriteFile(absl::GetFlag(FLAGS_out_header), sources->header);
+  WriteFile(absl::GetFlag(FLAGS_out_source), sources->source);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+# Copyright 2026 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Provides the `cel_cc_typed_field_accessors` build macro.
+"""
+
+load("@rules_cc//cc:cc_library.bzl", "cc_library")
+load("//bazel:cel_proto_transitive_descriptor_set.bzl", "cel_proto_transitive_descriptor_set")
+
+def _cel_cc_typed_field_accessors_gen(ctx):
+    args = ctx.actions.args()
+    args.add("--descriptor_set", ctx.file.descriptor_set)
+    args.add_joined("--message_types", ctx.attr.message_types, join_with = ",")
+    args.add("--function_name", ctx.attr.function_name)
+    args.add("--header_include", ctx.outputs.out_header.short_path)
+    args.add("--out_header", ctx.outputs.out_header)
+    args.add("--out_source", ctx.outputs.out_source)
+    ctx.actions.run(
+        mnemonic = "CelCcTypedFieldAccessors",
+        outputs = [ctx.outputs.out_header, ctx.outputs.out_source],
+        inputs = [ctx.file.descriptor_set],
+        progress_message = "Generating typed field accessors.",
+        executable = ctx.executable.gen_tool,
+        arguments = [args],
+    )
+
+_cel_cc_typed_field_accessors_gen_rule = rule(
+    implementation = _cel_cc_typed_field_accessors_gen,
+    attrs = {
+        "descriptor_set": attr.label(allow_single_file = True, mandatory = True),
+        "message_types": attr.string_list(mandatory = True),
+        "function_name": attr.string(mandatory = True),
+        "out_header": attr.output(mandatory = True),
+        "out_source": attr.output(mandatory = True),
+        "gen_tool": attr.label(
+            executable = True,
+            cfg = "exec",
+            allow_files = True,
+            default = Label("//bazel:cel_cc_typed_field_accessors"),
+        ),
+    },
+)
+
+def cel_cc_typed_field_accessors(
+        name,
+        proto_deps,
+        cc_proto_deps,
+        message_types,
+        function_name,
+        **kwargs):
+    """Generates a cc_library of direct field accessors for message types.
+
+    The library provides `absl::Status <function_name>(cel::TypeRegistry&)`,
+    declared in `<name>.h`, which registers a `cel::TypedFieldAccessor` for
+    each singular scalar, string, bytes and enum field of `message_types`.
+    With `RuntimeOptions::enable_typed_field_access`, field selections and
+    `has()` tests on those fields then use the generated C++ accessors instead
+    of reflection.
+
+    Args:
+      name: name of the cc_library.
+      proto_deps: proto_library targets defining `message_types`.
+      cc_proto_deps: cc_proto_library targets for `proto_deps`.
+      message_types: fully qualified names of the message types.
+      function_name: fully qualified name of the registration function.
+      **kwargs: passed to the cc_library.
+    """
+    cel_proto_transitive_descriptor_set(
+        name = name + "_descriptor_set",
+        deps = proto_deps,
+    )
+    _cel_cc_typed_field_accessors_gen_rule(
+        name = name + "_gen",
+        descriptor_set = ":" + name + "_descriptor_set",
+        message_types = message_types,
+        function_name = function_name,
+        out_header = name + ".h",
+        out_source = name + ".cc",
+    )
+    cc_library(
+        name = name,
+        srcs = [name + ".cc"],
+        hdrs = [name + ".h"],
+        deps = cc_proto_deps + [
+            Label("//common:value"),
+            Label("//internal:status_macros"),
+            Label("//runtime:type_registry"),
+            Label("//runtime:typed_field_accessor"),
+            Label("@com_google_absl//absl/base:core_headers"),
+            Label("@com_google_absl//absl/base:nullability"),
+            Label("@com_google_absl//absl/status"),
+            Label("@com_google_absl//absl/strings"),
+            Label("@com_google_protobuf//:protobuf"),
+        ],
+        **kwargs
+    )
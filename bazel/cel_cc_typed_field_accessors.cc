@@ -0,0 +1,321 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generates `cel::TypedFieldAccessor` tables for generated C++ message
+// classes. See cel_cc_typed_field_accessors.bzl.
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/log/initialize.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor_database.h"
+
+ABSL_FLAG(std::string, descriptor_set, "",
+          "Serialized FileDescriptorSet containing the message types.");
+ABSL_FLAG(std::vector<std::string>, message_types, {},
+          "Fully qualified names of the message types.");
+ABSL_FLAG(std::string, function_name, "",
+          "Fully qualified name of the generated registration function.");
+ABSL_FLAG(std::string, header_include, "",
+          "Path used to include the generated header.");
+ABSL_FLAG(std::string, out_header, "", "");
+ABSL_FLAG(std::string, out_source, "", "");
+
+namespace {
+
+using ::google::protobuf::Descriptor;
+using ::google::protobuf::FieldDescriptor;
+
+constexpr absl::string_view kPreamble =
+    "// Generated by cel_cc_typed_field_accessors. DO NOT EDIT.\n";
+
+std::string ReadFile(const std::string& path) {
+  ABSL_CHECK(!path.empty()) << "--descriptor_set is required";
+  std::ifstream file(path, std::ifstream::binary);
+  ABSL_CHECK(file.is_open()) << path;
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  ABSL_CHECK(file.good() || file.eof());
+  return buffer.str();
+}
+
+void WriteFile(const std::string& path, absl::string_view data) {
+  ABSL_CHECK(!path.empty());
+  std::ofstream file(path);
+  ABSL_CHECK(file.is_open()) << path;
+  file.write(data.data(), data.size());
+  file.flush();
+  ABSL_CHECK(file.good());
+}
+
+// Returns the C++ class name of a generated message, e.g. `::pkg::Outer_Inner`.
+std::string ClassName(const Descriptor* descriptor) {
+  absl::string_view name = descriptor->full_name();
+  absl::string_view package = descriptor->file()->package();
+  if (!package.empty()) {
+    name.remove_prefix(package.size() + 1);
+  }
+  return absl::StrCat("::", absl::StrReplaceAll(package, {{".", "::"}}),
+                      package.empty() ? "" : "::",
+                      absl::StrReplaceAll(name, {{".", "_"}}));
+}
+
+// Returns the name of the generated accessor for `field`, as protoc's C++
+// generator derives it: the lowercased field name, with an underscore appended
+// to C++ keywords. The keywords are protoc's own list.
+std::string AccessorName(const FieldDescriptor* field) {
+  static const auto* const kKeywords = new absl::flat_hash_set<std::string>{
+      "NULL", "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand",
+      "bitor", "bool", "break", "case", "catch", "char", "char8_t", "char16_t",
+      "char32_t", "class", "co_await", "co_return", "co_yield", "compl",
+      "concept", "const", "const_cast", "consteval", "constexpr", "constinit",
+      "continue", "decltype", "default", "delete", "do", "double",
+      "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false",
+      "float", "for", "friend", "goto", "if", "inline", "int", "long",
+      "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr",
+      "operator", "or", "or_eq", "private", "protected", "public", "register",
+      "reinterpret_cast", "requires", "return", "short", "signed", "sizeof",
+      "static", "static_assert", "static_cast", "struct", "switch", "template",
+      "this", "thread_local", "throw", "true", "try", "typedef", "typeid",
+      "typename", "union", "unsigned", "using", "virtual", "void", "volatile",
+      "wchar_t", "while", "xor", "xor_eq"};
+  std::string name = absl::AsciiStrToLower(field->name());
+  if (kKeywords->contains(name)) {
+    absl::StrAppend(&name, "_");
+  }
+  return name;
+}
+
+// Returns whether a direct accessor can be generated for `field`. Message,
+// repeated, map and cord fields, and `google.protobuf.NullValue` fields, which
+// are null rather than int, are left to reflection.
+bool IsSupported(const FieldDescriptor* field) {
+  if (field->is_repeated() || field->is_extension()) {
+    return false;
+  }
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return false;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return field->enum_type()->full_name() != "google.protobuf.NullValue";
+    case FieldDescriptor::CPPTYPE_STRING:
+      return field->cpp_string_type() ==
+                 FieldDescriptor::CppStringType::kString ||
+             field->cpp_string_type() == FieldDescriptor::CppStringType::kView;
+    default:
+      return true;
+  }
+}
+
+// Returns the expression converting `value` to a `cel::Value`.
+std::string ToValue(const FieldDescriptor* field, absl::string_view value) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return absl::StrCat("::cel::BoolValue(", value, ")");
+    case FieldDescriptor::CPPTYPE_INT32:
+    case FieldDescriptor::CPPTYPE_INT64:
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return absl::StrCat("::cel::IntValue(static_cast<int64_t>(", value,
+                          "))");
+    case FieldDescriptor::CPPTYPE_UINT32:
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return absl::StrCat("::cel::UintValue(static_cast<uint64_t>(", value,
+                          "))");
+    case FieldDescriptor::CPPTYPE_FLOAT:
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return absl::StrCat("::cel::DoubleValue(static_cast<double>(", value,
+                          "))");
+    case FieldDescriptor::CPPTYPE_STRING:
+      return absl::StrCat(field->type() == FieldDescriptor::TYPE_BYTES
+                              ? "::cel::BytesValue"
+                              : "::cel::StringValue",
+                          "::From(absl::string_view(", value, "), arena)");
+    default:
+      ABSL_LOG(FATAL) << "unsupported field " << field->full_name();
+  }
+}
+
+// Returns the expression testing presence of `field` in `typed`, matching
+// `google::protobuf::Reflection::HasField`.
+std::string HasValue(const FieldDescriptor* field) {
+  std::string accessor = AccessorName(field);
+  if (field->has_presence()) {
+    return absl::StrCat("typed.has_", accessor, "()");
+  }
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return absl::StrCat("typed.", accessor, "()");
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return absl::StrCat("absl::bit_cast<uint32_t>(typed.", accessor,
+                          "()) != 0");
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return absl::StrCat("absl::bit_cast<uint64_t>(typed.", accessor,
+                          "()) != 0");
+    case FieldDescriptor::CPPTYPE_STRING:
+      return absl::StrCat("!typed.", accessor, "().empty()");
+    default:
+      return absl::StrCat("typed.", accessor, "() != 0");
+  }
+}
+
+std::string HeaderPath(const google::protobuf::FileDescriptor* file) {
+  return absl::StrCat(absl::StripSuffix(file->name(), ".proto"), ".pb.h");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  {
+    auto args = absl::ParseCommandLine(argc, argv);
+    ABSL_CHECK(args.empty() || args.size() == 1)
+        << "unexpected positional args: " << absl::StrJoin(args, ", ");
+  }
+  absl::InitializeLog();
+
+  google::protobuf::FileDescriptorSet file_descriptor_set;
+  ABSL_CHECK(file_descriptor_set.ParseFromString(
+      ReadFile(absl::GetFlag(FLAGS_descriptor_set))));
+  // The set is a concatenation of the transitive sets of each dependency, so
+  // files may repeat.
+  google::protobuf::SimpleDescriptorDatabase database;
+  absl::flat_hash_set<std::string> file_names;
+  for (const auto& file : file_descriptor_set.file()) {
+    if (file_names.insert(file.name()).second) {
+      ABSL_CHECK(database.Add(file)) << file.name();
+    }
+  }
+  google::protobuf::DescriptorPool pool(&database);
+
+  const std::string function_name = absl::GetFlag(FLAGS_function_name);
+  ABSL_CHECK(!function_name.empty()) << "--function_name is required";
+  std::vector<absl::string_view> namespaces =
+      absl::StrSplit(function_name, "::");
+  const absl::string_view function = namespaces.back();
+  namespaces.pop_back();
+  const std::string namespace_name = absl::StrJoin(namespaces, "::");
+  const std::string guard = absl::StrCat(
+      absl::AsciiStrToUpper(absl::StrReplaceAll(
+          absl::GetFlag(FLAGS_header_include), {{"/", "_"}, {".", "_"}})),
+      "_");
+
+  absl::btree_set<std::string> proto_headers;
+  std::string accessors;
+  std::string registrations;
+  size_t index = 0;
+  for (const std::string& message_type : absl::GetFlag(FLAGS_message_types)) {
+    const Descriptor* descriptor = pool.FindMessageTypeByName(message_type);
+    ABSL_CHECK(descriptor != nullptr)
+        << "unknown message type " << message_type;
+    proto_headers.insert(HeaderPath(descriptor->file()));
+    const std::string class_name = ClassName(descriptor);
+    absl::StrAppend(&registrations, "  {\n",
+                    "    const google::protobuf::Descriptor* descriptor = ",
+                    class_name, "::descriptor();\n");
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+      const FieldDescriptor* field = descriptor->field(i);
+      if (!IsSupported(field)) {
+        continue;
+      }
+      const std::string accessor = AccessorName(field);
+      absl::StrAppend(
+          &accessors, "// ", field->full_name(), "\n",
+          "void Get", index, "(const google::protobuf::Message& message,\n",
+          "          google::protobuf::Arena* absl_nonnull arena,\n",
+          "          ::cel::Value* absl_nonnull result) {\n",
+          "  const auto& typed = static_cast<const ", class_name,
+          "&>(message);\n", "  *result = ",
+          ToValue(field, absl::StrCat("typed.", accessor, "()")), ";\n",
+          "}\n\n", "bool Has", index,
+          "(const google::protobuf::Message& message) {\n",
+          "  const auto& typed = static_cast<const ", class_name,
+          "&>(message);\n", "  return ", HasValue(field), ";\n", "}\n\n");
+      absl::StrAppend(
+          &registrations,
+          "    CEL_RETURN_IF_ERROR(registry.RegisterTypedFieldAccessor(\n",
+          "        ::cel::TypedFieldAccessor{descriptor->FindFieldByNumber(",
+          field->number(), "),\n", "                                &",
+          class_name, "::default_instance(), &Get", index, ", &Has", index,
+          "}));\n");
+      ++index;
+    }
+    absl::StrAppend(&registrations, "  }\n");
+  }
+
+  std::string header = absl::StrCat(
+      kPreamble, "\n#ifndef ", guard, "\n#define ", guard, "\n\n",
+      "#include \"absl/status/status.h\"\n",
+      "#include \"runtime/type_registry.h\"\n\n",
+      namespace_name.empty() ? ""
+                             : absl::StrCat("namespace ", namespace_name,
+                                            " {\n\n"),
+      "// Registers direct field accessors for the generated message types\n",
+      "// with `registry`.\n", "absl::Status ", function,
+      "(::cel::TypeRegistry& registry);\n\n",
+      namespace_name.empty()
+          ? ""
+          : absl::StrCat("}  // namespace ", namespace_name, "\n\n"),
+      "#endif  // ", guard, "\n");
+
+  std::string source =
+      absl::StrCat(kPreamble, "\n#include \"",
+                   absl::GetFlag(FLAGS_header_include), "\"\n\n",
+                   "#include <cstdint>\n\n",
+                   "#include \"absl/base/casts.h\"\n",
+                   "#include \"absl/base/nullability.h\"\n",
+                   "#include \"absl/status/status.h\"\n",
+                   "#include \"absl/strings/string_view.h\"\n",
+                   "#include \"common/value.h\"\n",
+                   "#include \"internal/status_macros.h\"\n",
+                   "#include \"runtime/type_registry.h\"\n",
+                   "#include \"runtime/typed_field_accessor.h\"\n");
+  for (const std::string& proto_header : proto_headers) {
+    absl::StrAppend(&source, "#include \"", proto_header, "\"\n");
+  }
+  absl::StrAppend(
+      &source, "#include \"google/protobuf/arena.h\"\n",
+      "#include \"google/protobuf/descriptor.h\"\n",
+      "#include \"google/protobuf/message.h\"\n\n",
+      namespace_name.empty()
+          ? ""
+          : absl::StrCat("namespace ", namespace_name, " {\n"),
+      "namespace {\n\n", accessors, "}  // namespace\n\n", "absl::Status ",
+      function, "(::cel::TypeRegistry& registry) {\n", registrations,
+      "  return absl::OkStatus();\n", "}\n",
+      namespace_name.empty()
+          ? ""
+          : absl::StrCat("\n}  // namespace ", namespace_name, "\n"));
+
+  WriteFile(absl::GetFlag(FLAGS_out_header), header);
+  WriteFile(absl::GetFlag(FLAGS_out_source), source);
+  return EXIT_SUCCESS;
+}
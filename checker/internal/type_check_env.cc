@@ -16,7 +16,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <utility>
 
 #include "absl/base/nullability.h"
 #include "absl/status/statusor.h"
@@ -32,11 +34,36 @@
 
 namespace cel::checker_internal {
 
+const VariableDecl* absl_nullable
+TypeCheckEnv::DeclarationLayer::FindVariable(absl::string_view name) const {
+  for (const DeclarationLayer* layer = this; layer != nullptr;
+       layer = layer->parent.get()) {
+    if (auto it = layer->variables.find(name); it != layer->variables.end()) {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
+const FunctionDecl* absl_nullable
+TypeCheckEnv::DeclarationLayer::FindFunction(absl::string_view name) const {
+  for (const DeclarationLayer* layer = this; layer != nullptr;
+       layer = layer->parent.get()) {
+    if (auto it = layer->functions.find(name); it != layer->functions.end()) {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
 const VariableDecl* absl_nullable TypeCheckEnv::LookupVariable(
     absl::string_view name) const {
   if (auto it = variables_.find(name); it != variables_.end()) {
     return &it->second;
   }
+  if (frozen_ != nullptr) {
+    return frozen_->FindVariable(name);
+  }
   return nullptr;
 }
 
@@ -45,10 +72,25 @@ const FunctionDecl* absl_nullable TypeCheckEnv::LookupFunction(
   if (auto it = functions_.find(name); it != functions_.end()) {
     return &it->second;
   }
-
+  if (frozen_ != nullptr) {
+    return frozen_->FindFunction(name);
+  }
   return nullptr;
 }
 
+void TypeCheckEnv::FreezeDeclarations() {
+  if (variables_.empty() && functions_.empty()) {
+    return;
+  }
+  auto layer = std::make_shared<DeclarationLayer>();
+  layer->parent = std::move(frozen_);
+  layer->variables = std::move(variables_);
+  layer->functions = std::move(functions_);
+  variables_.clear();
+  functions_.clear();
+  frozen_ = std::move(layer);
+}
+
 absl::StatusOr<std::optional<Type>> TypeCheckEnv::LookupTypeName(
     absl::string_view name) const {
   for (auto iter = type_providers_.begin(); iter != type_providers_.end();
@@ -140,15 +140,14 @@ class TypeCheckEnv {
     type_providers_.push_back(std::move(provider));
   }
 
-  const absl::flat_hash_map<std::string, VariableDecl>& variables() const {
-    return variables_;
-  }
-
   // Inserts a variable declaration into the environment of the current scope if
   // is is not already present. Parent scopes are not searched.
   //
   // Returns true if the variable was inserted, false otherwise.
   bool InsertVariableIfAbsent(VariableDecl decl) {
+    if (frozen_ != nullptr && frozen_->FindVariable(decl.name()) != nullptr) {
+      return false;
+    }
     return variables_.insert({decl.name(), std::move(decl)}).second;
   }
 
@@ -166,16 +165,15 @@ class TypeCheckEnv {
     return absl::OkStatus();
   }
 
-  const absl::flat_hash_map<std::string, FunctionDecl>& functions() const {
-    return functions_;
-  }
-
   // Inserts a function declaration into the environment of the current scope if
   // is is not already present. Parent scopes are not searched (allowing for
   // shadowing).
   //
   // Returns true if the decl was inserted, false otherwise.
   bool InsertFunctionIfAbsent(FunctionDecl decl) {
+    if (frozen_ != nullptr && frozen_->FindFunction(decl.name()) != nullptr) {
+      return false;
+    }
     return functions_.insert({decl.name(), std::move(decl)}).second;
   }
 
@@ -192,6 +190,14 @@ class TypeCheckEnv {
   const FunctionDecl* absl_nullable LookupFunction(
       absl::string_view name) const;
 
+  // Moves the declarations added since the last call into an immutable layer
+  // shared by copies of this environment.
+  //
+  // Copying a frozen environment does not copy its declarations, so deriving
+  // a checker from a fully configured one only pays for the declarations it
+  // adds. Declarations added after freezing shadow frozen ones.
+  void FreezeDeclarations();
+
   absl::StatusOr<absl::optional<Type>> LookupTypeName(
       absl::string_view name) const;
 
@@ -217,6 +223,19 @@ class TypeCheckEnv {
   std::shared_ptr<google::protobuf::Arena> arena() const { return arena_; }
 
  private:
+  // Declarations frozen by FreezeDeclarations. Later layers shadow their
+  // parents.
+  struct DeclarationLayer {
+    const VariableDecl* absl_nullable FindVariable(
+        absl::string_view name) const;
+    const FunctionDecl* absl_nullable FindFunction(
+        absl::string_view name) const;
+
+    absl_nullable std::shared_ptr<const DeclarationLayer> parent;
+    absl::flat_hash_map<std::string, VariableDecl> variables;
+    absl::flat_hash_map<std::string, FunctionDecl> functions;
+  };
+
   absl::StatusOr<absl::optional<VariableDecl>> LookupEnumConstant(
       absl::string_view type, absl::string_view value) const;
 
@@ -232,9 +251,10 @@ class TypeCheckEnv {
   // Used to resolve fields on message types.
   std::shared_ptr<DescriptorPoolTypeIntrospector> proto_type_introspector_;
 
-  // Maps fully qualified names to declarations.
+  // Maps fully qualified names to declarations added since the last freeze.
   absl::flat_hash_map<std::string, VariableDecl> variables_;
   absl::flat_hash_map<std::string, FunctionDecl> functions_;
+  absl_nullable std::shared_ptr<const DeclarationLayer> frozen_;
 
   std::shared_ptr<ProtoTypeMaskRegistry> proto_type_mask_registry_;
 
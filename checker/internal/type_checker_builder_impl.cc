@@ -372,6 +372,9 @@ absl::Status TypeCheckerBuilderImpl::ApplyConfig(
 absl::StatusOr<std::unique_ptr<TypeChecker>> TypeCheckerBuilderImpl::Build() {
   TypeCheckEnv env(template_env_);
   CEL_RETURN_IF_ERROR(ConfigureTypeCheckEnv(env));
+  // Checkers derived with ToBuilder() share the declarations instead of
+  // copying them.
+  env.FreezeDeclarations();
   return std::make_unique<checker_internal::TypeCheckerImpl>(std::move(env),
                                                              options_);
 }
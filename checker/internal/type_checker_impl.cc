@@ -1362,7 +1362,8 @@ absl::StatusOr<ValidationResult> TypeCheckerImpl::CheckImpl(
                        NamespaceGenerator::Create(env_.container()));
 
   TypeInferenceContext type_inference_context(
-      arena, options_.enable_legacy_null_assignment);
+      arena, options_.enable_legacy_null_assignment,
+      &overload_resolution_cache_);
   ResolveVisitor visitor(std::move(generator), env_, *ast,
                          type_inference_context, issues, arena);
 
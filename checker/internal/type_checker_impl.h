@@ -21,6 +21,7 @@
 #include "absl/status/statusor.h"
 #include "checker/checker_options.h"
 #include "checker/internal/type_check_env.h"
+#include "checker/internal/type_inference_context.h"
 #include "checker/type_checker.h"
 #include "checker/type_checker_builder.h"
 #include "checker/validation_result.h"
@@ -51,6 +52,8 @@ class TypeCheckerImpl : public TypeChecker {
   TypeCheckEnv env_;
   google::protobuf::Arena type_arena_;
   CheckerOptions options_;
+  // Overload resolutions shared across checks. Internally synchronized.
+  mutable OverloadResolutionCache overload_resolution_cache_;
 };
 
 }  // namespace cel::checker_internal
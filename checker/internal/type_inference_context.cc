@@ -26,6 +26,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "common/decl.h"
@@ -55,8 +56,8 @@ bool IsWildCardType(Type type) {
 //
 // TODO(uncreated-issue/74): Need a concrete plan for updating existing CEL expressions
 // that depend on the old behavior.
-bool IsLegacyNullable(Type type) {
-  switch (type.kind()) {
+bool IsLegacyNullableKind(TypeKind kind) {
+  switch (kind) {
     case TypeKind::kStruct:
     case TypeKind::kDuration:
     case TypeKind::kTimestamp:
@@ -68,6 +69,8 @@ bool IsLegacyNullable(Type type) {
   }
 }
 
+bool IsLegacyNullable(Type type) { return IsLegacyNullableKind(type.kind()); }
+
 bool IsTypeVar(absl::string_view name) { return absl::StartsWith(name, "T%"); }
 
 bool IsUnionType(Type t) {
@@ -153,8 +156,94 @@ std::optional<Type> WrapperToPrimitive(const Type& t) {
   }
 }
 
+std::optional<TypeKind> WrapperKindToPrimitiveKind(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::kBoolWrapper:
+      return TypeKind::kBool;
+    case TypeKind::kBytesWrapper:
+      return TypeKind::kBytes;
+    case TypeKind::kDoubleWrapper:
+      return TypeKind::kDouble;
+    case TypeKind::kStringWrapper:
+      return TypeKind::kString;
+    case TypeKind::kIntWrapper:
+      return TypeKind::kInt;
+    case TypeKind::kUintWrapper:
+      return TypeKind::kUint;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Returns false if a type of kind `from` can never be assigned to a type of
+// kind `to`, regardless of type parameters.
+//
+// Mirrors the rules in TypeInferenceContext::IsAssignableInternal, erring on
+// the side of returning true.
+bool KindsMayBeAssignable(TypeKind from, TypeKind to) {
+  if (from == to) {
+    return true;
+  }
+  switch (from) {
+    case TypeKind::kTypeParam:
+    case TypeKind::kAny:
+    case TypeKind::kDyn:
+    case TypeKind::kError:
+      return true;
+    default:
+      break;
+  }
+  switch (to) {
+    case TypeKind::kTypeParam:
+    case TypeKind::kAny:
+    case TypeKind::kDyn:
+    case TypeKind::kError:
+      return true;
+    default:
+      break;
+  }
+  if (std::optional<TypeKind> wrapped = WrapperKindToPrimitiveKind(to);
+      wrapped.has_value()) {
+    return from == TypeKind::kNull || KindsMayBeAssignable(*wrapped, from);
+  }
+  if (std::optional<TypeKind> wrapped = WrapperKindToPrimitiveKind(from);
+      wrapped.has_value()) {
+    return KindsMayBeAssignable(*wrapped, to);
+  }
+  // Legacy null assignment may be disabled, but the full check handles that.
+  if ((from == TypeKind::kNull && IsLegacyNullableKind(to)) ||
+      (to == TypeKind::kNull && IsLegacyNullableKind(from))) {
+    return true;
+  }
+  return (from == TypeKind::kEnum && to == TypeKind::kInt) ||
+         (from == TypeKind::kInt && to == TypeKind::kEnum);
+}
+
 }  // namespace
 
+absl::optional<std::vector<size_t>> OverloadResolutionCache::Find(
+    absl::string_view key) const {
+  absl::MutexLock lock(mutex_);
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    return it->second;
+  }
+  return absl::nullopt;
+}
+
+void OverloadResolutionCache::Insert(std::string key,
+                                     std::vector<size_t> overload_indices) {
+  absl::MutexLock lock(mutex_);
+  if (entries_.size() >= kMaxEntries) {
+    return;
+  }
+  entries_.try_emplace(std::move(key), std::move(overload_indices));
+}
+
+size_t OverloadResolutionCache::size() const {
+  absl::MutexLock lock(mutex_);
+  return entries_.size();
+}
+
 Type TypeInferenceContext::InstantiateTypeParams(const Type& type) {
   InstanceMap substitutions;
   return InstantiateTypeParams(type, substitutions);
@@ -536,19 +625,69 @@ std::optional<TypeInferenceContext::OverloadResolution>
 TypeInferenceContext::ResolveOverload(const FunctionDecl& decl,
                                       absl::Span<const Type> argument_types,
                                       bool is_receiver) {
-  std::optional<Type> result_type;
-
   bool is_logical_op = (decl.name() == cel::StandardFunctions::kAnd ||
                         decl.name() == cel::StandardFunctions::kOr) &&
                        argument_types.size() >= 2;
 
-  std::vector<OverloadDecl> matching_overloads;
-  for (const auto& ovl : decl.overloads()) {
+  // Whether an overload matches fully concrete arguments doesn't depend on
+  // the rest of the expression, so the matching overloads can be reused.
+  std::string cache_key;
+  bool cacheable = overload_cache_ != nullptr && !is_logical_op;
+  if (cacheable) {
+    absl::StrAppend(&cache_key, decl.name(), is_receiver ? "/r" : "/g");
+    for (const Type& type : argument_types) {
+      cache_key.push_back('/');
+      if (!AppendConcreteTypeKey(type, cache_key)) {
+        cacheable = false;
+        break;
+      }
+    }
+  }
+  if (cacheable) {
+    if (std::optional<std::vector<size_t>> cached =
+            overload_cache_->Find(cache_key);
+        cached.has_value()) {
+      return ResolveOverloadCandidates(decl, *cached, argument_types,
+                                       /*is_logical_op=*/false,
+                                       /*matched_indices=*/nullptr);
+    }
+  }
+
+  std::vector<size_t> candidates;
+  for (size_t i = 0; i < decl.overloads().size(); ++i) {
+    const OverloadDecl& ovl = decl.overloads()[i];
     if (ovl.member() != is_receiver ||
         (!is_logical_op && argument_types.size() != ovl.args().size())) {
       continue;
     }
+    if (!is_logical_op && !ArgumentKindsMayMatch(ovl, argument_types)) {
+      continue;
+    }
+    candidates.push_back(i);
+  }
+
+  if (!cacheable) {
+    return ResolveOverloadCandidates(decl, candidates, argument_types,
+                                     is_logical_op,
+                                     /*matched_indices=*/nullptr);
+  }
+  std::vector<size_t> matched_indices;
+  std::optional<OverloadResolution> resolution = ResolveOverloadCandidates(
+      decl, candidates, argument_types, is_logical_op, &matched_indices);
+  overload_cache_->Insert(std::move(cache_key), std::move(matched_indices));
+  return resolution;
+}
+
+std::optional<TypeInferenceContext::OverloadResolution>
+TypeInferenceContext::ResolveOverloadCandidates(
+    const FunctionDecl& decl, absl::Span<const size_t> candidate_indices,
+    absl::Span<const Type> argument_types, bool is_logical_op,
+    std::vector<size_t>* absl_nullable matched_indices) {
+  std::optional<Type> result_type;
 
+  std::vector<OverloadDecl> matching_overloads;
+  for (size_t index : candidate_indices) {
+    const OverloadDecl& ovl = decl.overloads()[index];
     auto call_type_instance = InstantiateFunctionOverload(*this, ovl);
     if (!is_logical_op) {
       ABSL_DCHECK_EQ(argument_types.size(),
@@ -567,6 +706,9 @@ TypeInferenceContext::ResolveOverload(const FunctionDecl& decl,
 
     if (is_match) {
       matching_overloads.push_back(ovl);
+      if (matched_indices != nullptr) {
+        matched_indices->push_back(index);
+      }
       assignability_context.UpdateInferredTypeAssignments();
       if (!result_type.has_value()) {
         result_type = call_type_instance.result_type;
@@ -587,6 +729,40 @@ TypeInferenceContext::ResolveOverload(const FunctionDecl& decl,
   };
 }
 
+bool TypeInferenceContext::ArgumentKindsMayMatch(
+    const OverloadDecl& ovl, absl::Span<const Type> argument_types) const {
+  for (size_t i = 0; i < argument_types.size(); ++i) {
+    TypeKind argument_kind =
+        Substitute(argument_types[i], SubstitutionMap()).kind();
+    if (!KindsMayBeAssignable(argument_kind, ovl.args()[i].kind())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TypeInferenceContext::AppendConcreteTypeKey(const Type& type,
+                                                 std::string& key) const {
+  Type subs = Substitute(type, SubstitutionMap());
+  if (subs.kind() == TypeKind::kTypeParam) {
+    return false;
+  }
+  absl::StrAppend(&key, static_cast<int>(subs.kind()), ":", subs.name());
+  auto params = subs.GetParameters();
+  if (params.empty()) {
+    return true;
+  }
+  key.push_back('(');
+  for (const Type& param : params) {
+    if (!AppendConcreteTypeKey(param, key)) {
+      return false;
+    }
+    key.push_back(',');
+  }
+  key.push_back(')');
+  return true;
+}
+
 void TypeInferenceContext::UpdateTypeParameterBindings(
     const SubstitutionMap& prospective_substitutions) {
   if (prospective_substitutions.empty()) {
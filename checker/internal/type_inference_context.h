@@ -15,15 +15,19 @@
 #ifndef THIRD_PARTY_CEL_CPP_CHECKER_INTERNAL_TYPE_INFERENCE_CONTEXT_H_
 #define THIRD_PARTY_CEL_CPP_CHECKER_INTERNAL_TYPE_INFERENCE_CONTEXT_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
+#include "absl/base/nullability.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "common/decl.h"
@@ -32,6 +36,38 @@
 
 namespace cel::checker_internal {
 
+// Memoizes overload resolution for calls with fully concrete argument types.
+//
+// Intended to be shared by all of the checks performed by a TypeChecker, so
+// the function declarations must not change for the lifetime of the cache.
+// Thread safe.
+//
+// Only the indices of the matching overloads are recorded. The resolution is
+// replayed against just those overloads so the calling inference context is
+// updated exactly as it would be without the cache.
+class OverloadResolutionCache {
+ public:
+  // Limit on the number of memoized resolutions. Further resolutions are
+  // computed but not recorded.
+  static constexpr size_t kMaxEntries = 8192;
+
+  OverloadResolutionCache() = default;
+
+  OverloadResolutionCache(const OverloadResolutionCache&) = delete;
+  OverloadResolutionCache& operator=(const OverloadResolutionCache&) = delete;
+
+  absl::optional<std::vector<size_t>> Find(absl::string_view key) const;
+
+  void Insert(std::string key, std::vector<size_t> overload_indices);
+
+  size_t size() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::vector<size_t>> entries_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 // Class manages context for type inferences in the type checker.
 // TODO(uncreated-issue/72): for now, just checks assignability for concrete types.
 // Support for finding substitutions of type parameters will be added in a
@@ -95,10 +131,13 @@ class TypeInferenceContext {
     SubstitutionMap prospective_substitutions_;
   };
 
-  explicit TypeInferenceContext(google::protobuf::Arena* arena,
-                                bool enable_legacy_null_assignment = true)
+  // If provided, `overload_cache` must outlive the context.
+  explicit TypeInferenceContext(
+      google::protobuf::Arena* arena, bool enable_legacy_null_assignment = true,
+      OverloadResolutionCache* absl_nullable overload_cache = nullptr)
       : arena_(arena),
-        enable_legacy_null_assignment_(enable_legacy_null_assignment) {}
+        enable_legacy_null_assignment_(enable_legacy_null_assignment),
+        overload_cache_(overload_cache) {}
 
   // Creates a new AssignabilityContext for the current inference context.
   //
@@ -133,6 +172,11 @@ class TypeInferenceContext {
   // inferred argument types.
   //
   // If found, returns the result type and the list of applicable overloads.
+  //
+  // Overloads that cannot match based on the kinds of the argument and
+  // parameter types are skipped without being instantiated. If the context
+  // has an overload cache and the argument types are fully concrete, the
+  // matching overloads are memoized.
   absl::optional<OverloadResolution> ResolveOverload(
       const FunctionDecl& decl, absl::Span<const Type> argument_types,
       bool is_receiver);
@@ -205,6 +249,23 @@ class TypeInferenceContext {
   void UpdateTypeParameterBindings(
       const SubstitutionMap& prospective_substitutions);
 
+  // Returns false if the argument kinds rule out `ovl` without needing to
+  // instantiate it.
+  bool ArgumentKindsMayMatch(const OverloadDecl& ovl,
+                             absl::Span<const Type> argument_types) const;
+
+  // Appends a key identifying `type` to `key`. Returns false if the type
+  // has free type parameters under the current substitutions.
+  bool AppendConcreteTypeKey(const Type& type, std::string& key) const;
+
+  // Resolves the call against the overloads of `decl` at the given indices.
+  // If `matched_indices` is not null, the indices of the overloads that
+  // match are appended to it.
+  absl::optional<OverloadResolution> ResolveOverloadCandidates(
+      const FunctionDecl& decl, absl::Span<const size_t> candidate_indices,
+      absl::Span<const Type> argument_types, bool is_logical_op,
+      std::vector<size_t>* absl_nullable matched_indices);
+
   // Map from type var parameter name to the type it is bound to.
   //
   // Type var parameters are formatted as "T%<id>" to avoid collisions with
@@ -222,6 +283,7 @@ class TypeInferenceContext {
   int64_t next_type_parameter_id_ = 0;
   google::protobuf::Arena* arena_;
   bool enable_legacy_null_assignment_;
+  OverloadResolutionCache* absl_nullable overload_cache_;
 };
 
 }  // namespace cel::checker_internal
@@ -29,7 +29,9 @@ namespace cel::checker_internal {
 namespace {
 
 using ::testing::ElementsAre;
+using ::testing::Field;
 using ::testing::IsEmpty;
+using ::testing::Optional;
 using ::testing::SafeMatcherCast;
 using ::testing::SizeIs;
 
@@ -846,5 +848,77 @@ TEST(TypeInferenceContextTest, AssignabilityContextReset) {
               IsTypeKind(TypeKind::kDouble));
 }
 
+TEST(TypeInferenceContextTest, ResolveOverloadFiltersByKind) {
+  google::protobuf::Arena arena;
+  TypeInferenceContext context(&arena);
+
+  ASSERT_OK_AND_ASSIGN(
+      FunctionDecl decl,
+      MakeFunctionDecl(
+          "foo",
+          MakeOverloadDecl("foo_int_wrapper", IntType(), IntWrapperType()),
+          MakeOverloadDecl("foo_string", StringType(), StringType()),
+          MakeOverloadDecl("foo_list", ListType(&arena, TypeParamType("A")),
+                           ListType(&arena, TypeParamType("A")))));
+
+  std::optional<TypeInferenceContext::OverloadResolution> resolution =
+      context.ResolveOverload(decl, {IntType()}, false);
+  ASSERT_TRUE(resolution.has_value());
+  EXPECT_THAT(resolution->overloads,
+              ElementsAre(IsOverloadDecl("foo_int_wrapper")));
+
+  resolution = context.ResolveOverload(decl, {NullType()}, false);
+  ASSERT_TRUE(resolution.has_value());
+  EXPECT_THAT(resolution->overloads,
+              ElementsAre(IsOverloadDecl("foo_int_wrapper")));
+
+  resolution = context.ResolveOverload(decl, {DynType()}, false);
+  ASSERT_TRUE(resolution.has_value());
+  EXPECT_THAT(resolution->overloads, SizeIs(3));
+
+  EXPECT_FALSE(context.ResolveOverload(decl, {BytesType()}, false));
+}
+
+TEST(TypeInferenceContextTest, ResolveOverloadCachesConcreteArguments) {
+  google::protobuf::Arena arena;
+  OverloadResolutionCache cache;
+
+  ASSERT_OK_AND_ASSIGN(
+      FunctionDecl decl,
+      MakeFunctionDecl(
+          "_+_", MakeOverloadDecl("add_int", IntType(), IntType(), IntType()),
+          MakeOverloadDecl("add_list", ListType(&arena, TypeParamType("A")),
+                           ListType(&arena, TypeParamType("A")),
+                           ListType(&arena, TypeParamType("A")))));
+  Type list_of_int = ListType(&arena, IntType());
+
+  for (int i = 0; i < 2; ++i) {
+    TypeInferenceContext context(&arena, /*enable_legacy_null_assignment=*/true,
+                                 &cache);
+    std::optional<TypeInferenceContext::OverloadResolution> resolution =
+        context.ResolveOverload(decl, {list_of_int, list_of_int}, false);
+    ASSERT_TRUE(resolution.has_value());
+    EXPECT_THAT(resolution->overloads,
+                ElementsAre(IsOverloadDecl("add_list")));
+    ASSERT_THAT(resolution->result_type, IsTypeKind(TypeKind::kList));
+    EXPECT_THAT(resolution->result_type.AsList()->GetElement(),
+                IsTypeKind(TypeKind::kInt));
+    EXPECT_EQ(cache.size(), 1);
+  }
+
+  TypeInferenceContext context(&arena, /*enable_legacy_null_assignment=*/true,
+                               &cache);
+  // No matching overloads is also recorded.
+  EXPECT_FALSE(context.ResolveOverload(decl, {IntType(), list_of_int}, false));
+  EXPECT_EQ(cache.size(), 2);
+
+  // Free type parameters depend on the rest of the expression, so the
+  // resolution isn't cached.
+  Type list_of_a = context.InstantiateTypeParams(
+      ListType(&arena, TypeParamType("A")));
+  EXPECT_TRUE(context.ResolveOverload(decl, {list_of_a, list_of_int}, false));
+  EXPECT_EQ(cache.size(), 2);
+}
+
 }  // namespace
 }  // namespace cel::checker_internal
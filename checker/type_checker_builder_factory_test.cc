@@ -848,5 +848,72 @@ TEST(TypeCheckerBuilderTest, ToBuilderIndependenceAndInheritance) {
   }
 }
 
+TEST(TypeCheckerBuilderTest, ToBuilderLayersDeclarations) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TypeCheckerBuilder> builder,
+      CreateTypeCheckerBuilder(GetSharedTestingDescriptorPool()));
+  ASSERT_THAT(builder->AddLibrary(StandardCheckerLibrary()), IsOk());
+  ASSERT_THAT(builder->AddVariable(MakeVariableDecl("x", IntType())), IsOk());
+  ASSERT_OK_AND_ASSIGN(
+      auto fn_decl,
+      MakeFunctionDecl("addOne",
+                       MakeOverloadDecl("addOne_int", IntType(), IntType())));
+  ASSERT_THAT(builder->AddFunction(fn_decl), IsOk());
+  ASSERT_OK_AND_ASSIGN(auto base, builder->Build());
+
+  // Redeclaring an inherited variable is still an error.
+  auto duplicate = base->ToBuilder();
+  ASSERT_THAT(duplicate->AddVariable(MakeVariableDecl("x", IntType())),
+              IsOk());
+  EXPECT_THAT(duplicate->Build(),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+
+  // Inherited declarations can be replaced and merged with.
+  auto child_builder = base->ToBuilder();
+  ASSERT_THAT(child_builder->AddOrReplaceVariable(
+                  MakeVariableDecl("x", StringType())),
+              IsOk());
+  ASSERT_OK_AND_ASSIGN(
+      auto merged_decl,
+      MakeFunctionDecl("addOne", MakeOverloadDecl("addOne_string",
+                                                  StringType(), StringType())));
+  ASSERT_THAT(child_builder->MergeFunction(merged_decl), IsOk());
+  ASSERT_OK_AND_ASSIGN(auto child, child_builder->Build());
+
+  // Derive again to exercise more than one inherited layer.
+  auto grandchild_builder = child->ToBuilder();
+  ASSERT_THAT(
+      grandchild_builder->AddVariable(MakeVariableDecl("y", IntType())),
+      IsOk());
+  ASSERT_OK_AND_ASSIGN(auto grandchild, grandchild_builder->Build());
+
+  {
+    ASSERT_OK_AND_ASSIGN(auto ast,
+                         MakeTestParsedAst("addOne(x) + 'a' == 'b'"));
+    ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                         grandchild->Check(std::move(ast)));
+    EXPECT_TRUE(result.IsValid());
+  }
+  {
+    ASSERT_OK_AND_ASSIGN(auto ast, MakeTestParsedAst("addOne(y) + 1 == 2"));
+    ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                         grandchild->Check(std::move(ast)));
+    EXPECT_TRUE(result.IsValid());
+  }
+  // The base checker is unaffected.
+  {
+    ASSERT_OK_AND_ASSIGN(auto ast, MakeTestParsedAst("addOne(x) + 1 == 2"));
+    ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                         base->Check(std::move(ast)));
+    EXPECT_TRUE(result.IsValid());
+  }
+  {
+    ASSERT_OK_AND_ASSIGN(auto ast, MakeTestParsedAst("addOne('a')"));
+    ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                         base->Check(std::move(ast)));
+    EXPECT_FALSE(result.IsValid());
+  }
+}
+
 }  // namespace
 }  // namespace cel
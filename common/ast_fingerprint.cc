@@ -0,0 +1,309 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/ast_fingerprint.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/casts.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/ast.h"
+#include "common/ast/metadata.h"
+#include "common/constant.h"
+#include "common/expr.h"
+
+namespace cel {
+
+namespace {
+
+// Appends fields to a fingerprint. Variable length fields are length
+// prefixed so the encoding is unambiguous.
+class FingerprintWriter {
+ public:
+  explicit FingerprintWriter(std::string& out) : out_(out) {}
+
+  void Bool(bool value) { out_.push_back(value ? '\1' : '\0'); }
+
+  void Uint(uint64_t value) {
+    out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void Int(int64_t value) { Uint(static_cast<uint64_t>(value)); }
+
+  void String(absl::string_view value) {
+    Uint(value.size());
+    out_.append(value.data(), value.size());
+  }
+
+ private:
+  std::string& out_;
+};
+
+void AppendConstant(const Constant& constant, FingerprintWriter& writer) {
+  writer.Uint(static_cast<uint64_t>(constant.kind_case()));
+  switch (constant.kind_case()) {
+    case ConstantKindCase::kBool:
+      writer.Bool(constant.bool_value());
+      break;
+    case ConstantKindCase::kInt:
+      writer.Int(constant.int_value());
+      break;
+    case ConstantKindCase::kUint:
+      writer.Uint(constant.uint_value());
+      break;
+    case ConstantKindCase::kDouble:
+      writer.Uint(absl::bit_cast<uint64_t>(constant.double_value()));
+      break;
+    case ConstantKindCase::kBytes:
+      writer.String(constant.bytes_value());
+      break;
+    case ConstantKindCase::kString:
+      writer.String(constant.string_value());
+      break;
+    case ConstantKindCase::kDuration:
+      writer.String(absl::FormatDuration(constant.duration_value()));
+      break;
+    case ConstantKindCase::kTimestamp:
+      writer.String(absl::FormatTime(absl::RFC3339_full,
+                                     constant.timestamp_value(),
+                                     absl::UTCTimeZone()));
+      break;
+    default:
+      break;
+  }
+}
+
+// Appends the expression tree in pre-order, recording the pre-order position
+// of each expression id so that metadata keyed by id can be encoded
+// independently of the id assignment.
+//
+// Uses an explicit stack since ASTs may be deeply nested.
+void AppendExprTree(const Expr& root, FingerprintWriter& writer,
+                    absl::flat_hash_map<int64_t, int64_t>& positions) {
+  std::vector<const Expr*> stack;
+  stack.push_back(&root);
+  while (!stack.empty()) {
+    const Expr& expr = *stack.back();
+    stack.pop_back();
+    positions.try_emplace(expr.id(), static_cast<int64_t>(positions.size()));
+    writer.Uint(static_cast<uint64_t>(expr.kind_case()));
+    switch (expr.kind_case()) {
+      case ExprKindCase::kConstant:
+        AppendConstant(expr.const_expr(), writer);
+        break;
+      case ExprKindCase::kIdentExpr:
+        writer.String(expr.ident_expr().name());
+        break;
+      case ExprKindCase::kSelectExpr: {
+        const SelectExpr& select = expr.select_expr();
+        writer.String(select.field());
+        writer.Bool(select.test_only());
+        stack.push_back(&select.operand());
+        break;
+      }
+      case ExprKindCase::kCallExpr: {
+        const CallExpr& call = expr.call_expr();
+        writer.String(call.function());
+        writer.Bool(call.has_target());
+        writer.Uint(call.args().size());
+        for (auto it = call.args().rbegin(); it != call.args().rend(); ++it) {
+          stack.push_back(&*it);
+        }
+        if (call.has_target()) {
+          stack.push_back(&call.target());
+        }
+        break;
+      }
+      case ExprKindCase::kListExpr: {
+        const auto& elements = expr.list_expr().elements();
+        writer.Uint(elements.size());
+        for (const ListExprElement& element : elements) {
+          writer.Bool(element.optional());
+        }
+        for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+          stack.push_back(&it->expr());
+        }
+        break;
+      }
+      case ExprKindCase::kStructExpr: {
+        const StructExpr& struct_expr = expr.struct_expr();
+        writer.String(struct_expr.name());
+        writer.Uint(struct_expr.fields().size());
+        for (const StructExprField& field : struct_expr.fields()) {
+          writer.String(field.name());
+          writer.Bool(field.optional());
+        }
+        for (auto it = struct_expr.fields().rbegin();
+             it != struct_expr.fields().rend(); ++it) {
+          stack.push_back(&it->value());
+        }
+        break;
+      }
+      case ExprKindCase::kMapExpr: {
+        const auto& entries = expr.map_expr().entries();
+        writer.Uint(entries.size());
+        for (const MapExprEntry& entry : entries) {
+          writer.Bool(entry.optional());
+        }
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+          stack.push_back(&it->value());
+          stack.push_back(&it->key());
+        }
+        break;
+      }
+      case ExprKindCase::kComprehensionExpr: {
+        const ComprehensionExpr& comprehension = expr.comprehension_expr();
+        writer.String(comprehension.iter_var());
+        writer.String(comprehension.iter_var2());
+        writer.String(comprehension.accu_var());
+        stack.push_back(&comprehension.result());
+        stack.push_back(&comprehension.loop_step());
+        stack.push_back(&comprehension.loop_condition());
+        stack.push_back(&comprehension.accu_init());
+        stack.push_back(&comprehension.iter_range());
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+void AppendTypeSpec(const TypeSpec& root, FingerprintWriter& writer) {
+  std::vector<const TypeSpec*> stack;
+  stack.push_back(&root);
+  while (!stack.empty()) {
+    const TypeSpec& type = *stack.back();
+    stack.pop_back();
+    writer.Uint(type.type_kind().index());
+    if (type.has_primitive()) {
+      writer.Uint(static_cast<uint64_t>(type.primitive()));
+    } else if (type.has_wrapper()) {
+      writer.Uint(static_cast<uint64_t>(type.wrapper()));
+    } else if (type.has_well_known()) {
+      writer.Uint(static_cast<uint64_t>(type.well_known()));
+    } else if (type.has_list_type()) {
+      stack.push_back(&type.list_type().elem_type());
+    } else if (type.has_map_type()) {
+      stack.push_back(&type.map_type().value_type());
+      stack.push_back(&type.map_type().key_type());
+    } else if (type.has_function()) {
+      const auto& arg_types = type.function().arg_types();
+      writer.Uint(arg_types.size());
+      for (auto it = arg_types.rbegin(); it != arg_types.rend(); ++it) {
+        stack.push_back(&*it);
+      }
+      stack.push_back(&type.function().result_type());
+    } else if (type.has_message_type()) {
+      writer.String(type.message_type().type());
+    } else if (type.has_type_param()) {
+      writer.String(type.type_param().type());
+    } else if (type.has_type()) {
+      stack.push_back(&type.type());
+    } else if (type.has_abstract_type()) {
+      const auto& parameter_types = type.abstract_type().parameter_types();
+      writer.String(type.abstract_type().name());
+      writer.Uint(parameter_types.size());
+      for (auto it = parameter_types.rbegin(); it != parameter_types.rend();
+           ++it) {
+        stack.push_back(&*it);
+      }
+    }
+  }
+}
+
+// Returns the entries of an expr id keyed map for ids in the expression tree,
+// ordered by pre-order position.
+template <typename V>
+std::vector<std::pair<int64_t, const V*>> SortByPosition(
+    const absl::flat_hash_map<int64_t, V>& map,
+    const absl::flat_hash_map<int64_t, int64_t>& positions) {
+  std::vector<std::pair<int64_t, const V*>> entries;
+  entries.reserve(map.size());
+  for (const auto& [id, value] : map) {
+    if (auto it = positions.find(id); it != positions.end()) {
+      entries.push_back({it->second, &value});
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.first < rhs.first;
+            });
+  return entries;
+}
+
+}  // namespace
+
+std::string StructuralFingerprint(const Ast& ast) {
+  std::string fingerprint;
+  FingerprintWriter writer(fingerprint);
+
+  writer.Bool(ast.is_checked());
+
+  absl::flat_hash_map<int64_t, int64_t> positions;
+  AppendExprTree(ast.root_expr(), writer, positions);
+
+  auto references = SortByPosition(ast.reference_map(), positions);
+  writer.Uint(references.size());
+  for (const auto& [position, reference] : references) {
+    writer.Int(position);
+    writer.String(reference->name());
+    writer.Uint(reference->overload_id().size());
+    for (const std::string& overload_id : reference->overload_id()) {
+      writer.String(overload_id);
+    }
+    writer.Bool(reference->has_value());
+    if (reference->has_value()) {
+      AppendConstant(reference->value(), writer);
+    }
+  }
+
+  auto types = SortByPosition(ast.type_map(), positions);
+  writer.Uint(types.size());
+  for (const auto& [position, type] : types) {
+    writer.Int(position);
+    AppendTypeSpec(*type, writer);
+  }
+
+  const auto& extensions = ast.source_info().extensions();
+  writer.Uint(extensions.size());
+  for (const ExtensionSpec& extension : extensions) {
+    writer.String(extension.id());
+    writer.Int(extension.version().major());
+    writer.Int(extension.version().minor());
+    writer.Uint(extension.affected_components().size());
+    for (ExtensionSpec::Component component :
+         extension.affected_components()) {
+      writer.Uint(static_cast<uint64_t>(component));
+    }
+  }
+
+  return fingerprint;
+}
+
+std::string ConstantFingerprint(const Constant& constant) {
+  std::string fingerprint;
+  FingerprintWriter writer(fingerprint);
+  AppendConstant(constant, writer);
+  return fingerprint;
+}
+
+}  // namespace cel
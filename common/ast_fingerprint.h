@@ -0,0 +1,42 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_AST_FINGERPRINT_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_AST_FINGERPRINT_H_
+
+#include <string>
+
+#include "common/ast.h"
+#include "common/constant.h"
+
+namespace cel {
+
+// Returns a canonical encoding of the structure of `ast`.
+//
+// Two ASTs have equal fingerprints if and only if they have the same
+// expression tree, resolved references and resolved types, ignoring
+// expression ids, source positions and macro call records. Source info
+// extensions are included since they may affect how the AST is planned.
+//
+// The encoding is binary and intended for use as a lookup key within a
+// process. It is not stable across releases.
+std::string StructuralFingerprint(const Ast& ast);
+
+// Returns a canonical encoding of `constant`, using the same encoding as
+// StructuralFingerprint.
+std::string ConstantFingerprint(const Constant& constant);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_AST_FINGERPRINT_H_
@@ -0,0 +1,131 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/ast_fingerprint.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/ast/metadata.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "internal/testing.h"
+
+namespace cel {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Not;
+
+// Builds `function(x, 1)` with ids starting at `first_id`.
+Expr MakeCall(int64_t first_id, absl::string_view function = "_+_",
+              int64_t constant = 1) {
+  Expr expr;
+  expr.set_id(first_id);
+  CallExpr& call = expr.mutable_call_expr();
+  call.set_function(function);
+  Expr& ident = call.add_args();
+  ident.set_id(first_id + 1);
+  ident.mutable_ident_expr().set_name("x");
+  Expr& literal = call.add_args();
+  literal.set_id(first_id + 2);
+  literal.mutable_const_expr().set_int_value(constant);
+  return expr;
+}
+
+// Builds a checked `x + 1` with ids starting at `first_id`.
+Ast MakeCheckedAst(int64_t first_id, absl::string_view overload_id,
+                   PrimitiveType ident_type) {
+  Ast::ReferenceMap reference_map;
+  reference_map[first_id].set_overload_id({std::string(overload_id)});
+  reference_map[first_id + 1].set_name("x");
+  Ast::TypeMap type_map;
+  type_map[first_id] = TypeSpec(PrimitiveType::kInt64);
+  type_map[first_id + 1] = TypeSpec(ident_type);
+  type_map[first_id + 2] = TypeSpec(PrimitiveType::kInt64);
+  return Ast(MakeCall(first_id), SourceInfo(), std::move(reference_map),
+             std::move(type_map), "");
+}
+
+TEST(StructuralFingerprintTest, IgnoresIdsAndPositions) {
+  Ast ast(MakeCall(1), SourceInfo());
+  Ast renumbered(MakeCall(10), SourceInfo());
+  renumbered.mutable_source_info().mutable_positions()[10] = 4;
+  renumbered.mutable_source_info().mutable_positions()[11] = 2;
+
+  EXPECT_THAT(StructuralFingerprint(ast),
+              Eq(StructuralFingerprint(renumbered)));
+}
+
+TEST(StructuralFingerprintTest, DistinguishesStructure) {
+  std::string fingerprint = StructuralFingerprint(Ast(MakeCall(1), {}));
+
+  EXPECT_THAT(StructuralFingerprint(Ast(MakeCall(1, "_-_"), {})),
+              Not(Eq(fingerprint)));
+  EXPECT_THAT(StructuralFingerprint(Ast(MakeCall(1, "_+_", 2), {})),
+              Not(Eq(fingerprint)));
+
+  Expr uint_constant = MakeCall(1);
+  uint_constant.mutable_call_expr().mutable_args()[1].mutable_const_expr()
+      .set_uint_value(1);
+  EXPECT_THAT(StructuralFingerprint(Ast(std::move(uint_constant), {})),
+              Not(Eq(fingerprint)));
+
+  Expr swapped = MakeCall(1);
+  std::swap(swapped.mutable_call_expr().mutable_args()[0],
+            swapped.mutable_call_expr().mutable_args()[1]);
+  EXPECT_THAT(StructuralFingerprint(Ast(std::move(swapped), {})),
+              Not(Eq(fingerprint)));
+}
+
+TEST(StructuralFingerprintTest, IncludesCheckerMetadata) {
+  std::string fingerprint = StructuralFingerprint(
+      MakeCheckedAst(1, "add_int64", PrimitiveType::kInt64));
+
+  EXPECT_THAT(StructuralFingerprint(
+                  MakeCheckedAst(20, "add_int64", PrimitiveType::kInt64)),
+              Eq(fingerprint));
+  EXPECT_THAT(StructuralFingerprint(
+                  MakeCheckedAst(1, "add_double", PrimitiveType::kInt64)),
+              Not(Eq(fingerprint)));
+  EXPECT_THAT(StructuralFingerprint(
+                  MakeCheckedAst(1, "add_int64", PrimitiveType::kUint64)),
+              Not(Eq(fingerprint)));
+  EXPECT_THAT(StructuralFingerprint(Ast(MakeCall(1), SourceInfo())),
+              Not(Eq(fingerprint)));
+}
+
+TEST(ConstantFingerprintTest, DistinguishesKinds) {
+  Constant int_constant;
+  int_constant.set_int_value(1);
+  Constant uint_constant;
+  uint_constant.set_uint_value(1);
+  Constant string_constant;
+  string_constant.set_string_value("1");
+  Constant other_int_constant;
+  other_int_constant.set_int_value(1);
+
+  EXPECT_THAT(ConstantFingerprint(int_constant),
+              Eq(ConstantFingerprint(other_int_constant)));
+  EXPECT_THAT(ConstantFingerprint(int_constant),
+              Not(Eq(ConstantFingerprint(uint_constant))));
+  EXPECT_THAT(ConstantFingerprint(int_constant),
+              Not(Eq(ConstantFingerprint(string_constant))));
+}
+
+}  // namespace
+}  // namespace cel
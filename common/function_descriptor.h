@@ -39,6 +39,12 @@ struct FunctionDescriptorOptions {
   // some of the assumptions of the CEL evaluation model. This flag is used as a
   // hint to the planner that some optimizations are not safe or not effective.
   bool is_contextual = false;
+
+  // Whether the function always returns the same result for the same
+  // arguments. Calls to deterministic functions may be memoized for the
+  // duration of an evaluation, see
+  // `RuntimeOptions::function_memoization_max_entries`.
+  bool is_deterministic = false;
 };
 
 // Coarsely describes a function for the purpose of runtime resolution of
@@ -89,6 +95,10 @@ class FunctionDescriptor final {
   // that some optimizations are not safe or not effective.
   bool is_contextual() const { return impl_->options.is_contextual; }
 
+  // Whether the function always returns the same result for the same
+  // arguments, making its results safe to memoize.
+  bool is_deterministic() const { return impl_->options.is_deterministic; }
+
   // Helper for matching a descriptor. This tests that the shape is the same --
   // |other| accepts the same number and types of arguments and is the same call
   // style).
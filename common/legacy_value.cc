@@ -29,7 +29,6 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -56,6 +55,7 @@
 #include "eval/public/structs/legacy_type_info_apis.h"
 #include "eval/public/structs/proto_message_type_adapter.h"
 #include "internal/json.h"
+#include "internal/message_copy.h"
 #include "internal/status_macros.h"
 #include "internal/well_known_types.h"
 #include "runtime/runtime_options.h"
@@ -448,23 +448,7 @@ absl::Status LegacyListValue::ConvertToJson(
       return absl::UnknownError("failed to convert legacy list to JSON");
     }
 
-    if (wrapped->GetDescriptor() == json->GetDescriptor()) {
-      // We can directly use google::protobuf::Message::Copy().
-      json->CopyFrom(*wrapped);
-    } else {
-      // Equivalent descriptors but not identical. Must serialize and
-      // deserialize.
-      absl::Cord serialized;
-      if (!wrapped->SerializePartialToString(&serialized)) {
-        return absl::UnknownError(absl::StrCat("failed to serialize message: ",
-                                               wrapped->GetTypeName()));
-      }
-      if (!json->ParsePartialFromString(serialized)) {
-        return absl::UnknownError(
-            absl::StrCat("failed to parsed message: ", json->GetTypeName()));
-      }
-    }
-    return absl::OkStatus();
+    return internal::CopyMessage(*wrapped, json);
   }
 }
 
@@ -487,23 +471,7 @@ absl::Status LegacyListValue::ConvertToJsonArray(
       return absl::UnknownError("failed to convert legacy list to JSON");
     }
 
-    if (wrapped->GetDescriptor() == json->GetDescriptor()) {
-      // We can directly use google::protobuf::Message::Copy().
-      json->CopyFrom(*wrapped);
-    } else {
-      // Equivalent descriptors but not identical. Must serialize and
-      // deserialize.
-      absl::Cord serialized;
-      if (!wrapped->SerializePartialToString(&serialized)) {
-        return absl::UnknownError(absl::StrCat("failed to serialize message: ",
-                                               wrapped->GetTypeName()));
-      }
-      if (!json->ParsePartialFromString(serialized)) {
-        return absl::UnknownError(
-            absl::StrCat("failed to parsed message: ", json->GetTypeName()));
-      }
-    }
-    return absl::OkStatus();
+    return internal::CopyMessage(*wrapped, json);
   }
 }
 
@@ -621,22 +589,7 @@ absl::Status LegacyMapValue::ConvertToJson(
     return absl::UnknownError("failed to convert legacy map to JSON");
   }
 
-  if (wrapped->GetDescriptor() == json->GetDescriptor()) {
-    // We can directly use google::protobuf::Message::Copy().
-    json->CopyFrom(*wrapped);
-  } else {
-    // Equivalent descriptors but not identical. Must serialize and deserialize.
-    absl::Cord serialized;
-    if (!wrapped->SerializePartialToString(&serialized)) {
-      return absl::UnknownError(absl::StrCat("failed to serialize message: ",
-                                             wrapped->GetTypeName()));
-    }
-    if (!json->ParsePartialFromString(serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to parsed message: ", json->GetTypeName()));
-    }
-  }
-  return absl::OkStatus();
+  return internal::CopyMessage(*wrapped, json);
 }
 
 absl::Status LegacyMapValue::ConvertToJsonObject(
@@ -657,22 +610,7 @@ absl::Status LegacyMapValue::ConvertToJsonObject(
     return absl::UnknownError("failed to convert legacy map to JSON");
   }
 
-  if (wrapped->GetDescriptor() == json->GetDescriptor()) {
-    // We can directly use google::protobuf::Message::Copy().
-    json->CopyFrom(*wrapped);
-  } else {
-    // Equivalent descriptors but not identical. Must serialize and deserialize.
-    absl::Cord serialized;
-    if (!wrapped->SerializePartialToString(&serialized)) {
-      return absl::UnknownError(absl::StrCat("failed to serialize message: ",
-                                             wrapped->GetTypeName()));
-    }
-    if (!json->ParsePartialFromString(serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to parsed message: ", json->GetTypeName()));
-    }
-  }
-  return absl::OkStatus();
+  return internal::CopyMessage(*wrapped, json);
 }
 
 bool LegacyMapValue::IsEmpty() const { return impl_->empty(); }
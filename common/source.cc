@@ -25,6 +25,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
 #include "absl/container/inlined_vector.h"
@@ -44,24 +45,123 @@
 
 namespace cel {
 
+namespace common_internal {
+
+namespace {
+
+// Returns the length of the UTF-8 sequence starting with `lead`, which is not
+// a continuation byte of well-formed UTF-8.
+size_t Utf8SequenceLength(char lead) {
+  const auto b = static_cast<uint8_t>(lead);
+  if (b < 0x80) {
+    return 1;
+  }
+  if (b < 0xe0) {
+    return 2;
+  }
+  if (b < 0xf0) {
+    return 3;
+  }
+  return 4;
+}
+
+}  // namespace
+
+// Well-formed UTF-8 source text containing non-ASCII code points. Code point
+// positions are mapped to byte offsets through an index of every
+// `kIndexStride`th code point, built on first use, as sequential scanning of
+// the text (lexing, formatting) does not need it.
+class Utf8SourceText final {
+ public:
+  Utf8SourceText(absl::string_view text, size_t size)
+      : text_(text), size_(size) {}
+
+  Utf8SourceText(const Utf8SourceText&) = delete;
+  Utf8SourceText& operator=(const Utf8SourceText&) = delete;
+
+  absl::string_view text() const { return text_; }
+
+  // Returns the byte offset of the code point at `position`, or the size of
+  // the text if `position` is the number of code points.
+  size_t ByteOffset(size_t position) const {
+    ABSL_DCHECK_LE(position, size_);
+    if (position == size_) {
+      return text_.size();
+    }
+    const absl::Span<const uint32_t> index = this->index();
+    const size_t block = position / kIndexStride;
+    size_t offset = index[block];
+    size_t remaining = position % kIndexStride;
+    const size_t block_size =
+        std::min(kIndexStride, size_ - block * kIndexStride);
+    const size_t block_end =
+        block + 1 < index.size() ? index[block + 1] : text_.size();
+    if (block_end - offset == block_size) {
+      // The block is ASCII.
+      return offset + remaining;
+    }
+    for (; remaining > 0; --remaining) {
+      offset += Utf8SequenceLength(text_[offset]);
+    }
+    return offset;
+  }
+
+  SourceContentView content() const {
+    return SourceContentView(Utf8SourceView(this, 0, size_));
+  }
+
+ private:
+  static constexpr size_t kIndexStride = 16;
+
+  absl::Span<const uint32_t> index() const {
+    absl::call_once(index_once_, [this]() {
+      index_.reserve(size_ / kIndexStride + 1);
+      size_t position = 0;
+      for (size_t offset = 0; offset < text_.size();
+           offset += Utf8SequenceLength(text_[offset]), ++position) {
+        if (position % kIndexStride == 0) {
+          index_.push_back(static_cast<uint32_t>(offset));
+        }
+      }
+    });
+    return absl::MakeConstSpan(index_);
+  }
+
+  const absl::string_view text_;
+  // The number of code points in `text_`.
+  const size_t size_;
+  mutable absl::once_flag index_once_;
+  mutable std::vector<uint32_t> index_;
+};
+
+char32_t Utf8SourceView::operator[](size_t position) const {
+  ABSL_DCHECK_LT(position, size_);
+  char32_t code_point;
+  internal::Utf8Decode(
+      text_->text().substr(text_->ByteOffset(begin_ + position)), &code_point);
+  return code_point;
+}
+
+absl::string_view Utf8SourceView::Utf8(size_t begin, size_t end) const {
+  ABSL_DCHECK_LE(begin, end);
+  ABSL_DCHECK_LE(end, size_);
+  if (begin == end) {
+    return absl::string_view();
+  }
+  const size_t begin_offset = text_->ByteOffset(begin_ + begin);
+  return text_->text().substr(begin_offset,
+                              text_->ByteOffset(begin_ + end) - begin_offset);
+}
+
+}  // namespace common_internal
+
 SourcePosition SourceContentView::size() const {
-  return static_cast<SourcePosition>(absl::visit(
-      absl::Overload(
-          [](absl::Span<const char> view) { return view.size(); },
-          [](absl::Span<const uint8_t> view) { return view.size(); },
-          [](absl::Span<const char16_t> view) { return view.size(); },
-          [](absl::Span<const char32_t> view) { return view.size(); }),
-      view_));
+  return static_cast<SourcePosition>(
+      absl::visit([](const auto& view) { return view.size(); }, view_));
 }
 
 bool SourceContentView::empty() const {
-  return absl::visit(
-      absl::Overload(
-          [](absl::Span<const char> view) { return view.empty(); },
-          [](absl::Span<const uint8_t> view) { return view.empty(); },
-          [](absl::Span<const char16_t> view) { return view.empty(); },
-          [](absl::Span<const char32_t> view) { return view.empty(); }),
-      view_);
+  return absl::visit([](const auto& view) { return view.empty(); }, view_);
 }
 
 char32_t SourceContentView::at(SourcePosition position) const {
@@ -73,17 +173,9 @@ char32_t SourceContentView::at(SourcePosition position) const {
                static_cast<size_t>(position)](absl::Span<const char> view) {
             return static_cast<char32_t>(static_cast<uint8_t>(view[position]));
           },
-          [position =
-               static_cast<size_t>(position)](absl::Span<const uint8_t> view) {
-            return static_cast<char32_t>(view[position]);
-          },
-          [position =
-               static_cast<size_t>(position)](absl::Span<const char16_t> view) {
-            return static_cast<char32_t>(view[position]);
-          },
-          [position =
-               static_cast<size_t>(position)](absl::Span<const char32_t> view) {
-            return static_cast<char32_t>(view[position]);
+          [position = static_cast<size_t>(position)](
+              const common_internal::Utf8SourceView& view) {
+            return view[position];
           }),
       view_);
 }
@@ -100,399 +192,148 @@ std::string SourceContentView::ToString(SourcePosition begin,
             view = view.subspan(begin, end - begin);
             return std::string(view.data(), view.size());
           },
-          [begin = static_cast<size_t>(begin),
-           end = static_cast<size_t>(end)](absl::Span<const uint8_t> view) {
-            view = view.subspan(begin, end - begin);
-            std::string result;
-            result.reserve(view.size() * 2);
-            for (const auto& code_point : view) {
-              internal::Utf8Encode(result, code_point);
-            }
-            result.shrink_to_fit();
-            return result;
-          },
-          [begin = static_cast<size_t>(begin),
-           end = static_cast<size_t>(end)](absl::Span<const char16_t> view) {
-            view = view.subspan(begin, end - begin);
-            std::string result;
-            result.reserve(view.size() * 3);
-            for (const auto& code_point : view) {
-              internal::Utf8Encode(result, code_point);
-            }
-            result.shrink_to_fit();
-            return result;
-          },
-          [begin = static_cast<size_t>(begin),
-           end = static_cast<size_t>(end)](absl::Span<const char32_t> view) {
-            view = view.subspan(begin, end - begin);
-            std::string result;
-            result.reserve(view.size() * 4);
-            for (const auto& code_point : view) {
-              internal::Utf8Encode(result, code_point);
-            }
-            result.shrink_to_fit();
-            return result;
+          [begin = static_cast<size_t>(begin), end = static_cast<size_t>(end)](
+              const common_internal::Utf8SourceView& view) {
+            return std::string(view.Utf8(begin, end));
           }),
       view_);
 }
 
 void SourceContentView::AppendToString(std::string& dest) const {
-  absl::visit(absl::Overload(
-                  [&dest](absl::Span<const char> view) {
-                    dest.append(view.data(), view.size());
-                  },
-                  [&dest](absl::Span<const uint8_t> view) {
-                    for (const auto& code_point : view) {
-                      internal::Utf8Encode(dest, code_point);
-                    }
-                  },
-                  [&dest](absl::Span<const char16_t> view) {
-                    for (const auto& code_point : view) {
-                      internal::Utf8Encode(dest, code_point);
-                    }
-                  },
-                  [&dest](absl::Span<const char32_t> view) {
-                    for (const auto& code_point : view) {
-                      internal::Utf8Encode(dest, code_point);
-                    }
-                  }),
-              view_);
+  absl::string_view utf8 = AsUtf8();
+  dest.append(utf8.data(), utf8.size());
+}
+
+absl::string_view SourceContentView::AsUtf8() const {
+  return absl::visit(
+      absl::Overload(
+          [](absl::Span<const char> view) {
+            return absl::string_view(view.data(), view.size());
+          },
+          [](const common_internal::Utf8SourceView& view) {
+            return view.Utf8(0, view.size());
+          }),
+      view_);
 }
 
 namespace common_internal {
 
 class SourceImpl : public Source {
  public:
-  SourceImpl(std::string description,
-             absl::InlinedVector<SourcePosition, 1> line_offsets)
+  // `size` is the number of code points in `text`.
+  SourceImpl(std::string description, std::string text, SourcePosition size)
       : description_(std::move(description)),
-        line_offsets_(std::move(line_offsets)) {}
+        text_(std::move(text)),
+        size_(size) {}
 
   absl::string_view description() const final { return description_; }
 
   absl::Span<const SourcePosition> line_offsets() const final {
+    absl::call_once(line_offsets_once_, [this]() {
+      const bool ascii = static_cast<size_t>(size_) == text_.size();
+      absl::string_view text = text_;
+      SourcePosition position = 0;
+      for (size_t newline = text.find('\n');
+           newline != absl::string_view::npos; newline = text.find('\n')) {
+        absl::string_view line = text.substr(0, newline + 1);
+        position += static_cast<SourcePosition>(
+            ascii ? line.size() : internal::Utf8CodePointCountUnchecked(line));
+        line_offsets_.push_back(position);
+        text.remove_prefix(line.size());
+      }
+      line_offsets_.push_back(size_ + 1);
+    });
     return absl::MakeConstSpan(line_offsets_);
   }
 
+ protected:
+  absl::string_view text() const { return text_; }
+
  private:
   const std::string description_;
-  const absl::InlinedVector<SourcePosition, 1> line_offsets_;
+  const std::string text_;
+  const SourcePosition size_;
+  mutable absl::once_flag line_offsets_once_;
+  mutable absl::InlinedVector<SourcePosition, 1> line_offsets_;
 };
 
 namespace {
 
 class AsciiSource final : public SourceImpl {
  public:
-  AsciiSource(std::string description,
-              absl::InlinedVector<SourcePosition, 1> line_offsets,
-              std::vector<char> text)
-      : SourceImpl(std::move(description), std::move(line_offsets)),
-        text_(std::move(text)) {}
+  AsciiSource(std::string description, std::string text, SourcePosition size)
+      : SourceImpl(std::move(description), std::move(text), size) {}
 
   ContentView content() const override {
-    return MakeContentView(absl::MakeConstSpan(text_));
+    return MakeContentView(absl::MakeConstSpan(text().data(), text().size()));
   }
-
- private:
-  const std::vector<char> text_;
-};
-
-class Latin1Source final : public SourceImpl {
- public:
-  Latin1Source(std::string description,
-               absl::InlinedVector<SourcePosition, 1> line_offsets,
-               std::vector<uint8_t> text)
-      : SourceImpl(std::move(description), std::move(line_offsets)),
-        text_(std::move(text)) {}
-
-  ContentView content() const override {
-    return MakeContentView(absl::MakeConstSpan(text_));
-  }
-
- private:
-  const std::vector<uint8_t> text_;
-};
-
-class BasicPlaneSource final : public SourceImpl {
- public:
-  BasicPlaneSource(std::string description,
-                   absl::InlinedVector<SourcePosition, 1> line_offsets,
-                   std::vector<char16_t> text)
-      : SourceImpl(std::move(description), std::move(line_offsets)),
-        text_(std::move(text)) {}
-
-  ContentView content() const override {
-    return MakeContentView(absl::MakeConstSpan(text_));
-  }
-
- private:
-  const std::vector<char16_t> text_;
 };
 
-class SupplementalPlaneSource final : public SourceImpl {
+class Utf8Source final : public SourceImpl {
  public:
-  SupplementalPlaneSource(std::string description,
-                          absl::InlinedVector<SourcePosition, 1> line_offsets,
-                          std::vector<char32_t> text)
-      : SourceImpl(std::move(description), std::move(line_offsets)),
-        text_(std::move(text)) {}
+  Utf8Source(std::string description, std::string text, SourcePosition size)
+      : SourceImpl(std::move(description), std::move(text), size),
+        utf8_(SourceImpl::text(), static_cast<size_t>(size)) {}
 
-  ContentView content() const override {
-    return MakeContentView(absl::MakeConstSpan(text_));
-  }
+  ContentView content() const override { return utf8_.content(); }
 
  private:
-  const std::vector<char32_t> text_;
-};
-
-template <typename T>
-struct SourceTextTraits;
-
-template <>
-struct SourceTextTraits<absl::string_view> {
-  using iterator_type = absl::string_view;
-
-  static iterator_type Begin(absl::string_view text) { return text; }
-
-  static void Advance(iterator_type& it, size_t n) { it.remove_prefix(n); }
-
-  static void AppendTo(std::vector<uint8_t>& out, absl::string_view text,
-                       size_t n) {
-    const auto* in = reinterpret_cast<const uint8_t*>(text.data());
-    out.insert(out.end(), in, in + n);
-  }
-
-  static std::vector<char> ToVector(absl::string_view in) {
-    std::vector<char> out;
-    out.reserve(in.size());
-    out.insert(out.end(), in.begin(), in.end());
-    return out;
-  }
+  const Utf8SourceText utf8_;
 };
 
-template <>
-struct SourceTextTraits<absl::Cord> {
-  using iterator_type = absl::Cord::CharIterator;
-
-  static iterator_type Begin(const absl::Cord& text) {
-    return text.char_begin();
-  }
-
-  static void Advance(iterator_type& it, size_t n) {
-    absl::Cord::Advance(&it, n);
-  }
-
-  static void AppendTo(std::vector<uint8_t>& out, const absl::Cord& text,
-                       size_t n) {
-    auto it = text.char_begin();
-    while (n > 0) {
-      auto str = absl::Cord::ChunkRemaining(it);
-      size_t to_append = std::min(n, str.size());
-      const auto* in = reinterpret_cast<const uint8_t*>(str.data());
-      out.insert(out.end(), in, in + to_append);
-      n -= to_append;
-      absl::Cord::Advance(&it, to_append);
-    }
-  }
-
-  static std::vector<char> ToVector(const absl::Cord& in) {
-    std::vector<char> out;
-    out.reserve(in.size());
-    for (const auto& chunk : in.Chunks()) {
-      out.insert(out.end(), chunk.begin(), chunk.end());
-    }
-    return out;
-  }
-};
+absl::Status CodepointLimitError(size_t max_codepoints) {
+  return absl::InvalidArgumentError(absl::StrCat(
+      "expression is larger than codepoint limit ", max_codepoints));
+}
 
-template <typename T>
-absl::StatusOr<SourcePtr> NewSourceImpl(std::string description, const T& text,
-                                        const size_t text_size,
+absl::StatusOr<SourcePtr> NewSourceImpl(std::string description,
+                                        std::string text,
                                         const size_t max_codepoints) {
   if (ABSL_PREDICT_FALSE(
-          text_size >
+          text.size() >
           static_cast<size_t>(std::numeric_limits<int32_t>::max()))) {
     return absl::InvalidArgumentError("expression larger than 2GiB limit");
   }
-  if ((text_size >> 2) > max_codepoints) {
+  if ((text.size() >> 2) > max_codepoints) {
     // If byte size is 4 times the codepoint limit, then definitely exceeded.
-    return absl::InvalidArgumentError(absl::StrCat(
-        "expression is larger than codepoint limit ", max_codepoints));
-  }
-  using Traits = SourceTextTraits<T>;
-  size_t index = 0;
-  typename Traits::iterator_type it = Traits::Begin(text);
-  SourcePosition offset = 0;
-  char32_t code_point;
-  size_t code_units;
-  std::vector<uint8_t> data8;
-  std::vector<char16_t> data16;
-  std::vector<char32_t> data32;
-  absl::InlinedVector<SourcePosition, 1> line_offsets;
-  while (index < text_size) {
-    if (offset >= max_codepoints) {
-      return absl::InvalidArgumentError(absl::StrCat(
-          "expression is larger than codepoint limit ", max_codepoints));
-    }
-    std::tie(code_point, code_units) = cel::internal::Utf8Decode(it);
-    if (ABSL_PREDICT_FALSE(code_point ==
-                               cel::internal::kUnicodeReplacementCharacter &&
-                           code_units == 1)) {
-      // Thats an invalid UTF-8 encoding.
-      return absl::InvalidArgumentError("cannot parse malformed UTF-8 input");
-    }
-    if (code_point == '\n') {
-      line_offsets.push_back(offset + 1);
-    }
-    if (code_point <= 0x7f) {
-      Traits::Advance(it, code_units);
-      index += code_units;
-      ++offset;
-      continue;
-    }
-    if (code_point <= 0xff) {
-      data8.reserve(text_size);
-      Traits::AppendTo(data8, text, index);
-      data8.push_back(static_cast<uint8_t>(code_point));
-      Traits::Advance(it, code_units);
-      index += code_units;
-      ++offset;
-      goto latin1;
-    }
-    if (code_point <= 0xffff) {
-      data16.reserve(text_size);
-      for (size_t offset = 0; offset < index; offset++) {
-        data16.push_back(static_cast<uint8_t>(text[offset]));
-      }
-      data16.push_back(static_cast<char16_t>(code_point));
-      Traits::Advance(it, code_units);
-      index += code_units;
-      ++offset;
-      goto basic;
+    return CodepointLimitError(max_codepoints);
+  }
+  // Most expressions are ASCII, which is kept as is and needs no validation
+  // beyond this scan.
+  const size_t ascii = internal::Utf8AsciiPrefixLength(text);
+  if (ascii == text.size()) {
+    if (text.size() > max_codepoints) {
+      return CodepointLimitError(max_codepoints);
     }
-    data32.reserve(text_size);
-    for (size_t offset = 0; offset < index; offset++) {
-      data32.push_back(static_cast<char32_t>(text[offset]));
-    }
-    data32.push_back(code_point);
-    Traits::Advance(it, code_units);
-    index += code_units;
-    ++offset;
-    goto supplemental;
-  }
-  line_offsets.push_back(offset + 1);
-  return std::make_unique<AsciiSource>(
-      std::move(description), std::move(line_offsets), Traits::ToVector(text));
-latin1:
-  while (index < text_size) {
-    if (offset >= max_codepoints) {
-      return absl::InvalidArgumentError(absl::StrCat(
-          "expression is larger than codepoint limit ", max_codepoints));
-    }
-    std::tie(code_point, code_units) = internal::Utf8Decode(it);
-    if (ABSL_PREDICT_FALSE(code_point ==
-                               internal::kUnicodeReplacementCharacter &&
-                           code_units == 1)) {
-      // Thats an invalid UTF-8 encoding.
-      return absl::InvalidArgumentError("cannot parse malformed UTF-8 input");
-    }
-    if (code_point == '\n') {
-      line_offsets.push_back(offset + 1);
-    }
-    if (code_point <= 0xff) {
-      data8.push_back(static_cast<uint8_t>(code_point));
-      Traits::Advance(it, code_units);
-      index += code_units;
-      ++offset;
-      continue;
-    }
-    if (code_point <= 0xffff) {
-      data16.reserve(text_size);
-      for (const auto& value : data8) {
-        data16.push_back(value);
+    const auto size = static_cast<SourcePosition>(text.size());
+    return std::make_unique<AsciiSource>(std::move(description),
+                                         std::move(text), size);
+  }
+  size_t size = ascii;
+  absl::string_view rest = absl::string_view(text).substr(ascii);
+  while (!rest.empty()) {
+    size_t code_units;
+    if (static_cast<uint8_t>(rest.front()) < 0x80) {
+      code_units = internal::Utf8AsciiPrefixLength(rest);
+      size += code_units;
+    } else {
+      char32_t code_point;
+      code_units = internal::Utf8Decode(rest, &code_point);
+      if (ABSL_PREDICT_FALSE(code_point ==
+                                 internal::kUnicodeReplacementCharacter &&
+                             code_units == 1)) {
+        // Thats an invalid UTF-8 encoding.
+        return absl::InvalidArgumentError("cannot parse malformed UTF-8 input");
       }
-      std::vector<uint8_t>().swap(data8);
-      data16.push_back(static_cast<char16_t>(code_point));
-      Traits::Advance(it, code_units);
-      index += code_units;
-      ++offset;
-      goto basic;
-    }
-    data32.reserve(text_size);
-    for (const auto& value : data8) {
-      data32.push_back(value);
-    }
-    std::vector<uint8_t>().swap(data8);
-    data32.push_back(code_point);
-    Traits::Advance(it, code_units);
-    index += code_units;
-    ++offset;
-    goto supplemental;
-  }
-  line_offsets.push_back(offset + 1);
-  return std::make_unique<Latin1Source>(
-      std::move(description), std::move(line_offsets), std::move(data8));
-basic:
-  while (index < text_size) {
-    if (offset >= max_codepoints) {
-      return absl::InvalidArgumentError(absl::StrCat(
-          "expression is larger than codepoint limit ", max_codepoints));
+      ++size;
     }
-    std::tie(code_point, code_units) = internal::Utf8Decode(it);
-    if (ABSL_PREDICT_FALSE(code_point ==
-                               internal::kUnicodeReplacementCharacter &&
-                           code_units == 1)) {
-      // Thats an invalid UTF-8 encoding.
-      return absl::InvalidArgumentError("cannot parse malformed UTF-8 input");
+    if (size > max_codepoints) {
+      return CodepointLimitError(max_codepoints);
     }
-    if (code_point == '\n') {
-      line_offsets.push_back(offset + 1);
-    }
-    if (code_point <= 0xffff) {
-      data16.push_back(static_cast<char16_t>(code_point));
-      Traits::Advance(it, code_units);
-      index += code_units;
-      ++offset;
-      continue;
-    }
-    data32.reserve(text_size);
-    for (const auto& value : data16) {
-      data32.push_back(static_cast<char32_t>(value));
-    }
-    std::vector<char16_t>().swap(data16);
-    data32.push_back(code_point);
-    Traits::Advance(it, code_units);
-    index += code_units;
-    ++offset;
-    goto supplemental;
-  }
-  line_offsets.push_back(offset + 1);
-  return std::make_unique<BasicPlaneSource>(
-      std::move(description), std::move(line_offsets), std::move(data16));
-supplemental:
-  while (index < text_size) {
-    if (offset >= max_codepoints) {
-      return absl::InvalidArgumentError(absl::StrCat(
-          "expression is larger than codepoint limit ", max_codepoints));
-    }
-    std::tie(code_point, code_units) = internal::Utf8Decode(it);
-    if (ABSL_PREDICT_FALSE(code_point ==
-                               internal::kUnicodeReplacementCharacter &&
-                           code_units == 1)) {
-      // Thats an invalid UTF-8 encoding.
-      return absl::InvalidArgumentError("cannot parse malformed UTF-8 input");
-    }
-    if (code_point == '\n') {
-      line_offsets.push_back(offset + 1);
-    }
-    data32.push_back(code_point);
-    Traits::Advance(it, code_units);
-    index += code_units;
-    ++offset;
-  }
-  line_offsets.push_back(offset + 1);
-  return std::make_unique<SupplementalPlaneSource>(
-      std::move(description), std::move(line_offsets), std::move(data32));
+    rest.remove_prefix(code_units);
+  }
+  return std::make_unique<Utf8Source>(std::move(description), std::move(text),
+                                      static_cast<SourcePosition>(size));
 }
 
 }  // namespace
@@ -663,16 +504,16 @@ static size_t ClampLimit(int value) {
 absl::StatusOr<absl_nonnull SourcePtr> NewSource(absl::string_view content,
                                                  std::string description,
                                                  const SourceOptions& options) {
-  return common_internal::NewSourceImpl(std::move(description), content,
-                                        content.size(),
+  return common_internal::NewSourceImpl(std::move(description),
+                                        std::string(content),
                                         ClampLimit(options.max_codepoint_size));
 }
 
 absl::StatusOr<absl_nonnull SourcePtr> NewSource(const absl::Cord& content,
                                                  std::string description,
                                                  const SourceOptions& options) {
-  return common_internal::NewSourceImpl(std::move(description), content,
-                                        content.size(),
+  return common_internal::NewSourceImpl(std::move(description),
+                                        static_cast<std::string>(content),
                                         ClampLimit(options.max_codepoint_size));
 }
 
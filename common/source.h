@@ -15,6 +15,8 @@
 #ifndef THIRD_PARTY_CEL_CPP_COMMON_SOURCE_H_
 #define THIRD_PARTY_CEL_CPP_COMMON_SOURCE_H_
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -32,16 +34,50 @@
 
 namespace cel {
 
-namespace common_internal {
-class SourceImpl;
-}  // namespace common_internal
-
 class Source;
 class SourceSubrange;
 
 // SourcePosition represents an offset in source text.
 using SourcePosition = int32_t;
 
+namespace common_internal {
+
+class SourceImpl;
+class Utf8SourceText;
+
+// A range of the code points of `Utf8SourceText`, which keeps non-ASCII source
+// text as UTF-8 rather than re-encoding it as fixed width code points.
+class Utf8SourceView final {
+ public:
+  constexpr Utf8SourceView() = default;
+
+  constexpr Utf8SourceView(const Utf8SourceText* absl_nonnull text,
+                           size_t begin, size_t size)
+      : text_(text), begin_(begin), size_(size) {}
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  // As `absl::Span::subspan`, in code points.
+  Utf8SourceView subspan(size_t pos, size_t len) const {
+    pos = std::min(pos, size_);
+    return Utf8SourceView(text_, begin_ + pos, std::min(len, size_ - pos));
+  }
+
+  char32_t operator[](size_t position) const;
+
+  // Returns the UTF-8 encoding of the code points [begin, end).
+  absl::string_view Utf8(size_t begin, size_t end) const;
+
+ private:
+  const Utf8SourceText* text_ = nullptr;
+  size_t begin_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace common_internal
+
 // SourceRange represents a range of positions, where `begin` is inclusive and
 // `end` is exclusive.
 struct SourceRange final {
@@ -72,7 +108,8 @@ inline bool operator!=(const SourceLocation& lhs, const SourceLocation& rhs) {
 }
 
 // `SourceContentView` is a view of the content owned by `Source`, which is a
-// sequence of Unicode code points.
+// sequence of Unicode code points. Positions are in code points, while the
+// content itself is kept as UTF-8.
 class SourceContentView final {
  public:
   SourceContentView(const SourceContentView&) = default;
@@ -94,27 +131,24 @@ class SourceContentView final {
 
   void AppendToString(std::string& dest) const;
 
+  // Returns the content encoded as UTF-8, without copying.
+  absl::string_view AsUtf8() const;
+
  private:
   friend class Source;
   friend class SourceSubrange;
+  friend class common_internal::Utf8SourceText;
 
   constexpr SourceContentView() = default;
 
+  // ASCII content, where code points and bytes coincide.
   constexpr explicit SourceContentView(absl::Span<const char> view)
       : view_(view) {}
 
-  constexpr explicit SourceContentView(absl::Span<const uint8_t> view)
-      : view_(view) {}
-
-  constexpr explicit SourceContentView(absl::Span<const char16_t> view)
+  constexpr explicit SourceContentView(common_internal::Utf8SourceView view)
       : view_(view) {}
 
-  constexpr explicit SourceContentView(absl::Span<const char32_t> view)
-      : view_(view) {}
-
-  absl::variant<absl::Span<const char>, absl::Span<const uint8_t>,
-                absl::Span<const char16_t>, absl::Span<const char32_t>>
-      view_;
+  absl::variant<absl::Span<const char>, common_internal::Utf8SourceView> view_;
 };
 
 // `Source` represents the source expression.
@@ -167,17 +201,6 @@ class Source {
   static constexpr ContentView MakeContentView(absl::Span<const char> view) {
     return ContentView(view);
   }
-  static constexpr ContentView MakeContentView(absl::Span<const uint8_t> view) {
-    return ContentView(view);
-  }
-  static constexpr ContentView MakeContentView(
-      absl::Span<const char16_t> view) {
-    return ContentView(view);
-  }
-  static constexpr ContentView MakeContentView(
-      absl::Span<const char32_t> view) {
-    return ContentView(view);
-  }
 
  private:
   friend class common_internal::SourceImpl;
@@ -311,5 +311,50 @@ TEST(CordSource, CodepointLimitExceeded) {
   EXPECT_THAT(source->content().ToString(), ::testing::Eq("12345"));
 }
 
+TEST(StringSource, Utf8Content) {
+  // Mixes ASCII with 2, 3 and 4 byte code points over several index blocks.
+  ASSERT_OK_AND_ASSIGN(
+      auto source,
+      NewSource(
+          "'h\u00e9llo' + 'w\u00f6rld' +\n'\u65e5\u672c' + 'cel \U0001f600'",
+          "utf8-test"));
+  auto content = source->content();
+
+  EXPECT_EQ(content.size(), 34);
+  EXPECT_EQ(content.at(0), '\'');
+  EXPECT_EQ(content.at(2), U'\u00e9');
+  EXPECT_EQ(content.at(12), U'\u00f6');
+  EXPECT_EQ(content.at(19), '\n');
+  EXPECT_EQ(content.at(21), U'\u65e5');
+  EXPECT_EQ(content.at(32), U'\U0001f600');
+  EXPECT_EQ(content.at(33), '\'');
+  EXPECT_EQ(content.ToString(10, 17), "'w\u00f6rld'");
+  EXPECT_EQ(content.ToString(21, 23), "\u65e5\u672c");
+  EXPECT_EQ(
+      content.AsUtf8(),
+      "'h\u00e9llo' + 'w\u00f6rld' +\n'\u65e5\u672c' + 'cel \U0001f600'");
+  EXPECT_THAT(source->line_offsets(), ElementsAre(20, 35));
+  EXPECT_THAT(source->GetLocation(21),
+              Optional(Eq(SourceLocation{int32_t{2}, int32_t{1}})));
+  EXPECT_THAT(source->Snippet(2),
+              Optional(Eq("'\u65e5\u672c' + 'cel \U0001f600'")));
+}
+
+TEST(StringSource, MalformedUtf8) {
+  EXPECT_THAT(
+      NewSource("'\xff'"),
+      ::absl_testing::StatusIs(absl::StatusCode::kInvalidArgument,
+                               ::testing::HasSubstr("malformed UTF-8")));
+}
+
+TEST(SourceSubrange, Utf8Content) {
+  ASSERT_OK_AND_ASSIGN(auto source,
+                       NewSource("h\u00e9llo\nw\u00f6rld", "subrange-test"));
+  SourceSubrange subrange(*source, SourceRange{6, 11});
+  EXPECT_EQ(subrange.content().at(1), U'\u00f6');
+  EXPECT_EQ(subrange.content().ToString(), "w\u00f6rld");
+  EXPECT_EQ(subrange.content().AsUtf8(), "w\u00f6rld");
+}
+
 }  // namespace
 }  // namespace cel
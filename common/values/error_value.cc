@@ -13,19 +13,25 @@
 // limitations under the License.
 
 #include <cstddef>
+#include <cstring>
 #include <new>
 #include <string>
+#include <type_traits>
 #include <utility>
 
+#include "absl/base/call_once.h"
 #include "absl/base/no_destructor.h"
 #include "absl/base/nullability.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/type.h"
 #include "common/value.h"
+#include "runtime/internal/errors.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/io/zero_copy_stream.h"
@@ -48,6 +54,111 @@ const absl::Status& DefaultErrorValue() {
 
 }  // namespace
 
+namespace common_internal {
+
+// The representation of errors allocated on an arena: either a status, or the
+// code and operands of an error whose status is built when first inspected.
+class ErrorValueRep final {
+ public:
+  static const ErrorValueRep* absl_nonnull Create(
+      google::protobuf::Arena* absl_nonnull arena, absl::Status status) {
+    const absl::Status* absl_nonnull arena_status =
+        google::protobuf::Arena::Create<absl::Status>(arena, std::move(status));
+    return google::protobuf::Arena::Create<ErrorValueRep>(
+        arena, ErrorValueCode::kStatus, absl::Span<const absl::string_view>(),
+        arena_status);
+  }
+
+  // Allocates the representation, the operands and their characters as one
+  // block.
+  static const ErrorValueRep* absl_nonnull Create(
+      google::protobuf::Arena* absl_nonnull arena, ErrorValueCode code,
+      absl::Span<const absl::string_view> operands) {
+    size_t header_size =
+        sizeof(ErrorValueRep) + operands.size() * sizeof(absl::string_view);
+    size_t size = header_size;
+    for (absl::string_view operand : operands) {
+      size += operand.size();
+    }
+    char* data = static_cast<char*>(
+        arena->AllocateAligned(size, alignof(ErrorValueRep)));
+    auto* operand_copies =
+        reinterpret_cast<absl::string_view*>(data + sizeof(ErrorValueRep));
+    char* chars = data + header_size;
+    for (size_t i = 0; i < operands.size(); ++i) {
+      if (!operands[i].empty()) {
+        std::memcpy(chars, operands[i].data(), operands[i].size());
+      }
+      ::new (static_cast<void*>(operand_copies + i))
+          absl::string_view(chars, operands[i].size());
+      chars += operands[i].size();
+    }
+    return ::new (static_cast<void*>(data)) ErrorValueRep(
+        code, absl::MakeConstSpan(operand_copies, operands.size()), nullptr);
+  }
+
+  ErrorValueRep(ErrorValueCode code,
+                absl::Span<const absl::string_view> operands,
+                const absl::Status* absl_nullable status)
+      : code_(code), operands_(operands), status_(status) {}
+
+  ErrorValueCode code() const { return code_; }
+
+  absl::Span<const absl::string_view> operands() const { return operands_; }
+
+  const absl::Status& status(
+      google::protobuf::Arena* absl_nonnull arena) const {
+    absl::call_once(once_, [this, arena]() {
+      if (status_ == nullptr) {
+        status_ =
+            google::protobuf::Arena::Create<absl::Status>(arena, BuildStatus());
+      }
+    });
+    return *status_;
+  }
+
+ private:
+  absl::Status BuildStatus() const {
+    switch (code_) {
+      case ErrorValueCode::kNoMatchingOverload:
+        ABSL_DCHECK_GE(operands_.size(), 1);
+        return runtime_internal::CreateNoMatchingOverloadError(
+            absl::StrCat(operands_[0], "(",
+                         absl::StrJoin(operands_.subspan(1), ", "), ")"));
+      case ErrorValueCode::kNoMatchingReceiverOverload:
+        ABSL_DCHECK_GE(operands_.size(), 2);
+        return runtime_internal::CreateNoMatchingOverloadError(absl::StrCat(
+            "(", operands_[0], ").", operands_[1], "(",
+            absl::StrJoin(operands_.subspan(2), ", "), ")"));
+      case ErrorValueCode::kNoSuchVariable:
+        ABSL_DCHECK_EQ(operands_.size(), 1);
+        return runtime_internal::CreateError(absl::StrCat(
+            "No value with name \"", operands_[0], "\" found in Activation"));
+      case ErrorValueCode::kStatus:
+        break;
+    }
+    return absl::InternalError("unexpected error value code");
+  }
+
+  const ErrorValueCode code_;
+  const absl::Span<const absl::string_view> operands_;
+  mutable absl::once_flag once_;
+  mutable const absl::Status* absl_nullable status_;
+};
+
+static_assert(std::is_trivially_destructible_v<ErrorValueRep>);
+
+}  // namespace common_internal
+
+ErrorValue::ErrorValue(google::protobuf::Arena* absl_nonnull arena,
+                       ErrorValueCode code,
+                       absl::Span<const absl::string_view> operands)
+    : ErrorValue(arena, common_internal::ErrorValueRep::Create(
+                            arena, code, operands)) {
+  ABSL_DCHECK(arena != nullptr);
+  ABSL_DCHECK(code != ErrorValueCode::kStatus);
+}
+
 ErrorValue::ErrorValue() : ErrorValue(DefaultErrorValue()) {}
 
 ErrorValue NoSuchFieldError(absl::string_view field) {
@@ -66,7 +177,9 @@ ErrorValue NoSuchTypeError(absl::string_view type) {
 }
 
 ErrorValue DuplicateKeyError() {
-  return ErrorValue(absl::AlreadyExistsError("duplicate key in map"));
+  static const absl::NoDestructor<absl::Status> kDuplicateKeyError(
+      absl::AlreadyExistsError("duplicate key in map"));
+  return ErrorValue(*kDuplicateKeyError);
 }
 
 ErrorValue TypeConversionError(absl::string_view from, absl::string_view to) {
@@ -150,11 +263,30 @@ ErrorValue ErrorValue::Clone(google::protobuf::Arena* absl_nonnull arena) const
   ABSL_DCHECK(arena != nullptr);
   ABSL_DCHECK(*this);
 
-  if (arena_ == nullptr || arena_ != arena) {
-    return ErrorValue(arena,
-                      google::protobuf::Arena::Create<absl::Status>(arena, ToStatus()));
+  if (arena_ == arena) {
+    return *this;
+  }
+  if (ErrorValueCode error_code = code();
+      error_code != ErrorValueCode::kStatus) {
+    return ErrorValue(arena, error_code, status_.rep->operands());
   }
-  return *this;
+  return ErrorValue(arena,
+                    common_internal::ErrorValueRep::Create(arena, ToStatus()));
+}
+
+ErrorValueCode ErrorValue::code() const {
+  ABSL_DCHECK(*this);
+
+  if (arena_ == nullptr) {
+    return ErrorValueCode::kStatus;
+  }
+  return status_.rep->code();
+}
+
+const absl::Status& ErrorValue::ArenaStatus() const {
+  ABSL_DCHECK(arena_ != nullptr);
+
+  return status_.rep->status(arena_);
 }
 
 absl::Status ErrorValue::ToStatus() const& {
@@ -164,7 +296,7 @@ absl::Status ErrorValue::ToStatus() const& {
     return *std::launder(
         reinterpret_cast<const absl::Status*>(&status_.val[0]));
   }
-  return *status_.ptr;
+  return ArenaStatus();
 }
 
 absl::Status ErrorValue::ToStatus() && {
@@ -174,7 +306,7 @@ absl::Status ErrorValue::ToStatus() && {
     return std::move(
         *std::launder(reinterpret_cast<absl::Status*>(&status_.val[0])));
   }
-  return *status_.ptr;
+  return ArenaStatus();
 }
 
 ErrorValue::operator bool() const {
@@ -182,7 +314,10 @@ ErrorValue::operator bool() const {
     return !std::launder(reinterpret_cast<const absl::Status*>(&status_.val[0]))
                 ->ok();
   }
-  return status_.ptr != nullptr && !status_.ptr->ok();
+  // Errors created from operands are never OK, so avoid building their status.
+  return status_.rep != nullptr &&
+         (status_.rep->code() != ErrorValueCode::kStatus ||
+          !ArenaStatus().ok());
 }
 
 void swap(ErrorValue& lhs, ErrorValue& rhs) noexcept {
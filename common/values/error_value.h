@@ -33,6 +33,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/arena.h"
 #include "common/type.h"
 #include "common/value_kind.h"
@@ -46,6 +47,30 @@ namespace cel {
 
 class Value;
 
+namespace common_internal {
+class ErrorValueRep;
+}  // namespace common_internal
+
+// `ErrorValueCode` identifies errors which `ErrorValue` can represent by a few
+// operands, building their message and `absl::Status` only if inspected.
+// Errors which are absorbed by `&&`, `||` or optional handling are then never
+// formatted.
+enum class ErrorValueCode {
+  // The error is represented by its `absl::Status`.
+  kStatus = 0,
+  // `absl::StatusCode::kUnknown`: no overload of the function named by the
+  // first operand accepts arguments of the kinds named by the remaining
+  // operands.
+  kNoMatchingOverload,
+  // As `kNoMatchingOverload`, for a receiver style call. The operands are the
+  // kind of the receiver, which is empty if there is none, the function name
+  // and the kinds of the remaining arguments.
+  kNoMatchingReceiverOverload,
+  // `absl::StatusCode::kUnknown`: the activation has no variable named by the
+  // operand.
+  kNoSuchVariable,
+};
+
 // `ErrorValue` represents values of the `ErrorType`.
 class ABSL_ATTRIBUTE_TRIVIAL_ABI ErrorValue final
     : private common_internal::ValueMixin<ErrorValue> {
@@ -57,6 +82,12 @@ class ABSL_ATTRIBUTE_TRIVIAL_ABI ErrorValue final
     ABSL_DCHECK(*this) << "ErrorValue requires a non-OK absl::Status";
   }
 
+  // Creates an error identified by `code`, which must not be
+  // `ErrorValueCode::kStatus`, and `operands`. The operands are copied to
+  // `arena`, and the message and status are built only when first inspected.
+  ErrorValue(google::protobuf::Arena* absl_nonnull arena, ErrorValueCode code,
+             absl::Span<const absl::string_view> operands);
+
   // By default, this creates an UNKNOWN error. You should always create a more
   // specific error value.
   ErrorValue();
@@ -112,6 +143,10 @@ class ABSL_ATTRIBUTE_TRIVIAL_ABI ErrorValue final
 
   ErrorValue Clone(google::protobuf::Arena* absl_nonnull arena) const;
 
+  // Returns the code of errors created from operands, or
+  // `ErrorValueCode::kStatus` otherwise. Does not build the status.
+  ErrorValueCode code() const;
+
   absl::Status ToStatus() const&;
 
   absl::Status ToStatus() &&;
@@ -131,18 +166,22 @@ class ABSL_ATTRIBUTE_TRIVIAL_ABI ErrorValue final
   friend struct ArenaTraits<ErrorValue>;
 
   ErrorValue(google::protobuf::Arena* absl_nonnull arena,
-             const absl::Status* absl_nonnull status)
+             const common_internal::ErrorValueRep* absl_nonnull rep)
       : arena_(arena) {
-    status_.ptr = status;
+    status_.rep = rep;
   }
 
+  // Returns the status of an error allocated on `arena_`, building it if
+  // necessary.
+  const absl::Status& ArenaStatus() const;
+
   void CopyConstruct(const ErrorValue& other) {
     arena_ = other.arena_;
     if (arena_ == nullptr) {
       ::new (static_cast<void*>(&status_.val[0])) absl::Status(*std::launder(
           reinterpret_cast<const absl::Status*>(&other.status_.val[0])));
     } else {
-      status_.ptr = other.status_.ptr;
+      status_.rep = other.status_.rep;
     }
   }
 
@@ -153,7 +192,7 @@ class ABSL_ATTRIBUTE_TRIVIAL_ABI ErrorValue final
           absl::Status(std::move(*std::launder(
               reinterpret_cast<absl::Status*>(&other.status_.val[0]))));
     } else {
-      status_.ptr = other.status_.ptr;
+      status_.rep = other.status_.rep;
     }
   }
 
@@ -163,10 +202,12 @@ class ABSL_ATTRIBUTE_TRIVIAL_ABI ErrorValue final
     }
   }
 
+  // When `arena_` is null the status is stored inline, otherwise `rep` is
+  // allocated on `arena_`.
   google::protobuf::Arena* absl_nullable arena_;
   union {
     alignas(absl::Status) char val[sizeof(absl::Status)];
-    const absl::Status* absl_nonnull ptr;
+    const common_internal::ErrorValueRep* absl_nonnull rep;
   } status_;
 };
 
@@ -13,12 +13,15 @@
 // limitations under the License.
 
 #include <sstream>
+#include <string>
 
 #include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
 #include "common/native_type.h"
 #include "common/value.h"
 #include "common/value_testing.h"
 #include "internal/testing.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 
 namespace cel {
@@ -26,6 +29,7 @@ namespace {
 
 using ::absl_testing::StatusIs;
 using ::testing::_;
+using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::Not;
 
@@ -80,5 +84,68 @@ TEST_F(ErrorValueTest, NativeTypeId) {
             NativeTypeId::For<ErrorValue>());
 }
 
+TEST_F(ErrorValueTest, NoMatchingOverload) {
+  ErrorValue value(arena(), ErrorValueCode::kNoMatchingOverload,
+                   {"_+_", "int64", "string"});
+  EXPECT_TRUE(value);
+  EXPECT_EQ(value.code(), ErrorValueCode::kNoMatchingOverload);
+  EXPECT_THAT(value.ToStatus(),
+              StatusIs(absl::StatusCode::kUnknown,
+                       "No matching overloads found : _+_(int64, string)"));
+}
+
+TEST_F(ErrorValueTest, NoMatchingReceiverOverload) {
+  EXPECT_THAT(ErrorValue(arena(), ErrorValueCode::kNoMatchingReceiverOverload,
+                         {"string", "contains", "int64"})
+                  .ToStatus(),
+              StatusIs(absl::StatusCode::kUnknown,
+                       "No matching overloads found : "
+                       "(string).contains(int64)"));
+  EXPECT_THAT(ErrorValue(arena(), ErrorValueCode::kNoMatchingReceiverOverload,
+                         {"", "size"})
+                  .ToStatus(),
+              StatusIs(absl::StatusCode::kUnknown,
+                       "No matching overloads found : ().size()"));
+}
+
+TEST_F(ErrorValueTest, NoSuchVariable) {
+  ErrorValue value;
+  {
+    // Operands are copied.
+    std::string name = "request";
+    value = ErrorValue(arena(), ErrorValueCode::kNoSuchVariable, {name});
+  }
+  EXPECT_THAT(Value(value).DebugString(),
+              HasSubstr("No value with name \"request\" found in Activation"));
+  EXPECT_THAT(value.ToStatus(), StatusIs(absl::StatusCode::kUnknown));
+}
+
+TEST_F(ErrorValueTest, Code) {
+  EXPECT_EQ(ErrorValue(absl::CancelledError()).code(),
+            ErrorValueCode::kStatus);
+  EXPECT_EQ(ErrorValue(absl::CancelledError()).Clone(arena()).code(),
+            ErrorValueCode::kStatus);
+}
+
+TEST_F(ErrorValueTest, Clone) {
+  google::protobuf::Arena other_arena;
+  ErrorValue value =
+      ErrorValue(arena(), ErrorValueCode::kNoSuchVariable, {"x"})
+          .Clone(&other_arena);
+  EXPECT_EQ(value.code(), ErrorValueCode::kNoSuchVariable);
+  EXPECT_THAT(value.ToStatus(),
+              StatusIs(absl::StatusCode::kUnknown,
+                       "No value with name \"x\" found in Activation"));
+  EXPECT_THAT(ErrorValue(absl::CancelledError("cancelled"))
+                  .Clone(&other_arena)
+                  .ToStatus(),
+              StatusIs(absl::StatusCode::kCancelled, "cancelled"));
+}
+
+TEST_F(ErrorValueTest, DuplicateKeyError) {
+  EXPECT_THAT(DuplicateKeyError().ToStatus(),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
 }  // namespace
 }  // namespace cel
@@ -24,8 +24,6 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/cord.h"
-#include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include "common/memory.h"
@@ -33,6 +31,7 @@
 #include "common/values/parsed_json_value.h"
 #include "common/values/values.h"
 #include "internal/json.h"
+#include "internal/message_copy.h"
 #include "internal/message_equality.h"
 #include "internal/number.h"
 #include "internal/status_macros.h"
@@ -99,22 +98,7 @@ absl::Status ParsedJsonListValue::ConvertToJson(
     return absl::OkStatus();
   }
 
-  if (value_->GetDescriptor() == message->GetDescriptor()) {
-    // We can directly use google::protobuf::Message::Copy().
-    message->CopyFrom(*value_);
-  } else {
-    // Equivalent descriptors but not identical. Must serialize and deserialize.
-    absl::Cord serialized;
-    if (!value_->SerializePartialToString(&serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to serialize message: ", value_->GetTypeName()));
-    }
-    if (!message->ParsePartialFromString(serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to parsed message: ", message->GetTypeName()));
-    }
-  }
-  return absl::OkStatus();
+  return internal::CopyMessage(*value_, message);
 }
 
 absl::Status ParsedJsonListValue::ConvertToJsonArray(
@@ -132,22 +116,7 @@ absl::Status ParsedJsonListValue::ConvertToJsonArray(
     return absl::OkStatus();
   }
 
-  if (value_->GetDescriptor() == json->GetDescriptor()) {
-    // We can directly use google::protobuf::Message::Copy().
-    json->CopyFrom(*value_);
-  } else {
-    // Equivalent descriptors but not identical. Must serialize and deserialize.
-    absl::Cord serialized;
-    if (!value_->SerializePartialToString(&serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to serialize message: ", value_->GetTypeName()));
-    }
-    if (!json->ParsePartialFromString(serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to parsed message: ", json->GetTypeName()));
-    }
-  }
-  return absl::OkStatus();
+  return internal::CopyMessage(*value_, json);
 }
 
 absl::Status ParsedJsonListValue::Equal(
@@ -25,8 +25,6 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/cord.h"
-#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "common/allocator.h"
 #include "common/memory.h"
@@ -34,6 +32,7 @@
 #include "common/values/parsed_json_value.h"
 #include "common/values/values.h"
 #include "internal/json.h"
+#include "internal/message_copy.h"
 #include "internal/message_equality.h"
 #include "internal/status_macros.h"
 #include "internal/well_known_types.h"
@@ -102,22 +101,7 @@ absl::Status ParsedJsonMapValue::ConvertToJson(
     return absl::OkStatus();
   }
 
-  if (value_->GetDescriptor() == message->GetDescriptor()) {
-    // We can directly use google::protobuf::Message::Copy().
-    message->CopyFrom(*value_);
-  } else {
-    // Equivalent descriptors but not identical. Must serialize and deserialize.
-    absl::Cord serialized;
-    if (!value_->SerializePartialToString(&serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to serialize message: ", value_->GetTypeName()));
-    }
-    if (!message->ParsePartialFromString(serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to parsed message: ", message->GetTypeName()));
-    }
-  }
-  return absl::OkStatus();
+  return internal::CopyMessage(*value_, message);
 }
 
 absl::Status ParsedJsonMapValue::ConvertToJsonObject(
@@ -135,22 +119,7 @@ absl::Status ParsedJsonMapValue::ConvertToJsonObject(
     return absl::OkStatus();
   }
 
-  if (value_->GetDescriptor() == json->GetDescriptor()) {
-    // We can directly use google::protobuf::Message::Copy().
-    json->CopyFrom(*value_);
-  } else {
-    // Equivalent descriptors but not identical. Must serialize and deserialize.
-    absl::Cord serialized;
-    if (!value_->SerializePartialToString(&serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to serialize message: ", value_->GetTypeName()));
-    }
-    if (!json->ParsePartialFromString(serialized)) {
-      return absl::UnknownError(
-          absl::StrCat("failed to parsed message: ", json->GetTypeName()));
-    }
-  }
-  return absl::OkStatus();
+  return internal::CopyMessage(*value_, json);
 }
 
 absl::Status ParsedJsonMapValue::Equal(
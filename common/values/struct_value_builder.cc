@@ -38,6 +38,7 @@
 #include "common/value_kind.h"
 #include "common/values/value_builder.h"
 #include "extensions/protobuf/internal/map_reflection.h"
+#include "internal/message_copy.h"
 #include "internal/status_macros.h"
 #include "internal/well_known_types.h"
 #include "google/protobuf/arena.h"
@@ -63,21 +64,6 @@ absl::StatusOr<const google::protobuf::Descriptor* absl_nonnull> GetDescriptor(
   return desc;
 }
 
-absl::StatusOr<absl::optional<ErrorValue>> ProtoMessageCopyUsingSerialization(
-    google::protobuf::MessageLite* to, const google::protobuf::MessageLite* from) {
-  ABSL_DCHECK_EQ(to->GetTypeName(), from->GetTypeName());
-  absl::Cord serialized;
-  if (!from->SerializePartialToString(&serialized)) {
-    return absl::UnknownError(
-        absl::StrCat("failed to serialize `", from->GetTypeName(), "`"));
-  }
-  if (!to->ParsePartialFromString(serialized)) {
-    return absl::UnknownError(
-        absl::StrCat("failed to parse `", to->GetTypeName(), "`"));
-  }
-  return std::nullopt;
-}
-
 absl::StatusOr<absl::optional<ErrorValue>> ProtoMessageCopy(
     google::protobuf::Message* absl_nonnull to_message,
     const google::protobuf::Descriptor* absl_nonnull to_descriptor,
@@ -91,7 +77,8 @@ absl::StatusOr<absl::optional<ErrorValue>> ProtoMessageCopy(
   }
   if (to_descriptor->full_name() == from_descriptor->full_name()) {
     // Same type, different descriptors.
-    return ProtoMessageCopyUsingSerialization(to_message, from_message);
+    CEL_RETURN_IF_ERROR(internal::CopyMessage(*from_message, to_message));
+    return std::nullopt;
   }
   return TypeConversionError(from_descriptor->full_name(),
                              to_descriptor->full_name());
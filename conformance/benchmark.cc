@@ -0,0 +1,393 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks the cel-spec conformance tests. Each test is parsed, type
+// checked, planned and evaluated as separate benchmarks under a matrix of
+// parser and runtime configurations, which gives a broad performance surface
+// for spotting regressions.
+//
+// Benchmarks are named `<config>/<phase>/<file>/<section>/<test>`, e.g.
+// `recursive/eval/basic/self_eval_zeroish/self_eval_int_zero`, so
+// `--benchmark_filter` can select configurations, phases or tests. Reports
+// for regression tracking are written with the usual benchmark flags, and can
+// be compared across revisions with benchmark's `compare.py`:
+//
+//   bazel run //conformance:benchmark -- --benchmark_out=report.json \
+//       --benchmark_out_format=json --configs=default,recursive
+//
+// Only the phase itself is timed; the preceding phases run once up front.
+// Tests that fail to parse, check or plan under a configuration are not
+// benchmarked for the later phases, and are listed on stderr. Results are not
+// compared against the expected values: that is the job of the conformance
+// tests.
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/variant.h"
+#include "benchmark/benchmark.h"
+#include "checker/type_checker.h"
+#include "checker/type_checker_builder.h"
+#include "checker/type_checker_builder_factory.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/ast_proto.h"
+#include "common/decl.h"
+#include "common/decl_proto.h"
+#include "common/internal/value_conversion.h"
+#include "common/source.h"
+#include "common/value.h"
+#include "conformance/service.h"
+#include "internal/runfiles.h"
+#include "internal/status_macros.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "cel/expr/conformance/test/simple.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/text_format.h"
+
+ABSL_FLAG(std::vector<std::string>, configs, {},
+          "Configurations to benchmark, all if empty. See kConfigs.");
+
+namespace cel_conformance {
+namespace {
+
+using ::cel::expr::conformance::test::SimpleTest;
+using ::cel::expr::conformance::test::SimpleTestFile;
+
+// A parser and runtime configuration. Each one differs from `default` in one
+// dimension, except for `optimized` which enables all optimizations.
+struct BenchmarkConfig {
+  absl::string_view name;
+  bool enable_pratt_parser = true;
+  // Whether to type check expressions, unless a test disables checking.
+  bool checked = true;
+  int max_recursion_depth = 0;
+  bool enable_fast_builtins = true;
+  bool enable_typed_binary_operators = false;
+  bool enable_typed_field_access = false;
+  // Only takes effect for checked expressions.
+  bool select_optimization = false;
+  bool constant_folding = false;
+};
+
+constexpr BenchmarkConfig kConfigs[] = {
+    {.name = "default"},
+    {.name = "antlr", .enable_pratt_parser = false},
+    {.name = "parse_only", .checked = false},
+    // Matches the depth limit of the recursive conformance tests.
+    {.name = "recursive", .max_recursion_depth = 48},
+    {.name = "no_fast_builtins", .enable_fast_builtins = false},
+    {.name = "typed_binary_operators", .enable_typed_binary_operators = true},
+    {.name = "typed_field_access", .enable_typed_field_access = true},
+    {.name = "select_optimization", .select_optimization = true},
+    {.name = "constant_folding", .constant_folding = true},
+    {.name = "optimized",
+     .max_recursion_depth = 48,
+     .enable_typed_binary_operators = true,
+     .enable_typed_field_access = true,
+     .select_optimization = true,
+     .constant_folding = true},
+};
+
+// Everything needed to run the phases of one test under one configuration.
+// Later members are unset if an earlier phase failed.
+struct PreparedTest {
+  std::string name;
+  SimpleTest test;
+  std::unique_ptr<cel::Source> source;
+  std::unique_ptr<cel::Ast> parsed_ast;
+  std::unique_ptr<cel::TypeChecker> checker;
+  std::unique_ptr<cel::Ast> ast;
+  const cel::Runtime* runtime = nullptr;
+  std::unique_ptr<cel::Program> program;
+  // Owns the values bound in `activation`.
+  google::protobuf::Arena arena;
+  cel::Activation activation;
+};
+
+// Prepares and registers the benchmarks of a configuration.
+class ConfigBenchmarks {
+ public:
+  explicit ConfigBenchmarks(const BenchmarkConfig& config) : config_(config) {}
+
+  absl::Status Init() {
+    parser_options_.enable_optional_syntax = true;
+    parser_options_.enable_quoted_identifiers = true;
+    parser_options_.enable_pratt_parser = config_.enable_pratt_parser;
+    return RegisterConformanceMacros(macros_, parser_options_);
+  }
+
+  void RegisterFile(const SimpleTestFile& file) {
+    for (const auto& section : file.section()) {
+      for (const auto& test : section.test()) {
+        auto prepared = std::make_unique<PreparedTest>();
+        prepared->name =
+            absl::StrCat(file.name(), "/", section.name(), "/", test.name());
+        prepared->test = test;
+        absl::Status status = Prepare(*prepared);
+        if (!status.ok()) {
+          ABSL_LOG(WARNING) << config_.name << "/" << prepared->name << ": "
+                            << status;
+        }
+        Register(*prepared);
+        tests_.push_back(std::move(prepared));
+      }
+    }
+  }
+
+ private:
+  absl::Status Prepare(PreparedTest& prepared) {
+    const SimpleTest& test = prepared.test;
+    CEL_ASSIGN_OR_RETURN(prepared.source,
+                         cel::NewSource(test.expr(), prepared.name));
+    CEL_ASSIGN_OR_RETURN(cel::expr::ParsedExpr parsed_expr,
+                         google::api::expr::parser::Parse(
+                             *prepared.source, Macros(test), parser_options_));
+    CEL_ASSIGN_OR_RETURN(prepared.parsed_ast,
+                         cel::CreateAstFromParsedExpr(parsed_expr));
+
+    if (config_.checked && !test.disable_check()) {
+      CEL_ASSIGN_OR_RETURN(prepared.checker, NewChecker(test));
+      CEL_ASSIGN_OR_RETURN(cel::ValidationResult result,
+                           prepared.checker->Check(*prepared.parsed_ast));
+      if (!result.IsValid()) {
+        return absl::InvalidArgumentError(result.FormatError());
+      }
+      CEL_ASSIGN_OR_RETURN(prepared.ast, result.ReleaseAst());
+    } else {
+      prepared.ast = std::make_unique<cel::Ast>(*prepared.parsed_ast);
+    }
+    if (test.check_only()) {
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(prepared.runtime, GetRuntime(test.container()));
+    CEL_ASSIGN_OR_RETURN(
+        prepared.program,
+        prepared.runtime->CreateProgram(std::make_unique<cel::Ast>(
+            *prepared.ast)));
+
+    for (const auto& [name, binding] : test.bindings()) {
+      CEL_ASSIGN_OR_RETURN(
+          cel::Value value,
+          cel::test::FromExprValue(binding.value(),
+                                   prepared.runtime->GetDescriptorPool(),
+                                   prepared.runtime->GetMessageFactory(),
+                                   &prepared.arena));
+      prepared.activation.InsertOrAssignValue(name, std::move(value));
+    }
+    return absl::OkStatus();
+  }
+
+  void Register(const PreparedTest& prepared) {
+    const PreparedTest* test = &prepared;
+    if (test->parsed_ast == nullptr) {
+      return;
+    }
+    std::string suffix = absl::StrCat("/", test->name);
+    const cel::MacroRegistry* macros = &Macros(test->test);
+    const cel::ParserOptions* parser_options = &parser_options_;
+    benchmark::RegisterBenchmark(
+        absl::StrCat(config_.name, "/parse", suffix).c_str(),
+        [test, macros, parser_options](benchmark::State& state) {
+          for (auto _ : state) {
+            auto parsed_expr = google::api::expr::parser::Parse(
+                *test->source, *macros, *parser_options);
+            benchmark::DoNotOptimize(parsed_expr);
+          }
+        });
+    if (test->checker != nullptr) {
+      benchmark::RegisterBenchmark(
+          absl::StrCat(config_.name, "/check", suffix).c_str(),
+          [test](benchmark::State& state) {
+            for (auto _ : state) {
+              auto result = test->checker->Check(*test->parsed_ast);
+              benchmark::DoNotOptimize(result);
+            }
+          });
+    }
+    if (test->program == nullptr) {
+      return;
+    }
+    // Planning consumes the AST, so the timing includes copying it.
+    benchmark::RegisterBenchmark(
+        absl::StrCat(config_.name, "/plan", suffix).c_str(),
+        [test](benchmark::State& state) {
+          for (auto _ : state) {
+            auto program = test->runtime->CreateProgram(
+                std::make_unique<cel::Ast>(*test->ast));
+            benchmark::DoNotOptimize(program);
+          }
+        });
+    benchmark::RegisterBenchmark(
+        absl::StrCat(config_.name, "/eval", suffix).c_str(),
+        [test](benchmark::State& state) {
+          for (auto _ : state) {
+            google::protobuf::Arena arena;
+            auto result = test->program->Evaluate(&arena, test->activation);
+            benchmark::DoNotOptimize(result);
+          }
+        });
+  }
+
+  const cel::MacroRegistry& Macros(const SimpleTest& test) const {
+    return test.disable_macros() ? no_macros_ : macros_;
+  }
+
+  absl::StatusOr<std::unique_ptr<cel::TypeChecker>> NewChecker(
+      const SimpleTest& test) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<cel::TypeCheckerBuilder> builder,
+                         cel::CreateTypeCheckerBuilder(
+                             google::protobuf::DescriptorPool::generated_pool()));
+    CEL_RETURN_IF_ERROR(AddConformanceCheckerLibraries(*builder));
+    google::protobuf::Arena arena;
+    for (const auto& decl : test.type_env()) {
+      CEL_ASSIGN_OR_RETURN(
+          auto converted,
+          cel::DeclFromProto(decl, google::protobuf::DescriptorPool::generated_pool(),
+                             &arena));
+      if (auto* variable = absl::get_if<cel::VariableDecl>(&converted);
+          variable != nullptr) {
+        CEL_RETURN_IF_ERROR(builder->AddVariable(std::move(*variable)));
+      } else {
+        CEL_RETURN_IF_ERROR(builder->AddFunction(
+            std::move(absl::get<cel::FunctionDecl>(converted))));
+      }
+    }
+    builder->set_container(test.container());
+    return std::move(*builder).Build();
+  }
+
+  // Runtimes are shared by the tests of a container.
+  absl::StatusOr<const cel::Runtime*> GetRuntime(absl::string_view container) {
+    if (auto it = runtimes_.find(container); it != runtimes_.end()) {
+      return it->second.get();
+    }
+    cel::RuntimeOptions options;
+    options.container = std::string(container);
+    options.enable_qualified_type_identifiers = true;
+    options.enable_timestamp_duration_overflow_errors = true;
+    options.enable_heterogeneous_equality = true;
+    options.enable_empty_wrapper_null_unboxing = true;
+    // Conformance tests expect planning warnings to fail at evaluation time.
+    options.fail_on_warnings = false;
+    options.max_recursion_depth = config_.max_recursion_depth;
+    options.enable_fast_builtins = config_.enable_fast_builtins;
+    options.enable_typed_binary_operators =
+        config_.enable_typed_binary_operators;
+    options.enable_typed_field_access = config_.enable_typed_field_access;
+    CEL_ASSIGN_OR_RETURN(
+        std::unique_ptr<const cel::Runtime> runtime,
+        NewConformanceRuntime(options, config_.constant_folding,
+                              config_.select_optimization));
+    const cel::Runtime* result = runtime.get();
+    runtimes_[std::string(container)] = std::move(runtime);
+    return result;
+  }
+
+  const BenchmarkConfig& config_;
+  cel::ParserOptions parser_options_;
+  cel::MacroRegistry macros_;
+  cel::MacroRegistry no_macros_;
+  absl::flat_hash_map<std::string, std::unique_ptr<const cel::Runtime>>
+      runtimes_;
+  std::vector<std::unique_ptr<PreparedTest>> tests_;
+};
+
+absl::StatusOr<SimpleTestFile> ReadTestFile(absl::string_view path) {
+  SimpleTestFile file;
+  std::ifstream in;
+  in.open(std::string(path), std::ios_base::in | std::ios_base::binary);
+  if (!in.is_open()) {
+    return absl::UnknownError(absl::StrCat("failed to open file: ", path));
+  }
+  google::protobuf::io::IstreamInputStream stream(&in);
+  if (!google::protobuf::TextFormat::Parse(&stream, &file)) {
+    return absl::UnknownError(absl::StrCat("failed to parse file: ", path));
+  }
+  return file;
+}
+
+bool ShouldRunConfig(absl::string_view name) {
+  std::vector<std::string> configs = absl::GetFlag(FLAGS_configs);
+  if (configs.empty()) {
+    return true;
+  }
+  for (absl::string_view config : configs) {
+    if (config == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+}  // namespace cel_conformance
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  std::vector<char*> paths = absl::ParseCommandLine(argc, argv);
+  cel_conformance::LinkConformanceTestMessages();
+
+  std::vector<cel_conformance::SimpleTestFile> files;
+  for (size_t i = 1; i < paths.size(); ++i) {
+    auto file = cel_conformance::ReadTestFile(
+        cel::internal::ResolveRunfilesPath(paths[i]));
+    ABSL_CHECK_OK(file.status());
+    files.push_back(*std::move(file));
+  }
+
+  std::vector<std::unique_ptr<cel_conformance::ConfigBenchmarks>> configs;
+  for (const cel_conformance::BenchmarkConfig& config :
+       cel_conformance::kConfigs) {
+    if (!cel_conformance::ShouldRunConfig(config.name)) {
+      continue;
+    }
+    auto benchmarks =
+        std::make_unique<cel_conformance::ConfigBenchmarks>(config);
+    ABSL_CHECK_OK(benchmarks->Init());
+    for (const auto& file : files) {
+      benchmarks->RegisterFile(file);
+    }
+    configs.push_back(std::move(benchmarks));
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "conformance/codegen_compile.h"
+
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/variant.h"
+#include "checker/type_checker.h"
+#include "checker/type_checker_builder.h"
+#include "checker/type_checker_builder_factory.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/ast_proto.h"
+#include "common/decl.h"
+#include "common/decl_proto.h"
+#include "common/source.h"
+#include "conformance/service.h"
+#include "internal/status_macros.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+#include "parser/parser.h"
+#include "cel/expr/conformance/test/simple.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/text_format.h"
+
+namespace cel_conformance {
+
+using ::cel::expr::conformance::test::SimpleTest;
+using ::cel::expr::conformance::test::SimpleTestFile;
+using ::cel::expr::conformance::test::SimpleTestSection;
+
+absl::StatusOr<SimpleTestFile> ReadSimpleTestFile(absl::string_view path) {
+  SimpleTestFile file;
+  std::ifstream in;
+  in.open(std::string(path), std::ios_base::in | std::ios_base::binary);
+  if (!in.is_open()) {
+    return absl::UnknownError(absl::StrCat("failed to open file: ", path));
+  }
+  google::protobuf::io::IstreamInputStream stream(&in);
+  if (!google::protobuf::TextFormat::Parse(&stream, &file)) {
+    return absl::UnknownError(absl::StrCat("failed to parse file: ", path));
+  }
+  return file;
+}
+
+std::string CodegenTestName(const SimpleTestFile& file,
+                            const SimpleTestSection& section,
+                            const SimpleTest& test) {
+  return absl::StrCat(file.name(), "/", section.name(), "/", test.name());
+}
+
+absl::StatusOr<std::unique_ptr<cel::Ast>> CompileCodegenTest(
+    const SimpleTest& test) {
+  if (test.disable_check() || test.check_only()) {
+    return absl::FailedPreconditionError("not evaluated from a checked AST");
+  }
+  cel::ParserOptions parser_options;
+  parser_options.enable_optional_syntax = true;
+  parser_options.enable_quoted_identifiers = true;
+  cel::MacroRegistry macros;
+  if (!test.disable_macros()) {
+    CEL_RETURN_IF_ERROR(RegisterConformanceMacros(macros, parser_options));
+  }
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<cel::Source> source,
+                       cel::NewSource(test.expr(), test.name()));
+  CEL_ASSIGN_OR_RETURN(
+      cel::expr::ParsedExpr parsed_expr,
+      google::api::expr::parser::Parse(*source, macros, parser_options));
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<cel::Ast> parsed_ast,
+                       cel::CreateAstFromParsedExpr(parsed_expr));
+
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<cel::TypeCheckerBuilder> builder,
+                       cel::CreateTypeCheckerBuilder(
+                           google::protobuf::DescriptorPool::generated_pool()));
+  CEL_RETURN_IF_ERROR(AddConformanceCheckerLibraries(*builder));
+  google::protobuf::Arena arena;
+  for (const auto& decl : test.type_env()) {
+    CEL_ASSIGN_OR_RETURN(
+        auto converted,
+        cel::DeclFromProto(decl, google::protobuf::DescriptorPool::generated_pool(),
+                           &arena));
+    if (auto* variable = absl::get_if<cel::VariableDecl>(&converted);
+        variable != nullptr) {
+      CEL_RETURN_IF_ERROR(builder->AddVariable(std::move(*variable)));
+    } else {
+      CEL_RETURN_IF_ERROR(builder->AddFunction(
+          std::move(absl::get<cel::FunctionDecl>(converted))));
+    }
+  }
+  builder->set_container(test.container());
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<cel::TypeChecker> checker,
+                       std::move(*builder).Build());
+  CEL_ASSIGN_OR_RETURN(cel::ValidationResult result,
+                       checker->Check(*parsed_ast));
+  if (!result.IsValid()) {
+    return absl::InvalidArgumentError(result.FormatError());
+  }
+  return result.ReleaseAst();
+}
+
+}  // namespace cel_conformance
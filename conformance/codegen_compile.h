@@ -0,0 +1,50 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compiles conformance tests for the generated program corpus
+// (conformance/codegen_corpus.h), in the generator and in the differential
+// test that checks it against the interpreter.
+
+#ifndef THIRD_PARTY_CEL_CPP_CONFORMANCE_CODEGEN_COMPILE_H_
+#define THIRD_PARTY_CEL_CPP_CONFORMANCE_CODEGEN_COMPILE_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "cel/expr/conformance/test/simple.pb.h"
+
+namespace cel_conformance {
+
+// Reads a text format `SimpleTestFile`.
+absl::StatusOr<cel::expr::conformance::test::SimpleTestFile>
+ReadSimpleTestFile(absl::string_view path);
+
+// Returns the name of a test in the corpus, `<file>/<section>/<test>`.
+std::string CodegenTestName(
+    const cel::expr::conformance::test::SimpleTestFile& file,
+    const cel::expr::conformance::test::SimpleTestSection& section,
+    const cel::expr::conformance::test::SimpleTest& test);
+
+// Parses and type checks the expression of `test` in the conformance
+// environment. Returns an error for tests that are not evaluated from a
+// checked expression.
+absl::StatusOr<std::unique_ptr<cel::Ast>> CompileCodegenTest(
+    const cel::expr::conformance::test::SimpleTest& test);
+
+}  // namespace cel_conformance
+
+#endif  // THIRD_PARTY_CEL_CPP_CONFORMANCE_CODEGEN_COMPILE_H_
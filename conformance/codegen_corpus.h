@@ -0,0 +1,43 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Programs generated ahead of time from the checked conformance tests, see
+// conformance/codegen_corpus_gen.cc.
+
+#ifndef THIRD_PARTY_CEL_CPP_CONFORMANCE_CODEGEN_CORPUS_H_
+#define THIRD_PARTY_CEL_CPP_CONFORMANCE_CODEGEN_CORPUS_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "runtime/runtime.h"
+
+namespace cel_conformance {
+
+struct CodegenCorpusEntry {
+  // See `CodegenTestName`.
+  absl::string_view name;
+  absl::StatusOr<std::unique_ptr<cel::Program>> (*create_program)(
+      const cel::Runtime& runtime);
+};
+
+// Returns the tests a program was generated for, in the order of the test
+// files.
+absl::Span<const CodegenCorpusEntry> CodegenCorpus();
+
+}  // namespace cel_conformance
+
+#endif  // THIRD_PARTY_CEL_CPP_CONFORMANCE_CODEGEN_CORPUS_H_
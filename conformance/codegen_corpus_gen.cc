@@ -0,0 +1,147 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generates a program for each checked conformance test in the given test
+// files, and the table of conformance/codegen_corpus.h. Tests that do not
+// check, or use constructs generated programs do not support, are listed on
+// stderr and left out.
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/initialize.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "conformance/codegen_compile.h"
+#include "conformance/service.h"
+#include "tools/cc_expression_codegen.h"
+
+ABSL_FLAG(std::string, header_include, "",
+          "Path used to include the generated programs header.");
+ABSL_FLAG(std::string, out_header, "", "");
+ABSL_FLAG(std::string, out_source, "", "");
+ABSL_FLAG(std::string, out_table, "", "");
+
+namespace {
+
+void WriteFile(const std::string& path, absl::string_view data) {
+  ABSL_CHECK(!path.empty());
+  std::ofstream file(path);
+  ABSL_CHECK(file.is_open()) << path;
+  file.write(data.data(), data.size());
+  file.flush();
+  ABSL_CHECK(file.good());
+}
+
+struct CorpusTest {
+  std::string name;
+  std::string function;
+  std::unique_ptr<cel::Ast> ast;
+  std::string expr;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<char*> paths = absl::ParseCommandLine(argc, argv);
+  absl::InitializeLog();
+  cel_conformance::LinkConformanceTestMessages();
+
+  std::vector<CorpusTest> tests;
+  for (size_t i = 1; i < paths.size(); ++i) {
+    auto file = cel_conformance::ReadSimpleTestFile(paths[i]);
+    ABSL_CHECK_OK(file.status());
+    for (const auto& section : file->section()) {
+      for (const auto& test : section.test()) {
+        CorpusTest corpus_test;
+        corpus_test.name =
+            cel_conformance::CodegenTestName(*file, section, test);
+        corpus_test.function =
+            absl::StrCat("cel_conformance::codegen::Test", tests.size());
+        corpus_test.expr = test.expr();
+        absl::StatusOr<std::unique_ptr<cel::Ast>> ast =
+            cel_conformance::CompileCodegenTest(test);
+        if (!ast.ok()) {
+          std::cerr << corpus_test.name << ": " << ast.status() << std::endl;
+          continue;
+        }
+        corpus_test.ast = *std::move(ast);
+        // Leave out tests using unsupported constructs.
+        absl::StatusOr<cel::CcExpressionSources> sources =
+            cel::GenerateCcExpressions(
+                {cel::CcExpression{corpus_test.function,
+                                   corpus_test.ast.get(), ""}},
+                "");
+        if (!sources.ok()) {
+          ABSL_CHECK(absl::IsUnimplemented(sources.status()))
+              << corpus_test.name << ": " << sources.status();
+          std::cerr << corpus_test.name << ": " << sources.status()
+                    << std::endl;
+          continue;
+        }
+        tests.push_back(std::move(corpus_test));
+      }
+    }
+  }
+
+  std::vector<cel::CcExpression> expressions;
+  expressions.reserve(tests.size());
+  for (const CorpusTest& test : tests) {
+    expressions.push_back(
+        cel::CcExpression{test.function, test.ast.get(), test.expr});
+  }
+  const std::string header_include = absl::GetFlag(FLAGS_header_include);
+  auto sources = cel::GenerateCcExpressions(expressions, header_include);
+  ABSL_CHECK_OK(sources.status());
+
+  std::string table = absl::StrCat(
+      "// Generated by codegen_corpus_gen. DO NOT EDIT.\n\n",
+      "#include \"conformance/codegen_corpus.h\"\n\n", "#include \"",
+      header_include, "\"\n", "#include \"absl/types/span.h\"\n\n",
+      "namespace cel_conformance {\n");
+  if (tests.empty()) {
+    absl::StrAppend(&table,
+                    "\nabsl::Span<const CodegenCorpusEntry> CodegenCorpus() {\n",
+                    "  return {};\n", "}\n");
+  } else {
+    absl::StrAppend(&table, "namespace {\n\n",
+                    "constexpr CodegenCorpusEntry kCorpus[] = {\n");
+    for (const CorpusTest& test : tests) {
+      absl::StrAppend(&table, "    {\"", absl::CHexEscape(test.name), "\", &",
+                      test.function, "},\n");
+    }
+    absl::StrAppend(&table, "};\n\n", "}  // namespace\n\n",
+                    "absl::Span<const CodegenCorpusEntry> CodegenCorpus() {\n",
+                    "  return kCorpus;\n", "}\n");
+  }
+  absl::StrAppend(&table, "\n}  // namespace cel_conformance\n");
+
+  WriteFile(absl::GetFlag(FLAGS_out_header), sources->header);
+  WriteFile(absl::GetFlag(FLAGS_out_source), sources->source);
+  WriteFile(absl::GetFlag(FLAGS_out_table), table);
+  return EXIT_SUCCESS;
+}
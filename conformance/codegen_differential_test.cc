@@ -0,0 +1,170 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Evaluates each program of the generated conformance corpus, see
+// codegen_corpus.h, against the interpreter planning the same checked
+// expression, and expects identical results. The test files the corpus was
+// generated from are passed as arguments, for the expressions and bindings.
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/internal/value_conversion.h"
+#include "common/value.h"
+#include "conformance/codegen_compile.h"
+#include "conformance/codegen_corpus.h"
+#include "conformance/service.h"
+#include "internal/runfiles.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "cel/expr/conformance/test/simple.pb.h"
+#include "google/protobuf/arena.h"
+
+namespace cel_conformance {
+namespace {
+
+using ::cel::expr::conformance::test::SimpleTest;
+
+// Runtime configurations the generated programs are compared under. Generated
+// programs do not replicate the planner's fast paths, so these also check
+// that the fast paths do not change results.
+struct DifferentialConfig {
+  absl::string_view name;
+  bool enable_fast_builtins = true;
+};
+
+constexpr DifferentialConfig kConfigs[] = {
+    {.name = "default"},
+    {.name = "no_fast_builtins", .enable_fast_builtins = false},
+};
+
+absl::StatusOr<std::unique_ptr<const cel::Runtime>> NewRuntime(
+    const DifferentialConfig& config, const SimpleTest& test) {
+  cel::RuntimeOptions options;
+  options.container = test.container();
+  options.enable_qualified_type_identifiers = true;
+  options.enable_timestamp_duration_overflow_errors = true;
+  options.enable_heterogeneous_equality = true;
+  options.enable_empty_wrapper_null_unboxing = true;
+  // Conformance tests expect planning warnings to fail at evaluation time.
+  options.fail_on_warnings = false;
+  options.enable_fast_builtins = config.enable_fast_builtins;
+  return NewConformanceRuntime(options, /*constant_folding=*/false,
+                               /*select_optimization=*/false);
+}
+
+class CodegenDifferentialTest : public testing::Test {
+ public:
+  CodegenDifferentialTest(const DifferentialConfig& config,
+                          const CodegenCorpusEntry& entry,
+                          const SimpleTest& test)
+      : config_(config), entry_(entry), test_(test) {}
+
+  void TestBody() override {
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Ast> ast,
+                         CompileCodegenTest(test_));
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<const cel::Runtime> runtime,
+                         NewRuntime(config_, test_));
+
+    absl::StatusOr<std::unique_ptr<cel::Program>> interpreted =
+        runtime->CreateProgram(std::move(ast));
+    absl::StatusOr<std::unique_ptr<cel::Program>> generated =
+        entry_.create_program(*runtime);
+    if (!generated.ok()) {
+      // Generated programs report the same unresolved functions and
+      // disabled features as planning does.
+      EXPECT_FALSE(interpreted.ok()) << generated.status();
+      return;
+    }
+    ASSERT_OK(interpreted.status());
+
+    google::protobuf::Arena arena;
+    cel::Activation activation;
+    for (const auto& [name, binding] : test_.bindings()) {
+      ASSERT_OK_AND_ASSIGN(
+          cel::Value value,
+          cel::test::FromExprValue(binding.value(),
+                                   runtime->GetDescriptorPool(),
+                                   runtime->GetMessageFactory(), &arena));
+      activation.InsertOrAssignValue(name, std::move(value));
+    }
+
+    absl::StatusOr<cel::Value> expected =
+        (*interpreted)->Evaluate(&arena, activation);
+    absl::StatusOr<cel::Value> actual =
+        (*generated)->Evaluate(&arena, activation);
+    ASSERT_EQ(actual.status(), expected.status());
+    if (expected.ok()) {
+      EXPECT_EQ(actual->DebugString(), expected->DebugString());
+    }
+  }
+
+ private:
+  const DifferentialConfig& config_;
+  const CodegenCorpusEntry& entry_;
+  const SimpleTest test_;
+};
+
+TEST(CodegenCorpusTest, NotEmpty) { EXPECT_FALSE(CodegenCorpus().empty()); }
+
+}  // namespace
+}  // namespace cel_conformance
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  cel_conformance::LinkConformanceTestMessages();
+
+  absl::flat_hash_map<std::string, cel::expr::conformance::test::SimpleTest>
+      tests;
+  for (int argi = 1; argi < argc; argi++) {
+    auto file = cel_conformance::ReadSimpleTestFile(
+        cel::internal::ResolveRunfilesPath(argv[argi]));
+    ABSL_CHECK_OK(file.status());
+    for (const auto& section : file->section()) {
+      for (const auto& test : section.test()) {
+        tests[cel_conformance::CodegenTestName(*file, section, test)] = test;
+      }
+    }
+  }
+
+  for (const cel_conformance::DifferentialConfig& config :
+       cel_conformance::kConfigs) {
+    for (const cel_conformance::CodegenCorpusEntry& entry :
+         cel_conformance::CodegenCorpus()) {
+      auto it = tests.find(entry.name);
+      ABSL_CHECK(it != tests.end()) << "missing test file for " << entry.name;
+      const cel::expr::conformance::test::SimpleTest& test = it->second;
+      testing::RegisterTest(
+          "CodegenDifferentialTest",
+          absl::StrCat(config.name, "/", entry.name).c_str(), nullptr,
+          nullptr, __FILE__, __LINE__,
+          [&config, &entry, test]() -> testing::Test* {
+            return new cel_conformance::CodegenDifferentialTest(config, entry,
+                                                                test);
+          });
+    }
+  }
+  return RUN_ALL_TESTS();
+}
@@ -141,13 +141,8 @@ absl::Status LegacyParse(const conformance::v1alpha1::ParseRequest& request,
   options.enable_variadic_logical_operators = enable_variadic_logical_operators;
   options.enable_pratt_parser = enable_pratt_parser;
   cel::MacroRegistry macros;
-  CEL_RETURN_IF_ERROR(cel::RegisterStandardMacros(macros, options));
   CEL_RETURN_IF_ERROR(
-      cel::extensions::RegisterComprehensionsV2Macros(macros, options));
-  CEL_RETURN_IF_ERROR(cel::extensions::RegisterBindingsMacros(macros, options));
-  CEL_RETURN_IF_ERROR(cel::extensions::RegisterMathMacros(macros, options));
-  CEL_RETURN_IF_ERROR(cel::extensions::RegisterProtoMacros(macros, options));
-  CEL_RETURN_IF_ERROR(cel::test::RegisterTestMacros(macros));
+      cel_conformance::RegisterConformanceMacros(macros, options));
   CEL_ASSIGN_OR_RETURN(auto source, cel::NewSource(request.cel_source(),
                                                    request.source_location()));
   CEL_ASSIGN_OR_RETURN(auto parsed_expr,
@@ -180,18 +175,8 @@ absl::Status CheckImpl(google::protobuf::Arena* arena,
       cel::CreateTypeCheckerBuilder(google::protobuf::DescriptorPool::generated_pool()));
 
   if (!request.no_std_env()) {
-    CEL_RETURN_IF_ERROR(builder->AddLibrary(cel::StandardCheckerLibrary()));
-    CEL_RETURN_IF_ERROR(builder->AddLibrary(cel::OptionalCheckerLibrary()));
-    CEL_RETURN_IF_ERROR(
-        builder->AddLibrary(cel::extensions::BindingsCheckerLibrary()));
     CEL_RETURN_IF_ERROR(
-        builder->AddLibrary(cel::extensions::StringsCheckerLibrary()));
-    CEL_RETURN_IF_ERROR(
-        builder->AddLibrary(cel::extensions::MathCheckerLibrary()));
-    CEL_RETURN_IF_ERROR(
-        builder->AddLibrary(cel::extensions::EncodersCheckerLibrary()));
-    CEL_RETURN_IF_ERROR(
-        builder->AddLibrary(cel::extensions::ComprehensionsV2CheckerLibrary()));
+        cel_conformance::AddConformanceCheckerLibraries(*builder));
   }
 
   for (const auto& decl : request.type_env()) {
@@ -245,34 +230,7 @@ class LegacyConformanceServiceImpl : public ConformanceServiceInterface {
       bool enable_variadic_logical_operators, bool enable_pratt_parser) {
     static auto* constant_arena = new Arena();
 
-    google::protobuf::LinkMessageReflection<
-        cel::expr::conformance::proto3::TestAllTypes>();
-    google::protobuf::LinkMessageReflection<
-        cel::expr::conformance::proto2::TestAllTypes>();
-    google::protobuf::LinkMessageReflection<
-        cel::expr::conformance::proto3::NestedTestAllTypes>();
-    google::protobuf::LinkMessageReflection<
-        cel::expr::conformance::proto2::NestedTestAllTypes>();
-    google::protobuf::LinkExtensionReflection(cel::expr::conformance::proto2::int32_ext);
-    google::protobuf::LinkExtensionReflection(cel::expr::conformance::proto2::nested_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::test_all_types_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::nested_enum_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::repeated_test_all_types);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
-            int64_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
-            message_scoped_nested_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
-            nested_enum_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
-            message_scoped_repeated_test_all_types);
+    cel_conformance::LinkConformanceTestMessages();
 
     InterpreterOptions options;
     options.enable_qualified_type_identifiers = true;
@@ -444,34 +402,7 @@ class ModernConformanceServiceImpl : public ConformanceServiceInterface {
   static absl::StatusOr<std::unique_ptr<ModernConformanceServiceImpl>> Create(
       bool optimize, bool recursive, bool select_optimization,
       bool enable_variadic_logical_operators, bool enable_pratt_parser) {
-    google::protobuf::LinkMessageReflection<
-        cel::expr::conformance::proto3::TestAllTypes>();
-    google::protobuf::LinkMessageReflection<
-        cel::expr::conformance::proto2::TestAllTypes>();
-    google::protobuf::LinkMessageReflection<
-        cel::expr::conformance::proto3::NestedTestAllTypes>();
-    google::protobuf::LinkMessageReflection<
-        cel::expr::conformance::proto2::NestedTestAllTypes>();
-    google::protobuf::LinkExtensionReflection(cel::expr::conformance::proto2::int32_ext);
-    google::protobuf::LinkExtensionReflection(cel::expr::conformance::proto2::nested_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::test_all_types_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::nested_enum_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::repeated_test_all_types);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
-            int64_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
-            message_scoped_nested_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
-            nested_enum_ext);
-    google::protobuf::LinkExtensionReflection(
-        cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
-            message_scoped_repeated_test_all_types);
+    cel_conformance::LinkConformanceTestMessages();
 
     RuntimeOptions options;
     options.enable_qualified_type_identifiers = true;
@@ -497,47 +428,8 @@ class ModernConformanceServiceImpl : public ConformanceServiceInterface {
     if (enable_optimizations_) {
       options.enable_typed_field_access = true;
     }
-    CEL_ASSIGN_OR_RETURN(
-        auto builder, CreateStandardRuntimeBuilder(
-                          google::protobuf::DescriptorPool::generated_pool(), options));
-
-    if (enable_optimizations_) {
-      CEL_RETURN_IF_ERROR(cel::extensions::EnableConstantFolding(
-          builder, google::protobuf::MessageFactory::generated_factory()));
-      CEL_RETURN_IF_ERROR(cel::extensions::EnableRegexPrecompilation(builder));
-    }
-    CEL_RETURN_IF_ERROR(cel::EnableReferenceResolver(
-        builder, cel::ReferenceResolverEnabled::kAlways));
-    if (enable_select_optimization_) {
-      CEL_RETURN_IF_ERROR(cel::extensions::EnableSelectOptimization(builder));
-    }
-
-    auto& type_registry = builder.type_registry();
-    // Use linked pbs in the generated descriptor pool.
-    CEL_RETURN_IF_ERROR(RegisterProtobufEnum(
-        type_registry,
-        cel::expr::conformance::proto2::GlobalEnum_descriptor()));
-    CEL_RETURN_IF_ERROR(RegisterProtobufEnum(
-        type_registry,
-        cel::expr::conformance::proto3::GlobalEnum_descriptor()));
-    CEL_RETURN_IF_ERROR(RegisterProtobufEnum(
-        type_registry,
-        cel::expr::conformance::proto2::TestAllTypes::NestedEnum_descriptor()));
-    CEL_RETURN_IF_ERROR(RegisterProtobufEnum(
-        type_registry,
-        cel::expr::conformance::proto3::TestAllTypes::NestedEnum_descriptor()));
-
-    CEL_RETURN_IF_ERROR(cel::extensions::RegisterComprehensionsV2Functions(
-        builder.function_registry(), options));
-    CEL_RETURN_IF_ERROR(cel::extensions::EnableOptionalTypes(builder));
-    CEL_RETURN_IF_ERROR(cel::extensions::RegisterEncodersFunctions(
-        builder.function_registry(), options));
-    CEL_RETURN_IF_ERROR(cel::extensions::RegisterStringsFunctions(
-        builder.function_registry(), options));
-    CEL_RETURN_IF_ERROR(cel::extensions::RegisterMathExtensionFunctions(
-        builder.function_registry(), options));
-
-    return std::move(builder).Build();
+    return cel_conformance::NewConformanceRuntime(
+        options, enable_optimizations_, enable_select_optimization_);
   }
 
   void Parse(const conformance::v1alpha1::ParseRequest& request,
@@ -683,6 +575,106 @@ class ModernConformanceServiceImpl : public ConformanceServiceInterface {
 
 namespace cel_conformance {
 
+void LinkConformanceTestMessages() {
+  google::protobuf::LinkMessageReflection<
+      cel::expr::conformance::proto3::TestAllTypes>();
+  google::protobuf::LinkMessageReflection<
+      cel::expr::conformance::proto2::TestAllTypes>();
+  google::protobuf::LinkMessageReflection<
+      cel::expr::conformance::proto3::NestedTestAllTypes>();
+  google::protobuf::LinkMessageReflection<
+      cel::expr::conformance::proto2::NestedTestAllTypes>();
+  google::protobuf::LinkExtensionReflection(cel::expr::conformance::proto2::int32_ext);
+  google::protobuf::LinkExtensionReflection(cel::expr::conformance::proto2::nested_ext);
+  google::protobuf::LinkExtensionReflection(
+      cel::expr::conformance::proto2::test_all_types_ext);
+  google::protobuf::LinkExtensionReflection(
+      cel::expr::conformance::proto2::nested_enum_ext);
+  google::protobuf::LinkExtensionReflection(
+      cel::expr::conformance::proto2::repeated_test_all_types);
+  google::protobuf::LinkExtensionReflection(
+      cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
+          int64_ext);
+  google::protobuf::LinkExtensionReflection(
+      cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
+          message_scoped_nested_ext);
+  google::protobuf::LinkExtensionReflection(
+      cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
+          nested_enum_ext);
+  google::protobuf::LinkExtensionReflection(
+      cel::expr::conformance::proto2::Proto2ExtensionScopedMessage::
+          message_scoped_repeated_test_all_types);
+}
+
+absl::Status RegisterConformanceMacros(cel::MacroRegistry& macros,
+                                       const cel::ParserOptions& options) {
+  CEL_RETURN_IF_ERROR(cel::RegisterStandardMacros(macros, options));
+  CEL_RETURN_IF_ERROR(
+      cel::extensions::RegisterComprehensionsV2Macros(macros, options));
+  CEL_RETURN_IF_ERROR(cel::extensions::RegisterBindingsMacros(macros, options));
+  CEL_RETURN_IF_ERROR(cel::extensions::RegisterMathMacros(macros, options));
+  CEL_RETURN_IF_ERROR(cel::extensions::RegisterProtoMacros(macros, options));
+  return cel::test::RegisterTestMacros(macros);
+}
+
+absl::Status AddConformanceCheckerLibraries(cel::TypeCheckerBuilder& builder) {
+  CEL_RETURN_IF_ERROR(builder.AddLibrary(cel::StandardCheckerLibrary()));
+  CEL_RETURN_IF_ERROR(builder.AddLibrary(cel::OptionalCheckerLibrary()));
+  CEL_RETURN_IF_ERROR(
+      builder.AddLibrary(cel::extensions::BindingsCheckerLibrary()));
+  CEL_RETURN_IF_ERROR(
+      builder.AddLibrary(cel::extensions::StringsCheckerLibrary()));
+  CEL_RETURN_IF_ERROR(
+      builder.AddLibrary(cel::extensions::MathCheckerLibrary()));
+  CEL_RETURN_IF_ERROR(
+      builder.AddLibrary(cel::extensions::EncodersCheckerLibrary()));
+  return builder.AddLibrary(cel::extensions::ComprehensionsV2CheckerLibrary());
+}
+
+absl::StatusOr<std::unique_ptr<const cel::Runtime>> NewConformanceRuntime(
+    const cel::RuntimeOptions& options, bool constant_folding,
+    bool select_optimization) {
+  CEL_ASSIGN_OR_RETURN(
+      auto builder, CreateStandardRuntimeBuilder(
+                        google::protobuf::DescriptorPool::generated_pool(), options));
+
+  if (constant_folding) {
+    CEL_RETURN_IF_ERROR(cel::extensions::EnableConstantFolding(
+        builder, google::protobuf::MessageFactory::generated_factory()));
+    CEL_RETURN_IF_ERROR(cel::extensions::EnableRegexPrecompilation(builder));
+  }
+  CEL_RETURN_IF_ERROR(cel::EnableReferenceResolver(
+      builder, cel::ReferenceResolverEnabled::kAlways));
+  if (select_optimization) {
+    CEL_RETURN_IF_ERROR(cel::extensions::EnableSelectOptimization(builder));
+  }
+
+  auto& type_registry = builder.type_registry();
+  // Use linked pbs in the generated descriptor pool.
+  CEL_RETURN_IF_ERROR(RegisterProtobufEnum(
+      type_registry, cel::expr::conformance::proto2::GlobalEnum_descriptor()));
+  CEL_RETURN_IF_ERROR(RegisterProtobufEnum(
+      type_registry, cel::expr::conformance::proto3::GlobalEnum_descriptor()));
+  CEL_RETURN_IF_ERROR(RegisterProtobufEnum(
+      type_registry,
+      cel::expr::conformance::proto2::TestAllTypes::NestedEnum_descriptor()));
+  CEL_RETURN_IF_ERROR(RegisterProtobufEnum(
+      type_registry,
+      cel::expr::conformance::proto3::TestAllTypes::NestedEnum_descriptor()));
+
+  CEL_RETURN_IF_ERROR(cel::extensions::RegisterComprehensionsV2Functions(
+      builder.function_registry(), options));
+  CEL_RETURN_IF_ERROR(cel::extensions::EnableOptionalTypes(builder));
+  CEL_RETURN_IF_ERROR(cel::extensions::RegisterEncodersFunctions(
+      builder.function_registry(), options));
+  CEL_RETURN_IF_ERROR(cel::extensions::RegisterStringsFunctions(
+      builder.function_registry(), options));
+  CEL_RETURN_IF_ERROR(cel::extensions::RegisterMathExtensionFunctions(
+      builder.function_registry(), options));
+
+  return std::move(builder).Build();
+}
+
 absl::StatusOr<std::unique_ptr<ConformanceServiceInterface>>
 NewConformanceService(const ConformanceServiceOptions& options) {
   if (options.modern) {
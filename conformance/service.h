@@ -20,6 +20,11 @@
 #include "google/api/expr/conformance/v1alpha1/conformance_service.pb.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "checker/type_checker_builder.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
 
 namespace cel_conformance {
 
@@ -53,6 +58,28 @@ struct ConformanceServiceOptions {
 absl::StatusOr<std::unique_ptr<ConformanceServiceInterface>>
 NewConformanceService(const ConformanceServiceOptions&);
 
+// The environment of the modern conformance service, shared with the
+// conformance benchmark (conformance/benchmark.cc).
+
+// Links the conformance test messages and extensions into the generated
+// descriptor pool.
+void LinkConformanceTestMessages();
+
+// Registers the macros available to conformance test expressions.
+absl::Status RegisterConformanceMacros(cel::MacroRegistry& macros,
+                                       const cel::ParserOptions& options);
+
+// Adds the libraries conformance test expressions are type checked against,
+// unless a test opts out of the standard environment.
+absl::Status AddConformanceCheckerLibraries(cel::TypeCheckerBuilder& builder);
+
+// Builds a runtime with the functions and types used by conformance tests
+// over the generated descriptor pool. `constant_folding` also enables regex
+// precompilation.
+absl::StatusOr<std::unique_ptr<const cel::Runtime>> NewConformanceRuntime(
+    const cel::RuntimeOptions& options, bool constant_folding,
+    bool select_optimization);
+
 }  // namespace cel_conformance
 
 #endif  // THIRD_PARTY_CEL_CPP_CONFORMANCE_SERVICE_H_
@@ -47,6 +47,7 @@ namespace {
 using ::cel::Expr;
 using ::cel::builtin::kAnd;
 using ::cel::builtin::kOr;
+using ::cel::builtin::kRuntimeCollectResults;
 using ::cel::builtin::kTernary;
 using ::cel::runtime_internal::ConvertConstant;
 using ::google::api::expr::runtime::CreateConstValueDirectStep;
@@ -57,6 +58,7 @@ using ::google::api::expr::runtime::ExecutionPath;
 using ::google::api::expr::runtime::ExecutionPathView;
 using ::google::api::expr::runtime::FlatExpressionEvaluatorState;
 using ::google::api::expr::runtime::PlannerContext;
+using ::google::api::expr::runtime::ProgramBuilder;
 using ::google::api::expr::runtime::ProgramOptimizer;
 using ::google::api::expr::runtime::ProgramOptimizerFactory;
 using ::google::api::expr::runtime::Resolver;
@@ -143,7 +145,8 @@ IsConst IsConstExpr(const Expr& expr, const Resolver& resolver) {
       // For now we skip constant folding for cel.@block. We do not yet setup
       // slots. When we enable constant folding for comprehensions (like
       // cel.bind), we can address cel.@block.
-      if (call.function() == "cel.@block") {
+      if (call.function() == "cel.@block" ||
+          call.function() == kRuntimeCollectResults) {
         return IsConst::kNonConst;
       }
 
@@ -230,12 +233,17 @@ absl::Status ConstantFoldingExtension::OnPostVisit(PlannerContext& context,
   }
 
   // If recursive planning enabled (recursion limit unbounded or at least 1),
-  // use a recursive (direct) step for the folded constant.
+  // or the subexpression was planned recursively regardless (a parallel
+  // comprehension under the stack machine), use a recursive (direct) step for
+  // the folded constant.
   //
   // Constant folding is applied leaf to root based on the program plan so far,
   // so the planner will have an opportunity to validate that the recursion
   // limit is being followed when visiting parent nodes in the AST.
-  if (context.options().max_recursion_depth != 0) {
+  const ProgramBuilder::Subexpression* subexpression =
+      context.program_builder().GetSubexpression(&node);
+  if (context.options().max_recursion_depth != 0 ||
+      (subexpression != nullptr && subexpression->IsRecursive())) {
     return context.ReplaceSubplan(
         node, CreateConstValueDirectStep(std::move(value), node.id()), 1);
   }
@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
@@ -44,6 +45,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "base/ast.h"
@@ -53,15 +55,19 @@
 #include "common/ast.h"
 #include "common/ast_traverse.h"
 #include "common/ast_visitor.h"
+#include "common/ast_visitor_base.h"
 #include "common/constant.h"
 #include "common/expr.h"
 #include "common/kind.h"
 #include "common/type.h"
 #include "common/type_spec_resolver.h"
 #include "common/value.h"
+#include "common/value_kind.h"
 #include "eval/compiler/check_ast_extensions.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/compiler/recursion_cost_model.h"
 #include "eval/compiler/resolver.h"
+#include "eval/eval/collect_results_step.h"
 #include "eval/eval/comprehension_step.h"
 #include "eval/eval/const_value_step.h"
 #include "eval/eval/container_access_step.h"
@@ -81,12 +87,15 @@
 #include "eval/eval/shadowable_value_step.h"
 #include "eval/eval/ternary_step.h"
 #include "eval/eval/trace_step.h"
+#include "eval/eval/typed_operator_steps.h"
 #include "internal/status_macros.h"
+#include "runtime/function_overload_reference.h"
 #include "runtime/internal/convert_constant.h"
 #include "runtime/internal/issue_collector.h"
 #include "runtime/runtime_issue.h"
 #include "runtime/runtime_options.h"
 #include "runtime/type_registry.h"
+#include "runtime/typed_field_accessor.h"
 #include "google/protobuf/arena.h"
 
 namespace google::api::expr::runtime {
@@ -373,6 +382,238 @@ const cel::Expr* GetOptimizableListAppendOperand(
   return &GetOptimizableListAppendCall(comprehension)->args()[1];
 }
 
+bool IsIdent(const cel::Expr& expr, absl::string_view name) {
+  return expr.has_ident_expr() && expr.ident_expr().name() == name;
+}
+
+// Returns whether `name` is referenced anywhere in `expr`.
+bool ReferencesIdent(const cel::Expr& expr, absl::string_view name) {
+  std::vector<const cel::Expr*> stack = {&expr};
+  while (!stack.empty()) {
+    const cel::Expr* next = stack.back();
+    stack.pop_back();
+    switch (next->kind_case()) {
+      case cel::ExprKindCase::kIdentExpr:
+        if (next->ident_expr().name() == name) {
+          return true;
+        }
+        break;
+      case cel::ExprKindCase::kSelectExpr:
+        stack.push_back(&next->select_expr().operand());
+        break;
+      case cel::ExprKindCase::kCallExpr:
+        if (next->call_expr().has_target()) {
+          stack.push_back(&next->call_expr().target());
+        }
+        for (const cel::Expr& arg : next->call_expr().args()) {
+          stack.push_back(&arg);
+        }
+        break;
+      case cel::ExprKindCase::kListExpr:
+        for (const cel::ListExprElement& element :
+             next->list_expr().elements()) {
+          stack.push_back(&element.expr());
+        }
+        break;
+      case cel::ExprKindCase::kStructExpr:
+        for (const cel::StructExprField& field : next->struct_expr().fields()) {
+          stack.push_back(&field.value());
+        }
+        break;
+      case cel::ExprKindCase::kMapExpr:
+        for (const cel::MapExprEntry& entry : next->map_expr().entries()) {
+          stack.push_back(&entry.key());
+          stack.push_back(&entry.value());
+        }
+        break;
+      case cel::ExprKindCase::kComprehensionExpr: {
+        const cel::ComprehensionExpr& comprehension =
+            next->comprehension_expr();
+        stack.push_back(&comprehension.iter_range());
+        stack.push_back(&comprehension.accu_init());
+        stack.push_back(&comprehension.loop_condition());
+        stack.push_back(&comprehension.loop_step());
+        stack.push_back(&comprehension.result());
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+// Returns the parallel evaluation strategy for this comprehension if it
+// appears to be a standard all(), exists(), map() or filter() macro whose loop
+// step only reads the accumulator to combine it with a value computed from the
+// current element. It is not exhaustive, so it is unsafe to use with custom
+// comprehensions outside of the standard macros or hand crafted ASTs.
+//
+// all() and exists() are only evaluated in parallel when short-circuiting,
+// since later chunks are skipped once one of them decides the result.
+absl::optional<ParallelComprehensionKind> GetParallelComprehensionKind(
+    const cel::ComprehensionExpr& comprehension, bool short_circuiting) {
+  absl::string_view accu_var = comprehension.accu_var();
+  if (accu_var.empty() || !comprehension.iter_var2().empty() ||
+      comprehension.iter_var() == accu_var ||
+      !IsIdent(comprehension.result(), accu_var) ||
+      !comprehension.loop_step().has_call_expr()) {
+    return absl::nullopt;
+  }
+  const cel::Expr& condition = comprehension.loop_condition();
+  const cel::CallExpr& step = comprehension.loop_step().call_expr();
+
+  // all():    @not_strictly_false(accu_var), accu_var && <pred>
+  // exists(): @not_strictly_false(!accu_var), accu_var || <pred>
+  if (comprehension.accu_init().has_const_expr() &&
+      comprehension.accu_init().const_expr().has_bool_value()) {
+    const bool is_all = comprehension.accu_init().const_expr().bool_value();
+    if (!short_circuiting || !condition.has_call_expr() ||
+        (condition.call_expr().function() != cel::builtin::kNotStrictlyFalse &&
+         condition.call_expr().function() !=
+             cel::builtin::kNotStrictlyFalseDeprecated) ||
+        condition.call_expr().args().size() != 1) {
+      return absl::nullopt;
+    }
+    const cel::Expr* accu_ref = &condition.call_expr().args()[0];
+    if (!is_all) {
+      if (!accu_ref->has_call_expr() ||
+          accu_ref->call_expr().function() != cel::builtin::kNot ||
+          accu_ref->call_expr().args().size() != 1) {
+        return absl::nullopt;
+      }
+      accu_ref = &accu_ref->call_expr().args()[0];
+    }
+    if (!IsIdent(*accu_ref, accu_var) ||
+        step.function() != (is_all ? cel::builtin::kAnd : cel::builtin::kOr) ||
+        step.args().size() != 2 || !IsIdent(step.args()[0], accu_var) ||
+        ReferencesIdent(step.args()[1], accu_var)) {
+      return absl::nullopt;
+    }
+    return is_all ? ParallelComprehensionKind::kAll
+                  : ParallelComprehensionKind::kExists;
+  }
+
+  // map():    true, accu_var + [<elem>]
+  // filter(): true, <pred> ? accu_var + [<elem>] : accu_var
+  if (!comprehension.accu_init().has_list_expr() ||
+      !comprehension.accu_init().list_expr().elements().empty() ||
+      !condition.has_const_expr() || !condition.const_expr().has_bool_value() ||
+      !condition.const_expr().bool_value()) {
+    return absl::nullopt;
+  }
+  const cel::CallExpr* append = &step;
+  if (step.function() == cel::builtin::kTernary && step.args().size() == 3) {
+    if (ReferencesIdent(step.args()[0], accu_var) ||
+        !IsIdent(step.args()[2], accu_var) || !step.args()[1].has_call_expr()) {
+      return absl::nullopt;
+    }
+    append = &step.args()[1].call_expr();
+  }
+  if (append->function() != cel::builtin::kAdd || append->args().size() != 2 ||
+      !IsIdent(append->args()[0], accu_var) ||
+      !append->args()[1].has_list_expr() ||
+      append->args()[1].list_expr().elements().size() != 1 ||
+      append->args()[1].list_expr().elements()[0].optional() ||
+      ReferencesIdent(append->args()[1], accu_var)) {
+    return absl::nullopt;
+  }
+  return ParallelComprehensionKind::kList;
+}
+
+// Collects the comprehensions to plan as recursive programs, so that they can
+// be evaluated in parallel, within a program otherwise planned for the stack
+// machine.
+//
+// A comprehension referencing a variable that may be lazily initialized
+// outside of it (a cel.bind() or cel.@block() binding) is left to the stack
+// machine, since its reference would be planned recursively while the
+// binding's initializer is not.
+class ParallelComprehensionSelector final : public cel::AstVisitorBase {
+ public:
+  explicit ParallelComprehensionSelector(bool short_circuiting)
+      : short_circuiting_(short_circuiting) {}
+
+  void PreVisitExpr(const cel::Expr& expr) override {
+    nodes_.push_back(&expr);
+  }
+
+  void PreVisitComprehension(
+      const cel::Expr& expr,
+      const cel::ComprehensionExpr& comprehension) override {
+    scopes_.push_back(
+        Scope{&comprehension, nodes_.size() - 1,
+              GetParallelComprehensionKind(comprehension, short_circuiting_)
+                  .has_value()});
+  }
+
+  void PostVisitComprehension(
+      const cel::Expr& expr,
+      const cel::ComprehensionExpr& comprehension) override {
+    Scope scope = scopes_.back();
+    scopes_.pop_back();
+    if (scope.parallel) {
+      recursive_.push_back({scope.begin, nodes_.size()});
+    }
+  }
+
+  void PostVisitIdent(const cel::Expr& expr,
+                      const cel::IdentExpr& ident_expr) override {
+    absl::string_view name = ident_expr.name();
+    for (size_t i = 0; i < scopes_.size(); ++i) {
+      if (!scopes_[i].parallel) {
+        continue;
+      }
+      if (absl::StartsWith(name, "@index")) {
+        scopes_[i].parallel = false;
+        continue;
+      }
+      for (size_t j = 0; j < i; ++j) {
+        if (scopes_[j].comprehension->accu_var() == name) {
+          scopes_[i].parallel = false;
+          break;
+        }
+      }
+    }
+  }
+
+  bool has_parallel_comprehensions() const { return !recursive_.empty(); }
+
+  // Removes the subexpressions of the selected comprehensions from
+  // `stack_machine_subexpressions`.
+  void RemoveSelected(absl::flat_hash_set<const cel::Expr*>&
+                          stack_machine_subexpressions) const {
+    for (const auto& [begin, end] : recursive_) {
+      for (size_t i = begin; i < end; ++i) {
+        stack_machine_subexpressions.erase(nodes_[i]);
+      }
+    }
+  }
+
+  // Returns every subexpression outside of the selected comprehensions.
+  absl::flat_hash_set<const cel::Expr*> UnselectedSubexpressions() const {
+    absl::flat_hash_set<const cel::Expr*> unselected(nodes_.begin(),
+                                                     nodes_.end());
+    RemoveSelected(unselected);
+    return unselected;
+  }
+
+ private:
+  struct Scope {
+    const cel::ComprehensionExpr* comprehension;
+    // Index of the comprehension in `nodes_`.
+    size_t begin;
+    bool parallel;
+  };
+
+  const bool short_circuiting_;
+  // Subexpressions in pre-order.
+  std::vector<const cel::Expr*> nodes_;
+  std::vector<Scope> scopes_;
+  // Ranges of `nodes_` spanned by the selected comprehensions.
+  std::vector<std::pair<size_t, size_t>> recursive_;
+};
+
 // Returns whether this comprehension appears to be a macro implementation for
 // map transformations. It is not exhaustive, so it is unsafe to use with custom
 // comprehensions outside of the standard macros or hand crafted ASTs.
@@ -528,6 +769,7 @@ class FlatExprVisitor : public cel::AstVisitor {
       const Resolver& resolver, const cel::RuntimeOptions& options,
       std::vector<std::unique_ptr<ProgramOptimizer>> program_optimizers,
       const absl::flat_hash_map<int64_t, cel::TypeSpec>& type_map,
+      const absl::flat_hash_map<int64_t, cel::Reference>& reference_map,
       const cel::TypeProvider& type_provider, IssueCollector& issue_collector,
       ProgramBuilder& program_builder, PlannerContext& extension_context,
       bool enable_optional_types)
@@ -538,11 +780,12 @@ class FlatExprVisitor : public cel::AstVisitor {
         options_(options),
         program_optimizers_(std::move(program_optimizers)),
         type_map_(type_map),
+        reference_map_(reference_map),
         issue_collector_(issue_collector),
         program_builder_(program_builder),
         extension_context_(extension_context),
         enable_optional_types_(enable_optional_types) {
-    constexpr size_t kCallHandlerSizeHint = 11;
+    constexpr size_t kCallHandlerSizeHint = 18;
     call_handlers_.reserve(kCallHandlerSizeHint);
     call_handlers_[cel::builtin::kIndex] = [this](const cel::Expr& expr,
                                                   const cel::CallExpr& call) {
@@ -552,10 +795,30 @@ class FlatExprVisitor : public cel::AstVisitor {
                                     const cel::CallExpr& call) {
       return HandleBlock(expr, call);
     };
+    call_handlers_[cel::builtin::kRuntimeCollectResults] =
+        [this](const cel::Expr& expr, const cel::CallExpr& call) {
+          return HandleCollectResults(expr, call);
+        };
     call_handlers_[cel::builtin::kAdd] = [this](const cel::Expr& expr,
                                                 const cel::CallExpr& call) {
-      return HandleListAppend(expr, call);
+      if (HandleListAppend(expr, call) == CallHandlerResult::kIntercepted) {
+        return CallHandlerResult::kIntercepted;
+      }
+      return options_.enable_typed_binary_operators
+                 ? HandleTypedBinaryOperator(expr, call)
+                 : CallHandlerResult::kNotIntercepted;
     };
+    if (options_.enable_typed_binary_operators) {
+      for (const auto& op :
+           {cel::builtin::kSubtract, cel::builtin::kMultiply,
+            cel::builtin::kLess, cel::builtin::kLessOrEqual,
+            cel::builtin::kGreater, cel::builtin::kGreaterOrEqual}) {
+        call_handlers_[op] = [this](const cel::Expr& expr,
+                                    const cel::CallExpr& call) {
+          return HandleTypedBinaryOperator(expr, call);
+        };
+      }
+    }
     if (options_.enable_fast_builtins) {
       call_handlers_[cel::builtin::kNotStrictlyFalse] =
           [this](const cel::Expr& expr, const cel::CallExpr& call) {
@@ -604,7 +867,23 @@ class FlatExprVisitor : public cel::AstVisitor {
     max_recursion_depth_ = max_recursion_depth;
   }
 
-  bool PlanRecursiveProgram() const { return max_recursion_depth_ > 0; }
+  // Plans the given subexpressions for the stack machine and all others as
+  // recursive programs (see `cel::kAdaptiveRecursionDepth`).
+  void SetStackMachineSubexpressions(
+      absl::flat_hash_set<const cel::Expr*> stack_machine_subexpressions) {
+    adaptive_planning_ = true;
+    stack_machine_subexpressions_ = std::move(stack_machine_subexpressions);
+  }
+
+  // Returns whether the subexpression currently being planned should be
+  // planned as a recursive program.
+  bool PlanRecursiveProgram() const {
+    if (max_recursion_depth_ <= 0) {
+      return false;
+    }
+    return !adaptive_planning_ || plan_recursive_stack_.empty() ||
+           plan_recursive_stack_.back();
+  }
 
   void SetResolvedType(const cel::Expr& expr, cel::Type type) {
     resolved_types_[&expr] = std::move(type);
@@ -650,6 +929,10 @@ class FlatExprVisitor : public cel::AstVisitor {
           absl::InternalError("same CEL expr visited twice"));
       return;
     }
+    if (adaptive_planning_) {
+      plan_recursive_stack_.push_back(
+          !stack_machine_subexpressions_.contains(&expr));
+    }
 
     for (const std::unique_ptr<ProgramOptimizer>& optimizer :
          program_optimizers_) {
@@ -686,6 +969,9 @@ class FlatExprVisitor : public cel::AstVisitor {
     }
 
     program_builder_.ExitSubexpression(&expr);
+    if (adaptive_planning_) {
+      plan_recursive_stack_.pop_back();
+    }
 
     if (!comprehension_stack_.empty() &&
         comprehension_stack_.back().is_optimizable_bind &&
@@ -715,15 +1001,22 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    // Constants are reference counted by default so that evaluation results
+    // may outlive the program. In arena resident value mode they are owned by
+    // the program's arena instead.
+    google::protobuf::Arena* absl_nullable constant_arena =
+        options_.enable_arena_resident_values
+            ? extension_context_.MutableArena()
+            : nullptr;
     absl::StatusOr<cel::Value> converted_value =
-        ConvertConstant(const_expr, cel::NewDeleteAllocator());
+        ConvertConstant(const_expr, cel::Allocator<>(constant_arena));
 
     if (!converted_value.ok()) {
       SetProgressStatusIfError(converted_value.status());
       return;
     }
 
-    if (options_.max_recursion_depth > 0 || options_.max_recursion_depth < 0) {
+    if (PlanRecursiveProgram()) {
       SetRecursiveStep(CreateConstValueDirectStep(
                            std::move(converted_value).value(), expr.id()),
                        1);
@@ -860,7 +1153,7 @@ class FlatExprVisitor : public cel::AstVisitor {
       }
       return;
     } else if (slot.slot >= 0) {
-      if (options_.max_recursion_depth != 0) {
+      if (PlanRecursiveProgram()) {
         SetRecursiveStep(
             CreateDirectSlotIdentStep(ident_expr.name(), slot.slot, expr.id()),
             1);
@@ -911,7 +1204,8 @@ class FlatExprVisitor : public cel::AstVisitor {
     if (const_value) {
       // If the path starts with a dot, strip it.
       absl::string_view name = absl::StripPrefix(path, ".");
-      if (options_.max_recursion_depth != 0) {
+      RecordVariableReference(name);
+      if (PlanRecursiveProgram()) {
         SetRecursiveStep(
             CreateDirectShadowableValueStep(
                 name, std::move(const_value).value(), select_root_id),
@@ -924,7 +1218,8 @@ class FlatExprVisitor : public cel::AstVisitor {
     }
 
     absl::string_view ident_name = absl::StripPrefix(ident_expr.name(), ".");
-    if (options_.max_recursion_depth != 0) {
+    RecordVariableReference(ident_name);
+    if (PlanRecursiveProgram()) {
       SetRecursiveStep(CreateDirectIdentStep(ident_name, expr.id()), 1);
     } else {
       AddStep(CreateIdentStep(ident_name, expr.id()));
@@ -1032,10 +1327,16 @@ class FlatExprVisitor : public cel::AstVisitor {
     }
 
     if (field_type.has_value()) {
+      const cel::TypedFieldAccessor* accessor = nullptr;
+      if (field_type->IsMessage()) {
+        accessor = extension_context_.type_registry().FindTypedFieldAccessor(
+            field_type->GetMessage().descriptor());
+      }
       AddStep(CreateTypedSelectStep(
           std::move(field), *struct_type, *std::move(field_type),
           select_expr.test_only(), expr.id(),
-          options_.enable_empty_wrapper_null_unboxing, enable_optional_types_));
+          options_.enable_empty_wrapper_null_unboxing, enable_optional_types_,
+          accessor));
       return;
     }
     AddStep(CreateSelectStep(
@@ -1053,6 +1354,10 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    if (IsShortCircuitingCall(call_expr)) {
+      conditional_operands_.insert({&expr, false});
+    }
+
     std::unique_ptr<CondVisitor> cond_visitor;
     if (call_expr.function() == cel::builtin::kAnd) {
       cond_visitor = std::make_unique<LogicalCondVisitor>(
@@ -1310,14 +1615,32 @@ class FlatExprVisitor : public cel::AstVisitor {
     max_depth = std::max(max_depth, condition_plan->recursive_program().depth);
     max_depth = std::max(max_depth, result_plan->recursive_program().depth);
 
-    auto step = CreateDirectComprehensionStep(
-        iter_slot, iter2_slot, accu_slot,
-        range_plan->ExtractRecursiveProgram().step,
-        accu_plan->ExtractRecursiveProgram().step,
-        loop_plan->ExtractRecursiveProgram().step,
-        condition_plan->ExtractRecursiveProgram().step,
-        result_plan->ExtractRecursiveProgram().step, options_.short_circuiting,
-        expr->id());
+    absl::optional<ParallelComprehensionKind> parallel_kind;
+    if (options_.comprehension_parallelism > 1) {
+      parallel_kind = GetParallelComprehensionKind(*comprehension,
+                                                   options_.short_circuiting);
+    }
+
+    std::unique_ptr<DirectExpressionStep> step;
+    if (parallel_kind.has_value()) {
+      step = CreateDirectParallelComprehensionStep(
+          *parallel_kind, iter_slot, accu_slot,
+          range_plan->ExtractRecursiveProgram().step,
+          accu_plan->ExtractRecursiveProgram().step,
+          loop_plan->ExtractRecursiveProgram().step,
+          condition_plan->ExtractRecursiveProgram().step,
+          result_plan->ExtractRecursiveProgram().step,
+          options_.short_circuiting, expr->id());
+    } else {
+      step = CreateDirectComprehensionStep(
+          iter_slot, iter2_slot, accu_slot,
+          range_plan->ExtractRecursiveProgram().step,
+          accu_plan->ExtractRecursiveProgram().step,
+          loop_plan->ExtractRecursiveProgram().step,
+          condition_plan->ExtractRecursiveProgram().step,
+          result_plan->ExtractRecursiveProgram().step,
+          options_.short_circuiting, expr->id());
+    }
 
     SetRecursiveStep(std::move(step), max_depth + 1);
   }
@@ -1329,6 +1652,14 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    if (auto it = conditional_operands_.find(&expr);
+        it != conditional_operands_.end()) {
+      if (it->second) {
+        --conditional_depth_;
+      }
+      conditional_operands_.erase(it);
+    }
+
     auto cond_visitor = FindCondVisitor(&expr);
     if (cond_visitor) {
       cond_visitor->PostVisit(&expr);
@@ -1469,6 +1800,12 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    // The loop is not entered for an empty range.
+    if (comprehension_arg == cel::LOOP_CONDITION ||
+        comprehension_arg == cel::LOOP_STEP) {
+      ++conditional_depth_;
+    }
+
     if (comprehension_stack_.empty() ||
         comprehension_stack_.back().comprehension != &compr) {
       return;
@@ -1522,6 +1859,11 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    if (comprehension_arg == cel::LOOP_CONDITION ||
+        comprehension_arg == cel::LOOP_STEP) {
+      --conditional_depth_;
+    }
+
     if (comprehension_stack_.empty() ||
         comprehension_stack_.back().comprehension != &compr) {
       return;
@@ -1536,6 +1878,7 @@ class FlatExprVisitor : public cel::AstVisitor {
     if (!progress_status_.ok()) {
       return;
     }
+    EnterConditionalOperands(expr);
     auto cond_visitor = FindCondVisitor(&expr);
     if (cond_visitor) {
       cond_visitor->PostVisitArg(arg_num, &expr);
@@ -1546,6 +1889,7 @@ class FlatExprVisitor : public cel::AstVisitor {
     if (!progress_status_.ok()) {
       return;
     }
+    EnterConditionalOperands(expr);
     auto cond_visitor = FindCondVisitor(&expr);
     if (cond_visitor) {
       cond_visitor->PostVisitTarget(&expr);
@@ -1817,6 +2161,10 @@ class FlatExprVisitor : public cel::AstVisitor {
 
   size_t slot_count() const { return index_manager_.max_slot_count(); }
 
+  std::vector<cel::VariableReference> ReleaseReferencedVariables() {
+    return std::move(referenced_variables_);
+  }
+
   void AddOptimizer(std::unique_ptr<ProgramOptimizer> optimizer) {
     program_optimizers_.push_back(std::move(optimizer));
   }
@@ -1952,6 +2300,8 @@ class FlatExprVisitor : public cel::AstVisitor {
                                 const cel::CallExpr& call);
   CallHandlerResult HandleBlock(const cel::Expr& expr,
                                 const cel::CallExpr& call);
+  CallHandlerResult HandleCollectResults(const cel::Expr& expr,
+                                         const cel::CallExpr& call);
   CallHandlerResult HandleListAppend(const cel::Expr& expr,
                                      const cel::CallExpr& call);
   CallHandlerResult HandleNot(const cel::Expr& expr, const cel::CallExpr& call);
@@ -1962,11 +2312,51 @@ class FlatExprVisitor : public cel::AstVisitor {
                                                 const cel::CallExpr& call,
                                                 bool inequality);
 
+  CallHandlerResult HandleTypedBinaryOperator(const cel::Expr& expr,
+                                              const cel::CallExpr& call);
   CallHandlerResult HandleHeterogeneousEqualityIn(const cel::Expr& expr,
                                                   const cel::CallExpr& call);
 
   void MaybeResolveType(const cel::Expr& expr);
 
+  // Whether operands after the first operand (or target) of the call are only
+  // evaluated depending on its value.
+  bool IsShortCircuitingCall(const cel::CallExpr& call_expr) const {
+    if (!options_.short_circuiting) {
+      return false;
+    }
+    if (call_expr.function() == cel::builtin::kAnd ||
+        call_expr.function() == cel::builtin::kOr ||
+        call_expr.function() == cel::builtin::kTernary) {
+      return !call_expr.has_target();
+    }
+    return enable_optional_types_ && call_expr.has_target() &&
+           (call_expr.function() == kOptionalOrFn ||
+            call_expr.function() == kOptionalOrValueFn);
+  }
+
+  // Called after each operand of a call; the operands that follow the first
+  // one of a short-circuiting call are conditional.
+  void EnterConditionalOperands(const cel::Expr& expr) {
+    if (auto it = conditional_operands_.find(&expr);
+        it != conditional_operands_.end() && !it->second) {
+      it->second = true;
+      ++conditional_depth_;
+    }
+  }
+
+  void RecordVariableReference(absl::string_view name) {
+    bool conditional = conditional_depth_ > 0;
+    auto [it, inserted] = referenced_variable_indices_.try_emplace(
+        name, referenced_variables_.size());
+    if (inserted) {
+      referenced_variables_.push_back(
+          cel::VariableReference{std::string(name), conditional});
+    } else if (!conditional) {
+      referenced_variables_[it->second].conditional = false;
+    }
+  }
+
   const Resolver& resolver_;
   const cel::TypeProvider& type_provider_;
   absl::Status progress_status_;
@@ -1989,6 +2379,7 @@ class FlatExprVisitor : public cel::AstVisitor {
   const cel::Expr* resume_from_suppressed_branch_ = nullptr;
   std::vector<std::unique_ptr<ProgramOptimizer>> program_optimizers_;
   const absl::flat_hash_map<int64_t, cel::TypeSpec>& type_map_;
+  const absl::flat_hash_map<int64_t, cel::Reference>& reference_map_;
   absl::flat_hash_map<const cel::Expr*, cel::Type> resolved_types_;
   IssueCollector& issue_collector_;
 
@@ -1999,6 +2390,21 @@ class FlatExprVisitor : public cel::AstVisitor {
   bool enable_optional_types_;
   std::optional<FlatExprVisitor::BlockInfo> block_;
   int max_recursion_depth_ = 0;
+  bool adaptive_planning_ = false;
+  absl::flat_hash_set<const cel::Expr*> stack_machine_subexpressions_;
+  // Whether each subexpression being visited is planned recursively, under
+  // adaptive planning.
+  std::vector<bool> plan_recursive_stack_;
+
+  // Variables read from the activation, see `cel::Program::
+  // GetReferencedVariables`. A variable is conditional if it is only
+  // referenced while `conditional_depth_` is positive.
+  std::vector<cel::VariableReference> referenced_variables_;
+  absl::flat_hash_map<std::string, size_t> referenced_variable_indices_;
+  // Short-circuiting calls being visited, mapped to whether their conditional
+  // operands have been entered.
+  absl::flat_hash_map<const cel::Expr*, bool> conditional_operands_;
+  int conditional_depth_ = 0;
 };
 
 FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleIndex(
@@ -2103,11 +2509,9 @@ FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleBlock(
   ProgramBuilder::Subexpression* body_subexpression =
       program_builder_.GetSubexpression(&call_expr.args()[1]);
 
-  if (options_.max_recursion_depth != 0 && body_subexpression != nullptr &&
+  if (PlanRecursiveProgram() && body_subexpression != nullptr &&
       body_subexpression->IsRecursive() &&
-      (options_.max_recursion_depth < 0 ||
-       body_subexpression->recursive_program().depth <
-           options_.max_recursion_depth)) {
+      body_subexpression->recursive_program().depth < max_recursion_depth_) {
     auto recursive_program = body_subexpression->ExtractRecursiveProgram();
     SetRecursiveStep(
         CreateDirectBlockStep(block.index, block.slot_count,
@@ -2124,6 +2528,58 @@ FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleBlock(
   return CallHandlerResult::kIntercepted;
 }
 
+FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleCollectResults(
+    const cel::Expr& expr, const cel::CallExpr& call_expr) {
+  ABSL_DCHECK(call_expr.function() == cel::builtin::kRuntimeCollectResults);
+  if (!ValidateOrError(!call_expr.has_target(),
+                       "unexpected receiver for internal #collect_results")) {
+    return CallHandlerResult::kIntercepted;
+  }
+
+  if (auto depth = RecursionEligible(); depth.has_value()) {
+    auto args = ExtractRecursiveDependencies();
+    if (args.size() != call_expr.args().size()) {
+      SetProgressStatusIfError(absl::InvalidArgumentError(
+          "unexpected number of args for internal #collect_results"));
+      return CallHandlerResult::kIntercepted;
+    }
+    SetRecursiveStep(
+        CreateDirectCollectResultsStep(std::move(args), expr.id()),
+        *depth + 1);
+    return CallHandlerResult::kIntercepted;
+  }
+
+  // Precede the steps of each operand with a step isolating them, so that
+  // each operand is evaluated as if by a separate program.
+  ProgramBuilder::Subexpression* subexpression = program_builder_.current();
+  if (!ValidateOrError(subexpression != nullptr &&
+                           !subexpression->IsFlattened() &&
+                           !subexpression->IsRecursive(),
+                       "unexpected plan for internal #collect_results")) {
+    return CallHandlerResult::kIntercepted;
+  }
+  auto& elements = subexpression->elements();
+  std::remove_reference_t<decltype(elements)> isolated_elements;
+  isolated_elements.reserve(2 * elements.size());
+  for (auto& element : elements) {
+    if (auto* operand =
+            absl::get_if<ProgramBuilder::Subexpression*>(&element);
+        operand != nullptr) {
+      isolated_elements.push_back({CreateCollectResultsOperandStep(
+          (*operand)->ComputeSize(), expr.id())});
+    }
+    isolated_elements.push_back(std::move(element));
+  }
+  if (!ValidateOrError(
+          isolated_elements.size() == 2 * call_expr.args().size(),
+          "unexpected number of args for internal #collect_results")) {
+    return CallHandlerResult::kIntercepted;
+  }
+  elements = std::move(isolated_elements);
+  AddStep(CreateCollectResultsStep(call_expr.args().size(), expr.id()));
+  return CallHandlerResult::kIntercepted;
+}
+
 FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleListAppend(
     const cel::Expr& expr, const cel::CallExpr& call_expr) {
   ABSL_DCHECK(call_expr.function() == cel::builtin::kAdd);
@@ -2184,6 +2640,67 @@ FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleHeterogeneousEquality(
   return CallHandlerResult::kIntercepted;
 }
 
+FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleTypedBinaryOperator(
+    const cel::Expr& expr, const cel::CallExpr& call) {
+  if (call.args().size() != 2 || call.has_target()) {
+    return CallHandlerResult::kNotIntercepted;
+  }
+
+  // Only specialize calls the type checker narrowed to a single overload.
+  auto reference = reference_map_.find(expr.id());
+  if (reference == reference_map_.end() ||
+      reference->second.overload_id().size() != 1) {
+    return CallHandlerResult::kNotIntercepted;
+  }
+  absl::optional<TypedBinaryOperator> op =
+      FindTypedBinaryOperator(reference->second.overload_id().front());
+  if (!op.has_value()) {
+    return CallHandlerResult::kNotIntercepted;
+  }
+
+  // Lazy overloads shadow the eager ones, so leave those to the default
+  // handling.
+  if (!resolver_
+           .FindLazyOverloads(call.function(), /*receiver_style=*/false,
+                              /*arity=*/2, expr.id())
+           .empty()) {
+    return CallHandlerResult::kNotIntercepted;
+  }
+
+  // Don't introduce an implementation the runtime doesn't provide. The
+  // remaining overloads back the typed step when the operands don't match the
+  // checked types (e.g. dyn values, errors or unknowns).
+  std::vector<cel::FunctionOverloadReference> overloads =
+      resolver_.FindOverloads(call.function(), /*receiver_style=*/false,
+                              /*arity=*/2, expr.id());
+  const cel::Kind operand_kind = cel::ValueKindToKind(op->operand_kind);
+  if (!absl::c_any_of(overloads,
+                      [operand_kind](const cel::FunctionOverloadReference& ref) {
+                        return ref.descriptor.types() ==
+                               std::vector<cel::Kind>{operand_kind,
+                                                      operand_kind};
+                      })) {
+    return CallHandlerResult::kNotIntercepted;
+  }
+
+  if (auto depth = RecursionEligible(); depth.has_value()) {
+    auto args = ExtractRecursiveDependencies();
+    if (args.size() != 2) {
+      SetProgressStatusIfError(absl::InvalidArgumentError(
+          "unexpected number of args for builtin binary operator"));
+      return CallHandlerResult::kIntercepted;
+    }
+    SetRecursiveStep(CreateDirectTypedBinaryOperatorStep(
+                         *op, call, std::move(args[0]), std::move(args[1]),
+                         std::move(overloads), expr.id()),
+                     *depth + 1);
+    return CallHandlerResult::kIntercepted;
+  }
+  AddStep(CreateTypedBinaryOperatorStep(*op, call, std::move(overloads),
+                                        expr.id()));
+  return CallHandlerResult::kIntercepted;
+}
+
 FlatExprVisitor::CallHandlerResult
 FlatExprVisitor::HandleHeterogeneousEqualityIn(const cel::Expr& expr,
                                                const cel::CallExpr& call) {
@@ -2610,7 +3127,8 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
   PlannerContext extension_context(env_, resolver, options_, GetTypeProvider(),
                                    issue_collector, program_builder, arena);
 
-  for (const std::unique_ptr<AstTransform>& transform : ast_transforms_) {
+  for (const std::shared_ptr<const AstTransform>& transform :
+       ast_transforms_) {
     CEL_RETURN_IF_ERROR(transform->UpdateAst(extension_context, *ast));
   }
 
@@ -2626,15 +3144,41 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
   // These objects are expected to remain scoped to one build call -- references
   // to them shouldn't be persisted in any part of the result expression.
   FlatExprVisitor visitor(resolver, options_, std::move(optimizers),
-                          ast->type_map(), GetTypeProvider(), issue_collector,
+                          ast->type_map(), ast->reference_map(),
+                          GetTypeProvider(), issue_collector,
                           program_builder, extension_context,
                           enable_optional_types_);
 
-  if (options_.max_recursion_depth == -1 || options_.max_recursion_depth > 0) {
+  // Only recursive programs evaluate comprehensions in parallel, so parallel
+  // comprehensions are planned recursively within stack machine programs.
+  ParallelComprehensionSelector parallel_comprehensions(
+      options_.short_circuiting);
+  if (options_.comprehension_parallelism > 1 &&
+      (options_.max_recursion_depth == cel::kAdaptiveRecursionDepth ||
+       options_.max_recursion_depth == 0)) {
+    cel::TraversalOptions traversal_options;
+    traversal_options.use_comprehension_callbacks = true;
+    AstTraverse(ast->root_expr(), parallel_comprehensions, traversal_options);
+  }
+
+  if (options_.max_recursion_depth == cel::kAdaptiveRecursionDepth) {
+    // The cost model bounds the depth of recursive subexpressions instead.
+    absl::flat_hash_set<const cel::Expr*> stack_machine_subexpressions =
+        SelectStackMachineSubexpressions(ast->root_expr(), options_);
+    parallel_comprehensions.RemoveSelected(stack_machine_subexpressions);
+    visitor.SetStackMachineSubexpressions(
+        std::move(stack_machine_subexpressions));
+    visitor.SetMaxRecursionDepth(std::numeric_limits<int>::max());
+  } else if (options_.max_recursion_depth == -1 ||
+             options_.max_recursion_depth > 0) {
     int depth_limit = options_.max_recursion_depth == -1
                           ? std::numeric_limits<int>::max()
                           : options_.max_recursion_depth;
     visitor.SetMaxRecursionDepth(depth_limit);
+  } else if (parallel_comprehensions.has_parallel_comprehensions()) {
+    visitor.SetStackMachineSubexpressions(
+        parallel_comprehensions.UnselectedSubexpressions());
+    visitor.SetMaxRecursionDepth(std::numeric_limits<int>::max());
   }
 
   cel::TraversalOptions opts;
@@ -2653,9 +3197,11 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
   std::vector<ExecutionPathView> subexpressions =
       FlattenExpressionTable(program_builder, execution_path);
 
-  return FlatExpression(std::move(execution_path), std::move(subexpressions),
-                        visitor.slot_count(), GetTypeProvider(), options_,
-                        std::move(arena));
+  FlatExpression expression(std::move(execution_path),
+                            std::move(subexpressions), visitor.slot_count(),
+                            GetTypeProvider(), options_, std::move(arena));
+  expression.set_referenced_variables(visitor.ReleaseReferencedVariables());
+  return std::move(expression);
 }
 const cel::TypeProvider& FlatExprBuilder::GetTypeProvider() const {
   return use_legacy_type_provider_
@@ -51,6 +51,23 @@ class FlatExprBuilder {
         type_registry_(env_->type_registry),
         use_legacy_type_provider_(use_legacy_type_provider) {}
 
+  // Creates a builder for a runtime derived from the one using `parent`.
+  //
+  // Planner extensions and settings are shared with `parent`, while functions
+  // and types are resolved through `env`.
+  FlatExprBuilder(
+      absl_nonnull std::shared_ptr<const cel::runtime_internal::RuntimeEnv> env,
+      const FlatExprBuilder& parent)
+      : env_(std::move(env)),
+        options_(parent.options_),
+        container_(parent.container_),
+        enable_optional_types_(parent.enable_optional_types_),
+        function_registry_(env_->function_registry),
+        type_registry_(env_->type_registry),
+        use_legacy_type_provider_(parent.use_legacy_type_provider_),
+        ast_transforms_(parent.ast_transforms_),
+        program_optimizers_(parent.program_optimizers_) {}
+
   void AddAstTransform(std::unique_ptr<AstTransform> transform) {
     ast_transforms_.push_back(std::move(transform));
   }
@@ -95,7 +112,7 @@ class FlatExprBuilder {
   const cel::FunctionRegistry& function_registry_;
   const cel::TypeRegistry& type_registry_;
   bool use_legacy_type_provider_;
-  std::vector<std::unique_ptr<AstTransform>> ast_transforms_;
+  std::vector<std::shared_ptr<const AstTransform>> ast_transforms_;
   std::vector<ProgramOptimizerFactory> program_optimizers_;
 };
 
@@ -49,6 +49,7 @@
 #include "runtime/internal/issue_collector.h"
 #include "runtime/internal/runtime_env.h"
 #include "runtime/runtime_options.h"
+#include "runtime/type_registry.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -399,6 +400,10 @@ class PlannerContext {
     return environment_->descriptor_pool.get();
   }
 
+  const cel::TypeRegistry& type_registry() const {
+    return environment_->type_registry;
+  }
+
   // Returns `true` if an arena was explicitly provided during planning.
   bool HasExplicitArena() const { return explicit_arena_; }
 
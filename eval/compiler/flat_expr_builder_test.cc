@@ -1081,6 +1081,55 @@ TEST(FlatExprBuilderTest, CheckedExprWithReferenceMapFunction) {
   EXPECT_TRUE(result.BoolOrDie());
 }
 
+TEST(FlatExprBuilderTest, TypedBinaryOperatorsAreOptIn) {
+  CheckedExpr expr;
+  // a + b
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(R"(
+    reference_map {
+      key: 1
+      value { overload_id: "add_int64" }
+    }
+    expr {
+      id: 1
+      call_expr {
+        function: "_+_"
+        args {
+          id: 2
+          ident_expr { name: "a" }
+        }
+        args {
+          id: 3
+          ident_expr { name: "b" }
+        }
+      }
+    })",
+                                                  &expr));
+
+  for (bool enable_typed_binary_operators : {false, true}) {
+    SCOPED_TRACE(enable_typed_binary_operators);
+    cel::RuntimeOptions options;
+    options.enable_typed_binary_operators = enable_typed_binary_operators;
+    CelExpressionBuilderFlatImpl builder(NewTestingRuntimeEnv(), options);
+    // Replaces the standard add_int64 overload.
+    ASSERT_OK((FunctionAdapter<int64_t, int64_t, int64_t>::CreateAndRegister(
+        cel::builtin::kAdd, /*receiver_style=*/false,
+        [](google::protobuf::Arena*, int64_t lhs, int64_t rhs) {
+          return lhs * 100 + rhs;
+        },
+        builder.GetRegistry())));
+    ASSERT_OK_AND_ASSIGN(auto cel_expr, builder.CreateExpression(&expr));
+
+    Activation activation;
+    activation.InsertValue("a", CelValue::CreateInt64(1));
+    activation.InsertValue("b", CelValue::CreateInt64(2));
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(CelValue result,
+                         cel_expr->Evaluate(activation, &arena));
+    EXPECT_THAT(result,
+                test::IsCelInt64(enable_typed_binary_operators ? 3 : 102));
+  }
+}
+
 TEST(FlatExprBuilderTest, CheckedExprActivationMissesReferences) {
   CheckedExpr expr;
   // <foo.var1> && <bar>.<var2>
@@ -67,7 +67,8 @@ bool IsSpecialFunction(absl::string_view function_name) {
          function_name == cel::builtin::kIn ||
          function_name == cel::builtin::kInDeprecated ||
          function_name == cel::builtin::kInFunction ||
-         function_name == "cel.@block";
+         function_name == "cel.@block" ||
+         function_name == cel::builtin::kRuntimeCollectResults;
 }
 
 bool OverloadExists(const Resolver& resolver, absl::string_view name,
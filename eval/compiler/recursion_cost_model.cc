@@ -0,0 +1,217 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/recursion_cost_model.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "common/ast_traverse.h"
+#include "common/ast_visitor.h"
+#include "common/ast_visitor_base.h"
+#include "common/expr.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+constexpr absl::string_view kBlock = "cel.@block";
+
+// Weight of a comprehension node. The direct comprehension step keeps the
+// iteration state in its frame and evaluates the loop under it.
+constexpr int kComprehensionWeight = 3;
+
+// Minimum number of nodes in a recursive subexpression under a stack machine
+// planned parent.
+constexpr int kMinEmbeddedSize = 2;
+
+struct NodeCost {
+  const cel::Expr* expr;
+  const cel::Expr* parent;
+  int height;
+  int size;
+};
+
+class CostVisitor final : public cel::AstVisitorBase {
+ public:
+  explicit CostVisitor(bool enable_recursive_tracing)
+      : weight_multiplier_(enable_recursive_tracing ? 2 : 1) {}
+
+  void PreVisitExpr(const cel::Expr& expr) override {
+    frames_.push_back(Frame{&expr});
+  }
+
+  void PostVisitExpr(const cel::Expr& expr) override {
+    Frame frame = frames_.back();
+    frames_.pop_back();
+
+    int weight = expr.has_comprehension_expr() ? kComprehensionWeight : 1;
+    NodeCost cost{&expr, frames_.empty() ? nullptr : frames_.back().expr,
+                  weight * weight_multiplier_ + frame.max_child_height,
+                  1 + frame.size};
+    heights_[&expr] = cost.height;
+    nodes_.push_back(cost);
+
+    // The bindings of a block are planned as separate subexpressions, costed
+    // at their references.
+    if (cost.parent != nullptr && &expr != block_bindings_) {
+      Frame& parent = frames_.back();
+      parent.max_child_height = std::max(parent.max_child_height, cost.height);
+      parent.size += cost.size;
+    }
+  }
+
+  void PostVisitIdent(const cel::Expr& expr,
+                      const cel::IdentExpr& ident_expr) override {
+    if (absl::optional<int> height = LookupLazyHeight(ident_expr.name());
+        height.has_value()) {
+      frames_.back().max_child_height = *height;
+    }
+  }
+
+  void PreVisitCall(const cel::Expr& expr,
+                    const cel::CallExpr& call_expr) override {
+    if (block_bindings_ != nullptr || call_expr.function() != kBlock ||
+        call_expr.args().size() != 2 || !call_expr.args()[0].has_list_expr()) {
+      return;
+    }
+    block_bindings_ = &call_expr.args()[0];
+    for (const auto& element : block_bindings_->list_expr().elements()) {
+      lazy_roots_.insert(&element.expr());
+    }
+  }
+
+  void PreVisitComprehension(
+      const cel::Expr& expr,
+      const cel::ComprehensionExpr& comprehension) override {
+    scopes_.push_back(Scope{&comprehension, cel::ITER_RANGE});
+    lazy_roots_.insert(&comprehension.accu_init());
+  }
+
+  void PreVisitComprehensionSubexpression(
+      const cel::Expr& expr, const cel::ComprehensionExpr& comprehension,
+      cel::ComprehensionArg comprehension_arg) override {
+    if (!scopes_.empty() && scopes_.back().comprehension == &comprehension) {
+      scopes_.back().arg = comprehension_arg;
+    }
+  }
+
+  void PostVisitComprehension(
+      const cel::Expr& expr,
+      const cel::ComprehensionExpr& comprehension) override {
+    if (!scopes_.empty() && scopes_.back().comprehension == &comprehension) {
+      scopes_.pop_back();
+    }
+  }
+
+  absl::flat_hash_set<const cel::Expr*> SelectStackMachineSubexpressions() && {
+    absl::flat_hash_set<const cel::Expr*> stack_planned;
+    // Post-order reversed visits parents before their children.
+    for (auto it = nodes_.rbegin(); it != nodes_.rend(); ++it) {
+      bool recursive = it->height <= kAdaptiveRecursionBudget;
+      if (recursive && it->size < kMinEmbeddedSize &&
+          it->parent != nullptr && stack_planned.contains(it->parent) &&
+          !lazy_roots_.contains(it->expr)) {
+        recursive = false;
+      }
+      if (!recursive) {
+        stack_planned.insert(it->expr);
+      }
+    }
+    return stack_planned;
+  }
+
+ private:
+  struct Frame {
+    const cel::Expr* expr;
+    int max_child_height = 0;
+    int size = 0;
+  };
+
+  struct Scope {
+    const cel::ComprehensionExpr* comprehension;
+    cel::ComprehensionArg arg;
+  };
+
+  // Returns the height of the expression lazily evaluated by a reference to
+  // `name`, following the planner's variable resolution.
+  absl::optional<int> LookupLazyHeight(absl::string_view name) const {
+    if (block_bindings_ != nullptr) {
+      absl::string_view index_suffix = name;
+      size_t index;
+      if (absl::ConsumePrefix(&index_suffix, "@index") &&
+          absl::SimpleAtoi(index_suffix, &index) &&
+          index < block_bindings_->list_expr().elements().size()) {
+        return FindHeight(
+            block_bindings_->list_expr().elements()[index].expr());
+      }
+    }
+    for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
+      const cel::ComprehensionExpr& comprehension = *it->comprehension;
+      bool in_loop =
+          it->arg == cel::LOOP_CONDITION || it->arg == cel::LOOP_STEP;
+      if (in_loop && (comprehension.iter_var() == name ||
+                      (!comprehension.iter_var2().empty() &&
+                       comprehension.iter_var2() == name))) {
+        return absl::nullopt;
+      }
+      if ((in_loop || it->arg == cel::RESULT) &&
+          comprehension.accu_var() == name) {
+        return FindHeight(comprehension.accu_init());
+      }
+    }
+    return absl::nullopt;
+  }
+
+  absl::optional<int> FindHeight(const cel::Expr& expr) const {
+    auto it = heights_.find(&expr);
+    if (it == heights_.end()) {
+      return absl::nullopt;
+    }
+    return it->second;
+  }
+
+  const int weight_multiplier_;
+  std::vector<Frame> frames_;
+  std::vector<Scope> scopes_;
+  // Nodes in post-order.
+  std::vector<NodeCost> nodes_;
+  absl::flat_hash_map<const cel::Expr*, int> heights_;
+  // Expressions that may be lazily evaluated at a reference elsewhere in the
+  // AST, so must be planned recursively whenever a reference may be.
+  absl::flat_hash_set<const cel::Expr*> lazy_roots_;
+  const cel::Expr* block_bindings_ = nullptr;
+};
+
+}  // namespace
+
+absl::flat_hash_set<const cel::Expr*> SelectStackMachineSubexpressions(
+    const cel::Expr& root, const cel::RuntimeOptions& options) {
+  CostVisitor visitor(options.enable_recursive_tracing);
+  cel::TraversalOptions traversal_options;
+  traversal_options.use_comprehension_callbacks = true;
+  cel::AstTraverse(root, visitor, traversal_options);
+  return std::move(visitor).SelectStackMachineSubexpressions();
+}
+
+}  // namespace google::api::expr::runtime
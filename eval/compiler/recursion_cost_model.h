@@ -0,0 +1,48 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_RECURSION_COST_MODEL_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_RECURSION_COST_MODEL_H_
+
+#include "absl/container/flat_hash_set.h"
+#include "common/expr.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+
+// Maximum weighted height of a recursively planned subexpression under
+// adaptive planning (see `cel::kAdaptiveRecursionDepth`).
+inline constexpr int kAdaptiveRecursionBudget = 32;
+
+// Returns the subexpressions of `root` that adaptive planning plans for the
+// stack machine. All other subexpressions are planned as recursive programs
+// (`DirectExpressionStep`s), which the stack machine program embeds.
+//
+// Each subexpression is costed by its height in the AST, weighted by how much
+// native stack its recursive step needs: comprehensions weigh more than other
+// nodes, and every node weighs double when `options.enable_recursive_tracing`
+// is set since each recursive step is then wrapped for tracing. A reference to
+// a comprehension accumulator or a `cel.@block` binding is costed as the
+// expression it may lazily evaluate.
+//
+// Subexpressions within `kAdaptiveRecursionBudget` are planned recursively,
+// except single nodes under a stack machine planned parent: wrapping those only
+// adds an indirection. If a subexpression is planned recursively, so are all of
+// its descendants.
+absl::flat_hash_set<const cel::Expr*> SelectStackMachineSubexpressions(
+    const cel::Expr& root, const cel::RuntimeOptions& options);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_RECURSION_COST_MODEL_H_
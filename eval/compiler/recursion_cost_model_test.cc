@@ -0,0 +1,146 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/recursion_cost_model.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/ast_proto.h"
+#include "common/expr.h"
+#include "internal/testing.h"
+#include "parser/options.h"
+#include "parser/parser.h"
+#include "runtime/runtime_options.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+using ::testing::IsEmpty;
+
+// Returns `terms` additions of `term`, nested `terms` deep.
+std::string DeepSum(int terms, absl::string_view term = "x") {
+  return absl::StrJoin(std::vector<std::string>(terms, std::string(term)),
+                       " + ");
+}
+
+std::unique_ptr<cel::Ast> ParseAst(absl::string_view expression) {
+  cel::ParserOptions options;
+  options.max_recursion_depth = 128;
+  auto parsed_expr = Parse(expression, "<input>", options);
+  ABSL_CHECK_OK(parsed_expr.status());
+  auto ast = cel::CreateAstFromParsedExpr(*parsed_expr);
+  ABSL_CHECK_OK(ast.status());
+  return *std::move(ast);
+}
+
+// Returns the innermost call on the left operand chain of `expr`.
+const cel::Expr& InnermostCall(const cel::Expr& expr) {
+  const cel::Expr* current = &expr;
+  while (current->call_expr().args()[0].has_call_expr()) {
+    current = &current->call_expr().args()[0];
+  }
+  return *current;
+}
+
+TEST(SelectStackMachineSubexpressionsTest, ShallowExpressionIsRecursive) {
+  std::unique_ptr<cel::Ast> ast =
+      ParseAst("[1, 2].exists(i, i * x + y == z) && a.b.c");
+
+  EXPECT_THAT(
+      SelectStackMachineSubexpressions(ast->root_expr(), cel::RuntimeOptions()),
+      IsEmpty());
+}
+
+TEST(SelectStackMachineSubexpressionsTest, DeepExpressionEmbedsShallowParts) {
+  std::unique_ptr<cel::Ast> ast = ParseAst(DeepSum(100));
+  const cel::Expr& root = ast->root_expr();
+  const cel::Expr& innermost = InnermostCall(root);
+
+  absl::flat_hash_set<const cel::Expr*> stack_machine =
+      SelectStackMachineSubexpressions(root, cel::RuntimeOptions());
+
+  EXPECT_TRUE(stack_machine.contains(&root));
+  // Single identifiers under the stack machine part stay on the stack machine.
+  EXPECT_TRUE(stack_machine.contains(&root.call_expr().args()[1]));
+  EXPECT_FALSE(stack_machine.contains(&innermost));
+  EXPECT_FALSE(stack_machine.contains(&innermost.call_expr().args()[0]));
+}
+
+TEST(SelectStackMachineSubexpressionsTest, TracingHalvesBudget) {
+  std::unique_ptr<cel::Ast> ast =
+      ParseAst(DeepSum(kAdaptiveRecursionBudget / 2 + 1));
+  cel::RuntimeOptions options;
+
+  EXPECT_THAT(SelectStackMachineSubexpressions(ast->root_expr(), options),
+              IsEmpty());
+
+  options.enable_recursive_tracing = true;
+  EXPECT_TRUE(SelectStackMachineSubexpressions(ast->root_expr(), options)
+                  .contains(&ast->root_expr()));
+}
+
+TEST(SelectStackMachineSubexpressionsTest, ComprehensionsWeighMore) {
+  // The sum alone is within budget, but not under a comprehension.
+  std::string sum = DeepSum(kAdaptiveRecursionBudget - 4);
+  ASSERT_THAT(SelectStackMachineSubexpressions(ParseAst(sum)->root_expr(),
+                                               cel::RuntimeOptions()),
+              IsEmpty());
+
+  std::unique_ptr<cel::Ast> ast =
+      ParseAst(absl::StrCat("[1].exists(x, ", sum, " == 1)"));
+
+  EXPECT_TRUE(
+      SelectStackMachineSubexpressions(ast->root_expr(), cel::RuntimeOptions())
+          .contains(&ast->root_expr()));
+}
+
+TEST(SelectStackMachineSubexpressionsTest, BlockReferencesCostInitializer) {
+  // cel.@block([<sum>], @index0 + 1), which the parser does not accept.
+  std::unique_ptr<cel::Ast> ast = ParseAst(absl::StrCat(
+      "block([", DeepSum(kAdaptiveRecursionBudget), "], index + 1)"));
+  cel::Expr& mutable_block = ast->mutable_root_expr();
+  mutable_block.mutable_call_expr().set_function("cel.@block");
+  mutable_block.mutable_call_expr()
+      .mutable_args()[1]
+      .mutable_call_expr()
+      .mutable_args()[0]
+      .mutable_ident_expr()
+      .set_name("@index0");
+  const cel::Expr& block = ast->root_expr();
+  const cel::Expr& initializer =
+      block.call_expr().args()[0].list_expr().elements()[0].expr();
+  const cel::Expr& body = block.call_expr().args()[1];
+
+  absl::flat_hash_set<const cel::Expr*> stack_machine =
+      SelectStackMachineSubexpressions(block, cel::RuntimeOptions());
+
+  // The initializer alone is within budget, but its reference adds to it.
+  EXPECT_FALSE(stack_machine.contains(&initializer));
+  EXPECT_TRUE(stack_machine.contains(&body.call_expr().args()[0]));
+  EXPECT_TRUE(stack_machine.contains(&body));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,107 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/any_unpack_cache.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/algorithm/container.h"
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "internal/status_macros.h"
+#include "internal/well_known_types.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+bool AnyUnpackCache::IsAnyField(
+    const google::protobuf::FieldDescriptor* absl_nonnull field) {
+  return field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
+         !field->is_repeated() &&
+         field->message_type()->well_known_type() ==
+             google::protobuf::Descriptor::WELLKNOWNTYPE_ANY;
+}
+
+absl::Status AnyUnpackCache::GetField(
+    const cel::ParsedMessageValue& message,
+    const google::protobuf::FieldDescriptor* absl_nonnull field,
+    cel::ProtoWrapperTypeOptions unboxing_options,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, cel::Value* absl_nonnull result) {
+  if (!IsAnyField(field)) {
+    return message.GetField(field, unboxing_options, descriptor_pool,
+                            message_factory, arena, result);
+  }
+  // The key is taken before `result` is written, as `message` may refer to it.
+  const Key key(message.message(), field);
+  if (auto it = values_.find(key); it != values_.end()) {
+    *result = it->second;
+    return absl::OkStatus();
+  }
+  CEL_RETURN_IF_ERROR(message.GetField(field, unboxing_options,
+                                       descriptor_pool, message_factory, arena,
+                                       result));
+  values_.insert({key, *result});
+  return absl::OkStatus();
+}
+
+void AnyUnpackCache::Prefetch(
+    const cel::ParsedMessageValue& message,
+    absl::Span<const std::string> type_urls,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  const google::protobuf::Descriptor* descriptor = message.GetDescriptor();
+  const google::protobuf::Reflection* reflection = message.GetReflection();
+  std::string scratch;
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (!IsAnyField(field) || !reflection->HasField(*message, field) ||
+        values_.contains(Key(message.message(), field))) {
+      continue;
+    }
+    const google::protobuf::Message& any = reflection->GetMessage(*message, field);
+    absl::StatusOr<cel::well_known_types::AnyReflection> any_reflection =
+        cel::well_known_types::GetAnyReflection(any.GetDescriptor());
+    if (!any_reflection.ok()) {
+      continue;
+    }
+    const cel::well_known_types::StringValue type_url =
+        any_reflection->GetTypeUrl(any, scratch);
+    if (!absl::c_any_of(type_urls, [&](const std::string& eager_type_url) {
+          return type_url == cel::well_known_types::StringValue(
+                                 absl::string_view(eager_type_url));
+        })) {
+      continue;
+    }
+    cel::Value value;
+    // Errors are reported when the field is selected.
+    if (message
+            .GetField(field, cel::ProtoWrapperTypeOptions::kUnsetNull,
+                      descriptor_pool, message_factory, arena, &value)
+            .ok()) {
+      values_.insert({Key(message.message(), field), std::move(value)});
+    }
+  }
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,85 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_ANY_UNPACK_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_ANY_UNPACK_CACHE_H_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+// Memoizes the values of `google.protobuf.Any` message fields for the duration
+// of an evaluation, so that selecting several fields through the same `Any`
+// unpacks its payload once.
+//
+// Values are keyed by the address of the containing message and the field.
+// Messages are not modified or freed while an evaluation is running, so the
+// key identifies the same payload for the duration of the evaluation.
+//
+// Unpacked payloads are owned by the evaluation arena, so the cache must be
+// cleared before the arena is destroyed.
+class AnyUnpackCache {
+ public:
+  AnyUnpackCache() = default;
+
+  AnyUnpackCache(const AnyUnpackCache&) = delete;
+  AnyUnpackCache& operator=(const AnyUnpackCache&) = delete;
+
+  // Returns true if `field` is a singular `google.protobuf.Any` field, whose
+  // value is memoized by `GetField`.
+  static bool IsAnyField(const google::protobuf::FieldDescriptor* absl_nonnull field);
+
+  // As `cel::ParsedMessageValue::GetField`, returning the memoized value if
+  // `field` is an `Any` field that was already unpacked.
+  absl::Status GetField(
+      const cel::ParsedMessageValue& message,
+      const google::protobuf::FieldDescriptor* absl_nonnull field,
+      cel::ProtoWrapperTypeOptions unboxing_options,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, cel::Value* absl_nonnull result);
+
+  // Unpacks the `Any` fields of `message` that are set to one of `type_urls`.
+  void Prefetch(const cel::ParsedMessageValue& message,
+                absl::Span<const std::string> type_urls,
+                const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                google::protobuf::MessageFactory* absl_nonnull message_factory,
+                google::protobuf::Arena* absl_nonnull arena);
+
+  // Drops all memoized values.
+  void Clear() { values_.clear(); }
+
+  size_t size() const { return values_.size(); }
+
+ private:
+  using Key = std::pair<const google::protobuf::Message*,
+                        const google::protobuf::FieldDescriptor*>;
+
+  absl::flat_hash_map<Key, cel::Value> values_;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_ANY_UNPACK_CACHE_H_
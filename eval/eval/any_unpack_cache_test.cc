@@ -0,0 +1,165 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/any_unpack_cache.h"
+
+#include <string>
+#include <utility>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/descriptor.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::cel::Activation;
+using ::cel::ParsedMessageValue;
+using ::cel::ProtoWrapperTypeOptions;
+using ::cel::Value;
+using ::cel::expr::ParsedExpr;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::cel::test::IntValueIs;
+using ::google::api::expr::parser::Parse;
+
+using TestAllTypesProto3 = ::cel::expr::conformance::proto3::TestAllTypes;
+
+constexpr char kTestAllTypesUrl[] =
+    "type.googleapis.com/cel.expr.conformance.proto3.TestAllTypes";
+
+constexpr char kMessage[] = R"pb(
+  single_int64: 2
+  single_any {
+    [type.googleapis.com/cel.expr.conformance.proto3.TestAllTypes] {
+      single_int64: 40
+      single_int32: 2
+    }
+  }
+)pb";
+
+class AnyUnpackCacheTest : public cel::common_internal::ValueTest<> {
+ protected:
+  Value GetField(AnyUnpackCache& cache, const ParsedMessageValue& message,
+                 absl::string_view name) {
+    Value result;
+    EXPECT_THAT(cache.GetField(message,
+                               DynamicGetField<TestAllTypesProto3>(name),
+                               ProtoWrapperTypeOptions::kUnsetNull,
+                               descriptor_pool(), message_factory(), arena(),
+                               &result),
+                IsOk());
+    return result;
+  }
+};
+
+TEST_F(AnyUnpackCacheTest, IsAnyField) {
+  EXPECT_TRUE(AnyUnpackCache::IsAnyField(
+      DynamicGetField<TestAllTypesProto3>("single_any")));
+  EXPECT_FALSE(AnyUnpackCache::IsAnyField(
+      DynamicGetField<TestAllTypesProto3>("repeated_any")));
+  EXPECT_FALSE(AnyUnpackCache::IsAnyField(
+      DynamicGetField<TestAllTypesProto3>("standalone_message")));
+}
+
+TEST_F(AnyUnpackCacheTest, UnpacksOnce) {
+  ParsedMessageValue message = MakeParsedMessage<TestAllTypesProto3>(kMessage);
+  AnyUnpackCache cache;
+
+  Value first = GetField(cache, message, "single_any");
+  Value second = GetField(cache, message, "single_any");
+  ASSERT_TRUE(first.IsParsedMessage());
+  ASSERT_TRUE(second.IsParsedMessage());
+  EXPECT_EQ(first.GetParsedMessage().message(),
+            second.GetParsedMessage().message());
+  EXPECT_EQ(cache.size(), 1);
+
+  // Other fields are not memoized.
+  EXPECT_THAT(GetField(cache, message, "single_int64"), IntValueIs(2));
+  EXPECT_EQ(cache.size(), 1);
+
+  cache.Clear();
+  Value third = GetField(cache, message, "single_any");
+  ASSERT_TRUE(third.IsParsedMessage());
+  EXPECT_NE(first.GetParsedMessage().message(),
+            third.GetParsedMessage().message());
+}
+
+TEST_F(AnyUnpackCacheTest, Prefetch) {
+  ParsedMessageValue message = MakeParsedMessage<TestAllTypesProto3>(kMessage);
+  AnyUnpackCache cache;
+
+  cache.Prefetch(message, {"type.googleapis.com/google.protobuf.Int64Value"},
+                 descriptor_pool(), message_factory(), arena());
+  EXPECT_EQ(cache.size(), 0);
+
+  cache.Prefetch(message, {kTestAllTypesUrl}, descriptor_pool(),
+                 message_factory(), arena());
+  EXPECT_EQ(cache.size(), 1);
+  Value value = GetField(cache, message, "single_any");
+  ASSERT_TRUE(value.IsParsedMessage());
+  EXPECT_EQ(cache.size(), 1);
+}
+
+class AnyUnpackCacheEvaluationTest
+    : public cel::common_internal::ValueTest<bool, bool> {};
+
+TEST_P(AnyUnpackCacheEvaluationTest, SelectsThroughAny) {
+  const auto& [recursive, eager] = GetParam();
+  cel::RuntimeOptions options;
+  options.enable_any_unpack_cache = true;
+  if (eager) {
+    options.eager_any_unpack_type_urls.push_back(kTestAllTypesUrl);
+  }
+  options.max_recursion_depth = recursive ? -1 : 0;
+  ASSERT_OK_AND_ASSIGN(cel::RuntimeBuilder builder,
+                       cel::CreateStandardRuntimeBuilder(
+                           cel::internal::GetTestingDescriptorPool(), options));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr parsed_expr,
+      Parse("msg.single_any.single_int64 + msg.single_any.single_int32 + "
+            "msg.single_int64"));
+  ASSERT_OK_AND_ASSIGN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                         *runtime, parsed_expr));
+
+  Activation activation;
+  activation.InsertOrAssignValue(
+      "msg", MakeParsedMessage<TestAllTypesProto3>(kMessage));
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(arena(), activation));
+    EXPECT_THAT(result, IntValueIs(44));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(AnyUnpackCacheEvaluationTest,
+                         AnyUnpackCacheEvaluationTest,
+                         testing::Combine(testing::Bool(), testing::Bool()));
+
+}  // namespace
+}  // namespace google::api::expr::runtime
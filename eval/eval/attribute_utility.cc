@@ -1,9 +1,12 @@
 #include "eval/eval/attribute_utility.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/hash/hash.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -25,6 +28,7 @@ namespace google::api::expr::runtime {
 
 using ::cel::Attribute;
 using ::cel::AttributePattern;
+using ::cel::AttributeQualifier;
 using ::cel::AttributeSet;
 using ::cel::Cast;
 using ::cel::ErrorValue;
@@ -39,6 +43,34 @@ using ::cel::runtime_internal::AttributeMatcher;
 using Accumulator = AttributeUtility::Accumulator;
 using MatchResult = AttributeMatcher::MatchResult;
 
+namespace {
+
+void AppendUnknowns(const UnknownValue& value,
+                    std::vector<Attribute>& attributes,
+                    std::vector<FunctionResult>& function_results) {
+  attributes.insert(attributes.end(), value.attribute_set().begin(),
+                    value.attribute_set().end());
+  function_results.insert(function_results.end(),
+                          value.function_result_set().begin(),
+                          value.function_result_set().end());
+}
+
+// Qualifiers of unsupported types never compare equal, so attributes with
+// them are not interned.
+bool IsInternable(const Attribute& attr) {
+  for (const AttributeQualifier& qualifier : attr.qualifier_path()) {
+    if (!qualifier.GetInt64Key().has_value() &&
+        !qualifier.GetUint64Key().has_value() &&
+        !qualifier.GetStringKey().has_value() &&
+        !qualifier.GetBoolKey().has_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 DefaultAttributeMatcher::DefaultAttributeMatcher(
     absl::Span<const AttributePattern> unknown_patterns,
     absl::Span<const AttributePattern> missing_patterns)
@@ -108,41 +140,48 @@ absl::optional<UnknownValue> AttributeUtility::MergeUnknowns(
     absl::Span<const cel::Value> args) const {
   // Empty unknown value may be used as a sentinel in some tests so need to
   // distinguish unset (nullopt) and empty(engaged empty value).
-  absl::optional<UnknownSet> result_set;
+  const UnknownValue* first = nullptr;
+  bool merged = false;
+  std::vector<Attribute> attributes;
+  std::vector<FunctionResult> function_results;
 
   for (const auto& value : args) {
     if (!value->Is<cel::UnknownValue>()) continue;
-    if (!result_set.has_value()) {
-      result_set.emplace();
+    if (first == nullptr) {
+      // Forwarded as is unless another unknown is found.
+      first = &value.GetUnknown();
+      continue;
     }
-    const auto& current_set = value.GetUnknown();
-
-    cel::base_internal::UnknownSetAccess::Add(
-        *result_set, UnknownSet(current_set.attribute_set(),
-                                current_set.function_result_set()));
+    if (!merged) {
+      AppendUnknowns(*first, attributes, function_results);
+      merged = true;
+    }
+    AppendUnknowns(value.GetUnknown(), attributes, function_results);
   }
 
-  if (!result_set.has_value()) {
+  if (first == nullptr) {
     return std::nullopt;
   }
-
-  return UnknownValue(cel::Unknown(result_set->unknown_attributes(),
-                                   result_set->unknown_function_results()));
+  if (!merged) {
+    return *first;
+  }
+  return UnknownValue(cel::Unknown(
+      AttributeSet::FromUnsorted(std::move(attributes)),
+      FunctionResultSet::FromUnsorted(std::move(function_results))));
 }
 
 UnknownValue AttributeUtility::MergeUnknownValues(
     const UnknownValue& left, const UnknownValue& right) const {
-  // Empty unknown value may be used as a sentinel in some tests so need to
-  // distinguish unset (nullopt) and empty(engaged empty value).
-  AttributeSet attributes;
-  FunctionResultSet function_results;
-  attributes.Add(left.attribute_set());
-  function_results.Add(left.function_result_set());
-  attributes.Add(right.attribute_set());
-  function_results.Add(right.function_result_set());
-
-  return UnknownValue(
-      cel::Unknown(std::move(attributes), std::move(function_results)));
+  if (right.attribute_set().empty() && right.function_result_set().empty()) {
+    return left;
+  }
+  if (left.attribute_set().empty() && left.function_result_set().empty()) {
+    return right;
+  }
+  return UnknownValue(cel::Unknown(
+      AttributeSet(left.attribute_set(), right.attribute_set()),
+      FunctionResultSet(left.function_result_set(),
+                        right.function_result_set())));
 }
 
 // Creates merged UnknownAttributeSet.
@@ -152,15 +191,15 @@ UnknownValue AttributeUtility::MergeUnknownValues(
 // Returns pointer to merged set or nullptr, if there were no sets to merge.
 AttributeSet AttributeUtility::CheckForUnknowns(
     absl::Span<const AttributeTrail> args, bool use_partial) const {
-  AttributeSet attribute_set;
+  std::vector<Attribute> attributes;
 
   for (const auto& trail : args) {
     if (CheckForUnknown(trail, use_partial)) {
-      attribute_set.Add(trail.attribute());
+      attributes.push_back(Intern(trail.attribute()));
     }
   }
 
-  return attribute_set;
+  return AttributeSet::FromUnsorted(std::move(attributes));
 }
 
 // Creates merged UnknownAttributeSet.
@@ -200,7 +239,7 @@ absl::optional<UnknownValue> AttributeUtility::IdentifyAndMergeUnknowns(
 }
 
 UnknownValue AttributeUtility::CreateUnknownSet(cel::Attribute attr) const {
-  return UnknownValue(cel::Unknown(AttributeSet({std::move(attr)})));
+  return UnknownValue(cel::Unknown(AttributeSet({Intern(attr)})));
 }
 
 absl::StatusOr<ErrorValue> AttributeUtility::CreateMissingAttributeError(
@@ -218,12 +257,29 @@ UnknownValue AttributeUtility::CreateUnknownSet(
 }
 
 void AttributeUtility::Add(Accumulator& a, const cel::UnknownValue& v) const {
-  a.attribute_set_.Add(v.attribute_set());
-  a.function_result_set_.Add(v.function_result_set());
+  AppendUnknowns(v, a.attributes_, a.function_results_);
 }
 
 void AttributeUtility::Add(Accumulator& a, const AttributeTrail& attr) const {
-  a.attribute_set_.Add(attr.attribute());
+  a.attributes_.push_back(Intern(attr.attribute()));
+}
+
+size_t AttributeUtility::AttributeHash::operator()(
+    const Attribute& attr) const {
+  size_t hash =
+      absl::HashOf(attr.variable_name(), attr.qualifier_path().size());
+  for (const AttributeQualifier& qualifier : attr.qualifier_path()) {
+    hash = absl::HashOf(hash, qualifier.GetInt64Key(), qualifier.GetUint64Key(),
+                        qualifier.GetStringKey(), qualifier.GetBoolKey());
+  }
+  return hash;
+}
+
+Attribute AttributeUtility::Intern(const Attribute& attr) const {
+  if (!IsInternable(attr)) {
+    return attr;
+  }
+  return *interned_attributes_.insert(attr).first;
 }
 
 void Accumulator::Add(const UnknownValue& value) {
@@ -248,13 +304,13 @@ void Accumulator::MaybeAdd(const Value& v, const AttributeTrail& attr) {
 }
 
 bool Accumulator::IsEmpty() const {
-  return !unknown_present_ && attribute_set_.empty() &&
-         function_result_set_.empty();
+  return !unknown_present_ && attributes_.empty() && function_results_.empty();
 }
 
 cel::UnknownValue Accumulator::Build() && {
-  return cel::UnknownValue(
-      cel::Unknown(std::move(attribute_set_), std::move(function_result_set_)));
+  return cel::UnknownValue(cel::Unknown(
+      AttributeSet::FromUnsorted(std::move(attributes_)),
+      FunctionResultSet::FromUnsorted(std::move(function_results_))));
 }
 
 }  // namespace google::api::expr::runtime
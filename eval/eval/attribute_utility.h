@@ -1,14 +1,18 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_UNKNOWNS_UTILITY_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_UNKNOWNS_UTILITY_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "absl/base/nullability.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
 #include "base/attribute_set.h"
+#include "base/function_result.h"
 #include "base/function_result_set.h"
 #include "common/function_descriptor.h"
 #include "common/value.h"
@@ -42,6 +46,10 @@ class DefaultAttributeMatcher : public cel::runtime_internal::AttributeMatcher {
 // helpers for merging unknown sets from arguments on the stack and for
 // identifying unknown/missing attributes based on the patterns for a given
 // Evaluation.
+//
+// Attributes added to unknown sets are interned for the lifetime of the
+// utility, which is one evaluation, so that equal attributes share a single
+// representation and are merged by address.
 // Neither moveable nor copyable.
 class AttributeUtility {
  public:
@@ -79,8 +87,9 @@ class AttributeUtility {
     friend class AttributeUtility;
     const AttributeUtility& parent_;
 
-    cel::AttributeSet attribute_set_;
-    cel::FunctionResultSet function_result_set_;
+    // Collected unsorted, and sorted once when the unknown value is built.
+    std::vector<cel::Attribute> attributes_;
+    std::vector<cel::FunctionResult> function_results_;
 
     // Some tests will use an empty unknown set as a sentinel.
     // Preserve forwarding behavior.
@@ -166,12 +175,22 @@ class AttributeUtility {
   }
 
  private:
+  struct AttributeHash {
+    size_t operator()(const cel::Attribute& attr) const;
+  };
+
   // Workaround friend visibility.
   void Add(Accumulator& a, const cel::UnknownValue& v) const;
   void Add(Accumulator& a, const AttributeTrail& attr) const;
 
+  // Returns an attribute equal to `attr`, sharing its representation with the
+  // equal attributes previously interned.
+  cel::Attribute Intern(const cel::Attribute& attr) const;
+
   DefaultAttributeMatcher default_matcher_;
   const cel::runtime_internal::AttributeMatcher* absl_nonnull matcher_;
+  mutable absl::flat_hash_set<cel::Attribute, AttributeHash>
+      interned_attributes_;
 };
 
 }  // namespace google::api::expr::runtime
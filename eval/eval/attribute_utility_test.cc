@@ -23,6 +23,7 @@ using ::cel::AttributeSet;
 
 using ::cel::UnknownValue;
 using ::cel::Value;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::SizeIs;
 using ::testing::UnorderedPointwise;
@@ -167,6 +168,47 @@ TEST_F(AttributeUtilityTest, CreateUnknownSet) {
   EXPECT_EQ(elem, "destination.ip");
 }
 
+TEST_F(AttributeUtilityTest, InternsEqualAttributes) {
+  std::vector<CelAttributePattern> empty_patterns;
+  AttributeUtility utility(empty_patterns, empty_patterns);
+
+  // Equal attributes built separately, as by two selections of the same path.
+  AttributeTrail trail0 = AttributeTrail("destination")
+                              .Step(cel::AttributeQualifier::OfString("ip"));
+  AttributeTrail trail1 = AttributeTrail("destination")
+                              .Step(cel::AttributeQualifier::OfString("ip"));
+
+  UnknownValue set0 = utility.CreateUnknownSet(trail0.attribute());
+  UnknownValue set1 = utility.CreateUnknownSet(trail1.attribute());
+  ASSERT_THAT(set0.attribute_set(), SizeIs(1));
+  ASSERT_THAT(set1.attribute_set(), SizeIs(1));
+  EXPECT_EQ(set0.attribute_set().begin()->variable_name().data(),
+            set1.attribute_set().begin()->variable_name().data());
+}
+
+TEST_F(AttributeUtilityTest, MergeUnknownsSortsAndDeduplicates) {
+  std::vector<CelAttributePattern> empty_patterns;
+  AttributeUtility utility(empty_patterns, empty_patterns);
+
+  UnknownValue unknown0 = utility.CreateUnknownSet(cel::Attribute("b"));
+  UnknownValue unknown1 = utility.CreateUnknownSet(cel::Attribute("a"));
+  UnknownValue unknown2 = utility.MergeUnknownValues(unknown0, unknown1);
+  std::vector<cel::Value> values = {unknown0, unknown2, cel::IntValue(1),
+                                    unknown1};
+
+  absl::optional<UnknownValue> merged = utility.MergeUnknowns(values);
+  ASSERT_TRUE(merged.has_value());
+  EXPECT_THAT(merged->attribute_set(),
+              ElementsAre(cel::Attribute("a"), cel::Attribute("b")));
+  EXPECT_EQ(merged->attribute_set(), unknown2.attribute_set());
+
+  // A single unknown is forwarded as is.
+  values = {cel::IntValue(1), unknown0};
+  merged = utility.MergeUnknowns(values);
+  ASSERT_TRUE(merged.has_value());
+  EXPECT_EQ(merged->attribute_set(), unknown0.attribute_set());
+}
+
 class FakeMatcher : public cel::runtime_internal::AttributeMatcher {
  private:
   using MatchResult = cel::runtime_internal::AttributeMatcher::MatchResult;
@@ -0,0 +1,197 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/collect_results_step.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/types/span.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/status_macros.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::CustomListValue;
+using ::cel::CustomListValueInterface;
+using ::cel::NativeTypeId;
+using ::cel::Value;
+
+// List holding the results verbatim. Unlike lists built with
+// ListValueBuilder, elements may be errors or unknowns.
+class ResultsListValue final : public CustomListValueInterface {
+ public:
+  explicit ResultsListValue(std::vector<Value> elements)
+      : elements_(std::move(elements)) {}
+
+  static CustomListValue Create(std::vector<Value> elements,
+                                google::protobuf::Arena* absl_nonnull arena) {
+    return CustomListValue(
+        google::protobuf::Arena::Create<ResultsListValue>(arena, std::move(elements)),
+        arena);
+  }
+
+  std::string DebugString() const override {
+    return absl::StrCat(
+        "[",
+        absl::StrJoin(elements_, ", ",
+                      [](std::string* out, const Value& value) {
+                        out->append(value.DebugString());
+                      }),
+        "]");
+  }
+
+  absl::Status ConvertToJsonArray(
+      const google::protobuf::DescriptorPool* absl_nonnull,
+      google::protobuf::MessageFactory* absl_nonnull,
+      google::protobuf::Message* absl_nonnull) const override {
+    return absl::FailedPreconditionError(
+        "#collect_results list is not convertible to JSON");
+  }
+
+  size_t Size() const override { return elements_.size(); }
+
+  CustomListValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    std::vector<Value> elements;
+    elements.reserve(elements_.size());
+    for (const Value& element : elements_) {
+      elements.push_back(element.Clone(arena));
+    }
+    return Create(std::move(elements), arena);
+  }
+
+ private:
+  absl::Status Get(size_t index,
+                   const google::protobuf::DescriptorPool* absl_nonnull,
+                   google::protobuf::MessageFactory* absl_nonnull,
+                   google::protobuf::Arena* absl_nonnull,
+                   Value* absl_nonnull result) const override {
+    if (index >= elements_.size()) {
+      *result = cel::IndexOutOfBoundsError(index);
+      return absl::OkStatus();
+    }
+    *result = elements_[index];
+    return absl::OkStatus();
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<ResultsListValue>();
+  }
+
+  std::vector<Value> elements_;
+};
+
+class CollectResultsStep final : public ExpressionStepBase {
+ public:
+  CollectResultsStep(size_t result_count, int64_t expr_id)
+      : ExpressionStepBase(expr_id), result_count_(result_count) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    frame->EndIsolatedSteps();
+    if (!frame->value_stack().HasEnough(result_count_)) {
+      return absl::InternalError("CollectResultsStep: stack underflow");
+    }
+    absl::Span<const Value> args =
+        frame->value_stack().GetSpan(result_count_);
+    frame->value_stack().PopAndPush(
+        result_count_,
+        ResultsListValue::Create(std::vector<Value>(args.begin(), args.end()),
+                                 frame->arena()));
+    return absl::OkStatus();
+  }
+
+ private:
+  const size_t result_count_;
+};
+
+// Precedes the steps of each operand of the stack machine `#collect_results`,
+// so that the operand is evaluated as if by a separate program.
+class CollectResultsOperandStep final : public ExpressionStepBase {
+ public:
+  CollectResultsOperandStep(size_t step_count, int64_t expr_id)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/false),
+        step_count_(step_count) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    frame->ResetIterations();
+    frame->BeginIsolatedSteps(step_count_);
+    return absl::OkStatus();
+  }
+
+ private:
+  const size_t step_count_;
+};
+
+class DirectCollectResultsStep final : public DirectExpressionStep {
+ public:
+  DirectCollectResultsStep(
+      std::vector<std::unique_ptr<DirectExpressionStep>> deps, int64_t expr_id)
+      : DirectExpressionStep(expr_id), deps_(std::move(deps)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute) const override {
+    std::vector<Value> results(deps_.size());
+    AttributeTrail ignored;
+    for (size_t i = 0; i < deps_.size(); ++i) {
+      // Each operand is evaluated as if by a separate program.
+      frame.ResetIterations();
+      if (absl::Status status = deps_[i]->Evaluate(frame, results[i], ignored);
+          !status.ok()) {
+        results[i] = cel::ErrorValue(std::move(status));
+      }
+    }
+    result = ResultsListValue::Create(std::move(results), frame.arena());
+    return absl::OkStatus();
+  }
+
+ private:
+  std::vector<std::unique_ptr<DirectExpressionStep>> deps_;
+};
+
+}  // namespace
+
+std::unique_ptr<ExpressionStep> CreateCollectResultsStep(size_t result_count,
+                                                         int64_t expr_id) {
+  return std::make_unique<CollectResultsStep>(result_count, expr_id);
+}
+
+std::unique_ptr<ExpressionStep> CreateCollectResultsOperandStep(
+    size_t step_count, int64_t expr_id) {
+  return std::make_unique<CollectResultsOperandStep>(step_count, expr_id);
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectCollectResultsStep(
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps, int64_t expr_id) {
+  return std::make_unique<DirectCollectResultsStep>(std::move(deps), expr_id);
+}
+
+}  // namespace google::api::expr::runtime
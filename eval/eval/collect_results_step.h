@@ -0,0 +1,57 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Program steps for the runtime-only `#collect_results` function.
+//
+// The step gathers the values of its arguments into a list without the error
+// and unknown propagation of list literals, so that several independent
+// expressions can be evaluated by one program and their results, including
+// errors and unknowns, read back individually.
+//
+// The resulting list is an internal value. It may contain error and unknown
+// elements and must not be exposed to CEL expressions.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_COLLECT_RESULTS_STEP_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_COLLECT_RESULTS_STEP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Creates a step that pops `result_count` values and pushes the internal
+// results list.
+std::unique_ptr<ExpressionStep> CreateCollectResultsStep(size_t result_count,
+                                                         int64_t expr_id);
+
+// Creates a step preceding the `step_count` steps of an operand. The operand
+// gets its own iteration budget, and a non-OK status from its steps is
+// collected as an error value instead of failing the evaluation.
+std::unique_ptr<ExpressionStep> CreateCollectResultsOperandStep(
+    size_t step_count, int64_t expr_id);
+
+// Creates a recursive step that evaluates `deps` in order and returns the
+// internal results list. Like the stack machine steps, each operand gets its
+// own iteration budget and a non-OK status is collected as an error value.
+std::unique_ptr<DirectExpressionStep> CreateDirectCollectResultsStep(
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps, int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_COLLECT_RESULTS_STEP_H_
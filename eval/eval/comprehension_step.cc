@@ -1,9 +1,12 @@
 #include "eval/eval/comprehension_step.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/casts.h"
@@ -12,12 +15,14 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "base/attribute.h"
 #include "common/casting.h"
 #include "common/value.h"
 #include "common/value_kind.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/comprehension_slots.h"
+#include "eval/eval/comprehension_worker_pool.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
@@ -35,6 +40,7 @@ enum class IterableKind {
 using ::cel::AttributeQualifier;
 using ::cel::Cast;
 using ::cel::InstanceOf;
+using ::cel::ListValue;
 using ::cel::UnknownValue;
 using ::cel::Value;
 using ::cel::ValueIterator;
@@ -86,7 +92,7 @@ class ComprehensionDirectStep final : public DirectExpressionStep {
       std::unique_ptr<DirectExpressionStep> loop_step,
       std::unique_ptr<DirectExpressionStep> condition_step,
       std::unique_ptr<DirectExpressionStep> result_step, bool shortcircuiting,
-      int64_t expr_id)
+      absl::optional<ParallelComprehensionKind> parallel_kind, int64_t expr_id)
       : DirectExpressionStep(expr_id),
         iter_slot_(iter_slot),
         iter2_slot_(iter2_slot),
@@ -96,7 +102,8 @@ class ComprehensionDirectStep final : public DirectExpressionStep {
         loop_step_(std::move(loop_step)),
         condition_(std::move(condition_step)),
         result_step_(std::move(result_step)),
-        shortcircuiting_(shortcircuiting) {}
+        shortcircuiting_(shortcircuiting),
+        parallel_kind_(parallel_kind) {}
 
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& trail) const override {
@@ -125,6 +132,30 @@ class ComprehensionDirectStep final : public DirectExpressionStep {
   absl::Status Evaluate2(ExecutionFrameBase& frame, Value& result,
                          AttributeTrail& trail) const;
 
+  // The outcome of evaluating the loop over one chunk of the range.
+  struct Chunk {
+    absl::Status status;
+    // The chunk's accumulator, or the comprehension result if `skip_result`.
+    Value result;
+    // The chunk decided the result, so later chunks can't affect it.
+    bool decided = false;
+    // The loop condition produced `result`, which is the comprehension result
+    // without evaluating the result step.
+    bool skip_result = false;
+    int iterations = 0;
+  };
+
+  absl::Status EvaluateParallel(ExecutionFrameBase& frame,
+                                const ListValue& range, size_t size,
+                                Value& result, AttributeTrail& trail) const;
+
+  // Evaluates the loop over `range[begin, end)` starting from a fresh
+  // accumulator. Stops early once `stop_chunk` is less than `chunk_index`.
+  absl::Status EvaluateChunk(ExecutionFrameBase& frame, const ListValue& range,
+                             size_t begin, size_t end, size_t chunk_index,
+                             const std::atomic<size_t>& stop_chunk,
+                             Chunk& chunk) const;
+
   const size_t iter_slot_;
   const size_t iter2_slot_;
   const size_t accu_slot_;
@@ -134,6 +165,7 @@ class ComprehensionDirectStep final : public DirectExpressionStep {
   const std::unique_ptr<DirectExpressionStep> condition_;
   const std::unique_ptr<DirectExpressionStep> result_step_;
   const bool shortcircuiting_;
+  const absl::optional<ParallelComprehensionKind> parallel_kind_;
 };
 
 absl::Status ComprehensionDirectStep::Evaluate1(ExecutionFrameBase& frame,
@@ -151,6 +183,15 @@ absl::Status ComprehensionDirectStep::Evaluate1(ExecutionFrameBase& frame,
     }
   }
 
+  if (parallel_kind_.has_value() && range.IsList() &&
+      frame.parallel_comprehensions_enabled()) {
+    CEL_ASSIGN_OR_RETURN(size_t size, range.GetList().Size());
+    if (size >= static_cast<size_t>(std::max(
+                    frame.options().parallel_comprehension_min_size, 1))) {
+      return EvaluateParallel(frame, range.GetList(), size, result, trail);
+    }
+  }
+
   absl_nullability_unknown ValueIteratorPtr range_iter;
   IterableKind iterable_kind;
   switch (range.kind()) {
@@ -324,6 +365,201 @@ absl::StatusOr<bool> ComprehensionDirectStep::Evaluate1Known(
   return false;
 }
 
+absl::Status ComprehensionDirectStep::EvaluateParallel(
+    ExecutionFrameBase& frame, const ListValue& range, size_t size,
+    Value& result, AttributeTrail& trail) const {
+  const size_t parallelism =
+      static_cast<size_t>(frame.options().comprehension_parallelism);
+  // More chunks than threads, so threads that finish early pick up the
+  // remaining work. The pool may lend fewer workers than requested, down to
+  // none, in which case the calling thread evaluates every chunk.
+  const size_t chunk_count = std::min(size, parallelism * 4);
+  std::vector<Chunk> chunks(chunk_count);
+  std::atomic<size_t> next_chunk(0);
+  // Index of the first chunk known to decide the result. Chunks after it
+  // need not run.
+  std::atomic<size_t> stop_chunk(chunk_count);
+
+  auto worker = [&]() {
+    for (size_t i = next_chunk.fetch_add(1); i < chunk_count;
+         i = next_chunk.fetch_add(1)) {
+      if (i > stop_chunk.load(std::memory_order_relaxed)) {
+        break;
+      }
+      ComprehensionSlots slots(frame.comprehension_slots().size());
+      for (size_t slot = 0; slot < slots.size(); ++slot) {
+        ComprehensionSlots::Slot* parent_slot =
+            frame.comprehension_slots().Get(slot);
+        if (parent_slot->Has()) {
+          slots.Set(slot, parent_slot->value(), parent_slot->attribute());
+        }
+      }
+      ExecutionFrameBase chunk_frame(frame, slots);
+      Chunk& chunk = chunks[i];
+      chunk.status =
+          EvaluateChunk(chunk_frame, range, size * i / chunk_count,
+                        size * (i + 1) / chunk_count, i, stop_chunk, chunk);
+      chunk.iterations = chunk_frame.iterations();
+      if (!chunk.status.ok() || chunk.decided) {
+        size_t stop = stop_chunk.load(std::memory_order_relaxed);
+        while (i < stop && !stop_chunk.compare_exchange_weak(stop, i)) {
+        }
+      }
+    }
+  };
+
+  ComprehensionWorkerPool::Get().Run(std::min(parallelism, chunk_count),
+                                      worker);
+
+  // Merge in range order, as if the chunks had been evaluated sequentially.
+  const size_t last_chunk = std::min(stop_chunk.load(), chunk_count - 1);
+  absl::optional<Value> error;
+  Value accu;
+  cel::ListValueBuilderPtr builder;
+  switch (*parallel_kind_) {
+    case ParallelComprehensionKind::kAll:
+      accu = cel::TrueValue();
+      break;
+    case ParallelComprehensionKind::kExists:
+      accu = cel::FalseValue();
+      break;
+    case ParallelComprehensionKind::kList:
+      builder = cel::NewListValueBuilder(frame.arena());
+      break;
+  }
+  for (size_t i = 0; i <= last_chunk; ++i) {
+    Chunk& chunk = chunks[i];
+    CEL_RETURN_IF_ERROR(frame.IncrementIterations(chunk.iterations));
+    CEL_RETURN_IF_ERROR(chunk.status);
+    if (chunk.skip_result) {
+      result = std::move(chunk.result);
+      return absl::OkStatus();
+    }
+    if (builder == nullptr && chunk.result.IsBool()) {
+      // Folds with `&&` for all() and `||` for exists(): the absorbing value
+      // decides the result regardless of earlier errors, and the other value
+      // leaves the accumulator unchanged.
+      if (chunk.result.GetBool() != accu.GetBool()) {
+        accu = std::move(chunk.result);
+        error = absl::nullopt;
+        break;
+      }
+      continue;
+    }
+    if (chunk.result.IsError()) {
+      // The first error is propagated through the remaining loop steps.
+      if (!error.has_value()) {
+        error = std::move(chunk.result);
+      }
+      continue;
+    }
+    if (builder != nullptr && !error.has_value()) {
+      const ListValue& elements = chunk.result.GetList();
+      CEL_ASSIGN_OR_RETURN(size_t element_count, elements.Size());
+      builder->Reserve(builder->Size() + element_count);
+      for (size_t j = 0; j < element_count; ++j) {
+        Value element;
+        CEL_RETURN_IF_ERROR(elements.Get(j, frame.descriptor_pool(),
+                                         frame.message_factory(),
+                                         frame.arena(), &element));
+        CEL_RETURN_IF_ERROR(builder->Add(std::move(element)));
+      }
+    }
+  }
+  if (error.has_value()) {
+    accu = std::move(*error);
+  } else if (builder != nullptr) {
+    accu = std::move(*builder).Build();
+  }
+
+  ComprehensionSlots::Slot* accu_slot =
+      frame.comprehension_slots().Get(accu_slot_);
+  ABSL_DCHECK(accu_slot != nullptr);
+  accu_slot->Set(std::move(accu));
+  CEL_RETURN_IF_ERROR(result_step_->Evaluate(frame, result, trail));
+  accu_slot->Clear();
+  return absl::OkStatus();
+}
+
+absl::Status ComprehensionDirectStep::EvaluateChunk(
+    ExecutionFrameBase& frame, const ListValue& range, size_t begin,
+    size_t end, size_t chunk_index, const std::atomic<size_t>& stop_chunk,
+    Chunk& chunk) const {
+  ComprehensionSlots::Slot* accu_slot =
+      frame.comprehension_slots().Get(accu_slot_);
+  ABSL_DCHECK(accu_slot != nullptr);
+
+  {
+    Value accu_init;
+    AttributeTrail accu_init_attr;
+    CEL_RETURN_IF_ERROR(accu_init_->Evaluate(frame, accu_init, accu_init_attr));
+    accu_slot->Set(std::move(accu_init), std::move(accu_init_attr));
+  }
+
+  ComprehensionSlots::Slot* iter_slot =
+      frame.comprehension_slots().Get(iter_slot_);
+  ABSL_DCHECK(iter_slot != nullptr);
+  iter_slot->Set();
+
+  Value condition;
+  AttributeTrail condition_attr;
+
+  for (size_t i = begin; i < end; ++i) {
+    if (chunk_index > stop_chunk.load(std::memory_order_relaxed)) {
+      // An earlier chunk decided the result.
+      return absl::OkStatus();
+    }
+    CEL_RETURN_IF_ERROR(range.Get(i, frame.descriptor_pool(),
+                                  frame.message_factory(), frame.arena(),
+                                  iter_slot->mutable_value()));
+    CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+
+    // Evaluate the loop condition.
+    CEL_RETURN_IF_ERROR(condition_->Evaluate(frame, condition, condition_attr));
+
+    switch (condition.kind()) {
+      case ValueKind::kBool:
+        break;
+      case ValueKind::kError:
+        ABSL_FALLTHROUGH_INTENDED;
+      case ValueKind::kUnknown:
+        chunk.result = std::move(condition);
+        chunk.decided = chunk.skip_result = true;
+        return absl::OkStatus();
+      default:
+        chunk.result =
+            cel::ErrorValue(CreateNoMatchingOverloadError("<loop_condition>"));
+        chunk.decided = chunk.skip_result = true;
+        return absl::OkStatus();
+    }
+
+    if (shortcircuiting_ && !absl::implicit_cast<bool>(condition.GetBool())) {
+      chunk.decided = true;
+      break;
+    }
+
+    // Evaluate the loop step.
+    CEL_RETURN_IF_ERROR(loop_step_->Evaluate(frame, *accu_slot->mutable_value(),
+                                             *accu_slot->mutable_attribute()));
+  }
+  chunk.result = std::move(*accu_slot->mutable_value());
+  // The loop condition only sees the accumulator before the next element, so
+  // an accumulator decided by the chunk's last element is checked here.
+  if (chunk.result.IsBool()) {
+    switch (*parallel_kind_) {
+      case ParallelComprehensionKind::kAll:
+        chunk.decided = !chunk.result.GetBool();
+        break;
+      case ParallelComprehensionKind::kExists:
+        chunk.decided = chunk.result.GetBool();
+        break;
+      case ParallelComprehensionKind::kList:
+        break;
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::Status ComprehensionDirectStep::Evaluate2(ExecutionFrameBase& frame,
                                                 Value& result,
                                                 AttributeTrail& trail) const {
@@ -674,7 +910,21 @@ std::unique_ptr<DirectExpressionStep> CreateDirectComprehensionStep(
   return std::make_unique<ComprehensionDirectStep>(
       iter_slot, iter2_slot, accu_slot, std::move(range), std::move(accu_init),
       std::move(loop_step), std::move(condition_step), std::move(result_step),
-      shortcircuiting, expr_id);
+      shortcircuiting, /*parallel_kind=*/absl::nullopt, expr_id);
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelComprehensionStep(
+    ParallelComprehensionKind kind, size_t iter_slot, size_t accu_slot,
+    std::unique_ptr<DirectExpressionStep> range,
+    std::unique_ptr<DirectExpressionStep> accu_init,
+    std::unique_ptr<DirectExpressionStep> loop_step,
+    std::unique_ptr<DirectExpressionStep> condition_step,
+    std::unique_ptr<DirectExpressionStep> result_step, bool shortcircuiting,
+    int64_t expr_id) {
+  return std::make_unique<ComprehensionDirectStep>(
+      iter_slot, /*iter2_slot=*/iter_slot, accu_slot, std::move(range),
+      std::move(accu_init), std::move(loop_step), std::move(condition_step),
+      std::move(result_step), shortcircuiting, kind, expr_id);
 }
 
 std::unique_ptr<ExpressionStep> CreateComprehensionFinishStep(size_t accu_slot,
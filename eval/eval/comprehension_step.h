@@ -108,6 +108,30 @@ std::unique_ptr<DirectExpressionStep> CreateDirectComprehensionStep(
     std::unique_ptr<DirectExpressionStep> result_step, bool shortcircuiting,
     int64_t expr_id);
 
+// Standard macro shapes that support parallel evaluation. The loop step only
+// combines the accumulator with a value computed from the current element, so
+// the range can be split into chunks whose accumulators are merged in order.
+enum class ParallelComprehensionKind {
+  // all(): `@result && <pred>`, stopping at false.
+  kAll,
+  // exists(): `@result || <pred>`, stopping at true.
+  kExists,
+  // map() and filter(): appends to a list accumulator.
+  kList,
+};
+
+// Creates a step for executing a comprehension of the given macro shape, that
+// is evaluated in parallel over large lists when the frame allows it. See
+// `cel::RuntimeOptions::comprehension_parallelism`.
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelComprehensionStep(
+    ParallelComprehensionKind kind, size_t iter_slot, size_t accu_slot,
+    std::unique_ptr<DirectExpressionStep> range,
+    std::unique_ptr<DirectExpressionStep> accu_init,
+    std::unique_ptr<DirectExpressionStep> loop_step,
+    std::unique_ptr<DirectExpressionStep> condition_step,
+    std::unique_ptr<DirectExpressionStep> result_step, bool shortcircuiting,
+    int64_t expr_id);
+
 // Creates a cleanup step for the comprehension.
 // Removes the comprehension context then pushes the 'result' sub expression to
 // the top of the stack.
@@ -1,16 +1,23 @@
 #include "eval/eval/comprehension_step.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
 #include "cel/expr/syntax.pb.h"
 #include "google/protobuf/struct.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "base/type_provider.h"
 #include "common/expr.h"
 #include "common/value.h"
@@ -27,14 +34,20 @@
 #include "eval/public/cel_attribute.h"
 #include "eval/public/cel_value.h"
 #include "eval/public/structs/cel_proto_wrapper.h"
+#include "extensions/protobuf/runtime_adapter.h"
 #include "internal/status_macros.h"
 #include "internal/testing.h"
 #include "internal/testing_descriptor_pool.h"
 #include "internal/testing_message_factory.h"
+#include "parser/parser.h"
 #include "runtime/activation.h"
+#include "runtime/function_adapter.h"
 #include "runtime/internal/runtime_env_testing.h"
 #include "runtime/internal/runtime_type_provider.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
 #include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
 #include "google/protobuf/arena.h"
 
 namespace google::api::expr::runtime {
@@ -48,7 +61,10 @@ using ::cel::IntValue;
 using ::cel::TypeProvider;
 using ::cel::Value;
 using ::cel::runtime_internal::NewTestingRuntimeEnv;
+using ::cel::expr::ParsedExpr;
+using ::cel::extensions::ProtobufRuntimeAdapter;
 using ::cel::test::BoolValueIs;
+using ::google::api::expr::parser::Parse;
 using ::google::protobuf::Struct;
 using ::google::protobuf::Arena;
 using ::testing::_;
@@ -488,5 +504,163 @@ TEST_F(DirectComprehensionTest, Exhaustive) {
   EXPECT_THAT(result, BoolValueIs(false));
 }
 
+class ParallelComprehensionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    options_.max_recursion_depth = -1;
+    options_.comprehension_parallelism = 4;
+    options_.parallel_comprehension_min_size = 8;
+    options_.comprehension_max_iterations = 0;
+  }
+
+  // Evaluates `expr` with `xs` bound to the list [0, 1000).
+  absl::StatusOr<Value> Evaluate(absl::string_view expr) {
+    CEL_ASSIGN_OR_RETURN(
+        cel::RuntimeBuilder builder,
+        cel::CreateStandardRuntimeBuilder(
+            cel::internal::GetTestingDescriptorPool(), options_));
+    CEL_RETURN_IF_ERROR(
+        cel::NullaryFunctionAdapter<bool>::RegisterGlobalOverload(
+            "await_peer", [this]() { return AwaitPeer(); },
+            builder.function_registry()));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expr));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, parsed_expr));
+
+    auto list_builder = cel::NewListValueBuilder(&arena_);
+    for (int64_t i = 0; i < 1000; ++i) {
+      CEL_RETURN_IF_ERROR(list_builder->Add(IntValue(i)));
+    }
+    cel::Activation activation;
+    activation.InsertOrAssignValue("xs", std::move(*list_builder).Build());
+    return program->Evaluate(&arena_, activation);
+  }
+
+  // Returns whether another thread called this function before a timeout.
+  bool AwaitPeer() {
+    absl::MutexLock lock(mutex_);
+    threads_.insert(std::this_thread::get_id());
+    return mutex_.AwaitWithTimeout(
+        absl::Condition(
+            +[](absl::flat_hash_set<std::thread::id>* threads) {
+              return threads->size() >= 2;
+            },
+            &threads_),
+        absl::Seconds(30));
+  }
+
+  cel::RuntimeOptions options_;
+  Arena arena_;
+  absl::Mutex mutex_;
+  absl::flat_hash_set<std::thread::id> threads_ ABSL_GUARDED_BY(mutex_);
+};
+
+TEST_F(ParallelComprehensionTest, EvaluatesChunksConcurrently) {
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate("xs.all(x, await_peer())"));
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
+TEST_F(ParallelComprehensionTest, StackMachineEvaluatesChunksConcurrently) {
+  options_.max_recursion_depth = 0;
+  ASSERT_OK_AND_ASSIGN(
+      Value result, Evaluate("xs.size() == 1000 && xs.all(x, await_peer())"));
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
+TEST_F(ParallelComprehensionTest, MatchesSequentialResults) {
+  for (absl::string_view expr : {
+           "xs.all(x, x >= 0)",
+           "!xs.all(x, x < 999)",
+           "xs.exists(x, x == 997)",
+           "!xs.exists(x, x < 0)",
+           "xs.map(x, x) == xs",
+           "xs.map(x, x * 2)[999] == 1998",
+           "xs.filter(x, x % 3 == 0).size() == 334",
+           "xs.map(x, x % 2 == 0, x + 1)[499] == 999",
+           "xs.exists(x, [1, 2].all(y, x + y >= 1000))",
+       }) {
+    SCOPED_TRACE(expr);
+    ASSERT_OK_AND_ASSIGN(Value result, Evaluate(expr));
+    EXPECT_THAT(result, BoolValueIs(true));
+  }
+}
+
+TEST_F(ParallelComprehensionTest, StackMachineMatchesSequentialResults) {
+  for (int max_recursion_depth : {0, cel::kAdaptiveRecursionDepth}) {
+    options_.max_recursion_depth = max_recursion_depth;
+    for (absl::string_view expr : {
+             "xs.all(x, x >= 0) && xs.size() == 1000",
+             "!xs.exists(x, x < 0) && xs.map(x, x * 2)[999] == 1998",
+             "xs.filter(x, x % 3 == 0).size() == 334",
+             "xs.exists(x, [1, 2].all(y, x + y >= 1000))",
+             "[xs].all(ys, ys.all(x, x >= 0))",
+         }) {
+      SCOPED_TRACE(absl::StrCat(max_recursion_depth, ": ", expr));
+      ASSERT_OK_AND_ASSIGN(Value result, Evaluate(expr));
+      EXPECT_THAT(result, BoolValueIs(true));
+    }
+  }
+}
+
+TEST_F(ParallelComprehensionTest, DecidingValueOverridesErrors) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate("xs.all(x, x != 900 && 1 / (x - 500) != 7)"));
+  EXPECT_THAT(result, BoolValueIs(false));
+
+  ASSERT_OK_AND_ASSIGN(result, Evaluate("xs.all(x, 1 / (x - 500) != 7)"));
+  ASSERT_TRUE(result.IsError());
+  EXPECT_THAT(result.GetError().ToStatus(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  ASSERT_OK_AND_ASSIGN(result, Evaluate("xs.map(x, 1 / (x - 500))"));
+  EXPECT_TRUE(result.IsError());
+}
+
+TEST_F(ParallelComprehensionTest, DecidingValueEndsChunk) {
+  // The range is split into 16 chunks: [0, 62), [62, 125), ..., [937, 1000).
+  for (absl::string_view expr : {
+           "!xs.all(x, x != 61)",
+           "!xs.all(x, x != 999)",
+           "xs.exists(x, x == 61)",
+           "xs.exists(x, x == 999)",
+           "!xs.all(x, 1 / x != 7 && x != 124)",
+           "xs.exists(x, 1 / x == 7 || x == 124)",
+       }) {
+    SCOPED_TRACE(expr);
+    ASSERT_OK_AND_ASSIGN(Value result, Evaluate(expr));
+    EXPECT_THAT(result, BoolValueIs(true));
+  }
+}
+
+TEST_F(ParallelComprehensionTest, WithoutShortCircuiting) {
+  options_.short_circuiting = false;
+  for (absl::string_view expr : {
+           "!xs.all(x, x != 500)",
+           "xs.all(x, x >= 0)",
+           "xs.exists(x, x == 500)",
+           "!xs.exists(x, x < 0)",
+           "!xs.all(x, 1 / x != 7 && x != 500)",
+           "xs.filter(x, x % 3 == 0).size() == 334",
+       }) {
+    SCOPED_TRACE(expr);
+    ASSERT_OK_AND_ASSIGN(Value result, Evaluate(expr));
+    EXPECT_THAT(result, BoolValueIs(true));
+  }
+}
+
+TEST_F(ParallelComprehensionTest, IterationBudgetCountsSequentialIterations) {
+  options_.comprehension_max_iterations = 500;
+
+  // Short-circuits long before the budget is exhausted, even though other
+  // chunks may have been evaluated.
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate("xs.all(x, x < 10)"));
+  EXPECT_THAT(result, BoolValueIs(false));
+
+  EXPECT_THAT(Evaluate("xs.all(x, x >= 0)"),
+              StatusIs(absl::StatusCode::kInternal,
+                       testing::HasSubstr("Iteration budget exceeded")));
+}
+
 }  // namespace
 }  // namespace google::api::expr::runtime
@@ -0,0 +1,114 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/comprehension_worker_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+
+namespace google::api::expr::runtime {
+
+ComprehensionWorkerPool& ComprehensionWorkerPool::Get() {
+  static absl::NoDestructor<ComprehensionWorkerPool> pool(
+      std::max<size_t>(std::thread::hardware_concurrency(), 1));
+  return *pool;
+}
+
+ComprehensionWorkerPool::ComprehensionWorkerPool(size_t max_workers)
+    : max_workers_(max_workers) {}
+
+ComprehensionWorkerPool::~ComprehensionWorkerPool() {
+  std::vector<std::thread> workers;
+  {
+    absl::MutexLock lock(mutex_);
+    shutdown_ = true;
+    work_available_.SignalAll();
+    workers = std::move(workers_);
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void ComprehensionWorkerPool::Run(size_t parallelism,
+                                  absl::FunctionRef<void()> task) {
+  Job job{task, 0};
+  if (parallelism > 1) {
+    absl::MutexLock lock(mutex_);
+    if (!shutdown_ && outstanding_ < max_workers_) {
+      job.unclaimed = std::min(parallelism - 1, max_workers_ - outstanding_);
+      outstanding_ += job.unclaimed;
+      jobs_.push_back(&job);
+      while (idle_workers_ < outstanding_ && workers_.size() < max_workers_) {
+        ++idle_workers_;
+        workers_.emplace_back([this]() { WorkerLoop(); });
+      }
+      work_available_.SignalAll();
+    }
+  }
+
+  task();
+
+  if (parallelism > 1) {
+    // Withdraw the part of the request no worker picked up, and wait for the
+    // workers that did.
+    absl::MutexLock lock(mutex_);
+    if (job.unclaimed > 0) {
+      outstanding_ -= job.unclaimed;
+      job.unclaimed = 0;
+      jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+    }
+    while (job.active > 0) {
+      job_done_.Wait(&mutex_);
+    }
+  }
+}
+
+void ComprehensionWorkerPool::WorkerLoop() {
+  mutex_.Lock();
+  while (true) {
+    while (jobs_.empty() && !shutdown_) {
+      work_available_.Wait(&mutex_);
+    }
+    if (jobs_.empty()) {
+      break;
+    }
+    Job* job = jobs_.front();
+    if (--job->unclaimed == 0) {
+      jobs_.pop_front();
+    }
+    --outstanding_;
+    --idle_workers_;
+    ++job->active;
+    mutex_.Unlock();
+    job->task();
+    mutex_.Lock();
+    ++idle_workers_;
+    // The submitting thread may destroy the job as soon as it observes no
+    // active workers.
+    if (--job->active == 0) {
+      job_done_.SignalAll();
+    }
+  }
+  mutex_.Unlock();
+}
+
+}  // namespace google::api::expr::runtime
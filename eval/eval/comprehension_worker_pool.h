@@ -0,0 +1,82 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_COMPREHENSION_WORKER_POOL_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_COMPREHENSION_WORKER_POOL_H_
+
+#include <cstddef>
+#include <deque>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+
+namespace google::api::expr::runtime {
+
+// Bounded pool of threads shared by parallel comprehension evaluation.
+//
+// Threads are started lazily, up to `max_workers`, and kept for the lifetime
+// of the pool. The calling thread always takes part in the work it submits,
+// so a submission makes progress even when every worker is busy, including
+// when it is made from a worker by a nested comprehension.
+class ComprehensionWorkerPool final {
+ public:
+  // Returns the process-wide pool, sized to the hardware concurrency.
+  static ComprehensionWorkerPool& Get();
+
+  explicit ComprehensionWorkerPool(size_t max_workers);
+
+  // Waits for the workers to exit. Must not be called while `Run` is.
+  ~ComprehensionWorkerPool();
+
+  ComprehensionWorkerPool(const ComprehensionWorkerPool&) = delete;
+  ComprehensionWorkerPool& operator=(const ComprehensionWorkerPool&) = delete;
+
+  // Calls `task` on the calling thread and concurrently on up to
+  // `parallelism - 1` workers, and returns once every call has returned.
+  // `task` should claim work from shared state until none is left, since it
+  // may be called fewer times than requested: workers are only borrowed while
+  // fewer than `max_workers` are requested across all pending calls, and a
+  // request not yet picked up when the calling thread's `task` returns is
+  // withdrawn.
+  void Run(size_t parallelism, absl::FunctionRef<void()> task);
+
+ private:
+  struct Job {
+    absl::FunctionRef<void()> task;
+    // Number of workers that may still pick up the job.
+    size_t unclaimed;
+    // Number of workers running the job.
+    size_t active = 0;
+  };
+
+  void WorkerLoop();
+
+  const size_t max_workers_;
+  absl::Mutex mutex_;
+  absl::CondVar work_available_;
+  absl::CondVar job_done_;
+  std::deque<Job*> jobs_ ABSL_GUARDED_BY(mutex_);
+  // Sum of `unclaimed` over `jobs_`.
+  size_t outstanding_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::vector<std::thread> workers_ ABSL_GUARDED_BY(mutex_);
+  size_t idle_workers_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_COMPREHENSION_WORKER_POOL_H_
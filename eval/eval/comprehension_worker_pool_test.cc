@@ -0,0 +1,85 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/comprehension_worker_pool.h"
+
+#include <atomic>
+
+#include "absl/synchronization/mutex.h"
+#include "internal/testing.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+TEST(ComprehensionWorkerPoolTest, RunsOnCallerAndWorker) {
+  ComprehensionWorkerPool pool(/*max_workers=*/1);
+  absl::Mutex mutex;
+  int calls = 0;
+
+  pool.Run(2, [&]() {
+    absl::MutexLock lock(mutex);
+    ++calls;
+    // The request is only withdrawn once the caller returns, so the worker is
+    // guaranteed to join.
+    mutex.Await(absl::Condition(
+        +[](int* calls) { return *calls == 2; }, &calls));
+  });
+
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(ComprehensionWorkerPoolTest, RunsOnCallerWithoutWorkers) {
+  ComprehensionWorkerPool pool(/*max_workers=*/0);
+  int calls = 0;
+
+  pool.Run(4, [&]() { ++calls; });
+
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(ComprehensionWorkerPoolTest, NestedRunCompletes) {
+  ComprehensionWorkerPool pool(/*max_workers=*/1);
+  std::atomic<int> inner_calls(0);
+  std::atomic<int> outer_calls(0);
+
+  pool.Run(2, [&]() {
+    ++outer_calls;
+    // The only worker may be running the outer task, in which case the
+    // nested call runs on its caller alone.
+    pool.Run(2, [&]() { ++inner_calls; });
+  });
+
+  EXPECT_GE(outer_calls.load(), 1);
+  EXPECT_GE(inner_calls.load(), outer_calls.load());
+}
+
+TEST(ComprehensionWorkerPoolTest, CallerClaimsAllWork) {
+  ComprehensionWorkerPool pool(/*max_workers=*/4);
+  std::atomic<int> next(0);
+  std::atomic<int> done(0);
+
+  for (int run = 0; run < 100; ++run) {
+    next = 0;
+    done = 0;
+    pool.Run(4, [&]() {
+      while (next.fetch_add(1) < 1000) {
+        ++done;
+      }
+    });
+    ASSERT_EQ(done.load(), 1000);
+  }
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -219,6 +219,8 @@ void LookupInContainer(const Value& container, const Value& key,
   }
 }
 
+}  // namespace
+
 void PerformLookup(ExecutionFrameBase& frame, const Value& container,
                    const Value& key, const AttributeTrail& container_trail,
                    bool enable_optional_types, Value& result,
@@ -272,6 +274,8 @@ void PerformLookup(ExecutionFrameBase& frame, const Value& container,
   LookupInContainer(container, key, frame, result);
 }
 
+namespace {
+
 // ContainerAccessStep performs message field access specified by Expr::Select
 // message.
 class ContainerAccessStep : public ExpressionStepBase {
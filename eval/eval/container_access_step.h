@@ -6,11 +6,23 @@
 
 #include "absl/status/statusor.h"
 #include "common/expr.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 
 namespace google::api::expr::runtime {
 
+// Evaluates `container[key]` for already evaluated operands. `trail` is set to
+// the element's attribute when unknown processing is enabled.
+//
+// Shared by the container access steps and generated programs (see
+// runtime/internal/generated_program.h).
+void PerformLookup(ExecutionFrameBase& frame, const cel::Value& container,
+                   const cel::Value& key, const AttributeTrail& container_trail,
+                   bool enable_optional_types, cel::Value& result,
+                   AttributeTrail& trail);
+
 std::unique_ptr<DirectExpressionStep> CreateDirectContainerAccessStep(
     std::unique_ptr<DirectExpressionStep> container_step,
     std::unique_ptr<DirectExpressionStep> key_step, bool enable_optional_types,
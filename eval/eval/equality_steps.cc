@@ -45,6 +45,8 @@ using ::cel::ValueKind;
 using ::cel::internal::Number;
 using ::cel::runtime_internal::ValueEqualImpl;
 
+}  // namespace
+
 absl::StatusOr<Value> EvaluateEquality(
     ExecutionFrameBase& frame, const Value& lhs, const AttributeTrail& lhs_attr,
     const Value& rhs, const AttributeTrail& rhs_attr, bool negation) {
@@ -75,6 +77,8 @@ absl::StatusOr<Value> EvaluateEquality(
   return negation ? BoolValue(!*is_equal) : BoolValue(*is_equal);
 }
 
+namespace {
+
 class DirectEqualityStep : public DirectExpressionStep {
  public:
   explicit DirectEqualityStep(std::unique_ptr<DirectExpressionStep> lhs,
@@ -184,6 +188,8 @@ absl::StatusOr<Value> EvaluateInMap(ExecutionFrameBase& frame,
   return BoolValue(false);
 }
 
+}  // namespace
+
 absl::StatusOr<Value> EvaluateIn(ExecutionFrameBase& frame, const Value& item,
                                  const AttributeTrail& item_attr,
                                  const Value& container,
@@ -214,6 +220,8 @@ absl::StatusOr<Value> EvaluateIn(ExecutionFrameBase& frame, const Value& item,
       cel::runtime_internal::CreateNoMatchingOverloadError(cel::builtin::kIn));
 }
 
+namespace {
+
 class DirectInStep : public DirectExpressionStep {
  public:
   explicit DirectInStep(std::unique_ptr<DirectExpressionStep> item,
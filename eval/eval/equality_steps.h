@@ -18,11 +18,34 @@
 #include <cstdint>
 #include <memory>
 
+#include "absl/status/statusor.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 
 namespace google::api::expr::runtime {
 
+// Evaluates `_==_` (or `_!=_` if `negation`) for already evaluated operands
+// with heterogeneous equality.
+//
+// Shared by the equality steps and generated programs (see
+// runtime/internal/generated_program.h).
+absl::StatusOr<cel::Value> EvaluateEquality(ExecutionFrameBase& frame,
+                                            const cel::Value& lhs,
+                                            const AttributeTrail& lhs_attr,
+                                            const cel::Value& rhs,
+                                            const AttributeTrail& rhs_attr,
+                                            bool negation);
+
+// Evaluates `item in container` for already evaluated operands with
+// heterogeneous equality.
+absl::StatusOr<cel::Value> EvaluateIn(ExecutionFrameBase& frame,
+                                      const cel::Value& item,
+                                      const AttributeTrail& item_attr,
+                                      const cel::Value& container,
+                                      const AttributeTrail& container_attr);
+
 // Factory method for recursive _==_/_!=_ Execution step
 std::unique_ptr<DirectExpressionStep> CreateDirectEqualityStep(
     std::unique_ptr<DirectExpressionStep> lhs,
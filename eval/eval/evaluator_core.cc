@@ -25,7 +25,10 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/arena.h"
 #include "common/value.h"
+#include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
@@ -37,6 +40,32 @@ void FlatExpressionEvaluatorState::Reset() {
   value_stack_.Clear();
   iterator_stack_.Clear();
   comprehension_slots_.Reset();
+  function_result_cache_.Clear();
+  any_unpack_cache_.Clear();
+  arena_resident_variable_cache_.clear();
+}
+
+absl::StatusOr<bool> ExecutionFrameBase::FindVariable(absl::string_view name,
+                                                      cel::Value& result) {
+  if (arena_resident_variable_cache_ != nullptr &&
+      !arena_resident_variable_cache_->empty()) {
+    if (auto it = arena_resident_variable_cache_->find(name);
+        it != arena_resident_variable_cache_->end()) {
+      result = it->second;
+      return true;
+    }
+  }
+  CEL_ASSIGN_OR_RETURN(
+      bool found, activation_->FindVariable(name, descriptor_pool_,
+                                            message_factory_, arena_, &result));
+  if (found && options_->enable_arena_resident_values &&
+      !cel::ArenaTraits<>::trivially_destructible(result)) {
+    result = result.Clone(arena_);
+    if (arena_resident_variable_cache_ != nullptr) {
+      arena_resident_variable_cache_->insert_or_assign(name, result);
+    }
+  }
+  return found;
 }
 
 const ExpressionStep* ExecutionFrame::Next() {
@@ -66,6 +95,23 @@ const ExpressionStep* ExecutionFrame::Next() {
   }
 }
 
+bool ExecutionFrame::RecoverFromError(const absl::Status& status) {
+  if (!isolation_.has_value()) {
+    return false;
+  }
+  Isolation isolation = *isolation_;
+  isolation_.reset();
+  value_stack().Pop(value_stack().size() - isolation.value_stack_size);
+  while (iterator_stack().size() > isolation.iterator_stack_size) {
+    iterator_stack().Pop();
+  }
+  call_stack_.resize(isolation.call_stack_size);
+  execution_path_ = isolation.execution_path;
+  pc_ = isolation.resume_pc;
+  value_stack().Push(cel::ErrorValue(status));
+  return true;
+}
+
 namespace {
 
 // This class abuses the fact that `absl::Status` is trivially destructible when
@@ -111,14 +157,21 @@ absl::StatusOr<cel::Value> ExecutionFrame::Evaluate(
     for (const ExpressionStep* expr = Next();
          ABSL_PREDICT_TRUE(expr != nullptr); expr = Next()) {
       if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
-        return std::move(status).Consume();
+        if (absl::Status error = std::move(status).Consume();
+            !RecoverFromError(error)) {
+          return error;
+        }
       }
     }
   } else {
     for (const ExpressionStep* expr = Next();
          ABSL_PREDICT_TRUE(expr != nullptr); expr = Next()) {
       if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
-        return std::move(status).Consume();
+        if (absl::Status error = std::move(status).Consume();
+            !RecoverFromError(error)) {
+          return error;
+        }
+        continue;
       }
 
       if (pc_ == 0 || !expr->comes_from_ast()) {
@@ -18,22 +18,28 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/type_provider.h"
+#include "common/arena.h"
 #include "common/native_type.h"
 #include "common/value.h"
+#include "eval/eval/any_unpack_cache.h"
 #include "eval/eval/attribute_utility.h"
 #include "eval/eval/comprehension_slots.h"
 #include "eval/eval/evaluator_stack.h"
+#include "eval/eval/function_result_cache.h"
 #include "eval/eval/iterator_stack.h"
 #include "runtime/activation_interface.h"
 #include "runtime/internal/activation_attribute_matcher_access.h"
@@ -101,6 +107,15 @@ using ExecutionPath = std::vector<std::unique_ptr<const ExpressionStep>>;
 using ExecutionPathView =
     absl::Span<const std::unique_ptr<const ExpressionStep>>;
 
+// Copies of activation variables on the evaluation arena, keyed by name, made
+// in arena resident value mode (see `ExecutionFrameBase::FindVariable`).
+//
+// The activation is not modified while an evaluation is running, so a copy
+// stays valid for the duration of the evaluation. Copies are owned by the
+// evaluation arena, so the cache must be cleared before the arena is
+// destroyed.
+using ArenaResidentVariableCache = absl::flat_hash_map<std::string, cel::Value>;
+
 // Class that wraps the state that needs to be allocated for expression
 // evaluation. This can be reused to save on allocations.
 class FlatExpressionEvaluatorState {
@@ -124,6 +139,16 @@ class FlatExpressionEvaluatorState {
 
   void Reset();
 
+  // Points the state at the environment for a new evaluation so that the
+  // stacks allocated for a previous evaluation can be reused.
+  void Rebind(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+              google::protobuf::MessageFactory* absl_nonnull message_factory,
+              google::protobuf::Arena* absl_nonnull arena) {
+    descriptor_pool_ = descriptor_pool;
+    message_factory_ = message_factory;
+    arena_ = arena;
+  }
+
   EvaluatorStack& value_stack() { return value_stack_; }
 
   cel::runtime_internal::IteratorStack& iterator_stack() {
@@ -132,6 +157,16 @@ class FlatExpressionEvaluatorState {
 
   ComprehensionSlots& comprehension_slots() { return comprehension_slots_; }
 
+  FunctionResultCache& function_result_cache() {
+    return function_result_cache_;
+  }
+
+  AnyUnpackCache& any_unpack_cache() { return any_unpack_cache_; }
+
+  ArenaResidentVariableCache& arena_resident_variable_cache() {
+    return arena_resident_variable_cache_;
+  }
+
   const cel::TypeProvider& type_provider() { return type_provider_; }
 
   const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool() {
@@ -148,6 +183,9 @@ class FlatExpressionEvaluatorState {
   EvaluatorStack value_stack_;
   cel::runtime_internal::IteratorStack iterator_stack_;
   ComprehensionSlots comprehension_slots_;
+  FunctionResultCache function_result_cache_;
+  AnyUnpackCache any_unpack_cache_;
+  ArenaResidentVariableCache arena_resident_variable_cache_;
   const cel::TypeProvider& type_provider_;
   const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool_;
   google::protobuf::MessageFactory* absl_nonnull message_factory_;
@@ -219,6 +257,33 @@ class ExecutionFrameBase {
     }
   }
 
+  // Creates a frame for evaluating part of a comprehension concurrently with
+  // `parent`. It shares the activation, options and arena of `parent`, and
+  // `slots` must hold a copy of the comprehension slots of `parent`.
+  //
+  // The frame has no listener, embedder context, function result cache,
+  // `Any` unpack cache or arena resident variable cache. Its iteration budget
+  // is what remains of the budget of `parent`, and comprehensions are not
+  // parallelized further within it.
+  ExecutionFrameBase(const ExecutionFrameBase& parent,
+                     ComprehensionSlots& slots)
+      : activation_(parent.activation_),
+        callback_(),
+        options_(parent.options_),
+        type_provider_(parent.type_provider_),
+        descriptor_pool_(parent.descriptor_pool_),
+        message_factory_(parent.message_factory_),
+        arena_(parent.arena_),
+        embedder_context_(nullptr),
+        attribute_utility_(parent.activation_->GetUnknownAttributes(),
+                           parent.activation_->GetMissingAttributes()),
+        slots_(&slots),
+        max_iterations_(parent.max_iterations_ == 0
+                            ? 0
+                            : parent.max_iterations_ - parent.iterations_),
+        iterations_(0),
+        concurrent_(true) {}
+
   const cel::ActivationInterface& activation() const { return *activation_; }
 
   EvaluationListener& callback() { return callback_; }
@@ -260,6 +325,39 @@ class ExecutionFrameBase {
            cel::UnknownProcessingOptions::kDisabled;
   }
 
+  // In arena resident value mode, copies `value` to the evaluation arena if
+  // copying it would otherwise update a reference count.
+  void MaybeMakeArenaResident(cel::Value& value) const {
+    if (options_->enable_arena_resident_values &&
+        !cel::ArenaTraits<>::trivially_destructible(value)) {
+      value = value.Clone(arena_);
+    }
+  }
+
+  // Looks up the variable `name` in the activation, as
+  // `cel::ActivationInterface::FindVariable`, making it arena resident.
+  //
+  // Variables copied to the evaluation arena are memoized in the arena
+  // resident variable cache, if any, so that a variable referenced on every
+  // iteration of a comprehension is only copied once per evaluation.
+  absl::StatusOr<bool> FindVariable(absl::string_view name,
+                                    cel::Value& result);
+
+  // Unpacks the `google.protobuf.Any` fields of a message bound from the
+  // activation whose type URL is listed in
+  // `cel::RuntimeOptions::eager_any_unpack_type_urls`.
+  void MaybeUnpackAnyFields(const cel::Value& value) const {
+    if (any_unpack_cache_ == nullptr ||
+        options_->eager_any_unpack_type_urls.empty()) {
+      return;
+    }
+    if (auto message = value.AsParsedMessage(); message.has_value()) {
+      any_unpack_cache_->Prefetch(*message,
+                                  options_->eager_any_unpack_type_urls,
+                                  descriptor_pool_, message_factory_, arena_);
+    }
+  }
+
   bool unknown_function_results_enabled() const {
     return options_->unknown_processing ==
            cel::UnknownProcessingOptions::kAttributeAndFunction;
@@ -267,13 +365,59 @@ class ExecutionFrameBase {
 
   ComprehensionSlots& comprehension_slots() { return *slots_; }
 
+  // Cache for deterministic function results, or nullptr if memoization is
+  // disabled.
+  FunctionResultCache* absl_nullable function_result_cache() const {
+    return function_result_cache_;
+  }
+
+  void set_function_result_cache(
+      FunctionResultCache* absl_nullable function_result_cache) {
+    function_result_cache_ = function_result_cache;
+  }
+
+  // Cache for unpacked `google.protobuf.Any` fields, or nullptr if disabled.
+  AnyUnpackCache* absl_nullable any_unpack_cache() const {
+    return any_unpack_cache_;
+  }
+
+  void set_any_unpack_cache(AnyUnpackCache* absl_nullable any_unpack_cache) {
+    any_unpack_cache_ = any_unpack_cache;
+  }
+
+  // Cache for arena resident copies of activation variables, or nullptr if
+  // variables are copied on each lookup.
+  ArenaResidentVariableCache* absl_nullable arena_resident_variable_cache()
+      const {
+    return arena_resident_variable_cache_;
+  }
+
+  void set_arena_resident_variable_cache(
+      ArenaResidentVariableCache* absl_nullable arena_resident_variable_cache) {
+    arena_resident_variable_cache_ = arena_resident_variable_cache;
+  }
+
+  // Whether comprehensions evaluated in this frame may be split across
+  // threads. See `cel::RuntimeOptions::comprehension_parallelism`.
+  bool parallel_comprehensions_enabled() const {
+    return options_->comprehension_parallelism > 1 && !concurrent_ &&
+           !unknown_processing_enabled() && !callback_ &&
+           embedder_context_ == nullptr;
+  }
+
+  int iterations() const { return iterations_; }
+
+  // Starts a new iteration budget, for the independent expressions collected
+  // by `#collect_results`.
+  void ResetIterations() { iterations_ = 0; }
+
   // Increment iterations and return an error if the iteration budget is
   // exceeded
-  absl::Status IncrementIterations() {
+  absl::Status IncrementIterations(int count = 1) {
     if (max_iterations_ == 0) {
       return absl::OkStatus();
     }
-    iterations_++;
+    iterations_ += count;
     if (iterations_ >= max_iterations_) {
       return absl::Status(absl::StatusCode::kInternal,
                           "Iteration budget exceeded");
@@ -292,8 +436,14 @@ class ExecutionFrameBase {
   const cel::EmbedderContext* absl_nullable embedder_context_;
   AttributeUtility attribute_utility_;
   ComprehensionSlots* absl_nonnull slots_;
+  FunctionResultCache* absl_nullable function_result_cache_ = nullptr;
+  AnyUnpackCache* absl_nullable any_unpack_cache_ = nullptr;
+  ArenaResidentVariableCache* absl_nullable arena_resident_variable_cache_ =
+      nullptr;
   const int max_iterations_;
   int iterations_;
+  // True for frames evaluating part of a parallel comprehension.
+  bool concurrent_ = false;
 };
 
 // ExecutionFrame manages the context needed for expression evaluation.
@@ -318,7 +468,11 @@ class ExecutionFrame : public ExecutionFrameBase {
         execution_path_(flat),
         value_stack_(&state.value_stack()),
         iterator_stack_(&state.iterator_stack()),
-        subexpressions_() {}
+        subexpressions_() {
+    EnableFunctionResultCache(state);
+    EnableAnyUnpackCache(state);
+    EnableArenaResidentVariableCache(state);
+  }
 
   ExecutionFrame(
       absl::Span<const ExecutionPathView> subexpressions,
@@ -336,6 +490,9 @@ class ExecutionFrame : public ExecutionFrameBase {
         iterator_stack_(&state.iterator_stack()),
         subexpressions_(subexpressions) {
     ABSL_DCHECK(!subexpressions.empty());
+    EnableFunctionResultCache(state);
+    EnableAnyUnpackCache(state);
+    EnableArenaResidentVariableCache(state);
   }
 
   // Returns next expression to evaluate.
@@ -385,6 +542,21 @@ class ExecutionFrame : public ExecutionFrameBase {
     execution_path_ = subexpression;
   }
 
+  // Isolates the next `step_count` steps of the current execution path: if
+  // one of them, or a subexpression it calls, fails with a non-OK status, the
+  // stacks are unwound to their current state, the status is pushed as an
+  // error value and evaluation resumes after those steps.
+  //
+  // Only intended for use by `#collect_results`, whose operands are evaluated
+  // as if by separate programs.
+  void BeginIsolatedSteps(size_t step_count) {
+    isolation_ = Isolation{execution_path_, pc_ + step_count,
+                           value_stack().size(), iterator_stack().size(),
+                           call_stack_.size()};
+  }
+
+  void EndIsolatedSteps() { isolation_.reset(); }
+
   EvaluatorStack& value_stack() { return *value_stack_; }
 
   cel::runtime_internal::IteratorStack& iterator_stack() {
@@ -419,6 +591,27 @@ class ExecutionFrame : public ExecutionFrameBase {
   }
 
  private:
+  void EnableFunctionResultCache(FlatExpressionEvaluatorState& state) {
+    if (options().function_memoization_max_entries > 0) {
+      state.function_result_cache().set_max_entries(
+          options().function_memoization_max_entries);
+      set_function_result_cache(&state.function_result_cache());
+    }
+  }
+
+  void EnableAnyUnpackCache(FlatExpressionEvaluatorState& state) {
+    if (options().enable_any_unpack_cache) {
+      set_any_unpack_cache(&state.any_unpack_cache());
+    }
+  }
+
+  void EnableArenaResidentVariableCache(FlatExpressionEvaluatorState& state) {
+    if (options().enable_arena_resident_values) {
+      set_arena_resident_variable_cache(
+          &state.arena_resident_variable_cache());
+    }
+  }
+
   struct SubFrame {
     size_t return_pc;
     size_t slot_index;
@@ -426,12 +619,25 @@ class ExecutionFrame : public ExecutionFrameBase {
     size_t expected_stack_size;
   };
 
+  struct Isolation {
+    ExecutionPathView execution_path;
+    size_t resume_pc;
+    size_t value_stack_size;
+    size_t iterator_stack_size;
+    size_t call_stack_size;
+  };
+
+  // Unwinds to the isolated steps being evaluated, if any, and replaces their
+  // result with `status`. Returns false if no steps are isolated.
+  bool RecoverFromError(const absl::Status& status);
+
   size_t pc_;  // pc_ - Program Counter. Current position on execution path.
   ExecutionPathView execution_path_;
   EvaluatorStack* absl_nonnull const value_stack_;
   cel::runtime_internal::IteratorStack* absl_nonnull const iterator_stack_;
   absl::Span<const ExecutionPathView> subexpressions_;
   std::vector<SubFrame> call_stack_;
+  absl::optional<Isolation> isolation_;
 };
 
 // A flattened representation of the input CEL AST.
@@ -500,6 +706,17 @@ class FlatExpression {
 
   const cel::TypeProvider& type_provider() const { return type_provider_; }
 
+  // The variables the expression may read from the activation, as collected
+  // by the planner.
+  absl::Span<const cel::VariableReference> referenced_variables() const {
+    return referenced_variables_;
+  }
+
+  void set_referenced_variables(
+      std::vector<cel::VariableReference> referenced_variables) {
+    referenced_variables_ = std::move(referenced_variables);
+  }
+
  private:
   ExecutionPath path_;
   std::vector<ExecutionPathView> subexpressions_;
@@ -509,6 +726,7 @@ class FlatExpression {
   // Arena used during planning phase, may hold constant values so should be
   // kept alive.
   absl_nullable std::shared_ptr<google::protobuf::Arena> arena_;
+  std::vector<cel::VariableReference> referenced_variables_;
 };
 
 }  // namespace google::api::expr::runtime
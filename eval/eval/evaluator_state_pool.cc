@@ -0,0 +1,118 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluator_state_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "eval/eval/evaluator_core.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// Number of states cached per thread. Most services evaluate a handful of hot
+// programs per thread, so a small cache with round robin eviction keeps the
+// footprint bounded without tracking program lifetimes across threads.
+constexpr size_t kThreadCacheSize = 4;
+
+struct CacheEntry {
+  // Zero marks an empty entry.
+  uint64_t key = 0;
+  std::unique_ptr<FlatExpressionEvaluatorState> state;
+};
+
+struct ThreadCache {
+  std::array<CacheEntry, kThreadCacheSize> entries;
+  size_t next_eviction = 0;
+};
+
+ThreadCache& GetThreadCache() {
+  thread_local ThreadCache cache;
+  return cache;
+}
+
+uint64_t NextPoolKey() {
+  static std::atomic<uint64_t> next_key{1};
+  return next_key.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+EvaluatorStatePool::Lease::~Lease() {
+  if (state_ == nullptr) {
+    return;
+  }
+  // Release any values held from the evaluation while its arena is still
+  // alive.
+  state_->Reset();
+
+  ThreadCache& cache = GetThreadCache();
+  CacheEntry* entry = nullptr;
+  for (CacheEntry& candidate : cache.entries) {
+    if (candidate.state == nullptr) {
+      entry = &candidate;
+      break;
+    }
+  }
+  if (entry == nullptr) {
+    entry = &cache.entries[cache.next_eviction];
+    cache.next_eviction = (cache.next_eviction + 1) % kThreadCacheSize;
+  }
+  entry->key = key_;
+  entry->state = std::move(state_);
+}
+
+EvaluatorStatePool::EvaluatorStatePool() : key_(NextPoolKey()) {}
+
+EvaluatorStatePool::~EvaluatorStatePool() {
+  for (CacheEntry& entry : GetThreadCache().entries) {
+    if (entry.key == key_) {
+      entry.key = 0;
+      entry.state.reset();
+    }
+  }
+}
+
+EvaluatorStatePool::Lease EvaluatorStatePool::Borrow(
+    const FlatExpression& expression,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) const {
+  for (CacheEntry& entry : GetThreadCache().entries) {
+    if (entry.key == key_ && entry.state != nullptr) {
+      std::unique_ptr<FlatExpressionEvaluatorState> state =
+          std::move(entry.state);
+      entry.key = 0;
+      state->Rebind(descriptor_pool, message_factory, arena);
+      return Lease(key_, std::move(state));
+    }
+  }
+  return Lease(key_, std::make_unique<FlatExpressionEvaluatorState>(
+                         expression.path().size(),
+                         expression.comprehension_slots_size(),
+                         expression.type_provider(), descriptor_pool,
+                         message_factory, arena));
+}
+
+}  // namespace google::api::expr::runtime
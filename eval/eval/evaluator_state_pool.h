@@ -0,0 +1,92 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "eval/eval/evaluator_core.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+// Reuses evaluator state across evaluations of a FlatExpression.
+//
+// The value stack, iterator stack and comprehension slots needed to evaluate
+// a stack machine program are heap allocated. Released states are kept in a
+// small per-thread cache keyed by pool, so repeated evaluations of the same
+// program on a thread reuse them instead of reallocating.
+//
+// The pool must only be used with the FlatExpression it was created for.
+// Borrowing is reentrant: a nested evaluation on the same thread gets a
+// separate state.
+class EvaluatorStatePool final {
+ public:
+  // A borrowed evaluator state. Returned to the calling thread's cache when
+  // destroyed.
+  class Lease final {
+   public:
+    Lease(Lease&& other) noexcept
+        : key_(other.key_), state_(std::move(other.state_)) {}
+    Lease& operator=(Lease&&) = delete;
+
+    ~Lease();
+
+    FlatExpressionEvaluatorState& operator*() const { return *state_; }
+    FlatExpressionEvaluatorState* absl_nonnull operator->() const {
+      return state_.get();
+    }
+
+   private:
+    friend class EvaluatorStatePool;
+
+    Lease(uint64_t key, std::unique_ptr<FlatExpressionEvaluatorState> state)
+        : key_(key), state_(std::move(state)) {}
+
+    uint64_t key_;
+    std::unique_ptr<FlatExpressionEvaluatorState> state_;
+  };
+
+  EvaluatorStatePool();
+
+  // Releases any state cached for this pool on the calling thread. States
+  // cached on other threads are released when evicted or when the thread
+  // exits.
+  ~EvaluatorStatePool();
+
+  EvaluatorStatePool(const EvaluatorStatePool&) = delete;
+  EvaluatorStatePool& operator=(const EvaluatorStatePool&) = delete;
+
+  // Returns evaluator state for `expression` bound to the given evaluation
+  // environment, reusing a cached state if one is available.
+  Lease Borrow(const FlatExpression& expression,
+               const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+               google::protobuf::MessageFactory* absl_nonnull message_factory,
+               google::protobuf::Arena* absl_nonnull arena) const;
+
+ private:
+  // Unique for the lifetime of the process so that a cached state can never
+  // be matched to a different program allocated at the same address.
+  const uint64_t key_;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
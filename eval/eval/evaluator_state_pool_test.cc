@@ -0,0 +1,137 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluator_state_pool.h"
+
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+
+#include "absl/status/status.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "eval/eval/evaluator_core.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "internal/testing_message_factory.h"
+#include "runtime/activation.h"
+#include "runtime/internal/runtime_type_provider.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::IntValue;
+using ::cel::test::IntValueIs;
+
+class ConstStep : public ExpressionStep {
+ public:
+  ConstStep() : ExpressionStep(-1, false) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    frame->value_stack().Push(IntValue(42));
+    return absl::OkStatus();
+  }
+};
+
+class EvaluatorStatePoolTest : public testing::Test {
+ protected:
+  EvaluatorStatePoolTest()
+      : type_provider_(cel::internal::GetTestingDescriptorPool()),
+        expression_(MakePath(), /*comprehension_slots_size=*/1,
+                    type_provider_, options_) {}
+
+  static ExecutionPath MakePath() {
+    ExecutionPath path;
+    path.push_back(std::make_unique<ConstStep>());
+    return path;
+  }
+
+  EvaluatorStatePool::Lease Borrow(const EvaluatorStatePool& pool) {
+    return pool.Borrow(expression_, cel::internal::GetTestingDescriptorPool(),
+                       cel::internal::GetTestingMessageFactory(), &arena_);
+  }
+
+  cel::RuntimeOptions options_;
+  cel::runtime_internal::RuntimeTypeProvider type_provider_;
+  FlatExpression expression_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(EvaluatorStatePoolTest, ReusesStateOnSameThread) {
+  EvaluatorStatePool pool;
+  FlatExpressionEvaluatorState* first;
+  {
+    EvaluatorStatePool::Lease lease = Borrow(pool);
+    first = &*lease;
+    EXPECT_EQ(lease->value_stack().max_size(), 1u);
+  }
+  EvaluatorStatePool::Lease lease = Borrow(pool);
+  EXPECT_EQ(&*lease, first);
+}
+
+TEST_F(EvaluatorStatePoolTest, NestedBorrowGetsDistinctState) {
+  EvaluatorStatePool pool;
+  EvaluatorStatePool::Lease outer = Borrow(pool);
+  EvaluatorStatePool::Lease inner = Borrow(pool);
+  EXPECT_NE(&*outer, &*inner);
+}
+
+TEST_F(EvaluatorStatePoolTest, StatesAreNotSharedBetweenPools) {
+  EvaluatorStatePool pool;
+  EvaluatorStatePool other_pool;
+  FlatExpressionEvaluatorState* first;
+  {
+    EvaluatorStatePool::Lease lease = Borrow(pool);
+    first = &*lease;
+  }
+  EvaluatorStatePool::Lease lease = Borrow(other_pool);
+  EXPECT_NE(&*lease, first);
+}
+
+TEST_F(EvaluatorStatePoolTest, StatesAreNotSharedBetweenThreads) {
+  EvaluatorStatePool pool;
+  FlatExpressionEvaluatorState* first;
+  {
+    EvaluatorStatePool::Lease lease = Borrow(pool);
+    first = &*lease;
+  }
+  FlatExpressionEvaluatorState* other_thread_state = nullptr;
+  std::thread thread([&]() {
+    EvaluatorStatePool::Lease lease = Borrow(pool);
+    other_thread_state = &*lease;
+  });
+  thread.join();
+  EXPECT_NE(other_thread_state, first);
+}
+
+TEST_F(EvaluatorStatePoolTest, ReturnedStateIsReset) {
+  EvaluatorStatePool pool;
+  cel::Activation activation;
+  for (int i = 0; i < 3; ++i) {
+    EvaluatorStatePool::Lease lease = Borrow(pool);
+    EXPECT_TRUE(lease->value_stack().empty());
+    ASSERT_OK_AND_ASSIGN(
+        cel::Value result,
+        expression_.EvaluateWithCallback(activation, nullptr,
+                                         EvaluationListener(), *lease));
+    EXPECT_THAT(result, IntValueIs(42));
+    // Leave a value behind to check that it is cleared on release.
+    lease->value_stack().Push(IntValue(1));
+  }
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,60 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/function_result_cache.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "runtime/function.h"
+#include "runtime/internal/call_key.h"
+
+namespace google::api::expr::runtime {
+
+bool FunctionResultCache::MakeKey(const cel::Function& function,
+                                  absl::Span<const cel::Value> args,
+                                  std::string& key) {
+  key.clear();
+  cel::runtime_internal::AppendBytesToCallKey(&function, key);
+  return cel::runtime_internal::AppendArgsToCallKey(args, key);
+}
+
+const cel::Value* absl_nullable FunctionResultCache::Find(
+    absl::string_view key) {
+  if (auto it = results_.find(key); it != results_.end()) {
+    ++hits_;
+    return &it->second;
+  }
+  ++misses_;
+  return nullptr;
+}
+
+void FunctionResultCache::Insert(std::string key, const cel::Value& value) {
+  if (results_.size() >= max_entries_) {
+    return;
+  }
+  results_.insert({std::move(key), value});
+}
+
+void FunctionResultCache::Clear() {
+  results_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,76 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_FUNCTION_RESULT_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_FUNCTION_RESULT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "runtime/function.h"
+
+namespace google::api::expr::runtime {
+
+// Memoizes the results of deterministic function calls for the duration of an
+// evaluation.
+//
+// Calls are keyed by function implementation and argument values. Only calls
+// whose arguments are all null, bool, numeric, string, bytes, duration or
+// timestamp values are memoized. Once the cache holds `max_entries` results,
+// further results are not recorded.
+//
+// Cached values are owned by the evaluation arena, so the cache must be
+// cleared before the arena is destroyed.
+class FunctionResultCache {
+ public:
+  FunctionResultCache() = default;
+
+  FunctionResultCache(const FunctionResultCache&) = delete;
+  FunctionResultCache& operator=(const FunctionResultCache&) = delete;
+
+  // Builds the key for a call to `function` with `args`. Returns false if the
+  // call can't be memoized.
+  static bool MakeKey(const cel::Function& function,
+                      absl::Span<const cel::Value> args, std::string& key);
+
+  // Returns the memoized result for `key`, or nullptr. Counts a hit or miss.
+  const cel::Value* absl_nullable Find(absl::string_view key);
+
+  void Insert(std::string key, const cel::Value& value);
+
+  // Drops all memoized results and resets the counters.
+  void Clear();
+
+  void set_max_entries(size_t max_entries) { max_entries_ = max_entries; }
+
+  uint64_t hits() const { return hits_; }
+
+  uint64_t misses() const { return misses_; }
+
+ private:
+  absl::flat_hash_map<std::string, cel::Value> results_;
+  size_t max_entries_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_FUNCTION_RESULT_CACHE_H_
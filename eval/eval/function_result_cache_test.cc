@@ -0,0 +1,171 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/function_result_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "common/function_descriptor.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/function.h"
+#include "runtime/function_adapter.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::cel::Activation;
+using ::cel::FunctionDescriptorOptions;
+using ::cel::FunctionMemoizationStats;
+using ::cel::IntValue;
+using ::cel::ListValue;
+using ::cel::StringValue;
+using ::cel::UnaryFunctionAdapter;
+using ::cel::Value;
+using ::cel::expr::ParsedExpr;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::parser::Parse;
+
+class IdentityFunction final : public cel::Function {
+ public:
+  absl::StatusOr<Value> Invoke(absl::Span<const Value> args,
+                               const InvokeContext& context) const override {
+    return args[0];
+  }
+};
+
+TEST(FunctionResultCacheTest, KeysByFunctionAndArguments) {
+  IdentityFunction f;
+  IdentityFunction g;
+  std::string key1;
+  std::string key2;
+  ASSERT_TRUE(FunctionResultCache::MakeKey(f, {IntValue(1)}, key1));
+  ASSERT_TRUE(FunctionResultCache::MakeKey(f, {IntValue(1)}, key2));
+  EXPECT_EQ(key1, key2);
+  ASSERT_TRUE(FunctionResultCache::MakeKey(g, {IntValue(1)}, key2));
+  EXPECT_NE(key1, key2);
+  ASSERT_TRUE(FunctionResultCache::MakeKey(f, {cel::UintValue(1)}, key2));
+  EXPECT_NE(key1, key2);
+  ASSERT_TRUE(
+      FunctionResultCache::MakeKey(f, {StringValue("a"), StringValue("bc")},
+                                   key1));
+  ASSERT_TRUE(
+      FunctionResultCache::MakeKey(f, {StringValue("ab"), StringValue("c")},
+                                   key2));
+  EXPECT_NE(key1, key2);
+}
+
+TEST(FunctionResultCacheTest, SkipsAggregateArguments) {
+  IdentityFunction f;
+  std::string key;
+  EXPECT_FALSE(FunctionResultCache::MakeKey(f, {ListValue()}, key));
+}
+
+TEST(FunctionResultCacheTest, BoundedAndCounted) {
+  IdentityFunction f;
+  FunctionResultCache cache;
+  cache.set_max_entries(1);
+  std::string key1;
+  std::string key2;
+  ASSERT_TRUE(FunctionResultCache::MakeKey(f, {IntValue(1)}, key1));
+  ASSERT_TRUE(FunctionResultCache::MakeKey(f, {IntValue(2)}, key2));
+
+  EXPECT_EQ(cache.Find(key1), nullptr);
+  cache.Insert(key1, IntValue(1));
+  cache.Insert(key2, IntValue(2));
+  ASSERT_NE(cache.Find(key1), nullptr);
+  EXPECT_EQ(cache.Find(key2), nullptr);
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 2);
+
+  cache.Clear();
+  EXPECT_EQ(cache.Find(key1), nullptr);
+  EXPECT_EQ(cache.hits(), 0);
+  EXPECT_EQ(cache.misses(), 1);
+}
+
+class FunctionMemoizationTest : public testing::TestWithParam<bool> {};
+
+TEST_P(FunctionMemoizationTest, MemoizesDeterministicCalls) {
+  const bool recursive = GetParam();
+  cel::RuntimeOptions options;
+  options.function_memoization_max_entries = 16;
+  options.max_recursion_depth = recursive ? -1 : 0;
+  ASSERT_OK_AND_ASSIGN(cel::RuntimeBuilder builder,
+                       cel::CreateStandardRuntimeBuilder(
+                           cel::internal::GetTestingDescriptorPool(), options));
+
+  int call_count = 0;
+  using FunctionAdapter = UnaryFunctionAdapter<int64_t, int64_t>;
+  FunctionDescriptorOptions descriptor_options;
+  descriptor_options.is_deterministic = true;
+  ASSERT_THAT(builder.function_registry().Register(
+                  FunctionAdapter::CreateDescriptor(
+                      "square", /*receiver_style=*/false, descriptor_options),
+                  FunctionAdapter::WrapFunction([&call_count](int64_t x) {
+                    ++call_count;
+                    return x * x;
+                  })),
+              IsOk());
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr parsed_expr,
+      Parse("[1, 2, 1, 2, 1].map(x, square(x)) == [1, 4, 1, 4, 1]"));
+  ASSERT_OK_AND_ASSIGN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                         *runtime, parsed_expr));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  FunctionMemoizationStats stats;
+  cel::EvaluateOptions evaluate_options;
+  evaluate_options.function_memoization_stats = &stats;
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(&arena, activation, evaluate_options));
+  EXPECT_TRUE(result.IsTrue());
+  EXPECT_EQ(call_count, 2);
+  EXPECT_EQ(stats.hits, 3);
+  EXPECT_EQ(stats.misses, 2);
+
+  // Results are only memoized for the duration of an evaluation.
+  ASSERT_OK_AND_ASSIGN(result,
+                       program->Evaluate(&arena, activation, evaluate_options));
+  EXPECT_TRUE(result.IsTrue());
+  EXPECT_EQ(call_count, 4);
+  EXPECT_EQ(stats.hits, 6);
+  EXPECT_EQ(stats.misses, 4);
+}
+
+INSTANTIATE_TEST_SUITE_P(FunctionMemoizationTest, FunctionMemoizationTest,
+                         testing::Bool());
+
+}  // namespace
+}  // namespace google::api::expr::runtime
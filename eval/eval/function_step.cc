@@ -11,7 +11,6 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -25,6 +24,7 @@
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
+#include "eval/eval/function_result_cache.h"
 #include "eval/internal/errors.h"
 #include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
@@ -39,10 +39,10 @@ namespace google::api::expr::runtime {
 namespace {
 
 using ::cel::ErrorValue;
+using ::cel::ErrorValueCode;
 using ::cel::UnknownValue;
 using ::cel::Value;
 using ::cel::ValueKindToKind;
-using ::cel::runtime_internal::CreateNoMatchingOverloadError;
 
 // Determine if the overload should be considered. Overloads that can consume
 // errors or unknown sets must be allowed as a non-strict function.
@@ -79,27 +79,15 @@ bool ArgumentKindsMatch(const cel::FunctionDescriptor& descriptor,
 // Adjust new type names to legacy equivalent. int -> int64.
 // Temporary fix to migrate value types without breaking clients.
 // TODO(uncreated-issue/46): Update client tests that depend on this value.
-std::string ToLegacyKindName(absl::string_view type_name) {
-  if (type_name == "int" || type_name == "uint") {
-    return absl::StrCat(type_name, "64");
+absl::string_view LegacyKindName(cel::ValueKind kind) {
+  switch (kind) {
+    case cel::ValueKind::kInt:
+      return "int64";
+    case cel::ValueKind::kUint:
+      return "uint64";
+    default:
+      return cel::KindToString(ValueKindToKind(kind));
   }
-
-  return std::string(type_name);
-}
-
-std::string CallArgTypeString(absl::Span<const cel::Value> args) {
-  std::string call_sig_string = "";
-
-  for (size_t i = 0; i < args.size(); i++) {
-    const auto& arg = args[i];
-    if (!call_sig_string.empty()) {
-      absl::StrAppend(&call_sig_string, ", ");
-    }
-    absl::StrAppend(
-        &call_sig_string,
-        ToLegacyKindName(cel::KindToString(ValueKindToKind(arg->kind()))));
-  }
-  return absl::StrCat("(", call_sig_string, ")");
 }
 
 // Convert partially unknown arguments to unknowns before passing to the
@@ -182,6 +170,19 @@ class AbstractFunctionStep : public ExpressionStepBase {
 inline absl::StatusOr<Value> Invoke(
     const cel::FunctionOverloadReference& overload, int64_t expr_id,
     absl::Span<const cel::Value> args, ExecutionFrameBase& frame) {
+  FunctionResultCache* cache = overload.descriptor.is_deterministic()
+                                   ? frame.function_result_cache()
+                                   : nullptr;
+  std::string key;
+  if (cache != nullptr &&
+      FunctionResultCache::MakeKey(overload.implementation, args, key)) {
+    if (const Value* cached = cache->Find(key); cached != nullptr) {
+      return *cached;
+    }
+  } else {
+    cache = nullptr;
+  }
+
   cel::Function::InvokeContext context(frame.descriptor_pool(),
                                        frame.message_factory(), frame.arena());
   if (overload.descriptor.is_contextual()) {
@@ -190,12 +191,17 @@ inline absl::StatusOr<Value> Invoke(
 
   CEL_ASSIGN_OR_RETURN(Value result,
                        overload.implementation.Invoke(args, context));
+  frame.MaybeMakeArenaResident(result);
 
   if (frame.unknown_function_results_enabled() &&
       IsUnknownFunctionResultError(result)) {
+    // Unknown results identify the call site, so they aren't memoized.
     return frame.attribute_utility().CreateUnknownSet(overload.descriptor,
                                                       expr_id, args);
   }
+  if (cache != nullptr) {
+    cache->Insert(std::move(key), result);
+  }
   return result;
 }
 
@@ -223,22 +229,25 @@ Value NoOverloadResult(absl::string_view name,
   }
 
   // If no errors or unknowns in input args, create new CelError for missing
-  // overload.
-  std::string signature;
+  // overload. It is often absorbed by logical operators, so its message is
+  // only formatted if inspected.
+  absl::InlinedVector<absl::string_view, 4> operands;
+  ErrorValueCode code = ErrorValueCode::kNoMatchingOverload;
   if (receiver_style) {
-    if (args.empty()) {
-      // Should not be possible, but return a sensible error in case of logic
-      // error.
-      return ErrorValue(
-          CreateNoMatchingOverloadError(absl::StrCat("().", name, "()")));
+    code = ErrorValueCode::kNoMatchingReceiverOverload;
+    // An empty receiver should not be possible, but results in a sensible
+    // error in case of logic error.
+    operands.push_back(args.empty() ? absl::string_view()
+                                    : LegacyKindName(args[0].kind()));
+    if (!args.empty()) {
+      args.remove_prefix(1);
     }
-    return ErrorValue(CreateNoMatchingOverloadError(absl::StrCat(
-        "(",
-        ToLegacyKindName(cel::KindToString(ValueKindToKind(args[0].kind()))),
-        ").", name, CallArgTypeString(args.subspan(1)))));
   }
-  return cel::ErrorValue(CreateNoMatchingOverloadError(
-      absl::StrCat(name, CallArgTypeString(args))));
+  operands.push_back(name);
+  for (const auto& arg : args) {
+    operands.push_back(LegacyKindName(arg.kind()));
+  }
+  return ErrorValue(frame.arena(), code, operands);
 }
 
 absl::StatusOr<Value> AbstractFunctionStep::DoEvaluate(
@@ -486,6 +495,34 @@ class DirectFunctionStepImpl : public DirectExpressionStep {
   Resolver resolver_;
 };
 
+template <typename ResolveFn>
+absl::StatusOr<cel::Value> InvokeResolvedOverload(
+    ExecutionFrameBase& frame, int64_t expr_id, absl::string_view name,
+    bool receiver_style, absl::Span<const cel::Value> args,
+    absl::Span<const AttributeTrail> arg_trails, ResolveFn resolve) {
+  absl::InlinedVector<Value, 2> unknown_args;
+  if (frame.unknown_processing_enabled()) {
+    unknown_args.assign(args.begin(), args.end());
+    for (size_t i = 0; i < arg_trails.size(); i++) {
+      if (frame.attribute_utility().CheckForUnknown(arg_trails[i],
+                                                    /*use_partial=*/true)) {
+        unknown_args[i] = frame.attribute_utility().CreateUnknownSet(
+            arg_trails[i].attribute());
+      }
+    }
+    args = absl::MakeConstSpan(unknown_args);
+  }
+
+  CEL_ASSIGN_OR_RETURN(ResolveResult resolved_function, resolve(args));
+
+  if (resolved_function.has_value() &&
+      ShouldAcceptOverload(resolved_function->descriptor, args)) {
+    return Invoke(*resolved_function, expr_id, args, frame);
+  }
+
+  return NoOverloadResult(name, args, receiver_style, frame);
+}
+
 }  // namespace
 
 std::unique_ptr<DirectExpressionStep> CreateDirectFunctionStep(
@@ -526,4 +563,30 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateFunctionStep(
                                              num_args, receiver_style, expr_id);
 }
 
+absl::StatusOr<cel::Value> InvokeFunctionOverloads(
+    ExecutionFrameBase& frame, int64_t expr_id, absl::string_view name,
+    bool receiver_style,
+    absl::Span<const cel::FunctionOverloadReference> overloads,
+    absl::Span<const cel::Value> args,
+    absl::Span<const AttributeTrail> arg_trails) {
+  return InvokeResolvedOverload(
+      frame, expr_id, name, receiver_style, args, arg_trails,
+      [&](absl::Span<const cel::Value> input) {
+        return ResolveStatic(input, overloads);
+      });
+}
+
+absl::StatusOr<cel::Value> InvokeLazyFunctionOverloads(
+    ExecutionFrameBase& frame, int64_t expr_id, absl::string_view name,
+    bool receiver_style,
+    absl::Span<const cel::FunctionRegistry::LazyOverload> providers,
+    absl::Span<const cel::Value> args,
+    absl::Span<const AttributeTrail> arg_trails) {
+  return InvokeResolvedOverload(
+      frame, expr_id, name, receiver_style, args, arg_trails,
+      [&](absl::Span<const cel::Value> input) {
+        return ResolveLazy(input, name, receiver_style, providers, frame);
+      });
+}
+
 }  // namespace google::api::expr::runtime
@@ -6,7 +6,11 @@
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/expr.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "runtime/function_overload_reference.h"
@@ -43,6 +47,29 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateFunctionStep(
     const cel::CallExpr& call, int64_t expr_id,
     std::vector<cel::FunctionOverloadReference> overloads);
 
+// Dispatches already evaluated arguments to the matching overload in
+// `overloads`, with the same argument handling as the eagerly resolved function
+// steps (partially unknown arguments, error and unknown propagation).
+//
+// Used by specialized steps to fall back to generic dispatch, and by generated
+// programs (see runtime/internal/generated_program.h). `args` and
+// `arg_trails` are expected to be equal length.
+absl::StatusOr<cel::Value> InvokeFunctionOverloads(
+    ExecutionFrameBase& frame, int64_t expr_id, absl::string_view name,
+    bool receiver_style,
+    absl::Span<const cel::FunctionOverloadReference> overloads,
+    absl::Span<const cel::Value> args,
+    absl::Span<const AttributeTrail> arg_trails);
+
+// As `InvokeFunctionOverloads`, resolving the overload from the lazily bound
+// `providers` against the frame's activation like the lazy function steps.
+absl::StatusOr<cel::Value> InvokeLazyFunctionOverloads(
+    ExecutionFrameBase& frame, int64_t expr_id, absl::string_view name,
+    bool receiver_style,
+    absl::Span<const cel::FunctionRegistry::LazyOverload> providers,
+    absl::Span<const cel::Value> args,
+    absl::Span<const AttributeTrail> arg_trails);
+
 }  // namespace google::api::expr::runtime
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_FUNCTION_STEP_H_
@@ -25,7 +25,6 @@ namespace google::api::expr::runtime {
 namespace {
 
 using ::cel::Value;
-using ::cel::runtime_internal::CreateError;
 
 class IdentStep : public ExpressionStepBase {
  public:
@@ -38,8 +37,10 @@ class IdentStep : public ExpressionStepBase {
   std::string name_;
 };
 
+}  // namespace
+
 absl::Status LookupIdent(absl::string_view name, ExecutionFrameBase& frame,
-                         Value& result, AttributeTrail& attribute) {
+                         cel::Value& result, AttributeTrail& attribute) {
   if (frame.attribute_tracking_enabled()) {
     attribute = AttributeTrail(std::string(name));
     if (frame.missing_attribute_errors_enabled() &&
@@ -57,21 +58,23 @@ absl::Status LookupIdent(absl::string_view name, ExecutionFrameBase& frame,
     }
   }
 
-  CEL_ASSIGN_OR_RETURN(
-      auto found, frame.activation().FindVariable(name, frame.descriptor_pool(),
-                                                  frame.message_factory(),
-                                                  frame.arena(), &result));
+  CEL_ASSIGN_OR_RETURN(auto found, frame.FindVariable(name, result));
 
   if (found) {
+    frame.MaybeUnpackAnyFields(result);
     return absl::OkStatus();
   }
 
-  result = cel::ErrorValue(CreateError(
-      absl::StrCat("No value with name \"", name, "\" found in Activation")));
+  // The error is often absorbed by logical operators, so its message is only
+  // formatted if inspected.
+  result = cel::ErrorValue(frame.arena(), cel::ErrorValueCode::kNoSuchVariable,
+                           {name});
 
   return absl::OkStatus();
 }
 
+namespace {
+
 absl::Status IdentStep::Evaluate(ExecutionFrame* frame) const {
   Value value;
   AttributeTrail attribute;
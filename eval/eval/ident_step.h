@@ -5,13 +5,25 @@
 #include <cstdint>
 #include <memory>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 
 namespace google::api::expr::runtime {
 
+// Resolves the global variable `name` from the frame's activation, or as an
+// unknown or missing attribute when attribute tracking is enabled. A variable
+// absent from the activation evaluates to an error value.
+//
+// Shared by the ident steps and generated programs (see
+// runtime/internal/generated_program.h).
+absl::Status LookupIdent(absl::string_view name, ExecutionFrameBase& frame,
+                         cel::Value& result, AttributeTrail& attribute);
+
 std::unique_ptr<DirectExpressionStep> CreateDirectIdentStep(
     absl::string_view identifier, int64_t expr_id);
 
@@ -1,12 +1,15 @@
 #include "eval/eval/ident_step.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "base/type_provider.h"
+#include "common/arena.h"
 #include "common/casting.h"
 #include "common/memory.h"
 #include "common/value.h"
@@ -36,6 +39,7 @@ using ::cel::InstanceOf;
 using ::cel::IntValue;
 using ::cel::MemoryManagerRef;
 using ::cel::RuntimeOptions;
+using ::cel::StringValue;
 using ::cel::TypeProvider;
 using ::cel::UnknownValue;
 using ::cel::Value;
@@ -311,6 +315,43 @@ TEST(DirectIdentStepTest, NotFound) {
                        HasSubstr("\"var1\" found in Activation")));
 }
 
+TEST(DirectIdentStepTest, ArenaResidentVariableCopiedOnce) {
+  google::protobuf::Arena arena;
+  cel::runtime_internal::RuntimeTypeProvider type_provider(
+      cel::internal::GetTestingDescriptorPool());
+  cel::Activation activation;
+  RuntimeOptions options;
+  options.enable_arena_resident_values = true;
+
+  // Cord backed strings are reference counted, so they are copied to the
+  // evaluation arena.
+  activation.InsertOrAssignValue(
+      "var1", StringValue(absl::Cord(
+                  "a cord value which is too long to be stored inline")));
+
+  ExecutionFrameBase frame(activation, options, type_provider,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena);
+  ArenaResidentVariableCache cache;
+  frame.set_arena_resident_variable_cache(&cache);
+  Value result;
+  AttributeTrail trail;
+
+  auto step = CreateDirectIdentStep("var1", -1);
+
+  ASSERT_OK(step->Evaluate(frame, result, trail));
+  EXPECT_TRUE(cel::ArenaTraits<>::trivially_destructible(result));
+  const size_t space_used = arena.SpaceUsed();
+
+  ASSERT_OK(step->Evaluate(frame, result, trail));
+  EXPECT_TRUE(cel::ArenaTraits<>::trivially_destructible(result));
+  EXPECT_EQ(arena.SpaceUsed(), space_used);
+  EXPECT_THAT(cache, SizeIs(1));
+  ASSERT_TRUE(InstanceOf<StringValue>(result));
+  EXPECT_EQ(Cast<StringValue>(result).ToString(),
+            "a cord value which is too long to be stored inline");
+}
+
 }  // namespace
 
 }  // namespace google::api::expr::runtime
@@ -82,6 +82,24 @@ absl::Status ReturnLogicResult(ExecutionFrameBase& frame, OpType op_type,
   return absl::OkStatus();
 }
 
+}  // namespace
+
+absl::Status CombineLogicOperands(ExecutionFrameBase& frame, bool is_or,
+                                  Value& result, Value& rhs_result,
+                                  AttributeTrail& attribute_trail) {
+  if (rhs_result.IsBool() && rhs_result.GetBool().NativeValue() == is_or) {
+    result = std::move(rhs_result);
+    attribute_trail = AttributeTrail();
+    return absl::OkStatus();
+  }
+
+  AttributeTrail rhs_attr;
+  return ReturnLogicResult(frame, is_or ? OpType::kOr : OpType::kAnd, result,
+                           rhs_result, attribute_trail, rhs_attr);
+}
+
+namespace {
+
 class ExhaustiveDirectLogicStep : public DirectExpressionStep {
  public:
   explicit ExhaustiveDirectLogicStep(std::unique_ptr<DirectExpressionStep> lhs,
@@ -108,10 +126,8 @@ absl::Status ExhaustiveDirectLogicStep::Evaluate(
   ValueKind lhs_kind = result.kind();
 
   Value rhs_result;
-  AttributeTrail rhs_attr;
   CEL_RETURN_IF_ERROR(rhs_->Evaluate(frame, rhs_result, attribute_trail));
 
-  ValueKind rhs_kind = rhs_result.kind();
   if (lhs_kind == ValueKind::kBool) {
     bool lhs_bool = Cast<BoolValue>(result).NativeValue();
     if ((op_type_ == OpType::kOr && lhs_bool) ||
@@ -120,18 +136,8 @@ absl::Status ExhaustiveDirectLogicStep::Evaluate(
     }
   }
 
-  if (rhs_kind == ValueKind::kBool) {
-    bool rhs_bool = Cast<BoolValue>(rhs_result).NativeValue();
-    if ((op_type_ == OpType::kOr && rhs_bool) ||
-        (op_type_ == OpType::kAnd && !rhs_bool)) {
-      result = std::move(rhs_result);
-      attribute_trail = std::move(rhs_attr);
-      return absl::OkStatus();
-    }
-  }
-
-  return ReturnLogicResult(frame, op_type_, result, rhs_result, attribute_trail,
-                           rhs_attr);
+  return CombineLogicOperands(frame, op_type_ == OpType::kOr, result,
+                              rhs_result, attribute_trail);
 }
 
 class DirectLogicStep : public DirectExpressionStep {
@@ -166,24 +172,10 @@ absl::Status DirectLogicStep::Evaluate(ExecutionFrameBase& frame, Value& result,
   }
 
   Value rhs_result;
-  AttributeTrail rhs_attr;
-
   CEL_RETURN_IF_ERROR(rhs_->Evaluate(frame, rhs_result, attribute_trail));
 
-  ValueKind rhs_kind = rhs_result.kind();
-
-  if (rhs_kind == ValueKind::kBool) {
-    bool rhs_bool = Cast<BoolValue>(rhs_result).NativeValue();
-    if ((op_type_ == OpType::kOr && rhs_bool) ||
-        (op_type_ == OpType::kAnd && !rhs_bool)) {
-      result = std::move(rhs_result);
-      attribute_trail = std::move(rhs_attr);
-      return absl::OkStatus();
-    }
-  }
-
-  return ReturnLogicResult(frame, op_type_, result, rhs_result, attribute_trail,
-                           rhs_attr);
+  return CombineLogicOperands(frame, op_type_ == OpType::kOr, result,
+                              rhs_result, attribute_trail);
 }
 
 class LogicalOpStep : public ExpressionStepBase {
@@ -4,12 +4,25 @@
 #include <cstdint>
 #include <memory>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 
 namespace google::api::expr::runtime {
 
+// Combines the operands of `_&&_` (or `_||_` if `is_or`) once the left operand
+// in `result` failed to short-circuit the evaluation. `attribute_trail` holds
+// the trail the right operand was evaluated into.
+//
+// Shared by the logic steps and generated programs (see
+// runtime/internal/generated_program.h).
+absl::Status CombineLogicOperands(ExecutionFrameBase& frame, bool is_or,
+                                  cel::Value& result, cel::Value& rhs_result,
+                                  AttributeTrail& attribute_trail);
+
 // Factory method for "And" Execution step
 std::unique_ptr<DirectExpressionStep> CreateDirectAndStep(
     std::unique_ptr<DirectExpressionStep> lhs,
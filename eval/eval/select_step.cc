@@ -5,6 +5,7 @@
 #include <string>
 #include <utility>
 
+#include "absl/base/nullability.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
@@ -15,12 +16,14 @@
 #include "common/type.h"
 #include "common/value.h"
 #include "common/value_kind.h"
+#include "eval/eval/any_unpack_cache.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
 #include "internal/status_macros.h"
 #include "runtime/runtime_options.h"
+#include "runtime/typed_field_accessor.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -99,12 +102,39 @@ absl::Status PerformHas(const Value& target, absl::string_view field,
   }
 }
 
+// Gets `field` of the struct value `target`. Message fields holding a
+// `google.protobuf.Any` are read through `any_unpack_cache`, if present.
+absl::Status GetStructField(const Value& target, absl::string_view field,
+                            ProtoWrapperTypeOptions unboxing_option,
+                            const google::protobuf::DescriptorPool* descriptor_pool,
+                            google::protobuf::MessageFactory* message_factory,
+                            google::protobuf::Arena* arena,
+                            AnyUnpackCache* absl_nullable any_unpack_cache,
+                            Value& result) {
+  if (any_unpack_cache != nullptr) {
+    if (auto message = target.AsParsedMessage(); message.has_value()) {
+      if (const google::protobuf::FieldDescriptor* field_descriptor =
+              message->GetDescriptor()->FindFieldByName(field);
+          field_descriptor != nullptr) {
+        return any_unpack_cache->GetField(*message, field_descriptor,
+                                          unboxing_option, descriptor_pool,
+                                          message_factory, arena, &result);
+      }
+    }
+  }
+  return target.GetStruct().GetFieldByName(field, unboxing_option,
+                                           descriptor_pool, message_factory,
+                                           arena, &result);
+}
+
 absl::Status PerformGet(const Value& target, absl::string_view field,
                         const StringValue& field_value,
                         ProtoWrapperTypeOptions unboxing_option,
                         const google::protobuf::DescriptorPool* descriptor_pool,
                         google::protobuf::MessageFactory* message_factory,
-                        google::protobuf::Arena* arena, Value& result) {
+                        google::protobuf::Arena* arena,
+                        AnyUnpackCache* absl_nullable any_unpack_cache,
+                        Value& result) {
   switch (target.kind()) {
     case ValueKind::kMap: {
       auto status = target.GetMap().Get(field_value, descriptor_pool,
@@ -115,9 +145,9 @@ absl::Status PerformGet(const Value& target, absl::string_view field,
       return absl::OkStatus();
     }
     case ValueKind::kStruct: {
-      auto status = target.GetStruct().GetFieldByName(
-          field, unboxing_option, descriptor_pool, message_factory, arena,
-          &result);
+      auto status =
+          GetStructField(target, field, unboxing_option, descriptor_pool,
+                         message_factory, arena, any_unpack_cache, result);
       if (!status.ok()) {
         result = ErrorValue(std::move(status));
       }
@@ -133,7 +163,9 @@ absl::Status PerformOptionalGet(const Value& target, absl::string_view field,
                                 ProtoWrapperTypeOptions unboxing_option,
                                 const google::protobuf::DescriptorPool* descriptor_pool,
                                 google::protobuf::MessageFactory* message_factory,
-                                google::protobuf::Arena* arena, Value& result) {
+                                google::protobuf::Arena* arena,
+                                AnyUnpackCache* absl_nullable any_unpack_cache,
+                                Value& result) {
   switch (target.kind()) {
     case ValueKind::kMap: {
       CEL_ASSIGN_OR_RETURN(
@@ -154,9 +186,9 @@ absl::Status PerformOptionalGet(const Value& target, absl::string_view field,
         result = OptionalValue::None();
         return absl::OkStatus();
       }
-      CEL_RETURN_IF_ERROR(target.GetStruct().GetFieldByName(
-          field, unboxing_option, descriptor_pool, message_factory, arena,
-          &result));
+      CEL_RETURN_IF_ERROR(GetStructField(target, field, unboxing_option,
+                                         descriptor_pool, message_factory,
+                                         arena, any_unpack_cache, result));
 
       ABSL_DCHECK(!result.IsUnknown());
       result = OptionalValue::Of(std::move(result), arena);
@@ -262,7 +294,8 @@ absl::Status SelectStep::Evaluate(ExecutionFrame* frame) const {
     optional_arg->Value(&value);
     auto status = PerformOptionalGet(
         value, field_, field_value_, unboxing_option_, frame->descriptor_pool(),
-        frame->message_factory(), frame->arena(), result);
+        frame->message_factory(), frame->arena(), frame->any_unpack_cache(),
+        result);
     if (!status.ok()) {
       result = ErrorValue(std::move(status));
     }
@@ -272,11 +305,91 @@ absl::Status SelectStep::Evaluate(ExecutionFrame* frame) const {
 
   CEL_RETURN_IF_ERROR(PerformGet(
       arg, field_, field_value_, unboxing_option_, frame->descriptor_pool(),
-      frame->message_factory(), frame->arena(), result));
+      frame->message_factory(), frame->arena(), frame->any_unpack_cache(),
+      result));
   frame->value_stack().PopAndPush(std::move(result), std::move(result_trail));
   return absl::OkStatus();
 }
 
+}  // namespace
+
+absl::Status ApplySelect(ExecutionFrameBase& frame,
+                         const StringValue& field_value,
+                         const std::string& field, bool test_only,
+                         ProtoWrapperTypeOptions unboxing_option,
+                         bool enable_optional_types, Value& result,
+                         AttributeTrail& attribute) {
+  if (result.IsError() || result.IsUnknown()) {
+    // Just forward.
+    return absl::OkStatus();
+  }
+
+  if (frame.attribute_tracking_enabled()) {
+    attribute = attribute.Step(&field);
+    absl::optional<Value> value = CheckForMarkedAttributes(attribute, frame);
+    if (value.has_value()) {
+      result = std::move(value).value();
+      return absl::OkStatus();
+    }
+  }
+
+  absl::optional<OptionalValue> optional_arg;
+
+  if (enable_optional_types && result.IsOptional()) {
+    optional_arg = result.GetOptional();
+  }
+
+  switch (result.kind()) {
+    case ValueKind::kStruct:
+    case ValueKind::kMap:
+      break;
+    default:
+      if (optional_arg) {
+        break;
+      }
+      result = cel::ErrorValue(InvalidSelectTargetError());
+      return absl::OkStatus();
+  }
+
+  if (test_only) {
+    if (optional_arg) {
+      if (!optional_arg->HasValue()) {
+        result = cel::BoolValue{false};
+        return absl::OkStatus();
+      }
+      Value value;
+      optional_arg->Value(&value);
+      return PerformHas(value, field, field_value, frame.descriptor_pool(),
+                        frame.message_factory(), frame.arena(), result);
+    }
+    return PerformHas(result, field, field_value, frame.descriptor_pool(),
+                      frame.message_factory(), frame.arena(), result);
+  }
+
+  if (optional_arg) {
+    if (!optional_arg->HasValue()) {
+      // result is still buffer for the container. just return.
+      return absl::OkStatus();
+    }
+    Value value;
+    optional_arg->Value(&value);
+    auto status =
+        PerformOptionalGet(value, field, field_value, unboxing_option,
+                           frame.descriptor_pool(), frame.message_factory(),
+                           frame.arena(), frame.any_unpack_cache(), result);
+    if (!status.ok()) {
+      result = ErrorValue(std::move(status));
+    }
+    return absl::OkStatus();
+  }
+
+  return PerformGet(result, field, field_value, unboxing_option,
+                    frame.descriptor_pool(), frame.message_factory(),
+                    frame.arena(), frame.any_unpack_cache(), result);
+}
+
+namespace {
+
 class DirectSelectStep : public DirectExpressionStep {
  public:
   DirectSelectStep(int64_t expr_id,
@@ -297,74 +410,9 @@ class DirectSelectStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute) const override {
     CEL_RETURN_IF_ERROR(operand_->Evaluate(frame, result, attribute));
-
-    if (result.IsError() || result.IsUnknown()) {
-      // Just forward.
-      return absl::OkStatus();
-    }
-
-    if (frame.attribute_tracking_enabled()) {
-      attribute = attribute.Step(&field_);
-      absl::optional<Value> value = CheckForMarkedAttributes(attribute, frame);
-      if (value.has_value()) {
-        result = std::move(value).value();
-        return absl::OkStatus();
-      }
-    }
-
-    absl::optional<OptionalValue> optional_arg;
-
-    if (enable_optional_types_ && result.IsOptional()) {
-      optional_arg = result.GetOptional();
-    }
-
-    switch (result.kind()) {
-      case ValueKind::kStruct:
-      case ValueKind::kMap:
-        break;
-      default:
-        if (optional_arg) {
-          break;
-        }
-        result = cel::ErrorValue(InvalidSelectTargetError());
-        return absl::OkStatus();
-    }
-
-    if (test_only_) {
-      if (optional_arg) {
-        if (!optional_arg->HasValue()) {
-          result = cel::BoolValue{false};
-          return absl::OkStatus();
-        }
-        Value value;
-        optional_arg->Value(&value);
-        return PerformHas(value, field_, field_value_, frame.descriptor_pool(),
-                          frame.message_factory(), frame.arena(), result);
-      }
-      return PerformHas(result, field_, field_value_, frame.descriptor_pool(),
-                        frame.message_factory(), frame.arena(), result);
-    }
-
-    if (optional_arg) {
-      if (!optional_arg->HasValue()) {
-        // result is still buffer for the container. just return.
-        return absl::OkStatus();
-      }
-      Value value;
-      optional_arg->Value(&value);
-      auto status =
-          PerformOptionalGet(value, field_, field_value_, unboxing_option_,
-                             frame.descriptor_pool(), frame.message_factory(),
-                             frame.arena(), result);
-      if (!status.ok()) {
-        result = ErrorValue(std::move(status));
-      }
-      return absl::OkStatus();
-    }
-
-    return PerformGet(result, field_, field_value_, unboxing_option_,
-                      frame.descriptor_pool(), frame.message_factory(),
-                      frame.arena(), result);
+    return ApplySelect(frame, field_value_, field_, test_only_,
+                       unboxing_option_, enable_optional_types_, result,
+                       attribute);
   }
 
  private:
@@ -390,11 +438,14 @@ class ProtoSelectStep : public SelectStep {
                   bool enable_wrapper_type_null_unboxing,
                   bool enable_optional_types,
                   const google::protobuf::Descriptor* descriptor,
-                  const google::protobuf::FieldDescriptor* field_descriptor)
+                  const google::protobuf::FieldDescriptor* field_descriptor,
+                  const cel::TypedFieldAccessor* absl_nullable accessor)
       : SelectStep(std::move(value), /*test_field_presence=*/false, expr_id,
                    enable_wrapper_type_null_unboxing, enable_optional_types),
         descriptor_(descriptor),
-        field_descriptor_(field_descriptor) {
+        field_descriptor_(field_descriptor),
+        accessor_(accessor != nullptr ? absl::make_optional(*accessor)
+                                      : absl::nullopt) {
     ABSL_DCHECK(descriptor_ != nullptr);
     ABSL_DCHECK(field_descriptor_ != nullptr);
   }
@@ -431,6 +482,8 @@ class ProtoSelectStep : public SelectStep {
 
   const google::protobuf::Descriptor* descriptor_;
   const google::protobuf::FieldDescriptor* field_descriptor_;
+  // Copied, so the step doesn't depend on the type registry's storage.
+  absl::optional<cel::TypedFieldAccessor> accessor_;
 };
 
 bool CheckAttributeTrail(const std::string& field, ExecutionFrame* frame) {
@@ -456,6 +509,18 @@ absl::Status ProtoSelectStep::EvaluateModernMessageGetField(
   if (CheckAttributeTrail(field_, frame)) {
     return absl::OkStatus();
   }
+  if (accessor_.has_value() && accessor_->Matches(*parsed_message)) {
+    accessor_->get(*parsed_message, frame->arena(),
+                   &frame->value_stack().Peek());
+    return absl::OkStatus();
+  }
+  if (AnyUnpackCache* any_unpack_cache = frame->any_unpack_cache();
+      any_unpack_cache != nullptr) {
+    return any_unpack_cache->GetField(
+        parsed_message, field_descriptor_, unboxing_option_,
+        frame->descriptor_pool(), frame->message_factory(), frame->arena(),
+        &frame->value_stack().Peek());
+  }
   return parsed_message.GetField(
       field_descriptor_, unboxing_option_, frame->descriptor_pool(),
       frame->message_factory(), frame->arena(), &frame->value_stack().Peek());
@@ -466,6 +531,11 @@ absl::Status ProtoSelectStep::EvaluateLegacyMessageGetField(
   if (CheckAttributeTrail(field_, frame)) {
     return absl::OkStatus();
   }
+  if (accessor_.has_value() && accessor_->Matches(*legacy_message)) {
+    accessor_->get(*legacy_message, frame->arena(),
+                   &frame->value_stack().Peek());
+    return absl::OkStatus();
+  }
   return cel::interop_internal::WrapLegacyMessageField(
       legacy_message, field_descriptor_, unboxing_option_, frame->arena(),
       &frame->value_stack().Peek());
@@ -476,11 +546,14 @@ class ProtoHasStep : public SelectStep {
   ProtoHasStep(StringValue value, int64_t expr_id,
                bool enable_wrapper_type_null_unboxing,
                bool enable_optional_types, const google::protobuf::Descriptor* descriptor,
-               const google::protobuf::FieldDescriptor* field_descriptor)
+               const google::protobuf::FieldDescriptor* field_descriptor,
+               const cel::TypedFieldAccessor* absl_nullable accessor)
       : SelectStep(std::move(value), /*test_field_presence=*/true, expr_id,
                    enable_wrapper_type_null_unboxing, enable_optional_types),
         descriptor_(descriptor),
-        field_descriptor_(field_descriptor) {
+        field_descriptor_(field_descriptor),
+        accessor_(accessor != nullptr ? absl::make_optional(*accessor)
+                                      : absl::nullopt) {
     ABSL_DCHECK(descriptor_ != nullptr);
     ABSL_DCHECK(field_descriptor_ != nullptr);
   }
@@ -514,6 +587,7 @@ class ProtoHasStep : public SelectStep {
 
   const google::protobuf::Descriptor* descriptor_;
   const google::protobuf::FieldDescriptor* field_descriptor_;
+  absl::optional<cel::TypedFieldAccessor> accessor_;
 };
 
 absl::Status ProtoHasStep::EvaluateHas(
@@ -522,11 +596,80 @@ absl::Status ProtoHasStep::EvaluateHas(
   if (CheckAttributeTrail(field_, frame)) {
     return absl::OkStatus();
   }
+  if (accessor_.has_value() && accessor_->Matches(*parsed_message)) {
+    frame->value_stack().Peek() = BoolValue{accessor_->has(*parsed_message)};
+    return absl::OkStatus();
+  }
   frame->value_stack().Peek() =
       BoolValue{parsed_message.HasField(field_descriptor_)};
   return absl::OkStatus();
 }
 
+// Select or presence test on a field of a non-message struct type resolved at
+// plan time. Custom struct values of that type are accessed by field number,
+// skipping the lookup by name. Anything else uses the generic implementation.
+class CustomStructSelectStep : public SelectStep {
+ public:
+  CustomStructSelectStep(StringValue value, bool test_field_presence,
+                         int64_t expr_id, bool enable_wrapper_type_null_unboxing,
+                         bool enable_optional_types, std::string type_name,
+                         int64_t field_number)
+      : SelectStep(std::move(value), test_field_presence, expr_id,
+                   enable_wrapper_type_null_unboxing, enable_optional_types),
+        type_name_(std::move(type_name)),
+        field_number_(field_number) {
+    ABSL_DCHECK_GT(field_number_, 0);
+  }
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(1)) {
+      return absl::InternalError(
+          "No arguments supplied for Select-type expression");
+    }
+
+    const Value& arg = frame->value_stack().Peek();
+    if (auto unwrapped = arg.AsCustomStruct();
+        unwrapped.has_value() && unwrapped->GetTypeName() == type_name_) {
+      // Copied, as the result replaces the operand on the stack.
+      return EvaluateCustomStruct(frame, cel::CustomStructValue(*unwrapped));
+    }
+    // If we get an unexpected value type, fall back to the generic
+    // implementation.
+    return SelectStep::Evaluate(frame);
+  }
+
+ private:
+  absl::Status EvaluateCustomStruct(ExecutionFrame* frame,
+                                    const cel::CustomStructValue& value) const;
+
+  std::string type_name_;
+  int64_t field_number_;
+};
+
+absl::Status CustomStructSelectStep::EvaluateCustomStruct(
+    ExecutionFrame* frame, const cel::CustomStructValue& value) const {
+  if (CheckAttributeTrail(field_, frame)) {
+    return absl::OkStatus();
+  }
+  Value& result = frame->value_stack().Peek();
+  if (test_field_presence_) {
+    absl::StatusOr<bool> has_field = value.HasFieldByNumber(field_number_);
+    if (!has_field.ok()) {
+      result = ErrorValue(std::move(has_field).status());
+    } else {
+      result = BoolValue{*has_field};
+    }
+    return absl::OkStatus();
+  }
+  absl::Status status = value.GetFieldByNumber(
+      field_number_, unboxing_option_, frame->descriptor_pool(),
+      frame->message_factory(), frame->arena(), &result);
+  if (!status.ok()) {
+    result = ErrorValue(std::move(status));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 std::unique_ptr<DirectExpressionStep> CreateDirectSelectStep(
@@ -551,10 +694,19 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSelectStep(
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateTypedSelectStep(
     cel::StringValue field, cel::StructType resolved_operand_type,
     cel::StructTypeField resolved_field, bool test_only, int64_t expr_id,
-    bool enable_wrapper_type_null_unboxing, bool enable_optional_types) {
+    bool enable_wrapper_type_null_unboxing, bool enable_optional_types,
+    const cel::TypedFieldAccessor* absl_nullable accessor) {
   if (!resolved_operand_type.IsMessage()) {
-    // The specialization only supports messages. Fallback to the generic
-    // implementation for other types.
+    if (!resolved_field.IsMessage() && resolved_field.number() > 0) {
+      // A custom struct type, e.g. described by an introspector registered
+      // with the type registry.
+      return std::make_unique<CustomStructSelectStep>(
+          std::move(field), test_only, expr_id,
+          enable_wrapper_type_null_unboxing, enable_optional_types,
+          std::string(resolved_operand_type.name()), resolved_field.number());
+    }
+    // The specialization only supports messages and numbered custom struct
+    // fields. Fallback to the generic implementation for other types.
     // TODO(uncreated-issue/89): support optional select and chaining.
     return CreateSelectStep(std::move(field), test_only, expr_id,
                             enable_wrapper_type_null_unboxing,
@@ -567,15 +719,20 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateTypedSelectStep(
   const google::protobuf::FieldDescriptor* field_descriptor =
       resolved_field.GetMessage().descriptor();
 
+  if (accessor != nullptr && accessor->field != field_descriptor) {
+    // Registered for a field from another descriptor pool.
+    accessor = nullptr;
+  }
+
   if (test_only) {
     return std::make_unique<ProtoHasStep>(
         std::move(field), expr_id, enable_wrapper_type_null_unboxing,
-        enable_optional_types, descriptor, field_descriptor);
+        enable_optional_types, descriptor, field_descriptor, accessor);
   }
 
   return std::make_unique<ProtoSelectStep>(
       std::move(field), expr_id, enable_wrapper_type_null_unboxing,
-      enable_optional_types, descriptor, field_descriptor);
+      enable_optional_types, descriptor, field_descriptor, accessor);
 }
 
 }  // namespace google::api::expr::runtime
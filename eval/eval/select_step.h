@@ -3,15 +3,34 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "common/type.h"
 #include "common/value.h"
+#include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "runtime/typed_field_accessor.h"
 
 namespace google::api::expr::runtime {
 
+// Applies the field selection (or presence test if `test_only`) to the already
+// evaluated operand in `result`, replacing it with the selected value.
+// `attribute` holds the operand's trail and is extended by `field` when
+// attribute tracking is enabled. `field` and `field_value` hold the same name.
+//
+// Shared by the select steps and generated programs (see
+// runtime/internal/generated_program.h).
+absl::Status ApplySelect(ExecutionFrameBase& frame,
+                         const cel::StringValue& field_value,
+                         const std::string& field, bool test_only,
+                         cel::ProtoWrapperTypeOptions unboxing_option,
+                         bool enable_optional_types, cel::Value& result,
+                         AttributeTrail& attribute);
+
 // Factory method for recursively evaluated select step.
 std::unique_ptr<DirectExpressionStep> CreateDirectSelectStep(
     std::unique_ptr<DirectExpressionStep> operand, cel::StringValue field,
@@ -23,10 +42,15 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSelectStep(
     cel::StringValue field, bool test_only, int64_t expr_id,
     bool enable_wrapper_type_null_unboxing, bool enable_optional_ytpes = false);
 
+// Factory method for a Select step specialized for the operand type resolved
+// at plan time. If `accessor` is non-null, it is used to read the field from
+// instances of its generated message class. Numbered fields of other struct
+// types are read by number from custom struct values of the resolved type.
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateTypedSelectStep(
     cel::StringValue field, cel::StructType resolved_operand_type,
     cel::StructTypeField resolved_field, bool test_only, int64_t expr_id,
-    bool enable_wrapper_type_null_unboxing, bool enable_optional_types);
+    bool enable_wrapper_type_null_unboxing, bool enable_optional_types,
+    const cel::TypedFieldAccessor* absl_nullable accessor = nullptr);
 
 }  // namespace google::api::expr::runtime
 
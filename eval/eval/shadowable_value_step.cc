@@ -38,10 +38,7 @@ class ShadowableValueStep : public ExpressionStepBase {
 
 absl::Status ShadowableValueStep::Evaluate(ExecutionFrame* frame) const {
   cel::Value result;
-  CEL_ASSIGN_OR_RETURN(auto found,
-                       frame->modern_activation().FindVariable(
-                           identifier_, frame->descriptor_pool(),
-                           frame->message_factory(), frame->arena(), &result));
+  CEL_ASSIGN_OR_RETURN(auto found, frame->FindVariable(identifier_, result));
   if (found) {
     frame->value_stack().Push(std::move(result));
   } else {
@@ -71,10 +68,7 @@ class DirectShadowableValueStep : public DirectExpressionStep {
 // 'list' etc, but follows the current behavior of the stack machine version.
 absl::Status DirectShadowableValueStep::Evaluate(
     ExecutionFrameBase& frame, Value& result, AttributeTrail& attribute) const {
-  CEL_ASSIGN_OR_RETURN(auto found,
-                       frame.activation().FindVariable(
-                           identifier_, frame.descriptor_pool(),
-                           frame.message_factory(), frame.arena(), &result));
+  CEL_ASSIGN_OR_RETURN(auto found, frame.FindVariable(identifier_, result));
   if (!found) {
     result = value_;
   }
@@ -0,0 +1,342 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/typed_operator_steps.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/expr.h"
+#include "common/standard_definitions.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "eval/eval/function_step.h"
+#include "internal/overflow.h"
+#include "internal/status_macros.h"
+#include "runtime/function_overload_reference.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::BoolValue;
+using ::cel::DoubleValue;
+using ::cel::ErrorValue;
+using ::cel::IntValue;
+using ::cel::StandardOverloadIds;
+using ::cel::UintValue;
+using ::cel::Value;
+using ::cel::ValueKind;
+
+struct IntOperand {
+  static constexpr ValueKind kKind = ValueKind::kInt;
+  static int64_t Get(const Value& value) {
+    return value.GetInt().NativeValue();
+  }
+  static Value Wrap(int64_t value) { return IntValue(value); }
+};
+
+struct UintOperand {
+  static constexpr ValueKind kKind = ValueKind::kUint;
+  static uint64_t Get(const Value& value) {
+    return value.GetUint().NativeValue();
+  }
+  static Value Wrap(uint64_t value) { return UintValue(value); }
+};
+
+struct DoubleOperand {
+  static constexpr ValueKind kKind = ValueKind::kDouble;
+  static double Get(const Value& value) {
+    return value.GetDouble().NativeValue();
+  }
+  static Value Wrap(double value) { return DoubleValue(value); }
+};
+
+struct DurationOperand {
+  static constexpr ValueKind kKind = ValueKind::kDuration;
+  static absl::Duration Get(const Value& value) {
+    return value.GetDuration().ToDuration();
+  }
+};
+
+struct TimestampOperand {
+  static constexpr ValueKind kKind = ValueKind::kTimestamp;
+  static absl::Time Get(const Value& value) {
+    return value.GetTimestamp().ToTime();
+  }
+};
+
+// Integer arithmetic follows runtime/standard/arithmetic_functions.cc:
+// overflow is reported as an error value.
+template <typename Operand>
+Value WrapChecked(absl::StatusOr<decltype(Operand::Get(Value()))> result) {
+  if (!result.ok()) {
+    return ErrorValue(std::move(result).status());
+  }
+  return Operand::Wrap(*result);
+}
+
+template <typename Operand>
+Value Add(const Value& lhs, const Value& rhs) {
+  if constexpr (Operand::kKind == ValueKind::kDouble) {
+    return Operand::Wrap(Operand::Get(lhs) + Operand::Get(rhs));
+  } else {
+    return WrapChecked<Operand>(
+        cel::internal::CheckedAdd(Operand::Get(lhs), Operand::Get(rhs)));
+  }
+}
+
+template <typename Operand>
+Value Subtract(const Value& lhs, const Value& rhs) {
+  if constexpr (Operand::kKind == ValueKind::kDouble) {
+    return Operand::Wrap(Operand::Get(lhs) - Operand::Get(rhs));
+  } else {
+    return WrapChecked<Operand>(
+        cel::internal::CheckedSub(Operand::Get(lhs), Operand::Get(rhs)));
+  }
+}
+
+template <typename Operand>
+Value Multiply(const Value& lhs, const Value& rhs) {
+  if constexpr (Operand::kKind == ValueKind::kDouble) {
+    return Operand::Wrap(Operand::Get(lhs) * Operand::Get(rhs));
+  } else {
+    return WrapChecked<Operand>(
+        cel::internal::CheckedMul(Operand::Get(lhs), Operand::Get(rhs)));
+  }
+}
+
+template <typename Operand, typename Comparator>
+Value Compare(const Value& lhs, const Value& rhs) {
+  return BoolValue(Comparator()(Operand::Get(lhs), Operand::Get(rhs)));
+}
+
+template <typename Comparator>
+Value CompareStrings(const Value& lhs, const Value& rhs) {
+  return BoolValue(Comparator()(lhs.GetString().Compare(rhs.GetString()), 0));
+}
+
+template <typename Operand>
+TypedBinaryOperator MakeOperator(TypedBinaryOperator::Kernel kernel) {
+  return TypedBinaryOperator{Operand::kKind, kernel};
+}
+
+using OperatorMap = absl::flat_hash_map<absl::string_view, TypedBinaryOperator>;
+
+template <typename Operand>
+void AddComparisons(absl::string_view less, absl::string_view less_equals,
+                    absl::string_view greater,
+                    absl::string_view greater_equals, OperatorMap& operators) {
+  operators[less] = MakeOperator<Operand>(&Compare<Operand, std::less<>>);
+  operators[less_equals] =
+      MakeOperator<Operand>(&Compare<Operand, std::less_equal<>>);
+  operators[greater] = MakeOperator<Operand>(&Compare<Operand, std::greater<>>);
+  operators[greater_equals] =
+      MakeOperator<Operand>(&Compare<Operand, std::greater_equal<>>);
+}
+
+template <typename Operand>
+void AddArithmetic(absl::string_view add, absl::string_view subtract,
+                   absl::string_view multiply, OperatorMap& operators) {
+  operators[add] = MakeOperator<Operand>(&Add<Operand>);
+  operators[subtract] = MakeOperator<Operand>(&Subtract<Operand>);
+  operators[multiply] = MakeOperator<Operand>(&Multiply<Operand>);
+}
+
+OperatorMap MakeOperatorMap() {
+  OperatorMap operators;
+  AddArithmetic<IntOperand>(StandardOverloadIds::kAddInt,
+                            StandardOverloadIds::kSubtractInt,
+                            StandardOverloadIds::kMultiplyInt, operators);
+  AddArithmetic<UintOperand>(StandardOverloadIds::kAddUint,
+                             StandardOverloadIds::kSubtractUint,
+                             StandardOverloadIds::kMultiplyUint, operators);
+  AddArithmetic<DoubleOperand>(StandardOverloadIds::kAddDouble,
+                               StandardOverloadIds::kSubtractDouble,
+                               StandardOverloadIds::kMultiplyDouble, operators);
+  AddComparisons<IntOperand>(
+      StandardOverloadIds::kLessInt, StandardOverloadIds::kLessEqualsInt,
+      StandardOverloadIds::kGreaterInt, StandardOverloadIds::kGreaterEqualsInt,
+      operators);
+  AddComparisons<UintOperand>(
+      StandardOverloadIds::kLessUint, StandardOverloadIds::kLessEqualsUint,
+      StandardOverloadIds::kGreaterUint,
+      StandardOverloadIds::kGreaterEqualsUint, operators);
+  AddComparisons<DoubleOperand>(
+      StandardOverloadIds::kLessDouble, StandardOverloadIds::kLessEqualsDouble,
+      StandardOverloadIds::kGreaterDouble,
+      StandardOverloadIds::kGreaterEqualsDouble, operators);
+  AddComparisons<DurationOperand>(
+      StandardOverloadIds::kLessDuration,
+      StandardOverloadIds::kLessEqualsDuration,
+      StandardOverloadIds::kGreaterDuration,
+      StandardOverloadIds::kGreaterEqualsDuration, operators);
+  AddComparisons<TimestampOperand>(
+      StandardOverloadIds::kLessTimestamp,
+      StandardOverloadIds::kLessEqualsTimestamp,
+      StandardOverloadIds::kGreaterTimestamp,
+      StandardOverloadIds::kGreaterEqualsTimestamp, operators);
+  operators[StandardOverloadIds::kLessString] = TypedBinaryOperator{
+      ValueKind::kString, &CompareStrings<std::less<>>};
+  operators[StandardOverloadIds::kLessEqualsString] = TypedBinaryOperator{
+      ValueKind::kString, &CompareStrings<std::less_equal<>>};
+  operators[StandardOverloadIds::kGreaterString] = TypedBinaryOperator{
+      ValueKind::kString, &CompareStrings<std::greater<>>};
+  operators[StandardOverloadIds::kGreaterEqualsString] = TypedBinaryOperator{
+      ValueKind::kString, &CompareStrings<std::greater_equal<>>};
+  return operators;
+}
+
+// Shared state for the typed steps: the kernel for the expected operand kind
+// and the generic overloads used for anything else.
+class TypedBinaryOperatorImpl {
+ public:
+  TypedBinaryOperatorImpl(TypedBinaryOperator op, const cel::CallExpr& call,
+                          std::vector<cel::FunctionOverloadReference> overloads)
+      : op_(op),
+        name_(call.function()),
+        receiver_style_(call.has_target()),
+        overloads_(std::move(overloads)) {}
+
+  absl::StatusOr<Value> Evaluate(ExecutionFrameBase& frame, int64_t expr_id,
+                                 absl::Span<const Value> args,
+                                 absl::Span<const AttributeTrail> trails) const {
+    // Partially unknown operands are only detectable through the attribute
+    // trail, so unknown processing always takes the generic path.
+    if (args[0].kind() == op_.operand_kind &&
+        args[1].kind() == op_.operand_kind &&
+        !frame.unknown_processing_enabled()) {
+      return op_.kernel(args[0], args[1]);
+    }
+    return InvokeFunctionOverloads(frame, expr_id, name_, receiver_style_,
+                                   overloads_, args, trails);
+  }
+
+ private:
+  TypedBinaryOperator op_;
+  std::string name_;
+  bool receiver_style_;
+  std::vector<cel::FunctionOverloadReference> overloads_;
+};
+
+class DirectTypedBinaryOperatorStep : public DirectExpressionStep {
+ public:
+  DirectTypedBinaryOperatorStep(
+      TypedBinaryOperator op, const cel::CallExpr& call,
+      std::unique_ptr<DirectExpressionStep> lhs,
+      std::unique_ptr<DirectExpressionStep> rhs,
+      std::vector<cel::FunctionOverloadReference> overloads, int64_t expr_id)
+      : DirectExpressionStep(expr_id),
+        impl_(op, call, std::move(overloads)),
+        lhs_(std::move(lhs)),
+        rhs_(std::move(rhs)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute_trail) const override {
+    Value args[2];
+    AttributeTrail trails[2];
+    CEL_RETURN_IF_ERROR(lhs_->Evaluate(frame, args[0], trails[0]));
+    CEL_RETURN_IF_ERROR(rhs_->Evaluate(frame, args[1], trails[1]));
+    CEL_ASSIGN_OR_RETURN(result,
+                         impl_.Evaluate(frame, expr_id(), args, trails));
+    return absl::OkStatus();
+  }
+
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return std::vector<const DirectExpressionStep*>{lhs_.get(), rhs_.get()};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.reserve(2);
+    dependencies.push_back(std::move(lhs_));
+    dependencies.push_back(std::move(rhs_));
+    return dependencies;
+  }
+
+ private:
+  TypedBinaryOperatorImpl impl_;
+  std::unique_ptr<DirectExpressionStep> lhs_;
+  std::unique_ptr<DirectExpressionStep> rhs_;
+};
+
+class IterativeTypedBinaryOperatorStep : public ExpressionStepBase {
+ public:
+  IterativeTypedBinaryOperatorStep(
+      TypedBinaryOperator op, const cel::CallExpr& call,
+      std::vector<cel::FunctionOverloadReference> overloads, int64_t expr_id)
+      : ExpressionStepBase(expr_id), impl_(op, call, std::move(overloads)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(2)) {
+      return absl::Status(absl::StatusCode::kInternal, "Value stack underflow");
+    }
+    CEL_ASSIGN_OR_RETURN(
+        Value result,
+        impl_.Evaluate(*frame, id(), frame->value_stack().GetSpan(2),
+                       frame->value_stack().GetAttributeSpan(2)));
+    frame->value_stack().PopAndPush(2, std::move(result));
+    return absl::OkStatus();
+  }
+
+ private:
+  TypedBinaryOperatorImpl impl_;
+};
+
+}  // namespace
+
+absl::optional<TypedBinaryOperator> FindTypedBinaryOperator(
+    absl::string_view overload_id) {
+  static const absl::NoDestructor<OperatorMap> kOperators(MakeOperatorMap());
+  if (auto it = kOperators->find(overload_id); it != kOperators->end()) {
+    return it->second;
+  }
+  return absl::nullopt;
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectTypedBinaryOperatorStep(
+    TypedBinaryOperator op, const cel::CallExpr& call,
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs,
+    std::vector<cel::FunctionOverloadReference> overloads, int64_t expr_id) {
+  return std::make_unique<DirectTypedBinaryOperatorStep>(
+      op, call, std::move(lhs), std::move(rhs), std::move(overloads), expr_id);
+}
+
+std::unique_ptr<ExpressionStep> CreateTypedBinaryOperatorStep(
+    TypedBinaryOperator op, const cel::CallExpr& call,
+    std::vector<cel::FunctionOverloadReference> overloads, int64_t expr_id) {
+  return std::make_unique<IterativeTypedBinaryOperatorStep>(
+      op, call, std::move(overloads), expr_id);
+}
+
+}  // namespace google::api::expr::runtime
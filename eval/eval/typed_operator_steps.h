@@ -0,0 +1,68 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_TYPED_OPERATOR_STEPS_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_TYPED_OPERATOR_STEPS_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "runtime/function_overload_reference.h"
+
+namespace google::api::expr::runtime {
+
+// Specialized implementation of a standard binary operator overload whose
+// operands have the same kind, e.g. `add_int64` or `less_string`.
+struct TypedBinaryOperator {
+  using Kernel = cel::Value (*)(const cel::Value& lhs, const cel::Value& rhs);
+
+  // The kind both operands must have for `kernel` to apply.
+  cel::ValueKind operand_kind;
+  Kernel kernel;
+};
+
+// Returns the typed implementation for the standard overload id, if any.
+//
+// Covers `_+_`, `_-_` and `_*_` for int, uint and double, and `_<_`, `_<=_`,
+// `_>_` and `_>=_` for int, uint, double, string, duration and timestamp.
+absl::optional<TypedBinaryOperator> FindTypedBinaryOperator(
+    absl::string_view overload_id);
+
+// Factory method for recursive typed binary operator execution step.
+//
+// `overloads` are the runtime overloads for the call. They are used if the
+// operands do not have the expected kind (e.g. errors, unknowns or dyn typed
+// values) or if unknown processing is enabled.
+std::unique_ptr<DirectExpressionStep> CreateDirectTypedBinaryOperatorStep(
+    TypedBinaryOperator op, const cel::CallExpr& call,
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs,
+    std::vector<cel::FunctionOverloadReference> overloads, int64_t expr_id);
+
+// Factory method for iterative typed binary operator execution step.
+std::unique_ptr<ExpressionStep> CreateTypedBinaryOperatorStep(
+    TypedBinaryOperator op, const cel::CallExpr& call,
+    std::vector<cel::FunctionOverloadReference> overloads, int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_TYPED_OPERATOR_STEPS_H_
@@ -0,0 +1,250 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/typed_operator_steps.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/types/optional.h"
+#include "base/attribute.h"
+#include "common/expr.h"
+#include "common/standard_definitions.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "common/value_testing.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "internal/testing_message_factory.h"
+#include "runtime/activation.h"
+#include "runtime/function_overload_reference.h"
+#include "runtime/function_registry.h"
+#include "runtime/internal/runtime_type_provider.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard/arithmetic_functions.h"
+#include "runtime/standard/comparison_functions.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::cel::Attribute;
+using ::cel::DoubleValue;
+using ::cel::ErrorValue;
+using ::cel::IntValue;
+using ::cel::StandardOverloadIds;
+using ::cel::StringValue;
+using ::cel::Value;
+using ::cel::ValueKind;
+using ::cel::test::BoolValueIs;
+using ::cel::test::DoubleValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::ValueKindIs;
+using ::testing::Matcher;
+
+class ValueStep : public ExpressionStep, public DirectExpressionStep {
+ public:
+  ValueStep(Value value, Attribute attr)
+      : ExpressionStep(-1),
+        DirectExpressionStep(-1),
+        value_(std::move(value)),
+        attr_(std::move(attr)) {}
+  explicit ValueStep(Value value)
+      : ExpressionStep(-1),
+        DirectExpressionStep(-1),
+        value_(std::move(value)),
+        attr_() {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    frame->value_stack().Push(value_, attr_);
+    return absl::OkStatus();
+  }
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute_trail) const override {
+    result = value_;
+    attribute_trail = attr_;
+    return absl::OkStatus();
+  }
+
+ private:
+  Value value_;
+  AttributeTrail attr_;
+};
+
+struct TypedOperatorTestCase {
+  std::string function;
+  std::string overload_id;
+  Value lhs;
+  Value rhs;
+  Matcher<Value> result;
+};
+
+class TypedOperatorTest
+    : public ::testing::TestWithParam<TypedOperatorTestCase> {
+ protected:
+  TypedOperatorTest()
+      : type_provider_(cel::internal::GetTestingDescriptorPool()) {
+    cel::RuntimeOptions options;
+    ABSL_CHECK_OK(cel::RegisterArithmeticFunctions(registry_, options));
+    ABSL_CHECK_OK(cel::RegisterComparisonFunctions(registry_, options));
+  }
+
+  cel::CallExpr MakeCall() const {
+    cel::CallExpr call;
+    call.set_function(GetParam().function);
+    return call;
+  }
+
+  TypedBinaryOperator GetOperator() const {
+    absl::optional<TypedBinaryOperator> op =
+        FindTypedBinaryOperator(GetParam().overload_id);
+    ABSL_CHECK(op.has_value());
+    return *op;
+  }
+
+  std::vector<cel::FunctionOverloadReference> GetOverloads() const {
+    return registry_.FindStaticOverloadsByArity(GetParam().function,
+                                                /*receiver_style=*/false, 2);
+  }
+
+  cel::FunctionRegistry registry_;
+  cel::runtime_internal::RuntimeTypeProvider type_provider_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_P(TypedOperatorTest, Recursive) {
+  const TypedOperatorTestCase& test_case = GetParam();
+  cel::Activation activation;
+  cel::RuntimeOptions opts;
+
+  auto plan = CreateDirectTypedBinaryOperatorStep(
+      GetOperator(), MakeCall(), std::make_unique<ValueStep>(test_case.lhs),
+      std::make_unique<ValueStep>(test_case.rhs), GetOverloads(), -1);
+
+  ExecutionFrameBase frame(activation, opts, type_provider_,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena_);
+
+  Value result;
+  AttributeTrail attribute_trail;
+  ASSERT_THAT(plan->Evaluate(frame, result, attribute_trail), IsOk());
+  EXPECT_THAT(result, test_case.result);
+}
+
+TEST_P(TypedOperatorTest, Iterative) {
+  const TypedOperatorTestCase& test_case = GetParam();
+  cel::Activation activation;
+  cel::RuntimeOptions opts;
+
+  FlatExpressionEvaluatorState state(
+      /*value_stack_size=*/5,
+      /*comprehension_slot_count=*/0, type_provider_,
+      cel::internal::GetTestingDescriptorPool(),
+      cel::internal::GetTestingMessageFactory(), &arena_);
+
+  std::vector<std::unique_ptr<const ExpressionStep>> steps;
+  steps.push_back(std::make_unique<ValueStep>(test_case.lhs));
+  steps.push_back(std::make_unique<ValueStep>(test_case.rhs));
+  steps.push_back(CreateTypedBinaryOperatorStep(GetOperator(), MakeCall(),
+                                                GetOverloads(), -1));
+
+  ExecutionFrame frame(steps, activation, opts, state);
+
+  ASSERT_OK_AND_ASSIGN(Value result, frame.Evaluate());
+  EXPECT_THAT(result, test_case.result);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TypedOperatorTest, TypedOperatorTest,
+    testing::Values<TypedOperatorTestCase>(
+        TypedOperatorTestCase{"_+_", std::string(StandardOverloadIds::kAddInt),
+                              IntValue(1), IntValue(2), IntValueIs(3)},
+        TypedOperatorTestCase{"_+_", std::string(StandardOverloadIds::kAddInt),
+                              IntValue(std::numeric_limits<int64_t>::max()),
+                              IntValue(1), ValueKindIs(ValueKind::kError)},
+        TypedOperatorTestCase{"_*_",
+                              std::string(StandardOverloadIds::kMultiplyDouble),
+                              DoubleValue(1.5), DoubleValue(2.0),
+                              DoubleValueIs(3.0)},
+        TypedOperatorTestCase{"_<_",
+                              std::string(StandardOverloadIds::kLessString),
+                              StringValue("a"), StringValue("b"),
+                              BoolValueIs(true)},
+        TypedOperatorTestCase{
+            "_<=_", std::string(StandardOverloadIds::kLessEqualsDouble),
+            DoubleValue(std::numeric_limits<double>::quiet_NaN()),
+            DoubleValue(1.0), BoolValueIs(false)},
+        // Operands that don't match the checked overload use the registered
+        // overloads.
+        TypedOperatorTestCase{"_<_", std::string(StandardOverloadIds::kLessInt),
+                              IntValue(1), DoubleValue(1.5), BoolValueIs(true)},
+        TypedOperatorTestCase{"_+_", std::string(StandardOverloadIds::kAddInt),
+                              IntValue(1), DoubleValue(1.5),
+                              ValueKindIs(ValueKind::kError)},
+        TypedOperatorTestCase{"_-_",
+                              std::string(StandardOverloadIds::kSubtractInt),
+                              ErrorValue(absl::InternalError("error")),
+                              IntValue(1), ValueKindIs(ValueKind::kError)}));
+
+TEST(TypedOperatorStepTest, UnsupportedOverload) {
+  EXPECT_FALSE(FindTypedBinaryOperator(StandardOverloadIds::kAddList));
+  EXPECT_FALSE(FindTypedBinaryOperator(StandardOverloadIds::kLessIntDouble));
+  EXPECT_FALSE(FindTypedBinaryOperator("custom_overload"));
+}
+
+TEST(TypedOperatorStepTest, PartialAttrUnknown) {
+  cel::FunctionRegistry registry;
+  cel::RuntimeOptions opts;
+  opts.unknown_processing = cel::UnknownProcessingOptions::kAttributeOnly;
+  ASSERT_THAT(cel::RegisterArithmeticFunctions(registry, opts), IsOk());
+  cel::runtime_internal::RuntimeTypeProvider type_provider(
+      cel::internal::GetTestingDescriptorPool());
+  google::protobuf::Arena arena;
+  cel::Activation activation;
+  activation.SetUnknownPatterns({cel::AttributePattern(
+      "foo", {cel::AttributeQualifierPattern::OfString("bar")})});
+
+  cel::CallExpr call;
+  call.set_function("_+_");
+  auto plan = CreateDirectTypedBinaryOperatorStep(
+      *FindTypedBinaryOperator(StandardOverloadIds::kAddInt), call,
+      std::make_unique<ValueStep>(IntValue(1), Attribute("foo")),
+      std::make_unique<ValueStep>(IntValue(2)),
+      registry.FindStaticOverloadsByArity("_+_", /*receiver_style=*/false, 2),
+      -1);
+
+  ExecutionFrameBase frame(activation, opts, type_provider,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena);
+
+  Value result;
+  AttributeTrail attribute_trail;
+  ASSERT_THAT(plan->Evaluate(frame, result, attribute_trail), IsOk());
+  EXPECT_THAT(result, ValueKindIs(ValueKind::kUnknown));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -43,8 +43,15 @@ cel::RuntimeOptions ConvertToRuntimeOptions(const InterpreterOptions& options) {
       options.max_recursion_depth,
       options.enable_recursive_tracing,
       options.enable_fast_builtins,
+      options.enable_typed_binary_operators,
       options.enable_precision_preserving_double_format,
       options.enable_typed_field_access,
+      options.enable_arena_resident_values,
+      options.function_memoization_max_entries,
+      options.comprehension_parallelism,
+      options.parallel_comprehension_min_size,
+      options.enable_any_unpack_cache,
+      options.eager_any_unpack_type_urls,
   };
 }
 
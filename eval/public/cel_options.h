@@ -17,6 +17,10 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_CEL_OPTIONS_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_CEL_OPTIONS_H_
 
+#include <cstddef>
+#include <string>
+#include <vector>
+
 #include "absl/base/attributes.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
@@ -188,6 +192,8 @@ struct InterpreterOptions {
   // -1 means unbounded.
   // 0 means disabled (using a heap-based stack machine instead), which is the
   // default.
+  // `cel::kAdaptiveRecursionDepth` chooses per subexpression, see
+  // `cel::RuntimeOptions::max_recursion_depth`.
   int max_recursion_depth = 0;
 
   // Enable tracing support for recursively planned programs.
@@ -206,9 +212,18 @@ struct InterpreterOptions {
   // overloads have been added for these functions, and will attempt to use them
   // if they exist.
   //
-  // Currently applies to !_, @not_strictly_false, _==_, _!=_, @in
+  // Currently applies to !_, @not_strictly_false, _==_, _!=_, and @in.
   bool enable_fast_builtins = true;
 
+  // Enable typed implementations for checked calls to standard operators.
+  //
+  // Applies to _+_, _-_, _*_, _<_, _<=_, _>_, _>=_ calls that the type checker
+  // resolved to a single same-typed numeric (or, for comparisons, string,
+  // duration or timestamp) overload. The typed implementation replaces the
+  // registered overload with that signature, so this must stay disabled if
+  // the standard overloads are replaced by custom ones.
+  bool enable_typed_binary_operators = false;
+
   // When enabled, string(double) will format the double with enough precision
   // to ensure that the original double value can be recovered exactly.
   //
@@ -223,6 +238,42 @@ struct InterpreterOptions {
   // path for field access when the type is known at plan time, instead of using
   // the generic field access implementation.
   bool enable_typed_field_access = false;
+
+  // When enabled, values produced during evaluation are kept arena resident so
+  // that copying them is a trivial copy without reference count updates.
+  //
+  // The planner allocates constants on the program's arena, and values loaded
+  // from the activation or returned by extension functions that would require
+  // reference counting are copied to the evaluation arena. Each activation
+  // variable is copied once per evaluation, however often it is referenced,
+  // except in comprehensions split across threads (see
+  // `comprehension_parallelism`), which copy it on each reference. Values read
+  // from message fields are not copied, so they may still be reference
+  // counted.
+  //
+  // Evaluation results may then borrow from both the program and the
+  // evaluation arena, so both must outlive all results. Intended for
+  // request-scoped evaluations where that is already the case.
+  bool enable_arena_resident_values = false;
+
+  // Maximum number of results of deterministic function calls memoized per
+  // evaluation. 0 disables memoization.
+  size_t function_memoization_max_entries = 0;
+
+  // Number of threads used to evaluate a large all(), exists(), map() or
+  // filter() over a list. 1 disables parallel evaluation. See
+  // `cel::RuntimeOptions::comprehension_parallelism`.
+  int comprehension_parallelism = 1;
+
+  // Minimum list size for parallel comprehension evaluation.
+  int parallel_comprehension_min_size = 16384;
+
+  // Memoize the values of google.protobuf.Any fields per evaluation.
+  bool enable_any_unpack_cache = false;
+
+  // Type URLs of google.protobuf.Any fields of bound messages that are
+  // unpacked when the message is bound. Requires enable_any_unpack_cache.
+  std::vector<std::string> eager_any_unpack_type_urls;
 };
 // LINT.ThenChange(//depot/google3/runtime/runtime_options.h)
 
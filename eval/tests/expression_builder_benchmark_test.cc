@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <cmath>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -35,6 +36,12 @@
 #include "internal/status_macros.h"
 #include "internal/testing.h"
 #include "parser/parser.h"
+#include "runtime/function_adapter.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_builder_factory.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
 #include "google/protobuf/arena.h"
 
 namespace google::api::expr::runtime {
@@ -76,6 +83,29 @@ void BM_RegisterBuiltins(benchmark::State& state) {
 
 BENCHMARK(BM_RegisterBuiltins);
 
+// Derives a runtime with one additional function from a fully configured
+// standard runtime, for comparison with BM_RegisterBuiltins.
+void BM_DeriveStandardRuntime(benchmark::State& state) {
+  ASSERT_OK_AND_ASSIGN(
+      cel::RuntimeBuilder base_builder,
+      cel::CreateStandardRuntimeBuilder(cel::GetMinimalDescriptorPool(),
+                                        cel::RuntimeOptions{}));
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const cel::Runtime> base,
+                       std::move(base_builder).Build());
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::RuntimeBuilder builder,
+                         cel::CreateDerivedRuntimeBuilder(base));
+    ASSERT_OK(
+        (cel::UnaryFunctionAdapter<int64_t, int64_t>::RegisterGlobalOverload(
+            "tenant_fn", [](int64_t x) { return x; },
+            builder.function_registry())));
+    ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+    benchmark::DoNotOptimize(runtime);
+  }
+}
+
+BENCHMARK(BM_DeriveStandardRuntime);
+
 InterpreterOptions OptionsForParam(BenchmarkParam param, google::protobuf::Arena& arena) {
   InterpreterOptions options;
   switch (param) {
@@ -35,7 +35,9 @@
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "base/attribute.h"
 #include "checker/validation_result.h"
 #include "common/allocator.h"
 #include "common/casting.h"
@@ -1467,6 +1469,46 @@ void BM_MapTransformComprehension(benchmark::State& state) {
 
 BENCHMARK(BM_MapTransformComprehension)->Range(1, 1 << 16);
 
+// Partial evaluation over a wide request: every `m[k]` is an unknown attribute,
+// and the comprehension merges them into a single unknown set.
+void BM_UnknownAttributes(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  options.unknown_processing = UnknownProcessingOptions::kAttributeOnly;
+  options.comprehension_max_iterations = 10000000;
+  auto runtime = StandardRuntimeOrDie(options);
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse("keys.all(k, m[k] > 0)"));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          *runtime, parsed_expr));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+
+  int len = state.range(0);
+  auto list_builder = cel::NewListValueBuilder(&arena);
+  list_builder->Reserve(len);
+  std::vector<AttributePattern> patterns;
+  patterns.reserve(len);
+  for (int i = 0; i < len; i++) {
+    std::string key = absl::StrCat("key", i);
+    ASSERT_THAT(list_builder->Add(StringValue(&arena, key)), IsOk());
+    patterns.push_back(AttributePattern(
+        "m", {AttributeQualifierPattern::OfString(std::move(key))}));
+  }
+  activation.InsertOrAssignValue("keys", std::move(*list_builder).Build());
+  activation.InsertOrAssignValue("m", cel::MapValue());
+  activation.SetUnknownPatterns(std::move(patterns));
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.IsUnknown());
+    ASSERT_EQ(result.GetUnknown().attribute_set().size(), len);
+  }
+}
+
+BENCHMARK(BM_UnknownAttributes)->Range(1, 1 << 12);
+
 }  // namespace
 
 }  // namespace cel
@@ -29,11 +29,10 @@
 #include "absl/meta/type_traits.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/cord.h"
-#include "absl/strings/str_cat.h"
 #include "common/memory.h"
 #include "common/type.h"
 #include "common/value.h"
+#include "internal/message_copy.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -76,16 +75,7 @@ inline absl::Status ProtoMessageFromValue(const Value& value,
       return absl::OkStatus();
     }
     if (dest_descriptor->full_name() == src_descriptor->full_name()) {
-      absl::Cord serialized;
-      if (!src_message->SerializePartialToCord(&serialized)) {
-        return absl::UnknownError(absl::StrCat("failed to serialize message: ",
-                                               src_descriptor->full_name()));
-      }
-      if (!dest_message.ParsePartialFromCord(serialized)) {
-        return absl::UnknownError(absl::StrCat("failed to parse message: ",
-                                               dest_descriptor->full_name()));
-      }
-      return absl::OkStatus();
+      return cel::internal::CopyMessage(*src_message, &dest_message);
     }
   }
   return TypeConversionError(value.GetRuntimeType(),
@@ -0,0 +1,470 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/message_copy.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "internal/status_macros.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/unknown_field_set.h"
+
+namespace cel::internal {
+
+namespace {
+
+using ::google::protobuf::Descriptor;
+using ::google::protobuf::FieldDescriptor;
+using ::google::protobuf::Message;
+using ::google::protobuf::Reflection;
+using ::google::protobuf::UnknownFieldSet;
+
+class MessageCopyPlan;
+
+using MessageCopyPlanKey =
+    std::pair<const Descriptor* absl_nonnull, const Descriptor* absl_nonnull>;
+
+using MessageCopyPlanMap =
+    absl::flat_hash_map<MessageCopyPlanKey, std::unique_ptr<MessageCopyPlan>>;
+
+absl::Status CopyMessageUsingSerialization(const Message& from,
+                                           Message* absl_nonnull to) {
+  absl::Cord serialized;
+  if (!from.SerializePartialToString(&serialized)) {
+    return absl::UnknownError(
+        absl::StrCat("failed to serialize message: ", from.GetTypeName()));
+  }
+  if (!to->ParsePartialFromString(serialized)) {
+    return absl::UnknownError(
+        absl::StrCat("failed to parse message: ", to->GetTypeName()));
+  }
+  return absl::OkStatus();
+}
+
+// Precomputed field by field copy from messages of one descriptor to messages
+// of an equivalent descriptor, possibly from another pool.
+//
+// Plans outlive the copies they were built for, and the pools of their
+// descriptors may be destroyed and the addresses reused in the meantime, by
+// descriptors of a different schema. So a plan checks everything it was built
+// from, starting with the addresses of the descriptors, against those of the
+// messages being copied before using them, and reports itself stale if any of
+// it differs.
+class MessageCopyPlan final {
+ public:
+  // Returns the plan for copying `from` to `to`, building it and the plans of
+  // any message typed fields into `plans` if they are not present.
+  static const MessageCopyPlan* absl_nonnull Build(
+      const Descriptor* absl_nonnull from, const Descriptor* absl_nonnull to,
+      MessageCopyPlanMap& plans);
+
+  MessageCopyPlan() = default;
+  MessageCopyPlan(const MessageCopyPlan&) = delete;
+  MessageCopyPlan& operator=(const MessageCopyPlan&) = delete;
+
+  // Merges `from` into `to`, which should be empty. Returns false if the plan
+  // is stale, leaving `to` partially copied.
+  absl::StatusOr<bool> Copy(const Message& from,
+                            Message* absl_nonnull to) const;
+
+ private:
+  struct FieldPlan {
+    const FieldDescriptor* absl_nonnull from;
+    const FieldDescriptor* absl_nonnull to;
+    int from_index;
+    int to_index;
+    // The number both fields were matched by.
+    int number;
+    FieldDescriptor::Type type;
+    bool is_repeated;
+    bool is_map;
+    // Plan for the field's message type, set iff it is a message or group.
+    const MessageCopyPlan* absl_nullable message_plan;
+  };
+
+  bool Matches(const Descriptor* absl_nonnull from,
+               const Descriptor* absl_nonnull to) const;
+
+  absl::StatusOr<bool> CopySingularField(const FieldPlan& plan,
+                                         const Message& from,
+                                         const Reflection& from_reflection,
+                                         Message* absl_nonnull to,
+                                         const Reflection& to_reflection,
+                                         std::string& scratch) const;
+
+  absl::StatusOr<bool> CopyRepeatedField(const FieldPlan& plan,
+                                         const Message& from,
+                                         const Reflection& from_reflection,
+                                         Message* absl_nonnull to,
+                                         const Reflection& to_reflection,
+                                         std::string& scratch) const;
+
+  const Descriptor* absl_nullable from_ = nullptr;
+  const Descriptor* absl_nullable to_ = nullptr;
+  std::string from_name_;
+  std::string to_name_;
+  int from_field_count_ = 0;
+  int to_field_count_ = 0;
+  bool use_serialization_ = false;
+  std::vector<FieldPlan> fields_;
+};
+
+const MessageCopyPlan* absl_nonnull MessageCopyPlan::Build(
+    const Descriptor* absl_nonnull from, const Descriptor* absl_nonnull to,
+    MessageCopyPlanMap& plans) {
+  if (auto it = plans.find(MessageCopyPlanKey(from, to)); it != plans.end()) {
+    return it->second.get();
+  }
+  // Insert before visiting fields so recursive message types terminate.
+  MessageCopyPlan* absl_nonnull plan =
+      plans
+          .insert({MessageCopyPlanKey(from, to),
+                   std::make_unique<MessageCopyPlan>()})
+          .first->second.get();
+  plan->from_ = from;
+  plan->to_ = to;
+  plan->from_name_ = std::string(from->full_name());
+  plan->to_name_ = std::string(to->full_name());
+  plan->from_field_count_ = from->field_count();
+  plan->to_field_count_ = to->field_count();
+  if (from->extension_range_count() > 0) {
+    plan->use_serialization_ = true;
+    return plan;
+  }
+  plan->fields_.reserve(from->field_count());
+  for (int i = 0; i < from->field_count(); ++i) {
+    const FieldDescriptor* absl_nonnull from_field = from->field(i);
+    const FieldDescriptor* absl_nullable to_field =
+        to->FindFieldByNumber(from_field->number());
+    if (to_field == nullptr || to_field->type() != from_field->type() ||
+        to_field->is_repeated() != from_field->is_repeated() ||
+        to_field->is_map() != from_field->is_map() ||
+        from_field->options().weak() || to_field->options().weak()) {
+      plan->use_serialization_ = true;
+      plan->fields_.clear();
+      return plan;
+    }
+    FieldPlan field_plan{from_field,
+                         to_field,
+                         from_field->index(),
+                         to_field->index(),
+                         from_field->number(),
+                         from_field->type(),
+                         from_field->is_repeated(),
+                         from_field->is_map(),
+                         nullptr};
+    if (from_field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      field_plan.message_plan =
+          Build(from_field->message_type(), to_field->message_type(), plans);
+    }
+    plan->fields_.push_back(field_plan);
+  }
+  return plan;
+}
+
+bool MessageCopyPlan::Matches(const Descriptor* absl_nonnull from,
+                              const Descriptor* absl_nonnull to) const {
+  // Only dereference the held descriptors once they are known to be live.
+  if (from != from_ || to != to_ || from->field_count() != from_field_count_ ||
+      to->field_count() != to_field_count_ ||
+      from->full_name() != from_name_ || to->full_name() != to_name_) {
+    return false;
+  }
+  if (use_serialization_) {
+    // Serialization copies between any descriptors.
+    return true;
+  }
+  if (from->extension_range_count() > 0) {
+    return false;
+  }
+  for (const FieldPlan& plan : fields_) {
+    if (from->field(plan.from_index) != plan.from ||
+        to->field(plan.to_index) != plan.to) {
+      return false;
+    }
+    for (const FieldDescriptor* field : {plan.from, plan.to}) {
+      if (field->number() != plan.number || field->type() != plan.type ||
+          field->is_repeated() != plan.is_repeated ||
+          field->is_map() != plan.is_map || field->options().weak()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+absl::StatusOr<bool> MessageCopyPlan::Copy(const Message& from,
+                                           Message* absl_nonnull to) const {
+  if (ABSL_PREDICT_FALSE(!Matches(from.GetDescriptor(), to->GetDescriptor()))) {
+    return false;
+  }
+  if (use_serialization_) {
+    CEL_RETURN_IF_ERROR(CopyMessageUsingSerialization(from, to));
+    return true;
+  }
+  const Reflection& from_reflection = *from.GetReflection();
+  const Reflection& to_reflection = *to->GetReflection();
+  std::string scratch;
+  for (const FieldPlan& plan : fields_) {
+    bool copied;
+    if (plan.from->is_repeated()) {
+      CEL_ASSIGN_OR_RETURN(copied,
+                           CopyRepeatedField(plan, from, from_reflection, to,
+                                             to_reflection, scratch));
+    } else {
+      CEL_ASSIGN_OR_RETURN(copied,
+                           CopySingularField(plan, from, from_reflection, to,
+                                             to_reflection, scratch));
+    }
+    if (ABSL_PREDICT_FALSE(!copied)) {
+      return false;
+    }
+  }
+  if (const UnknownFieldSet& unknown_fields =
+          from_reflection.GetUnknownFields(from);
+      !unknown_fields.empty()) {
+    to_reflection.MutableUnknownFields(to)->MergeFrom(unknown_fields);
+  }
+  return true;
+}
+
+absl::StatusOr<bool> MessageCopyPlan::CopySingularField(
+    const FieldPlan& plan, const Message& from,
+    const Reflection& from_reflection, Message* absl_nonnull to,
+    const Reflection& to_reflection, std::string& scratch) const {
+  if (!from_reflection.HasField(from, plan.from)) {
+    return true;
+  }
+  switch (plan.from->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      to_reflection.SetInt32(to, plan.to,
+                             from_reflection.GetInt32(from, plan.from));
+      return true;
+    case FieldDescriptor::CPPTYPE_INT64:
+      to_reflection.SetInt64(to, plan.to,
+                             from_reflection.GetInt64(from, plan.from));
+      return true;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      to_reflection.SetUInt32(to, plan.to,
+                              from_reflection.GetUInt32(from, plan.from));
+      return true;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      to_reflection.SetUInt64(to, plan.to,
+                              from_reflection.GetUInt64(from, plan.from));
+      return true;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      to_reflection.SetFloat(to, plan.to,
+                             from_reflection.GetFloat(from, plan.from));
+      return true;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      to_reflection.SetDouble(to, plan.to,
+                              from_reflection.GetDouble(from, plan.from));
+      return true;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      to_reflection.SetBool(to, plan.to,
+                            from_reflection.GetBool(from, plan.from));
+      return true;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      to_reflection.SetEnumValue(to, plan.to,
+                                 from_reflection.GetEnumValue(from, plan.from));
+      return true;
+    case FieldDescriptor::CPPTYPE_STRING:
+      to_reflection.SetString(
+          to, plan.to,
+          from_reflection.GetStringReference(from, plan.from, &scratch));
+      return true;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return plan.message_plan->Copy(
+          from_reflection.GetMessage(from, plan.from),
+          to_reflection.MutableMessage(to, plan.to));
+  }
+  ABSL_UNREACHABLE();
+}
+
+absl::StatusOr<bool> MessageCopyPlan::CopyRepeatedField(
+    const FieldPlan& plan, const Message& from,
+    const Reflection& from_reflection, Message* absl_nonnull to,
+    const Reflection& to_reflection, std::string& scratch) const {
+  const int size = from_reflection.FieldSize(from, plan.from);
+  switch (plan.from->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddInt32(
+            to, plan.to, from_reflection.GetRepeatedInt32(from, plan.from, i));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_INT64:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddInt64(
+            to, plan.to, from_reflection.GetRepeatedInt64(from, plan.from, i));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddUInt32(
+            to, plan.to,
+            from_reflection.GetRepeatedUInt32(from, plan.from, i));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddUInt64(
+            to, plan.to,
+            from_reflection.GetRepeatedUInt64(from, plan.from, i));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddFloat(
+            to, plan.to, from_reflection.GetRepeatedFloat(from, plan.from, i));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddDouble(
+            to, plan.to,
+            from_reflection.GetRepeatedDouble(from, plan.from, i));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddBool(
+            to, plan.to, from_reflection.GetRepeatedBool(from, plan.from, i));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddEnumValue(
+            to, plan.to,
+            from_reflection.GetRepeatedEnumValue(from, plan.from, i));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_STRING:
+      for (int i = 0; i < size; ++i) {
+        to_reflection.AddString(to, plan.to,
+                                from_reflection.GetRepeatedStringReference(
+                                    from, plan.from, i, &scratch));
+      }
+      return true;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      // Map fields are copied as their repeated entry messages.
+      for (int i = 0; i < size; ++i) {
+        CEL_ASSIGN_OR_RETURN(
+            bool copied,
+            plan.message_plan->Copy(
+                from_reflection.GetRepeatedMessage(from, plan.from, i),
+                to_reflection.AddMessage(to, plan.to)));
+        if (ABSL_PREDICT_FALSE(!copied)) {
+          return false;
+        }
+      }
+      return true;
+  }
+  ABSL_UNREACHABLE();
+}
+
+// The plans built for copying between one pair of descriptors.
+struct MessageCopyPlans final {
+  MessageCopyPlanMap plans;
+  const MessageCopyPlan* absl_nonnull root;
+};
+
+// Process wide cache of plans, keyed by the pair of descriptors they copy
+// between. Stale entries are replaced when a copy detects them, and the cache
+// is dropped when it grows past `kMaxEntries`, as descriptors of destroyed
+// pools are never looked up again.
+class MessageCopyPlanCache final {
+ public:
+  static constexpr size_t kMaxEntries = 1024;
+
+  static MessageCopyPlanCache& Get() {
+    static absl::NoDestructor<MessageCopyPlanCache> instance;
+    return *instance;
+  }
+
+  std::shared_ptr<const MessageCopyPlans> Find(
+      const Descriptor* absl_nonnull from, const Descriptor* absl_nonnull to) {
+    {
+      absl::ReaderMutexLock lock(mutex_);
+      if (auto it = plans_.find(MessageCopyPlanKey(from, to));
+          it != plans_.end()) {
+        return it->second;
+      }
+    }
+    return Rebuild(from, to);
+  }
+
+  std::shared_ptr<const MessageCopyPlans> Rebuild(
+      const Descriptor* absl_nonnull from, const Descriptor* absl_nonnull to) {
+    auto plans = std::make_shared<MessageCopyPlans>();
+    plans->root = MessageCopyPlan::Build(from, to, plans->plans);
+    absl::MutexLock lock(mutex_);
+    if (plans_.size() >= kMaxEntries) {
+      plans_.clear();
+    }
+    plans_.insert_or_assign(MessageCopyPlanKey(from, to), plans);
+    return plans;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<MessageCopyPlanKey,
+                      std::shared_ptr<const MessageCopyPlans>>
+      plans_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+absl::Status CopyMessage(const google::protobuf::Message& from,
+                         google::protobuf::Message* absl_nonnull to) {
+  ABSL_DCHECK(to != nullptr);
+  const Descriptor* from_descriptor = from.GetDescriptor();
+  const Descriptor* to_descriptor = to->GetDescriptor();
+  if (from_descriptor == to_descriptor) {
+    to->CopyFrom(from);
+    return absl::OkStatus();
+  }
+  MessageCopyPlanCache& cache = MessageCopyPlanCache::Get();
+  std::shared_ptr<const MessageCopyPlans> plans =
+      cache.Find(from_descriptor, to_descriptor);
+  to->Clear();
+  CEL_ASSIGN_OR_RETURN(bool copied, plans->root->Copy(from, to));
+  if (ABSL_PREDICT_FALSE(!copied)) {
+    // The cached plan was built for descriptors which have since been
+    // destroyed. Plans built for the live descriptors always match them.
+    plans = cache.Rebuild(from_descriptor, to_descriptor);
+    to->Clear();
+    CEL_ASSIGN_OR_RETURN(copied, plans->root->Copy(from, to));
+    ABSL_DCHECK(copied);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace cel::internal
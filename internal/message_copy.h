@@ -0,0 +1,37 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_INTERNAL_MESSAGE_COPY_H_
+#define THIRD_PARTY_CEL_CPP_INTERNAL_MESSAGE_COPY_H_
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "google/protobuf/message.h"
+
+namespace cel::internal {
+
+// Replaces the contents of `to` with a copy of `from`, as
+// `google::protobuf::Message::CopyFrom` does, except that the descriptors of
+// `from` and `to` may be equivalent descriptors from different pools.
+//
+// Fields are matched by number and type through a plan which is built once
+// per pair of descriptors and cached. Messages with extensions, or with fields
+// that have no counterpart of the same type, are copied by serializing and
+// parsing them, like the wire format would.
+absl::Status CopyMessage(const google::protobuf::Message& from,
+                         google::protobuf::Message* absl_nonnull to);
+
+}  // namespace cel::internal
+
+#endif  // THIRD_PARTY_CEL_CPP_INTERNAL_MESSAGE_COPY_H_
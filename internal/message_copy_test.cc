@@ -0,0 +1,213 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/message_copy.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "internal/equals_text_proto.h"
+#include "internal/parse_text_proto.h"
+#include "internal/testing.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/text_format.h"
+
+namespace cel::internal {
+namespace {
+
+using ::absl_testing::IsOk;
+
+using TestAllTypesProto3 = ::cel::expr::conformance::proto3::TestAllTypes;
+
+constexpr absl::string_view kTestAllTypes = R"pb(
+  single_int32: 1
+  single_int64: 2
+  single_uint32: 3
+  single_uint64: 4
+  single_float: 5.5
+  single_double: 6.5
+  single_bool: true
+  single_string: "foo"
+  single_bytes: "bar"
+  standalone_enum: BAZ
+  single_nested_message { bb: 7 }
+  single_any {
+    [type.googleapis.com/cel.expr.conformance.proto3.TestAllTypes] {
+      single_int64: 8
+    }
+  }
+  single_struct {
+    fields {
+      key: "baz"
+      value { list_value { values { number_value: 9 } } }
+    }
+  }
+  oneof_type { payload { single_int32: 10 } }
+  repeated_int32: [ 11, 12 ]
+  repeated_string: [ "a", "b" ]
+  repeated_nested_enum: [ FOO, BAR ]
+  repeated_nested_message { bb: 13 }
+  map_string_string { key: "c" value: "d" }
+  map_int64_nested_type {
+    key: 14
+    value { payload { single_int32: 15 } }
+  }
+)pb";
+
+class MessageCopyTest : public ::testing::Test {
+ protected:
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(MessageCopyTest, SameDescriptor) {
+  TestAllTypesProto3* from =
+      GeneratedParseTextProto<TestAllTypesProto3>(&arena_, kTestAllTypes);
+  TestAllTypesProto3 to;
+  to.set_single_sint32(1);
+
+  ASSERT_THAT(CopyMessage(*from, &to), IsOk());
+  EXPECT_THAT(to, EqualsTextProto<TestAllTypesProto3>(&arena_, kTestAllTypes));
+}
+
+TEST_F(MessageCopyTest, DynamicToGenerated) {
+  google::protobuf::Message* from =
+      DynamicParseTextProto<TestAllTypesProto3>(&arena_, kTestAllTypes);
+  ASSERT_NE(from->GetDescriptor(), TestAllTypesProto3::descriptor());
+  TestAllTypesProto3 to;
+  to.set_single_sint32(1);
+
+  ASSERT_THAT(CopyMessage(*from, &to), IsOk());
+  EXPECT_THAT(to, EqualsTextProto<TestAllTypesProto3>(&arena_, kTestAllTypes));
+  // Copying again reuses the cached plan.
+  ASSERT_THAT(CopyMessage(*from, &to), IsOk());
+  EXPECT_THAT(to, EqualsTextProto<TestAllTypesProto3>(&arena_, kTestAllTypes));
+}
+
+TEST_F(MessageCopyTest, GeneratedToDynamic) {
+  TestAllTypesProto3* from =
+      GeneratedParseTextProto<TestAllTypesProto3>(&arena_, kTestAllTypes);
+  from->GetReflection()->MutableUnknownFields(from)->AddVarint(1000, 1);
+  google::protobuf::Message* to =
+      DynamicParseTextProto<TestAllTypesProto3>(&arena_, "single_sint32: 1");
+
+  ASSERT_THAT(CopyMessage(*from, to), IsOk());
+  EXPECT_THAT(*to, EqualsTextProto<TestAllTypesProto3>(&arena_, kTestAllTypes));
+  EXPECT_EQ(to->GetReflection()->GetUnknownFields(*to).field_count(), 1);
+}
+
+// Builds a pool with a single message, `test.Message`, whose fields are
+// described by `fields`.
+std::unique_ptr<google::protobuf::DescriptorPool> MakePool(absl::string_view fields) {
+  google::protobuf::FileDescriptorProto file;
+  ABSL_CHECK(google::protobuf::TextFormat::ParseFromString(  // Crash OK
+      absl::StrCat(R"pb(
+                     name: "test.proto"
+                     package: "test"
+                     syntax: "proto3"
+                     message_type { name: "Message" )pb",
+                   fields, "}"),
+      &file));
+  auto pool = std::make_unique<google::protobuf::DescriptorPool>();
+  ABSL_CHECK(pool->BuildFile(file) != nullptr);  // Crash OK
+  return pool;
+}
+
+TEST_F(MessageCopyTest, IncompatibleFieldsUseSerialization) {
+  std::unique_ptr<google::protobuf::DescriptorPool> from_pool = MakePool(R"pb(
+    field { name: "a" number: 1 type: TYPE_INT32 label: LABEL_OPTIONAL }
+    field { name: "b" number: 2 type: TYPE_STRING label: LABEL_OPTIONAL }
+  )pb");
+  std::unique_ptr<google::protobuf::DescriptorPool> to_pool = MakePool(R"pb(
+    field { name: "a" number: 1 type: TYPE_INT64 label: LABEL_OPTIONAL }
+  )pb");
+  google::protobuf::DynamicMessageFactory from_factory(from_pool.get());
+  google::protobuf::DynamicMessageFactory to_factory(to_pool.get());
+  std::unique_ptr<google::protobuf::Message> from(
+      from_factory
+          .GetPrototype(from_pool->FindMessageTypeByName("test.Message"))
+          ->New());
+  std::unique_ptr<google::protobuf::Message> to(
+      to_factory.GetPrototype(to_pool->FindMessageTypeByName("test.Message"))
+          ->New());
+  ASSERT_TRUE(
+      google::protobuf::TextFormat::ParseFromString("a: 1 b: \"foo\"", from.get()));
+
+  ASSERT_THAT(CopyMessage(*from, to.get()), IsOk());
+  EXPECT_EQ(to->GetReflection()->GetInt64(
+                *to, to->GetDescriptor()->FindFieldByName("a")),
+            1);
+  // Fields without a counterpart are kept as unknown fields, as when parsing.
+  EXPECT_EQ(to->GetReflection()->GetUnknownFields(*to).field_count(), 1);
+}
+
+// Copies `text`, parsed as `test.Message` of `from_pool`, to a message of
+// `to_pool`, and returns it printed as text.
+std::string PoolCopyMessage(const google::protobuf::DescriptorPool& from_pool,
+                            const google::protobuf::DescriptorPool& to_pool,
+                            absl::string_view text) {
+  google::protobuf::DynamicMessageFactory from_factory(&from_pool);
+  google::protobuf::DynamicMessageFactory to_factory(&to_pool);
+  std::unique_ptr<google::protobuf::Message> from(
+      from_factory.GetPrototype(from_pool.FindMessageTypeByName("test.Message"))
+          ->New());
+  std::unique_ptr<google::protobuf::Message> to(
+      to_factory.GetPrototype(to_pool.FindMessageTypeByName("test.Message"))
+          ->New());
+  ABSL_CHECK(google::protobuf::TextFormat::ParseFromString(  // Crash OK
+      std::string(text), from.get()));
+  ABSL_CHECK_OK(CopyMessage(*from, to.get()));  // Crash OK
+  std::string result;
+  google::protobuf::TextFormat::Printer printer;
+  printer.SetSingleLineMode(true);
+  ABSL_CHECK(printer.PrintToString(*to, &result));  // Crash OK
+  return result;
+}
+
+TEST_F(MessageCopyTest, PlansOutlivingTheirPools) {
+  // Plans are cached by descriptor address, so replacing the pools with ones
+  // whose fields are numbered differently may hand out plans for the
+  // destroyed descriptors, which must not be used.
+  for (int i = 0; i < 8; ++i) {
+    std::unique_ptr<google::protobuf::DescriptorPool> from_pool = MakePool(R"pb(
+      field { name: "a" number: 1 type: TYPE_INT64 label: LABEL_OPTIONAL }
+      field { name: "b" number: 2 type: TYPE_INT64 label: LABEL_OPTIONAL }
+    )pb");
+    std::unique_ptr<google::protobuf::DescriptorPool> to_pool = MakePool(R"pb(
+      field { name: "a" number: 1 type: TYPE_INT64 label: LABEL_OPTIONAL }
+      field { name: "b" number: 2 type: TYPE_INT64 label: LABEL_OPTIONAL }
+    )pb");
+    EXPECT_EQ(PoolCopyMessage(*from_pool, *to_pool, "a: 1 b: 2"), "a: 1 b: 2 ");
+    to_pool = MakePool(R"pb(
+      field { name: "a" number: 2 type: TYPE_INT64 label: LABEL_OPTIONAL }
+      field { name: "b" number: 1 type: TYPE_INT64 label: LABEL_OPTIONAL }
+    )pb");
+    from_pool = MakePool(R"pb(
+      field { name: "a" number: 1 type: TYPE_INT64 label: LABEL_OPTIONAL }
+      field { name: "b" number: 2 type: TYPE_INT64 label: LABEL_OPTIONAL }
+    )pb");
+    EXPECT_EQ(PoolCopyMessage(*from_pool, *to_pool, "a: 1 b: 2"), "b: 1 a: 2 ");
+  }
+}
+
+}  // namespace
+}  // namespace cel::internal
@@ -21,17 +21,25 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/casts.h"
+#include "absl/base/no_destructor.h"
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/functional/overload.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include "common/memory.h"
 #include "extensions/protobuf/internal/map_reflection.h"
@@ -59,8 +67,534 @@ using ::google::protobuf::DescriptorPool;
 using ::google::protobuf::FieldDescriptor;
 using ::google::protobuf::Message;
 using ::google::protobuf::MessageFactory;
+using ::google::protobuf::Reflection;
 using ::google::protobuf::util::MessageDifferencer;
 
+class MessageEqualityPlan;
+
+using MessageEqualityPlanMap =
+    absl::flat_hash_map<const Descriptor* absl_nonnull,
+                        std::unique_ptr<MessageEqualityPlan>>;
+
+bool IsGeneratedDescriptor(const Descriptor* absl_nonnull descriptor) {
+  return descriptor->file()->pool() == DescriptorPool::generated_pool();
+}
+
+// Precomputed equality comparison for messages of a single descriptor which
+// is not a well known type.
+//
+// Follows the default semantics of `MessageDifferencer::Equals`, which is
+// what CEL uses for message equality, without rediscovering the set fields
+// through `Reflection::ListFields` and without re-classifying every field on
+// every comparison. Descriptors which the plan cannot handle faithfully
+// (maps, `google.protobuf.Any`, extensions and unknown fields) are delegated
+// to `MessageDifferencer`.
+class MessageEqualityPlan final {
+ public:
+  // Returns the plan for `descriptor`, building it and the plans of any
+  // message typed fields into `plans` if they are not present.
+  static const MessageEqualityPlan* absl_nonnull Build(
+      const Descriptor* absl_nonnull descriptor, MessageEqualityPlanMap& plans);
+
+  MessageEqualityPlan() = default;
+  MessageEqualityPlan(const MessageEqualityPlan&) = delete;
+  MessageEqualityPlan& operator=(const MessageEqualityPlan&) = delete;
+
+  // `lhs` and `rhs` must share a descriptor. Returns `absl::nullopt` if the
+  // plan, or the plan of a nested message, is stale: plans for descriptors
+  // outside of the generated pool may outlive their pool, whose descriptors
+  // may then be reallocated.
+  absl::optional<bool> Equals(const Message& lhs, const Message& rhs) const;
+
+ private:
+  enum class FieldKind {
+    kInt32,
+    kInt64,
+    kUInt32,
+    kUInt64,
+    kFloat,
+    kDouble,
+    kBool,
+    kEnum,
+    kString,
+    kMessage,
+  };
+
+  struct FieldPlan {
+    const FieldDescriptor* absl_nonnull field;
+    int index;
+    FieldDescriptor::CppType cpp_type;
+    FieldKind kind;
+    bool has_presence;
+    // Plan for the field's message type, set iff `kind == kMessage`.
+    const MessageEqualityPlan* absl_nullable message_plan;
+  };
+
+  // Returns whether the plan was built for `descriptor`, as in
+  // `MessageCopyPlan::Matches`.
+  bool Matches(const Descriptor* absl_nonnull descriptor) const;
+
+  absl::optional<bool> SingularFieldEquals(
+      const FieldPlan& plan, const Message& lhs,
+      const Reflection& lhs_reflection, const Message& rhs,
+      const Reflection& rhs_reflection) const;
+
+  absl::optional<bool> RepeatedFieldEquals(
+      const FieldPlan& plan, const Message& lhs,
+      const Reflection& lhs_reflection, const Message& rhs,
+      const Reflection& rhs_reflection) const;
+
+  const Descriptor* absl_nullable descriptor_ = nullptr;
+  int field_count_ = 0;
+  // Plans for generated descriptors are never stale.
+  bool generated_ = false;
+  bool use_differencer_ = false;
+  std::vector<FieldPlan> singular_fields_;
+  std::vector<FieldPlan> repeated_fields_;
+};
+
+const MessageEqualityPlan* absl_nonnull MessageEqualityPlan::Build(
+    const Descriptor* absl_nonnull descriptor, MessageEqualityPlanMap& plans) {
+  if (auto it = plans.find(descriptor); it != plans.end()) {
+    return it->second.get();
+  }
+  // Insert before visiting fields so recursive message types terminate.
+  MessageEqualityPlan* absl_nonnull plan =
+      plans.insert({descriptor, std::make_unique<MessageEqualityPlan>()})
+          .first->second.get();
+  plan->descriptor_ = descriptor;
+  plan->field_count_ = descriptor->field_count();
+  plan->generated_ = IsGeneratedDescriptor(descriptor);
+  if (descriptor->well_known_type() == Descriptor::WELLKNOWNTYPE_ANY ||
+      descriptor->extension_range_count() > 0) {
+    plan->use_differencer_ = true;
+    return plan;
+  }
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* absl_nonnull field = descriptor->field(i);
+    if (field->is_map() || field->options().weak()) {
+      plan->use_differencer_ = true;
+      plan->singular_fields_.clear();
+      plan->repeated_fields_.clear();
+      return plan;
+    }
+    FieldPlan field_plan{field,
+                         i,
+                         field->cpp_type(),
+                         FieldKind::kInt32,
+                         field->has_presence(),
+                         nullptr};
+    switch (field->cpp_type()) {
+      case FieldDescriptor::CPPTYPE_INT32:
+        field_plan.kind = FieldKind::kInt32;
+        break;
+      case FieldDescriptor::CPPTYPE_INT64:
+        field_plan.kind = FieldKind::kInt64;
+        break;
+      case FieldDescriptor::CPPTYPE_UINT32:
+        field_plan.kind = FieldKind::kUInt32;
+        break;
+      case FieldDescriptor::CPPTYPE_UINT64:
+        field_plan.kind = FieldKind::kUInt64;
+        break;
+      case FieldDescriptor::CPPTYPE_FLOAT:
+        field_plan.kind = FieldKind::kFloat;
+        break;
+      case FieldDescriptor::CPPTYPE_DOUBLE:
+        field_plan.kind = FieldKind::kDouble;
+        break;
+      case FieldDescriptor::CPPTYPE_BOOL:
+        field_plan.kind = FieldKind::kBool;
+        break;
+      case FieldDescriptor::CPPTYPE_ENUM:
+        field_plan.kind = FieldKind::kEnum;
+        break;
+      case FieldDescriptor::CPPTYPE_STRING:
+        field_plan.kind = FieldKind::kString;
+        break;
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        field_plan.kind = FieldKind::kMessage;
+        field_plan.message_plan = Build(field->message_type(), plans);
+        break;
+      default:
+        plan->use_differencer_ = true;
+        plan->singular_fields_.clear();
+        plan->repeated_fields_.clear();
+        return plan;
+    }
+    if (field->is_repeated()) {
+      plan->repeated_fields_.push_back(field_plan);
+    } else {
+      plan->singular_fields_.push_back(field_plan);
+    }
+  }
+  return plan;
+}
+
+bool MessageEqualityPlan::Matches(
+    const Descriptor* absl_nonnull descriptor) const {
+  if (generated_) {
+    return descriptor == descriptor_;
+  }
+  // The held descriptors may have been destroyed, so they are only
+  // dereferenced once they are known to be the live ones.
+  if (descriptor != descriptor_ ||
+      descriptor->field_count() != field_count_) {
+    return false;
+  }
+  if (use_differencer_) {
+    // The differencer only looks at the live descriptors.
+    return true;
+  }
+  if (descriptor->well_known_type() == Descriptor::WELLKNOWNTYPE_ANY ||
+      descriptor->extension_range_count() > 0) {
+    return false;
+  }
+  const auto field_matches = [descriptor](const FieldPlan& plan,
+                                          bool repeated) {
+    return descriptor->field(plan.index) == plan.field &&
+           plan.field->cpp_type() == plan.cpp_type &&
+           plan.field->is_repeated() == repeated && !plan.field->is_map() &&
+           plan.field->has_presence() == plan.has_presence;
+  };
+  for (const FieldPlan& plan : singular_fields_) {
+    if (!field_matches(plan, /*repeated=*/false)) {
+      return false;
+    }
+  }
+  for (const FieldPlan& plan : repeated_fields_) {
+    if (!field_matches(plan, /*repeated=*/true)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+absl::optional<bool> MessageEqualityPlan::Equals(const Message& lhs,
+                                                 const Message& rhs) const {
+  ABSL_DCHECK_EQ(lhs.GetDescriptor(), rhs.GetDescriptor());
+  if (ABSL_PREDICT_FALSE(!Matches(lhs.GetDescriptor()))) {
+    return absl::nullopt;
+  }
+  if (use_differencer_) {
+    return MessageDifferencer::Equals(lhs, rhs);
+  }
+  // Both sides share a descriptor, but may come from different factories (for
+  // example generated and dynamic messages), so each uses its own reflection.
+  const Reflection& lhs_reflection = *lhs.GetReflection();
+  const Reflection& rhs_reflection = *rhs.GetReflection();
+  if (!lhs_reflection.GetUnknownFields(lhs).empty() ||
+      !rhs_reflection.GetUnknownFields(rhs).empty()) {
+    return MessageDifferencer::Equals(lhs, rhs);
+  }
+  for (const FieldPlan& plan : singular_fields_) {
+    if (absl::optional<bool> equal = SingularFieldEquals(
+            plan, lhs, lhs_reflection, rhs, rhs_reflection);
+        !equal.value_or(false)) {
+      return equal;
+    }
+  }
+  for (const FieldPlan& plan : repeated_fields_) {
+    if (absl::optional<bool> equal = RepeatedFieldEquals(
+            plan, lhs, lhs_reflection, rhs, rhs_reflection);
+        !equal.value_or(false)) {
+      return equal;
+    }
+  }
+  return true;
+}
+
+absl::optional<bool> MessageEqualityPlan::SingularFieldEquals(
+    const FieldPlan& plan, const Message& lhs, const Reflection& lhs_reflection,
+    const Message& rhs, const Reflection& rhs_reflection) const {
+  const FieldDescriptor* absl_nonnull field = plan.field;
+  if (plan.has_presence) {
+    const bool lhs_has = lhs_reflection.HasField(lhs, field);
+    if (lhs_has != rhs_reflection.HasField(rhs, field)) {
+      return false;
+    }
+    if (!lhs_has) {
+      return true;
+    }
+  }
+  switch (plan.kind) {
+    case FieldKind::kInt32:
+      return lhs_reflection.GetInt32(lhs, field) ==
+             rhs_reflection.GetInt32(rhs, field);
+    case FieldKind::kInt64:
+      return lhs_reflection.GetInt64(lhs, field) ==
+             rhs_reflection.GetInt64(rhs, field);
+    case FieldKind::kUInt32:
+      return lhs_reflection.GetUInt32(lhs, field) ==
+             rhs_reflection.GetUInt32(rhs, field);
+    case FieldKind::kUInt64:
+      return lhs_reflection.GetUInt64(lhs, field) ==
+             rhs_reflection.GetUInt64(rhs, field);
+    case FieldKind::kFloat: {
+      const float lhs_value = lhs_reflection.GetFloat(lhs, field);
+      const float rhs_value = rhs_reflection.GetFloat(rhs, field);
+      if (!plan.has_presence) {
+        // Without presence, reflection considers a float set when its bit
+        // pattern is non-zero, so -0.0 is set and differs from unset 0.0.
+        const bool lhs_set = absl::bit_cast<uint32_t>(lhs_value) != 0;
+        if (lhs_set != (absl::bit_cast<uint32_t>(rhs_value) != 0)) {
+          return false;
+        }
+        if (!lhs_set) {
+          return true;
+        }
+      }
+      return lhs_value == rhs_value;
+    }
+    case FieldKind::kDouble: {
+      const double lhs_value = lhs_reflection.GetDouble(lhs, field);
+      const double rhs_value = rhs_reflection.GetDouble(rhs, field);
+      if (!plan.has_presence) {
+        // See above.
+        const bool lhs_set = absl::bit_cast<uint64_t>(lhs_value) != 0;
+        if (lhs_set != (absl::bit_cast<uint64_t>(rhs_value) != 0)) {
+          return false;
+        }
+        if (!lhs_set) {
+          return true;
+        }
+      }
+      return lhs_value == rhs_value;
+    }
+    case FieldKind::kBool:
+      return lhs_reflection.GetBool(lhs, field) ==
+             rhs_reflection.GetBool(rhs, field);
+    case FieldKind::kEnum:
+      return lhs_reflection.GetEnumValue(lhs, field) ==
+             rhs_reflection.GetEnumValue(rhs, field);
+    case FieldKind::kString: {
+      std::string lhs_scratch;
+      std::string rhs_scratch;
+      return lhs_reflection.GetStringReference(lhs, field, &lhs_scratch) ==
+             rhs_reflection.GetStringReference(rhs, field, &rhs_scratch);
+    }
+    case FieldKind::kMessage:
+      return plan.message_plan->Equals(lhs_reflection.GetMessage(lhs, field),
+                                       rhs_reflection.GetMessage(rhs, field));
+  }
+  ABSL_UNREACHABLE();
+}
+
+absl::optional<bool> MessageEqualityPlan::RepeatedFieldEquals(
+    const FieldPlan& plan, const Message& lhs, const Reflection& lhs_reflection,
+    const Message& rhs, const Reflection& rhs_reflection) const {
+  const FieldDescriptor* absl_nonnull field = plan.field;
+  const int size = lhs_reflection.FieldSize(lhs, field);
+  if (size != rhs_reflection.FieldSize(rhs, field)) {
+    return false;
+  }
+  switch (plan.kind) {
+    case FieldKind::kInt32:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedInt32(lhs, field, i) !=
+            rhs_reflection.GetRepeatedInt32(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldKind::kInt64:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedInt64(lhs, field, i) !=
+            rhs_reflection.GetRepeatedInt64(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldKind::kUInt32:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedUInt32(lhs, field, i) !=
+            rhs_reflection.GetRepeatedUInt32(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldKind::kUInt64:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedUInt64(lhs, field, i) !=
+            rhs_reflection.GetRepeatedUInt64(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldKind::kFloat:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedFloat(lhs, field, i) !=
+            rhs_reflection.GetRepeatedFloat(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldKind::kDouble:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedDouble(lhs, field, i) !=
+            rhs_reflection.GetRepeatedDouble(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldKind::kBool:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedBool(lhs, field, i) !=
+            rhs_reflection.GetRepeatedBool(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldKind::kEnum:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedEnumValue(lhs, field, i) !=
+            rhs_reflection.GetRepeatedEnumValue(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldKind::kString: {
+      std::string lhs_scratch;
+      std::string rhs_scratch;
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection.GetRepeatedStringReference(lhs, field, i,
+                                                      &lhs_scratch) !=
+            rhs_reflection.GetRepeatedStringReference(rhs, field, i,
+                                                      &rhs_scratch)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case FieldKind::kMessage:
+      for (int i = 0; i < size; ++i) {
+        if (absl::optional<bool> equal = plan.message_plan->Equals(
+                lhs_reflection.GetRepeatedMessage(lhs, field, i),
+                rhs_reflection.GetRepeatedMessage(rhs, field, i));
+            !equal.value_or(false)) {
+          return equal;
+        }
+      }
+      return true;
+  }
+  ABSL_UNREACHABLE();
+}
+
+// Process wide cache of plans for descriptors from the generated pool, which
+// are never destroyed.
+class GeneratedMessageEqualityPlans final {
+ public:
+  static GeneratedMessageEqualityPlans& Get() {
+    static absl::NoDestructor<GeneratedMessageEqualityPlans> instance;
+    return *instance;
+  }
+
+  const MessageEqualityPlan* absl_nonnull Find(
+      const Descriptor* absl_nonnull descriptor) {
+    ABSL_DCHECK_EQ(descriptor->file()->pool(),
+                   DescriptorPool::generated_pool());
+    {
+      absl::ReaderMutexLock lock(mutex_);
+      if (auto it = plans_.find(descriptor); it != plans_.end()) {
+        return it->second.get();
+      }
+    }
+    absl::MutexLock lock(mutex_);
+    return MessageEqualityPlan::Build(descriptor, plans_);
+  }
+
+ private:
+  absl::Mutex mutex_;
+  MessageEqualityPlanMap plans_ ABSL_GUARDED_BY(mutex_);
+};
+
+// The plans reachable from the plan for a descriptor outside of the generated
+// pool, which are built and cached together.
+struct MessageEqualityPlanGraph {
+  MessageEqualityPlanMap plans;
+  const MessageEqualityPlan* absl_nullable root = nullptr;
+};
+
+// Process wide cache of plans for descriptors outside of the generated pool.
+// Those pools may be destroyed while we hold plans keyed by their
+// descriptors, so plans are validated against the live descriptors before
+// use (see `MessageEqualityPlan::Matches`) and rebuilt when stale. The cache
+// is dropped when it grows past `kMaxEntries`, as descriptors of destroyed
+// pools are never looked up again.
+class MessageEqualityPlanCache final {
+ public:
+  static constexpr size_t kMaxEntries = 1024;
+
+  static MessageEqualityPlanCache& Get() {
+    static absl::NoDestructor<MessageEqualityPlanCache> instance;
+    return *instance;
+  }
+
+  std::shared_ptr<const MessageEqualityPlanGraph> Find(
+      const Descriptor* absl_nonnull descriptor) {
+    {
+      absl::ReaderMutexLock lock(mutex_);
+      if (auto it = plans_.find(descriptor); it != plans_.end()) {
+        return it->second;
+      }
+    }
+    return Rebuild(descriptor);
+  }
+
+  std::shared_ptr<const MessageEqualityPlanGraph> Rebuild(
+      const Descriptor* absl_nonnull descriptor) {
+    auto graph = std::make_shared<MessageEqualityPlanGraph>();
+    graph->root = MessageEqualityPlan::Build(descriptor, graph->plans);
+    absl::MutexLock lock(mutex_);
+    if (plans_.size() >= kMaxEntries) {
+      plans_.clear();
+    }
+    plans_.insert_or_assign(descriptor, graph);
+    return graph;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<const Descriptor* absl_nonnull,
+                      std::shared_ptr<const MessageEqualityPlanGraph>>
+      plans_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Plans used by a single top-level equality comparison. Plans for descriptors
+// outside of the generated pool are held for the duration of the comparison,
+// so that comparing many messages of the same type looks them up once.
+class MessageEqualityPlans final {
+ public:
+  // `lhs` and `rhs` must share a descriptor.
+  bool Equals(const Message& lhs, const Message& rhs) {
+    const Descriptor* absl_nonnull descriptor = lhs.GetDescriptor();
+    if (IsGeneratedDescriptor(descriptor)) {
+      return *GeneratedMessageEqualityPlans::Get().Find(descriptor)->Equals(
+          lhs, rhs);
+    }
+    MessageEqualityPlanCache& cache = MessageEqualityPlanCache::Get();
+    std::shared_ptr<const MessageEqualityPlanGraph>& graph =
+        graphs_[descriptor];
+    if (graph == nullptr) {
+      graph = cache.Find(descriptor);
+    }
+    absl::optional<bool> equal = graph->root->Equals(lhs, rhs);
+    if (ABSL_PREDICT_FALSE(!equal.has_value())) {
+      // The cached plan was built for descriptors which have since been
+      // destroyed. Plans built for the live descriptors always match them.
+      graph = cache.Rebuild(descriptor);
+      equal = graph->root->Equals(lhs, rhs);
+      ABSL_DCHECK(equal.has_value());
+    }
+    return equal.value_or(false);
+  }
+
+ private:
+  absl::flat_hash_map<const Descriptor* absl_nonnull,
+                      std::shared_ptr<const MessageEqualityPlanGraph>>
+      graphs_;
+};
+
 class EquatableListValue final
     : public std::reference_wrapper<const google::protobuf::Message> {
  public:
@@ -274,7 +808,7 @@ struct AnyEqualer {
 struct MessageEqualer {
   bool operator()(EquatableMessage lhs, EquatableMessage rhs) const {
     return lhs.get().GetDescriptor() == rhs.get().GetDescriptor() &&
-           MessageDifferencer::Equals(lhs.get(), rhs.get());
+           plans->Equals(lhs.get(), rhs.get());
   }
 
   template <typename T>
@@ -282,6 +816,8 @@ struct MessageEqualer {
   operator()(EquatableMessage, const T&) const {
     return false;
   }
+
+  MessageEqualityPlans* absl_nonnull plans;
 };
 
 struct EquatableValueReflection final {
@@ -574,14 +1110,14 @@ absl::StatusOr<EquatableValue> RepeatedFieldAsEquatableValue(
 }
 
 // Compare two `EquatableValue` for equality.
-bool EquatableValueEquals(const EquatableValue& lhs,
-                          const EquatableValue& rhs) {
+bool EquatableValueEquals(const EquatableValue& lhs, const EquatableValue& rhs,
+                          MessageEqualityPlans& plans) {
   return absl::visit(
       absl::Overload(NullValueEqualer{}, BoolValueEqualer{},
                      BytesValueEqualer{}, IntValueEqualer{}, UintValueEqualer{},
                      DoubleValueEqualer{}, StringValueEqualer{},
                      DurationEqualer{}, TimestampEqualer{}, ListValueEqualer{},
-                     StructEqualer{}, AnyEqualer{}, MessageEqualer{}),
+                     StructEqualer{}, AnyEqualer{}, MessageEqualer{&plans}),
       lhs, rhs);
 }
 
@@ -869,7 +1405,7 @@ class MessageEqualsState final {
         auto rhs_value,
         AsEquatableValue(rhs_reflection_, *rhs_ptr, rhs_descriptor,
                          rhs_well_known_type, rhs_scratch_));
-    return EquatableValueEquals(lhs_value, rhs_value);
+    return EquatableValueEquals(lhs_value, rhs_value, plans_);
   }
 
   // Equality between map message fields.
@@ -931,7 +1467,7 @@ class MessageEqualsState final {
           MapValueAsEquatableValue(&arena_, pool_, factory_, rhs_reflection_,
                                    rhs_map_value, rhs_entry_value_field,
                                    rhs_scratch_, rhs_unpacked));
-      if (!EquatableValueEquals(lhs_value, rhs_value)) {
+      if (!EquatableValueEquals(lhs_value, rhs_value, plans_)) {
         return false;
       }
     }
@@ -973,7 +1509,7 @@ class MessageEqualsState final {
                            RepeatedFieldAsEquatableValue(
                                &arena_, pool_, factory_, rhs_reflection_, rhs,
                                rhs_field, i, rhs_scratch_, rhs_unpacked));
-      if (!EquatableValueEquals(lhs_value, rhs_value)) {
+      if (!EquatableValueEquals(lhs_value, rhs_value, plans_)) {
         return false;
       }
     }
@@ -1067,7 +1603,7 @@ class MessageEqualsState final {
           rhs_value, AsEquatableValue(rhs_reflection_, *rhs_ptr,
                                       rhs_ptr->GetDescriptor(), rhs_scratch_));
     }
-    return EquatableValueEquals(lhs_value, rhs_value);
+    return EquatableValueEquals(lhs_value, rhs_value, plans_);
   }
 
   absl::StatusOr<bool> FieldEquals(
@@ -1420,6 +1956,7 @@ class MessageEqualsState final {
   EquatableValueReflection rhs_reflection_;
   std::string lhs_scratch_;
   std::string rhs_scratch_;
+  MessageEqualityPlans plans_;
 };
 
 }  // namespace
@@ -1432,6 +1969,13 @@ absl::StatusOr<bool> MessageEquals(const Message& lhs, const Message& rhs,
   if (&lhs == &rhs) {
     return true;
   }
+  if (const auto* descriptor = lhs.GetDescriptor();
+      descriptor == rhs.GetDescriptor() &&
+      descriptor->well_known_type() == Descriptor::WELLKNOWNTYPE_UNSPECIFIED) {
+    // Plain messages of the same type are compared with the cached plan,
+    // without setting up the state needed for cross type equality.
+    return MessageEqualityPlans().Equals(lhs, rhs);
+  }
   // MessageEqualsState has quite a large size, so we allocate it on the heap.
   // Ideally we should just hold most of the state at runtime in something like
   // `FlatExpressionEvaluatorState`, so we can avoid allocating this repeatedly.
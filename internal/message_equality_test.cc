@@ -14,6 +14,8 @@
 
 #include "internal/message_equality.h"
 
+#include <limits>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,6 +30,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/log/die_if_null.h"
 #include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -43,7 +46,11 @@
 #include "cel/expr/conformance/proto3/test_all_types.pb.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/dynamic_message.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/text_format.h"
+#include "google/protobuf/unknown_field_set.h"
 
 namespace cel::internal {
 namespace {
@@ -1051,5 +1058,177 @@ TEST(MessageFieldEquals, AnyFallback) {
               IsOkAndHolds(IsFalse()));
 }
 
+
+TEST(MessageEquals, GeneratedMessages) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  TestAllTypesProto3 lhs;
+  lhs.set_single_int64(1);
+  lhs.set_single_string("foo");
+  lhs.mutable_single_nested_message()->set_bb(2);
+  lhs.add_repeated_nested_message()->set_bb(3);
+  lhs.add_repeated_double(1.5);
+  TestAllTypesProto3 rhs = lhs;
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsTrue()));
+
+  rhs.mutable_repeated_nested_message(0)->set_bb(4);
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+
+  rhs = lhs;
+  rhs.add_repeated_double(1.5);
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+
+  rhs = lhs;
+  rhs.mutable_single_nested_message()->Clear();
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+
+  rhs.clear_single_nested_message();
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+}
+
+TEST(MessageEquals, GeneratedMessagesFloatingPoint) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  TestAllTypesProto3 lhs;
+  TestAllTypesProto3 rhs;
+  rhs.set_single_double(-0.0);
+  // An implicit presence field holding -0.0 is set, unlike 0.0.
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+
+  lhs.set_single_double(-0.0);
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsTrue()));
+
+  lhs.set_single_float(std::numeric_limits<float>::quiet_NaN());
+  rhs.set_single_float(std::numeric_limits<float>::quiet_NaN());
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+
+  lhs.clear_single_float();
+  rhs.clear_single_float();
+  lhs.add_repeated_double(std::numeric_limits<double>::quiet_NaN());
+  rhs.add_repeated_double(std::numeric_limits<double>::quiet_NaN());
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+}
+
+TEST(MessageEquals, GeneratedMessagesMapFields) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  TestAllTypesProto3 lhs;
+  (*lhs.mutable_map_string_string())["foo"] = "bar";
+  (*lhs.mutable_map_string_string())["baz"] = "qux";
+  TestAllTypesProto3 rhs;
+  (*rhs.mutable_map_string_string())["baz"] = "qux";
+  (*rhs.mutable_map_string_string())["foo"] = "bar";
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsTrue()));
+
+  (*rhs.mutable_map_string_string())["foo"] = "baz";
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+}
+
+TEST(MessageEquals, GeneratedMessagesUnknownFields) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  TestAllTypesProto3 lhs;
+  lhs.set_single_int64(1);
+  TestAllTypesProto3 rhs = lhs;
+  rhs.GetReflection()->MutableUnknownFields(&rhs)->AddVarint(100000, 1);
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+
+  lhs.GetReflection()->MutableUnknownFields(&lhs)->AddVarint(100000, 1);
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsTrue()));
+}
+
+TEST(MessageEquals, DynamicMessages) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  google::protobuf::Arena arena;
+  auto message1 = DynamicParseTextProto<TestAllTypesProto3>(
+      &arena, R"pb(single_int64: 1
+                   single_nested_message { bb: 2 }
+                   repeated_nested_message { bb: 3 }
+                   repeated_nested_message { bb: 4 })pb",
+      pool, factory);
+  auto message2 = DynamicParseTextProto<TestAllTypesProto3>(
+      &arena, R"pb(single_int64: 1
+                   single_nested_message { bb: 2 }
+                   repeated_nested_message { bb: 3 }
+                   repeated_nested_message { bb: 4 })pb",
+      pool, factory);
+  auto message3 = DynamicParseTextProto<TestAllTypesProto3>(
+      &arena, R"pb(single_int64: 1
+                   single_nested_message { bb: 2 }
+                   repeated_nested_message { bb: 4 }
+                   repeated_nested_message { bb: 3 })pb",
+      pool, factory);
+  EXPECT_THAT(MessageEquals(*message1, *message2, pool, factory),
+              IsOkAndHolds(IsTrue()));
+  EXPECT_THAT(MessageEquals(*message1, *message3, pool, factory),
+              IsOkAndHolds(IsFalse()));
+}
+
+// Builds a pool with a single message, `test.Message`, whose fields are
+// described by `fields`.
+std::unique_ptr<google::protobuf::DescriptorPool> MakePool(absl::string_view fields) {
+  google::protobuf::FileDescriptorProto file;
+  ABSL_CHECK(google::protobuf::TextFormat::ParseFromString(  // Crash OK
+      absl::StrCat(R"pb(
+                     name: "test.proto"
+                     package: "test"
+                     syntax: "proto3"
+                     message_type { name: "Message" )pb",
+                   fields, "}"),
+      &file));
+  auto pool = std::make_unique<google::protobuf::DescriptorPool>();
+  ABSL_CHECK(pool->BuildFile(file) != nullptr);  // Crash OK
+  return pool;
+}
+
+// Compares `lhs` and `rhs`, parsed as `test.Message` from `pool`.
+absl::StatusOr<bool> PoolMessageEquals(const google::protobuf::DescriptorPool& pool,
+                                       absl::string_view lhs,
+                                       absl::string_view rhs) {
+  google::protobuf::DynamicMessageFactory factory(&pool);
+  const google::protobuf::Message* prototype =
+      factory.GetPrototype(pool.FindMessageTypeByName("test.Message"));
+  std::unique_ptr<google::protobuf::Message> lhs_message(prototype->New());
+  std::unique_ptr<google::protobuf::Message> rhs_message(prototype->New());
+  ABSL_CHECK(google::protobuf::TextFormat::ParseFromString(  // Crash OK
+      lhs, lhs_message.get()));
+  ABSL_CHECK(google::protobuf::TextFormat::ParseFromString(  // Crash OK
+      rhs, rhs_message.get()));
+  return MessageEquals(*lhs_message, *rhs_message, &pool, &factory);
+}
+
+TEST(MessageEquals, PlansOutlivingTheirPool) {
+  // Plans for descriptors outside of the generated pool are cached, so
+  // replacing a pool with one of a different shape may hand out plans for
+  // the destroyed descriptors, which must not be used.
+  for (int i = 0; i < 8; ++i) {
+    std::unique_ptr<google::protobuf::DescriptorPool> pool = MakePool(R"pb(
+      field { name: "a" number: 1 type: TYPE_INT64 label: LABEL_OPTIONAL }
+      field {
+        name: "b"
+        number: 2
+        type: TYPE_MESSAGE
+        type_name: ".test.Message"
+        label: LABEL_OPTIONAL
+      }
+    )pb");
+    EXPECT_THAT(PoolMessageEquals(*pool, "a: 1 b { a: 2 }", "a: 1 b { a: 2 }"),
+                IsOkAndHolds(IsTrue()));
+    EXPECT_THAT(PoolMessageEquals(*pool, "a: 1 b { a: 2 }", "a: 1 b { a: 3 }"),
+                IsOkAndHolds(IsFalse()));
+    pool = MakePool(R"pb(
+      field { name: "a" number: 1 type: TYPE_STRING label: LABEL_REPEATED }
+      field { name: "b" number: 2 type: TYPE_DOUBLE label: LABEL_OPTIONAL }
+    )pb");
+    EXPECT_THAT(PoolMessageEquals(*pool, "a: [ \"x\", \"y\" ] b: 1.5",
+                                  "a: [ \"x\", \"y\" ] b: 1.5"),
+                IsOkAndHolds(IsTrue()));
+    EXPECT_THAT(PoolMessageEquals(*pool, "a: [ \"x\", \"y\" ] b: 1.5",
+                                  "a: [ \"y\", \"x\" ] b: 1.5"),
+                IsOkAndHolds(IsFalse()));
+  }
+}
+
 }  // namespace
 }  // namespace cel::internal
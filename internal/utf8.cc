@@ -24,6 +24,7 @@
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
 #include "absl/log/absl_check.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "internal/unicode.h"
@@ -355,6 +356,46 @@ std::pair<size_t, bool> Utf8Validate(const absl::Cord& str) {
 
 namespace {
 
+constexpr uint64_t kHighBits = 0x8080808080808080;
+
+uint64_t LoadWord(const char* absl_nonnull data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+}  // namespace
+
+size_t Utf8AsciiPrefixLength(absl::string_view str) {
+  size_t index = 0;
+  while (index + sizeof(uint64_t) <= str.size() &&
+         (LoadWord(str.data() + index) & kHighBits) == 0) {
+    index += sizeof(uint64_t);
+  }
+  while (index < str.size() &&
+         static_cast<uint8_t>(str[index]) < kUtf8RuneSelf) {
+    ++index;
+  }
+  return index;
+}
+
+size_t Utf8CodePointCountUnchecked(absl::string_view str) {
+  // Continuation bytes are 0b10xxxxxx, everything else starts a code point.
+  size_t continuations = 0;
+  size_t index = 0;
+  for (; index + sizeof(uint64_t) <= str.size(); index += sizeof(uint64_t)) {
+    const uint64_t word = LoadWord(str.data() + index);
+    continuations += static_cast<size_t>(
+        absl::popcount(word & ~(word << 1) & kHighBits));
+  }
+  for (; index < str.size(); ++index) {
+    continuations += (static_cast<uint8_t>(str[index]) & 0xc0) == 0x80;
+  }
+  return str.size() - continuations;
+}
+
+namespace {
+
 size_t Utf8DecodeImpl(uint8_t b, uint8_t leading, size_t size,
                       absl::string_view str,
                       char32_t* absl_nullable code_point) {
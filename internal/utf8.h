@@ -47,6 +47,15 @@ size_t Utf8CodePointCount(const absl::Cord& str);
 std::pair<size_t, bool> Utf8Validate(absl::string_view str);
 std::pair<size_t, bool> Utf8Validate(const absl::Cord& str);
 
+// Returns the length of the longest prefix of `str` consisting only of ASCII,
+// scanning eight bytes at a time.
+size_t Utf8AsciiPrefixLength(absl::string_view str);
+
+// Returns the number of Unicode code points in `str`, which must not be
+// malformed. Unlike `Utf8CodePointCount`, only the leading bytes are counted,
+// eight bytes at a time.
+size_t Utf8CodePointCountUnchecked(absl::string_view str);
+
 // Decodes the next code point, returning the decoded code point and the number
 // of code units (a.k.a. bytes) consumed. In the event that an invalid code unit
 // sequence is returned the replacement character, U+FFFD, is returned with a
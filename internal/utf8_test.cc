@@ -96,6 +96,26 @@ TEST(Utf8CodePointCount, Cord) {
   EXPECT_EQ(Utf8CodePointCount(absl::Cord("a\xe2\x80")), 3);
 }
 
+TEST(Utf8AsciiPrefixLength, String) {
+  EXPECT_EQ(Utf8AsciiPrefixLength(""), 0);
+  EXPECT_EQ(Utf8AsciiPrefixLength("abcd"), 4);
+  EXPECT_EQ(Utf8AsciiPrefixLength("0123456789abcdef"), 16);
+  EXPECT_EQ(Utf8AsciiPrefixLength("0123456789\xe2\x98\xba"), 10);
+  EXPECT_EQ(Utf8AsciiPrefixLength("0123\xe2\x98\xba" "456789abcdef"), 4);
+  EXPECT_EQ(Utf8AsciiPrefixLength("\xe2\x98\xba"), 0);
+}
+
+TEST(Utf8CodePointCountUnchecked, String) {
+  EXPECT_EQ(Utf8CodePointCountUnchecked(""), 0);
+  EXPECT_EQ(Utf8CodePointCountUnchecked("abcd"), 4);
+  EXPECT_EQ(Utf8CodePointCountUnchecked("0123456789abcdef"), 16);
+  EXPECT_EQ(
+      Utf8CodePointCountUnchecked("\xe2\x98\xba\xe2\x98\xbb\xe2\x98\xb9"), 3);
+  EXPECT_EQ(Utf8CodePointCountUnchecked(
+                "a\xc3\xa9\xe2\x98\xba\xf0\x9f\x98\x80" "bcdefgh"),
+            11);
+}
+
 TEST(Utf8Validate, String) {
   EXPECT_TRUE(Utf8Validate("").second);
   EXPECT_TRUE(Utf8Validate("a").second);
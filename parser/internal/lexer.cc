@@ -14,32 +14,120 @@
 
 #include "parser/internal/lexer.h"
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <string>
 #include <string_view>
 
 #include "absl/base/attributes.h"
+#include "absl/base/config.h"
 #include "absl/base/no_destructor.h"
 #include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "internal/utf8.h"
 
 namespace cel::parser_internal {
 
 namespace {
 
-[[nodiscard]] bool IsIdentTrailing(char32_t c) {
-  return c <= 0x7f && (absl::ascii_isdigit(static_cast<char>(c)) ||
-                       absl::ascii_isalpha(static_cast<char>(c)) || c == '_');
+// Character classes of source bytes. Bytes of non-ASCII code points are in no
+// class.
+constexpr uint8_t kIdentChar = 1 << 0;
+constexpr uint8_t kDigitChar = 1 << 1;
+constexpr uint8_t kHexDigitChar = 1 << 2;
+constexpr uint8_t kWhitespaceChar = 1 << 3;
+
+constexpr std::array<uint8_t, 256> MakeCharClasses() {
+  std::array<uint8_t, 256> classes{};
+  for (int c = '0'; c <= '9'; ++c) {
+    classes[c] = kIdentChar | kDigitChar | kHexDigitChar;
+  }
+  for (int c = 'a'; c <= 'z'; ++c) {
+    classes[c] = kIdentChar;
+    classes[c - 'a' + 'A'] = kIdentChar;
+  }
+  for (int c = 'a'; c <= 'f'; ++c) {
+    classes[c] |= kHexDigitChar;
+    classes[c - 'a' + 'A'] |= kHexDigitChar;
+  }
+  classes['_'] = kIdentChar;
+  for (char c : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+    classes[static_cast<unsigned char>(c)] = kWhitespaceChar;
+  }
+  return classes;
+}
+
+constexpr std::array<uint8_t, 256> kCharClasses = MakeCharClasses();
+
+[[nodiscard]] bool HasCharClass(char c, uint8_t char_class) {
+  return (kCharClasses[static_cast<unsigned char>(c)] & char_class) != 0;
+}
+
+[[nodiscard]] bool IsIdentTrailing(char c) {
+  return HasCharClass(c, kIdentChar);
+}
+
+[[nodiscard]] bool IsDigit(char c) { return HasCharClass(c, kDigitChar); }
+
+[[nodiscard]] bool IsPlusOrMinus(char c) { return c == '+' || c == '-'; }
+
+// Runs of bytes are scanned a word at a time, which vectorizes the common
+// cases of long string literals, comments and indentation without depending
+// on a particular instruction set.
+constexpr uint64_t kLowBits = 0x0101010101010101;
+constexpr uint64_t kHighBits = 0x8080808080808080;
+constexpr uint64_t kSpaces = kLowBits * ' ';
+
+[[nodiscard]] uint64_t LoadWord(const char* data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+// Returns a mask with the high bit set of exactly those bytes of `word` which
+// are `c`.
+[[nodiscard]] uint64_t MatchByte(uint64_t word, char c) {
+  uint64_t x = word ^ (kLowBits * static_cast<unsigned char>(c));
+  return ~(((x & ~kHighBits) + ~kHighBits) | x | ~kHighBits);
+}
+
+// Returns the index in memory order of the first byte set in a mask returned
+// by `MatchByte`.
+[[nodiscard]] size_t FirstMatch(uint64_t mask) {
+#ifdef ABSL_IS_BIG_ENDIAN
+  return static_cast<size_t>(absl::countl_zero(mask)) / 8;
+#else
+  return static_cast<size_t>(absl::countr_zero(mask)) / 8;
+#endif
 }
 
-[[nodiscard]] bool IsPlusOrMinus(char32_t c) { return c == '+' || c == '-'; }
+// Returns the offset of the first `a` or `b` in `text` at or after `pos`, or
+// `absl::string_view::npos`.
+[[nodiscard]] size_t FindEither(absl::string_view text, size_t pos, char a,
+                                char b) {
+  for (; pos + sizeof(uint64_t) <= text.size(); pos += sizeof(uint64_t)) {
+    uint64_t word = LoadWord(text.data() + pos);
+    uint64_t mask = MatchByte(word, a) | MatchByte(word, b);
+    if (mask != 0) {
+      return pos + FirstMatch(mask);
+    }
+  }
+  for (; pos < text.size(); ++pos) {
+    if (text[pos] == a || text[pos] == b) {
+      return pos;
+    }
+  }
+  return absl::string_view::npos;
+}
 
 [[nodiscard]] const absl::flat_hash_map<std::string_view, TokenType>&
 Keywords() {
@@ -162,12 +250,12 @@ std::string_view TokenTypeToString(TokenType type) {
 
 Token Lexer::Lex() {
   int32_t start = GetPosition();
-  if (ABSL_PREDICT_FALSE(position_ >= content_.size())) {
+  if (ABSL_PREDICT_FALSE(offset_ >= text_.size())) {
     at_end_ = true;
     done_ = true;
     return MakeToken(TokenType::kEnd, start, start);
   }
-  char32_t c = content_.at(position_);
+  char c = text_[offset_];
   switch (c) {
     case '\f':
       ABSL_FALLTHROUGH_INTENDED;
@@ -184,9 +272,7 @@ Token Lexer::Lex() {
       return MakeToken(TokenType::kWhitespace, start, GetPosition());
     }
     case '.': {
-      if (position_ + 1 < content_.size() &&
-          content_.at(position_ + 1) <= 0x7f &&
-          absl::ascii_isdigit(static_cast<char>(content_.at(position_ + 1)))) {
+      if (offset_ + 1 < text_.size() && IsDigit(text_[offset_ + 1])) {
         return ConsumeNumericLiteral();
       }
       Advance(1);
@@ -323,175 +409,130 @@ Token Lexer::Lex() {
     default:
       break;
   }
-  if (c <= 0x7f && absl::ascii_isdigit(static_cast<char>(c))) {
+  if (IsDigit(c)) {
     return ConsumeNumericLiteral();
   }
-  if (c <= 0x7f && absl::ascii_isalpha(static_cast<char>(c))) {
+  if (absl::ascii_isalpha(static_cast<unsigned char>(c))) {
     // Root identifiers (the ones starting with a period) are returned as
     // a sequence of kDot and kIdent tokens.
     return ConsumeIdent();
   }
-  Advance(1);
+  // Skip the whole code point, which may be non-ASCII.
+  AdvanceTo(offset_ + internal::Utf8Decode(text_.substr(offset_), nullptr));
   return SetError(start, GetPosition(), "unexpected character");
 }
 
+void Lexer::AdvanceTo(size_t end) {
+  ABSL_DCHECK_GE(end, offset_);
+  ABSL_DCHECK_LE(end, text_.size());
+  size_t code_points =
+      ascii_ ? end - offset_
+             : internal::Utf8CodePointCountUnchecked(
+                   text_.substr(offset_, end - offset_));
+  offset_ = end;
+  position_ += static_cast<int32_t>(code_points);
+}
+
 // Consumes characters up to and including the first occurrence of character `c`
 // without interpreting backslashes as escapes.
 // Returns true if `c` was found and consumed; false if end of input was
 // reached.
-bool Lexer::ConsumeUntilAfter(char32_t c) {
+bool Lexer::ConsumeUntilAfter(char c) {
   ABSL_DCHECK_NE(c, '\n');
-  for (int32_t pos = position_; pos < content_.size(); ++pos) {
-    if (content_.at(pos) == c) {
-      AdvanceProcessingNewLines(pos + 1);
-      return true;
-    }
+  size_t pos = text_.find(c, offset_);
+  if (pos == absl::string_view::npos) {
+    AdvanceTo(text_.size());
+    return false;
   }
-  AdvanceProcessingNewLines(content_.size());
-  return false;
+  AdvanceTo(pos + 1);
+  return true;
 }
 
 // Consumes characters up to and including the first occurrence of substring `s`
 // without interpreting backslashes as escapes (`s` must not contain newlines).
 // Returns true if `s` was found and consumed; false if end of input was
 // reached.
-bool Lexer::ConsumeUntilAfterString(std::u32string_view s) {
-  ABSL_DCHECK(s.find(U'\n') == std::u32string_view::npos);
-  int32_t pos = position_;
-  while (pos + static_cast<int32_t>(s.size()) <= content_.size()) {
-    bool match = true;
-    for (size_t i = 0; i < s.size(); ++i) {
-      if (content_.at(pos + static_cast<int32_t>(i)) != s[i]) {
-        match = false;
-        break;
-      }
-    }
-    if (match) {
-      AdvanceProcessingNewLines(pos + static_cast<int32_t>(s.size()));
-      return true;
-    }
-    ++pos;
+bool Lexer::ConsumeUntilAfterString(absl::string_view s) {
+  ABSL_DCHECK(s.find('\n') == absl::string_view::npos);
+  size_t pos = text_.find(s, offset_);
+  if (pos == absl::string_view::npos) {
+    AdvanceTo(text_.size());
+    return false;
   }
-  AdvanceProcessingNewLines(content_.size());
-  return false;
+  AdvanceTo(pos + s.size());
+  return true;
 }
 
 // Consumes characters up to and including the first occurrence of `c` that is
 // not preceded by an odd number of backslash ('\') escape characters. Returns
 // true if an unescaped `c` was found and consumed; false if reached EOF.
-bool Lexer::ConsumeUntilAfterUnescaped(char32_t c) {
+bool Lexer::ConsumeUntilAfterUnescaped(char c) {
   ABSL_DCHECK_NE(c, '\n');
   ABSL_DCHECK_NE(c, '\\');
-  int32_t pos = position_;
-  bool escaped = false;
-  while (pos < content_.size()) {
-    char32_t cc = content_.at(pos);
-    if (cc == '\\') {
-      escaped = !escaped;
-    } else {
-      if (cc == c && !escaped) {
-        AdvanceProcessingNewLines(pos + 1);
-        return true;
-      }
-      escaped = false;
-    }
-    ++pos;
-  }
-  AdvanceProcessingNewLines(content_.size());
-  return false;
+  return ConsumeUntilAfterUnescapedString(absl::string_view(&c, 1));
 }
 
 // Consumes characters up to and including the first occurrence of substring `s`
 // where the first character of `s` is not preceded by an odd number of
 // backslashes. Returns true if an unescaped `s` was found and consumed; false
 // if reached EOF.
-bool Lexer::ConsumeUntilAfterUnescapedString(std::u32string_view s) {
-  ABSL_DCHECK(s.find(U'\n') == std::u32string_view::npos);
-  int32_t pos = position_;
-  bool escaped = false;
-  while (pos < content_.size()) {
-    char32_t cc = content_.at(pos);
-    if (cc == '\\') {
-      escaped = !escaped;
-    } else {
-      if (!escaped && pos + static_cast<int32_t>(s.size()) <= content_.size()) {
-        bool match = true;
-        for (size_t j = 0; j < s.size(); ++j) {
-          if (content_.at(pos + static_cast<int32_t>(j)) != s[j]) {
-            match = false;
-            break;
-          }
-        }
-        if (match) {
-          AdvanceProcessingNewLines(pos + static_cast<int32_t>(s.size()));
-          return true;
-        }
-      }
-      escaped = false;
+bool Lexer::ConsumeUntilAfterUnescapedString(absl::string_view s) {
+  ABSL_DCHECK(!s.empty());
+  ABSL_DCHECK(s.find('\n') == absl::string_view::npos);
+  size_t pos = offset_;
+  while ((pos = FindEither(text_, pos, s[0], '\\')) !=
+         absl::string_view::npos) {
+    if (text_[pos] == '\\') {
+      // Skip the escaped character, which cannot start `s`. It may be the
+      // first byte of a multibyte code point, whose remaining bytes cannot
+      // match either.
+      pos += 2;
+      continue;
+    }
+    if (text_.substr(pos, s.size()) == s) {
+      AdvanceTo(pos + s.size());
+      return true;
     }
     ++pos;
   }
-  AdvanceProcessingNewLines(content_.size());
+  AdvanceTo(text_.size());
   return false;
 }
 
-bool Lexer::MatchString(std::u32string_view s) const {
-  if (position_ + static_cast<int32_t>(s.size()) > content_.size()) {
-    return false;
-  }
-  for (size_t i = 0; i < s.size(); ++i) {
-    if (content_.at(position_ + static_cast<int32_t>(i)) != s[i]) {
-      return false;
-    }
-  }
-  return true;
+bool Lexer::MatchString(absl::string_view s) const {
+  return text_.substr(offset_, s.size()) == s;
 }
 
-std::optional<char32_t> Lexer::MatchIf(
-    absl::FunctionRef<bool(char32_t)> predicate) const {
-  if (position_ < content_.size()) {
-    char32_t cp = content_.at(position_);
-    if (predicate(cp)) {
-      return cp;
+std::optional<char> Lexer::MatchIf(
+    absl::FunctionRef<bool(char)> predicate) const {
+  if (offset_ < text_.size()) {
+    char c = text_[offset_];
+    if (predicate(c)) {
+      return c;
     }
   }
   return std::nullopt;
 }
 
 void Lexer::ConsumeLine() {
-  while (position_ < content_.size()) {
-    if (content_.at(position_) == '\n') {
-      Advance(1);
-      return;
-    }
-    Advance(1);
-  }
+  size_t pos = text_.find('\n', offset_);
+  AdvanceTo(pos == absl::string_view::npos ? text_.size() : pos + 1);
 }
 
 void Lexer::ConsumeWhitespace() {
-  while (position_ < content_.size()) {
-    char32_t c = content_.at(position_);
-    switch (c) {
-      case '\f':
-        ABSL_FALLTHROUGH_INTENDED;
-      case '\n':
-        ABSL_FALLTHROUGH_INTENDED;
-      case ' ':
-        ABSL_FALLTHROUGH_INTENDED;
-      case '\r':
-        ABSL_FALLTHROUGH_INTENDED;
-      case '\v':
-        ABSL_FALLTHROUGH_INTENDED;
-      case '\t':
-        Advance(1);
-        break;
-      default:
-        return;
-    }
+  size_t pos = offset_;
+  // Indentation is commonly runs of spaces.
+  while (text_.size() - pos >= sizeof(uint64_t) &&
+         LoadWord(text_.data() + pos) == kSpaces) {
+    pos += sizeof(uint64_t);
   }
+  while (pos < text_.size() && HasCharClass(text_[pos], kWhitespaceChar)) {
+    ++pos;
+  }
+  Advance(pos - offset_);
 }
 
-bool Lexer::Consume(char32_t c) {
+bool Lexer::Consume(char c) {
   ABSL_DCHECK_NE(c, '\n');
   if (Match(c)) {
     Advance(1);
@@ -500,7 +541,7 @@ bool Lexer::Consume(char32_t c) {
   return false;
 }
 
-bool Lexer::ConsumeIgnoreCase(char32_t c) {
+bool Lexer::ConsumeIgnoreCase(char c) {
   ABSL_DCHECK_NE(c, '\n');
   if (MatchIgnoreCase(c)) {
     Advance(1);
@@ -509,8 +550,8 @@ bool Lexer::ConsumeIgnoreCase(char32_t c) {
   return false;
 }
 
-bool Lexer::ConsumeString(std::u32string_view s) {
-  ABSL_DCHECK(s.find(U'\n') == std::u32string_view::npos);
+bool Lexer::ConsumeString(absl::string_view s) {
+  ABSL_DCHECK(s.find('\n') == absl::string_view::npos);
   if (MatchString(s)) {
     Advance(s.size());
     return true;
@@ -518,40 +559,34 @@ bool Lexer::ConsumeString(std::u32string_view s) {
   return false;
 }
 
-std::optional<char32_t> Lexer::ConsumeIf(
-    absl::FunctionRef<bool(char32_t)> predicate) {
-  std::optional<char32_t> match = MatchIf(predicate);
+std::optional<char> Lexer::ConsumeIf(absl::FunctionRef<bool(char)> predicate) {
+  std::optional<char> match = MatchIf(predicate);
   if (match.has_value()) {
     ABSL_DCHECK_NE(*match, '\n');
+    ABSL_DCHECK(absl::ascii_isascii(*match));
     Advance(1);
   }
   return match;
 }
 
 bool Lexer::ConsumeDigits() {
-  bool advanced = false;
-  while (position_ < content_.size()) {
-    char32_t c = content_.at(position_);
-    if (c > 0x7f || !absl::ascii_isdigit(static_cast<char>(c))) {
-      break;
-    }
-    Advance(1);
-    advanced = true;
+  size_t pos = offset_;
+  while (pos < text_.size() && HasCharClass(text_[pos], kDigitChar)) {
+    ++pos;
   }
-  return advanced;
+  size_t n = pos - offset_;
+  Advance(n);
+  return n != 0;
 }
 
 bool Lexer::ConsumeHexDigits() {
-  bool advanced = false;
-  while (position_ < content_.size()) {
-    char32_t c = content_.at(position_);
-    if (c > 0x7f || !absl::ascii_isxdigit(static_cast<char>(c))) {
-      break;
-    }
-    Advance(1);
-    advanced = true;
+  size_t pos = offset_;
+  while (pos < text_.size() && HasCharClass(text_[pos], kHexDigitChar)) {
+    ++pos;
   }
-  return advanced;
+  size_t n = pos - offset_;
+  Advance(n);
+  return n != 0;
 }
 
 TokenType Lexer::ConsumeIntegralSuffix() {
@@ -570,11 +605,12 @@ Token Lexer::ConsumeQuotedIdent() {
   return MakeToken(TokenType::kIdent, start, GetPosition());
 }
 
-Token Lexer::ConsumeStringLiteral(int32_t start, char32_t quote, bool is_bytes,
+Token Lexer::ConsumeStringLiteral(int32_t start, char quote, bool is_bytes,
                                   bool is_raw) {
   Advance(1);
-  std::u32string triple_quote(3, quote);
-  if (ConsumeString(std::u32string_view(triple_quote.data(), 2))) {
+  const char triple_quote_chars[3] = {quote, quote, quote};
+  absl::string_view triple_quote(triple_quote_chars, 3);
+  if (ConsumeString(triple_quote.substr(0, 2))) {
     if (is_raw ? !ConsumeUntilAfterString(triple_quote)
                : !ConsumeUntilAfterUnescapedString(triple_quote)) {
       return SetError(start, GetPosition(),
@@ -601,13 +637,13 @@ Token Lexer::ConsumeStringLiteral(int32_t start, char32_t quote, bool is_bytes,
 //              rb"""...""", rb'''...'''
 std::optional<Token> Lexer::ConsumePrefixedStringLiteral() {
   int32_t start = GetPosition();
-  if (position_ >= content_.size()) return std::nullopt;
-  char32_t c = content_.at(position_);
+  if (offset_ >= text_.size()) return std::nullopt;
+  char c = text_[offset_];
   bool is_bytes = (c == 'b' || c == 'B');
   bool is_raw = (c == 'r' || c == 'R');
   size_t lookahead = 1;
-  if (position_ + 1 < content_.size()) {
-    char32_t c2 = content_.at(position_ + 1);
+  if (offset_ + 1 < text_.size()) {
+    char c2 = text_[offset_ + 1];
     if ((is_bytes && (c2 == 'r' || c2 == 'R')) ||
         (!is_bytes && (c2 == 'b' || c2 == 'B'))) {
       is_bytes = true;
@@ -615,8 +651,8 @@ std::optional<Token> Lexer::ConsumePrefixedStringLiteral() {
       lookahead = 2;
     }
   }
-  if (position_ + static_cast<int32_t>(lookahead) < content_.size()) {
-    char32_t quote = content_.at(position_ + static_cast<int32_t>(lookahead));
+  if (offset_ + lookahead < text_.size()) {
+    char quote = text_[offset_ + lookahead];
     if (quote == '"' || quote == '\'') {
       Advance(lookahead);
       return ConsumeStringLiteral(start, quote, is_bytes, is_raw);
@@ -632,7 +668,7 @@ std::optional<Token> Lexer::ConsumePrefixedStringLiteral() {
 // - Floating-point numbers (kFloat): .12345, 1.23, 1e6, 1.5e+10, .5e-3
 Token Lexer::ConsumeNumericLiteral() {
   int32_t start = GetPosition();
-  char32_t c = content_.at(position_);
+  char c = text_[offset_];
   bool floating_point = false;
   if (c == '.') {
     floating_point = true;
@@ -662,9 +698,8 @@ Token Lexer::ConsumeNumericLiteral() {
       }
     }
     static_cast<void>(ConsumeDigits());
-    if (position_ < content_.size() && content_.at(position_) == '.' &&
-        position_ + 1 < content_.size() && content_.at(position_ + 1) <= 0x7f &&
-        absl::ascii_isdigit(static_cast<char>(content_.at(position_ + 1)))) {
+    if (Match('.') && offset_ + 1 < text_.size() &&
+        IsDigit(text_[offset_ + 1])) {
       floating_point = true;
       Advance(1);
       static_cast<void>(ConsumeDigits());
@@ -692,15 +727,14 @@ Token Lexer::ConsumeNumericLiteral() {
 
 Token Lexer::ConsumeIdent() {
   int32_t start = GetPosition();
-  while (position_ < content_.size()) {
-    char32_t c = content_.at(position_);
-    if (!IsIdentTrailing(c)) {
-      break;
-    }
-    Advance(1);
+  size_t begin = offset_;
+  size_t pos = offset_;
+  while (pos < text_.size() && IsIdentTrailing(text_[pos])) {
+    ++pos;
   }
+  Advance(pos - begin);
   int32_t end = GetPosition();
-  std::string word = content_.ToString(start, end);
+  std::string_view word(text_.data() + begin, pos - begin);
   const auto& keywords = Keywords();
   if (auto it = keywords.find(word); it != keywords.end()) {
     return MakeToken(it->second, start, end);
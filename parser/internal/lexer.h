@@ -28,6 +28,7 @@
 #include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
 #include "common/source.h"
 
 namespace cel::parser_internal {
@@ -132,12 +133,19 @@ struct LexerError final {
 //    - Performs only general bounds and format matching for integers and
 //      floating-point numeric literals. The lexer expects the parser to perform
 //      final validation and numeric conversion when building the AST.
+//
+// 3. Source Representation:
+//    The lexer scans the UTF-8 encoding of the source a byte at a time, and
+//    runs of string, comment and whitespace bytes a word at a time. Token
+//    positions are code point positions, which only differ from byte offsets
+//    past non-ASCII code points and are then counted from the skipped bytes.
 class Lexer final {
  public:
   explicit Lexer(const cel::Source& source)
-      : content_(source.content()), position_(0) {
-    ABSL_DCHECK_LE(content_.size(), static_cast<SourcePosition>(
-                                        std::numeric_limits<int32_t>::max()));
+      : text_(source.content().AsUtf8()),
+        ascii_(static_cast<size_t>(source.content().size()) == text_.size()) {
+    ABSL_DCHECK_LE(text_.size(),
+                   static_cast<size_t>(std::numeric_limits<int32_t>::max()));
   }
 
   Lexer(const Lexer&) = delete;
@@ -159,28 +167,26 @@ class Lexer final {
   [[nodiscard]] int32_t GetPosition() const { return position_; }
 
  private:
-  [[nodiscard]] bool Match(char32_t c) const {
-    return position_ < content_.size() && content_.at(position_) == c;
+  [[nodiscard]] bool Match(char c) const {
+    return offset_ < text_.size() && text_[offset_] == c;
   }
 
-  [[nodiscard]] bool MatchIgnoreCase(char32_t c) const {
-    if (position_ >= content_.size()) return false;
-    char32_t cp = content_.at(position_);
-    return cp <= 0x7f && c <= 0x7f &&
-           absl::ascii_tolower(static_cast<char>(cp)) ==
-               absl::ascii_tolower(static_cast<char>(c));
+  [[nodiscard]] bool MatchIgnoreCase(char c) const {
+    return offset_ < text_.size() &&
+           absl::ascii_tolower(static_cast<unsigned char>(text_[offset_])) ==
+               absl::ascii_tolower(static_cast<unsigned char>(c));
   }
 
+  // Advances over `n` ASCII characters.
   void Advance(size_t n) {
-    ABSL_DCHECK_LE(n, static_cast<size_t>(content_.size() - position_));
+    ABSL_DCHECK_LE(n, text_.size() - offset_);
+    offset_ += n;
     position_ += static_cast<int32_t>(n);
   }
 
-  void AdvanceProcessingNewLines(int32_t end_position) {
-    ABSL_DCHECK_LE(end_position, content_.size());
-    ABSL_DCHECK_GE(end_position, position_);
-    Advance(static_cast<size_t>(end_position - position_));
-  }
+  // Advances to the byte offset `end`, which may be past non-ASCII code
+  // points.
+  void AdvanceTo(size_t end);
 
   [[nodiscard]] Token MakeToken(TokenType type, int32_t start, int32_t end) {
     if (ABSL_PREDICT_FALSE(at_end_)) {
@@ -201,42 +207,42 @@ class Lexer final {
   // Consumes characters up to and including the first occurrence of character
   // `c` without interpreting backslashes as escapes. Returns true if `c` was
   // found and consumed; false if end of input was reached.
-  [[nodiscard]] bool ConsumeUntilAfter(char32_t c);
+  [[nodiscard]] bool ConsumeUntilAfter(char c);
 
   // Consumes characters up to and including the first occurrence of substring
   // `s` without interpreting backslashes as escapes (`s` must not contain
   // newlines). Returns true if `s` was found and consumed; false if end of
   // input was reached.
-  [[nodiscard]] bool ConsumeUntilAfterString(std::u32string_view s);
+  [[nodiscard]] bool ConsumeUntilAfterString(absl::string_view s);
 
   // Consumes characters up to and including the first occurrence of `c` that is
   // not preceded by an odd number of backslash ('\') escape characters. Returns
   // true if an unescaped `c` was found and consumed; false if reached EOF.
-  [[nodiscard]] bool ConsumeUntilAfterUnescaped(char32_t c);
+  [[nodiscard]] bool ConsumeUntilAfterUnescaped(char c);
 
   // Consumes characters up to and including the first occurrence of substring
   // `s` where the first character of `s` is not preceded by an odd number of
   // backslashes. Returns true if an unescaped `s` was found and consumed; false
   // if reached EOF.
-  [[nodiscard]] bool ConsumeUntilAfterUnescapedString(std::u32string_view s);
+  [[nodiscard]] bool ConsumeUntilAfterUnescapedString(absl::string_view s);
 
-  [[nodiscard]] bool MatchString(std::u32string_view s) const;
+  [[nodiscard]] bool MatchString(absl::string_view s) const;
 
-  [[nodiscard]] std::optional<char32_t> MatchIf(
-      absl::FunctionRef<bool(char32_t)> predicate) const;
+  [[nodiscard]] std::optional<char> MatchIf(
+      absl::FunctionRef<bool(char)> predicate) const;
 
   void ConsumeLine();
 
   void ConsumeWhitespace();
 
-  [[nodiscard]] bool Consume(char32_t c);
+  [[nodiscard]] bool Consume(char c);
 
-  [[nodiscard]] bool ConsumeIgnoreCase(char32_t c);
+  [[nodiscard]] bool ConsumeIgnoreCase(char c);
 
-  [[nodiscard]] bool ConsumeString(std::u32string_view s);
+  [[nodiscard]] bool ConsumeString(absl::string_view s);
 
-  [[nodiscard]] std::optional<char32_t> ConsumeIf(
-      absl::FunctionRef<bool(char32_t)> predicate);
+  [[nodiscard]] std::optional<char> ConsumeIf(
+      absl::FunctionRef<bool(char)> predicate);
 
   [[nodiscard]] bool ConsumeDigits();
 
@@ -251,7 +257,7 @@ class Lexer final {
   // struct field specifiers).
   [[nodiscard]] Token ConsumeQuotedIdent();
 
-  [[nodiscard]] Token ConsumeStringLiteral(int32_t start, char32_t quote,
+  [[nodiscard]] Token ConsumeStringLiteral(int32_t start, char quote,
                                            bool is_bytes = false,
                                            bool is_raw = false);
 
@@ -274,7 +280,13 @@ class Lexer final {
   // keywords.
   [[nodiscard]] Token ConsumeIdent();
 
-  cel::SourceContentView content_;
+  // The UTF-8 encoded source.
+  const absl::string_view text_;
+  // Whether `text_` is ASCII, so that byte offsets and positions coincide.
+  const bool ascii_;
+  // The byte offset in `text_` of the next character.
+  size_t offset_ = 0;
+  // The code point position of the next character.
   int32_t position_ = 0;
   bool at_end_ = false;
   bool done_ = false;
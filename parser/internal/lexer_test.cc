@@ -312,6 +312,22 @@ bytes''' br"raw_bytes" `a.b-c/d e`
           {TokenType::kWhitespace, " "},
           {TokenType::kBytes, "b\"bytes\""},
           {TokenType::kRightParen, ")"}}},
+        {"NonAscii",
+         "'héllo' \"日\\\"本\" // 😀 comment\n"
+         "r'''ö''' 'é is longer than a word \\' \\\\'",
+         {{TokenType::kString, "'héllo'"},
+          {TokenType::kWhitespace, " "},
+          {TokenType::kString, "\"日\\\"本\""},
+          {TokenType::kWhitespace, " "},
+          {TokenType::kComment, "// 😀 comment\n"},
+          {TokenType::kString, "r'''ö'''"},
+          {TokenType::kWhitespace, " "},
+          {TokenType::kString, "'é is longer than a word \\' \\\\'"}}},
+        {"LongWhitespace",
+         "a                   \t  b",
+         {{TokenType::kIdent, "a"},
+          {TokenType::kWhitespace, "                   \t  "},
+          {TokenType::kIdent, "b"}}},
     }),
     [](const testing::TestParamInfo<LexerTestCase>& info) {
       return std::string(info.param.name);
@@ -470,6 +486,12 @@ INSTANTIATE_TEST_SUITE_P(
             .expected_error_message = "unexpected character",
             .expected_error_location = "\n | \"😀😀😀😀😀\" ~error"
                                        "\n | .．．．．．...^",
+        },
+        LexerErrorTestCase{
+            .source = "'é' é 1",
+            .expected_error_message = "unexpected character",
+            .expected_error_location = "\n | 'é' é 1"
+                                       "\n | .．..．^",
         }));
 
 TEST(LexerErrorRecoveryTest, ResumesAfterError) {
@@ -441,5 +441,40 @@ void BM_Antlr_ParseRepeatedSyntaxErrors(benchmark::State& state) {
 BENCHMARK(BM_Pratt_ParseRepeatedSyntaxErrors)->Arg(10)->Arg(50)->Arg(100);
 BENCHMARK(BM_Antlr_ParseRepeatedSyntaxErrors)->Arg(10)->Arg(50)->Arg(100);
 
+// -----------------------------------------------------------------------------
+// Workload 12: Non-ASCII String Literals ("'h\u00e9llo' + 'h\u00e9llo'...")
+// -----------------------------------------------------------------------------
+std::string BuildNonAsciiChain(int length) {
+  std::string expr = "'h\u00e9llo \u4e16\u754c'";
+  for (int i = 1; i < length; ++i) {
+    absl::StrAppend(&expr, " + 'h\u00e9llo \u4e16\u754c'");
+  }
+  return expr;
+}
+
+void BM_ParseNonAsciiChain(benchmark::State& state, ParserImplType type) {
+  cel::ParserOptions options;
+  auto parser = CreateParser(type, options);
+  std::string expr = BuildNonAsciiChain(state.range(0));
+
+  for (auto _ : state) {
+    auto source = cel::NewSource(expr);
+    ABSL_DCHECK_OK(source.status());
+    auto ast = parser->Parse(**source);
+    ABSL_DCHECK_OK(ast.status());
+    benchmark::DoNotOptimize(ast);
+  }
+}
+
+void BM_Pratt_ParseNonAsciiChain(benchmark::State& state) {
+  BM_ParseNonAsciiChain(state, ParserImplType::kPratt);
+}
+void BM_Antlr_ParseNonAsciiChain(benchmark::State& state) {
+  BM_ParseNonAsciiChain(state, ParserImplType::kAntlr);
+}
+
+BENCHMARK(BM_Pratt_ParseNonAsciiChain)->Arg(10)->Arg(50)->Arg(100);
+BENCHMARK(BM_Antlr_ParseNonAsciiChain)->Arg(10)->Arg(50)->Arg(100);
+
 }  // namespace
 }  // namespace cel::parser_internal
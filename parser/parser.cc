@@ -66,6 +66,7 @@
 #include "internal/lexis.h"
 #include "internal/status_macros.h"
 #include "internal/strings.h"
+#include "internal/utf8.h"
 #include "parser/internal/pratt_parser.h"
 #pragma push_macro("IN")
 #undef IN
@@ -456,13 +457,19 @@ using common::CelOperator;
 using common::ReverseLookupOperator;
 using ::cel::expr::ParsedExpr;
 
+// Presents the source to the ANTLR lexer as code points. The lexer reads the
+// source sequentially, so the byte offset of the current code point is kept
+// alongside its index and other positions are reached by stepping from it,
+// rather than mapping each position to its offset.
 class CodePointStream final : public CharStream {
  public:
   CodePointStream(cel::SourceContentView buffer, absl::string_view source_name)
-      : buffer_(buffer),
+      : text_(buffer.AsUtf8()),
         source_name_(source_name),
-        size_(buffer_.size()),
-        index_(0) {}
+        size_(buffer.size()),
+        ascii_(text_.size() == size_),
+        index_(0),
+        offset_(0) {}
 
   void consume() override {
     if (ABSL_PREDICT_FALSE(index_ >= size_)) {
@@ -470,6 +477,7 @@ class CodePointStream final : public CharStream {
       throw antlr4::IllegalStateException("cannot consume EOF");
     }
     index_++;
+    offset_ = ascii_ ? index_ : NextOffset(offset_);
   }
 
   size_t LA(ptrdiff_t i) override {
@@ -486,7 +494,13 @@ class CodePointStream final : public CharStream {
     if (p + i - 1 >= static_cast<ptrdiff_t>(size_)) {
       return IntStream::EOF;
     }
-    return buffer_.at(static_cast<size_t>(p + i - 1));
+    const size_t offset = Offset(static_cast<size_t>(p + i - 1));
+    if (ascii_) {
+      return static_cast<uint8_t>(text_[offset]);
+    }
+    char32_t code_point;
+    cel::internal::Utf8Decode(text_.substr(offset), &code_point);
+    return code_point;
   }
 
   ptrdiff_t mark() override { return -1; }
@@ -495,7 +509,11 @@ class CodePointStream final : public CharStream {
 
   size_t index() override { return index_; }
 
-  void seek(size_t index) override { index_ = std::min(index, size_); }
+  void seek(size_t index) override {
+    index = std::min(index, size_);
+    offset_ = Offset(index);
+    index_ = index;
+  }
 
   size_t size() override { return size_; }
 
@@ -516,17 +534,61 @@ class CodePointStream final : public CharStream {
     if (ABSL_PREDICT_FALSE(stop >= size_)) {
       stop = size_ - 1;
     }
-    return buffer_.ToString(static_cast<cel::SourcePosition>(start),
-                            static_cast<cel::SourcePosition>(stop) + 1);
+    if (ABSL_PREDICT_FALSE(stop < start)) {
+      return std::string();
+    }
+    // Tokens are requested once lexed, so they end near the current position.
+    const size_t end_offset = Offset(stop + 1);
+    const size_t start_offset =
+        ascii_ ? start : StepBack(end_offset, stop + 1 - start);
+    return std::string(text_.substr(start_offset, end_offset - start_offset));
   }
 
-  std::string toString() const override { return buffer_.ToString(); }
+  std::string toString() const override { return std::string(text_); }
 
  private:
-  cel::SourceContentView const buffer_;
+  // Returns the offset of the code point following the one at `offset`.
+  size_t NextOffset(size_t offset) const {
+    return offset + cel::internal::Utf8Decode(text_.substr(offset), nullptr);
+  }
+
+  // Returns the offset of the code point `count` code points before the one
+  // at `offset`.
+  size_t StepBack(size_t offset, size_t count) const {
+    for (; count > 0; --count) {
+      do {
+        --offset;
+      } while ((static_cast<uint8_t>(text_[offset]) & 0xc0) == 0x80);
+    }
+    return offset;
+  }
+
+  // Returns the byte offset of the code point at `position`, which is at most
+  // `size_`, by stepping from the current position.
+  size_t Offset(size_t position) const {
+    if (ascii_) {
+      return position;
+    }
+    if (position < index_) {
+      return StepBack(offset_, index_ - position);
+    }
+    size_t offset = offset_;
+    for (size_t i = index_; i < position; ++i) {
+      offset = NextOffset(offset);
+    }
+    return offset;
+  }
+
+  // The source encoded as UTF-8.
+  const absl::string_view text_;
   const absl::string_view source_name_;
+  // The number of code points in the source.
   const size_t size_;
+  // Whether code points and bytes coincide.
+  const bool ascii_;
   size_t index_;
+  // The byte offset of the code point at `index_`.
+  size_t offset_;
 };
 
 // Scoped helper for incrementing the parse recursion count.
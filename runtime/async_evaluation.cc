@@ -0,0 +1,165 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/async_evaluation.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/function_descriptor.h"
+#include "common/kind.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "internal/status_macros.h"
+#include "runtime/embedder_context.h"
+#include "runtime/function.h"
+#include "runtime/function_registry.h"
+#include "runtime/internal/call_key.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+// Answers calls from the results supplied to the AsyncEvaluation found in the
+// embedder context.
+class AsyncFunction final : public Function {
+ public:
+  explicit AsyncFunction(std::string name) : name_(std::move(name)) {}
+
+  absl::StatusOr<Value> Invoke(absl::Span<const Value> args,
+                               const InvokeContext& context) const override {
+    AsyncEvaluation* absl_nullable evaluation =
+        context.embedder_context() == nullptr
+            ? nullptr
+            : context.embedder_context()->Get<AsyncEvaluation*>();
+    if (evaluation == nullptr) {
+      return ErrorValue(absl::FailedPreconditionError(absl::StrCat(
+          "async function ", name_, " called outside of AsyncEvaluation")));
+    }
+    absl::StatusOr<const Value* absl_nullable> result =
+        evaluation->Lookup(name_, args);
+    if (!result.ok()) {
+      return ErrorValue(std::move(result).status());
+    }
+    if (*result != nullptr) {
+      return **result;
+    }
+    // Stands in for the result until it is supplied. Like any error, it is
+    // ignored by logical operators when the other operand decides the result.
+    return ErrorValue(absl::UnavailableError(
+        absl::StrCat("async function ", name_, " is pending")));
+  }
+
+ private:
+  std::string name_;
+};
+
+namespace {
+
+// Whether arguments of `kind` can identify a call. `kAny` arguments are
+// checked when the function is called.
+bool IsSupportedArgKind(Kind kind) {
+  return kind == Kind::kAny ||
+         (KindIsValueKind(kind) &&
+          runtime_internal::IsCallKeyKind(KindToValueKind(kind)));
+}
+
+// Encodes a call as the function name followed by its arguments.
+absl::StatusOr<std::string> CallKey(absl::string_view function,
+                                    absl::Span<const Value> args) {
+  std::string key;
+  runtime_internal::AppendStringToCallKey(function, key);
+  if (ABSL_PREDICT_TRUE(runtime_internal::AppendArgsToCallKey(args, key))) {
+    return key;
+  }
+  for (const Value& arg : args) {
+    if (!runtime_internal::IsCallKeyKind(arg.kind())) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("async function ", function,
+                       " called with unsupported argument of type ",
+                       ValueKindToString(arg.kind())));
+    }
+  }
+  ABSL_UNREACHABLE();
+}
+
+}  // namespace
+
+absl::Status RegisterAsyncFunction(FunctionRegistry& registry,
+                                   absl::string_view name, bool receiver_style,
+                                   std::vector<Kind> arg_kinds) {
+  for (Kind kind : arg_kinds) {
+    if (!IsSupportedArgKind(kind)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("async function ", name,
+                       " has unsupported argument kind ", KindToString(kind)));
+    }
+  }
+  return registry.Register(
+      FunctionDescriptor(name, receiver_style, std::move(arg_kinds),
+                         /*is_strict=*/true, /*is_contextual=*/true),
+      std::make_unique<AsyncFunction>(std::string(name)));
+}
+
+absl::StatusOr<bool> AsyncEvaluation::Resume() {
+  pending_calls_.clear();
+  pending_keys_.clear();
+  const EmbedderContext context = EmbedderContext::From(this);
+  EvaluateOptions options;
+  options.embedder_context = &context;
+  ++pass_count_;
+  CEL_ASSIGN_OR_RETURN(Value result,
+                       program_.Evaluate(arena_, activation_, options));
+  if (!pending_calls_.empty() && (result.IsError() || result.IsUnknown())) {
+    return false;
+  }
+  pending_calls_.clear();
+  pending_keys_.clear();
+  result_ = std::move(result);
+  return true;
+}
+
+void AsyncEvaluation::Resolve(size_t index, Value result) {
+  ABSL_DCHECK_LT(index, pending_keys_.size());
+  results_.insert_or_assign(pending_keys_[index], std::move(result));
+}
+
+absl::StatusOr<const Value* absl_nullable> AsyncEvaluation::Lookup(
+    absl::string_view function, absl::Span<const Value> args) {
+  CEL_ASSIGN_OR_RETURN(std::string key, CallKey(function, args));
+  if (auto it = results_.find(key); it != results_.end()) {
+    return &it->second;
+  }
+  if (std::find(pending_keys_.begin(), pending_keys_.end(), key) ==
+      pending_keys_.end()) {
+    pending_keys_.push_back(std::move(key));
+    pending_calls_.push_back(
+        PendingCall{std::string(function),
+                    std::vector<Value>(args.begin(), args.end())});
+  }
+  return nullptr;
+}
+
+}  // namespace cel
@@ -0,0 +1,154 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Suspendable evaluation for programs that call I/O bound extension functions.
+//
+// An asynchronous function is registered by signature only. When an
+// AsyncEvaluation reaches a call whose result hasn't been supplied yet, the
+// call is recorded as pending and evaluates to an error, letting evaluation
+// continue to discover the other calls it can reach. The evaluation then
+// suspends, handing back the batch of pending calls. Once the caller has
+// supplied their results the evaluation is resumed and replays the program
+// with the results memoized, until it completes.
+//
+// A caller can drive many evaluations from one thread by collecting the
+// pending calls of each into a single batch of lookups:
+//
+//   AsyncEvaluation evaluation(*program, activation, &arena);
+//   CEL_ASSIGN_OR_RETURN(bool done, evaluation.Resume());
+//   while (!done) {
+//     for (size_t i = 0; i < evaluation.pending_calls().size(); ++i) {
+//       evaluation.Resolve(i, Lookup(evaluation.pending_calls()[i]));
+//     }
+//     CEL_ASSIGN_OR_RETURN(done, evaluation.Resume());
+//   }
+//   Use(evaluation.result());
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_ASYNC_EVALUATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_ASYNC_EVALUATION_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/kind.h"
+#include "common/value.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_registry.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+// Registers an asynchronous function overload. The function is strict: it is
+// only called once all of its arguments are known, non-error values.
+//
+// Calls are identified by their argument values, so arguments must be null,
+// bool, numeric, string, bytes, duration or timestamp values. Other kinds are
+// rejected on registration. A `dyn` argument of another kind makes the call
+// evaluate to an error.
+//
+// The function must only be evaluated through an AsyncEvaluation. Evaluated
+// any other way, every call results in an error.
+absl::Status RegisterAsyncFunction(FunctionRegistry& registry,
+                                   absl::string_view name, bool receiver_style,
+                                   std::vector<Kind> arg_kinds);
+
+// A call to an asynchronous function whose result hasn't been supplied.
+struct PendingCall {
+  std::string function;
+  std::vector<Value> args;
+};
+
+// Evaluates a program that may call asynchronous functions.
+//
+// Calls are identified by function name and argument values, so the results
+// of asynchronous functions must be deterministic for the duration of the
+// evaluation. Each resumption re-evaluates the program; the results of
+// asynchronous calls are memoized and are not repeated.
+//
+// A non-error result reached while calls are pending is final: CEL's logical
+// operators only ignore an operand, pending or not, when its value can't
+// affect the result. Errors and unknowns are only final once no calls are
+// pending.
+//
+// The evaluation provides its own embedder context to the program, so other
+// context sensitive functions in the program won't receive one.
+//
+// Thread compatible. The program, activation and arena must outlive the
+// evaluation.
+class AsyncEvaluation {
+ public:
+  AsyncEvaluation(const Program& program ABSL_ATTRIBUTE_LIFETIME_BOUND,
+                  const ActivationInterface& activation
+                      ABSL_ATTRIBUTE_LIFETIME_BOUND,
+                  google::protobuf::Arena* absl_nonnull arena
+                      ABSL_ATTRIBUTE_LIFETIME_BOUND)
+      : program_(program), activation_(activation), arena_(arena) {}
+
+  AsyncEvaluation(const AsyncEvaluation&) = delete;
+  AsyncEvaluation& operator=(const AsyncEvaluation&) = delete;
+
+  // Evaluates the program with the results supplied so far. Returns true if
+  // evaluation completed, making result() available, or false if it is
+  // suspended on pending_calls().
+  //
+  // A non-OK status is a non-recoverable evaluation error, as for
+  // Program::Evaluate.
+  absl::StatusOr<bool> Resume();
+
+  // The calls the evaluation is suspended on, in the order they were reached.
+  const std::vector<PendingCall>& pending_calls() const {
+    return pending_calls_;
+  }
+
+  // Supplies the result of `pending_calls()[index]`. The result may be an
+  // error value, which the program observes as the result of the call.
+  void Resolve(size_t index, Value result);
+
+  // The result of the completed evaluation.
+  const Value& result() const { return result_; }
+
+  // Number of times the program has been evaluated.
+  size_t pass_count() const { return pass_count_; }
+
+ private:
+  friend class AsyncFunction;
+
+  // Returns the result of a call, or nullptr after recording it as pending.
+  // Fails if an argument can't identify the call.
+  absl::StatusOr<const Value* absl_nullable> Lookup(
+      absl::string_view function, absl::Span<const Value> args);
+
+  const Program& program_;
+  const ActivationInterface& activation_;
+  google::protobuf::Arena* absl_nonnull arena_;
+  // Resolved results keyed by call.
+  absl::flat_hash_map<std::string, Value> results_;
+  std::vector<PendingCall> pending_calls_;
+  std::vector<std::string> pending_keys_;
+  Value result_;
+  size_t pass_count_ = 0;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_ASYNC_EVALUATION_H_
@@ -0,0 +1,185 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/async_evaluation.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/kind.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "compiler/compiler.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "runtime/activation.h"
+#include "runtime/internal/standard_env_testing.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+
+class AsyncEvaluationTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<CompilerBuilder> builder,
+                         runtime_internal::NewTestingCompilerBuilder(
+                             {MakeVariableDecl("key", StringType())}));
+    ASSERT_OK_AND_ASSIGN(
+        FunctionDecl lookup,
+        MakeFunctionDecl("lookup", MakeOverloadDecl("lookup_string",
+                                                    StringType(),
+                                                    StringType())));
+    ASSERT_THAT(builder->GetCheckerBuilder().AddFunction(lookup), IsOk());
+    ASSERT_OK_AND_ASSIGN(compiler_, builder->Build());
+
+    ASSERT_OK_AND_ASSIGN(
+        RuntimeBuilder runtime_builder,
+        CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                     RuntimeOptions{}));
+    ASSERT_THAT(RegisterAsyncFunction(runtime_builder.function_registry(),
+                                      "lookup", /*receiver_style=*/false,
+                                      {Kind::kString}),
+                IsOk());
+    ASSERT_OK_AND_ASSIGN(runtime_, std::move(runtime_builder).Build());
+  }
+
+  absl::StatusOr<std::unique_ptr<Program>> Plan(absl::string_view expr) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast,
+                         runtime_internal::CompileForTesting(*compiler_, expr));
+    return runtime_->CreateProgram(std::move(ast));
+  }
+
+  // Answers every pending call with the upper-cased argument.
+  static void ResolveAll(AsyncEvaluation& evaluation) {
+    for (size_t i = 0; i < evaluation.pending_calls().size(); ++i) {
+      std::string arg =
+          evaluation.pending_calls()[i].args[0].GetString().ToString();
+      for (char& c : arg) {
+        c = absl::ascii_toupper(c);
+      }
+      evaluation.Resolve(i, StringValue(std::move(arg)));
+    }
+  }
+
+  std::unique_ptr<Compiler> compiler_;
+  std::unique_ptr<Runtime> runtime_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(AsyncEvaluationTest, BatchesIndependentCalls) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Program> program,
+      Plan("lookup('a') + lookup(key) + lookup('a') + lookup(lookup('c'))"));
+  Activation activation;
+  activation.InsertOrAssignValue("key", StringValue("b"));
+  AsyncEvaluation evaluation(*program, activation, &arena_);
+
+  ASSERT_THAT(evaluation.Resume(), IsOkAndHolds(false));
+  // lookup(lookup('c')) can't be issued until lookup('c') is resolved.
+  ASSERT_THAT(evaluation.pending_calls(), SizeIs(3));
+  EXPECT_THAT(evaluation.pending_calls(),
+              ElementsAre(Field(&PendingCall::function, "lookup"),
+                          Field(&PendingCall::function, "lookup"),
+                          Field(&PendingCall::function, "lookup")));
+  ResolveAll(evaluation);
+
+  ASSERT_THAT(evaluation.Resume(), IsOkAndHolds(false));
+  ASSERT_THAT(evaluation.pending_calls(), SizeIs(1));
+  EXPECT_EQ(evaluation.pending_calls()[0].args[0].GetString().ToString(),
+            "C");
+  ResolveAll(evaluation);
+
+  ASSERT_THAT(evaluation.Resume(), IsOkAndHolds(true));
+  EXPECT_THAT(evaluation.pending_calls(), IsEmpty());
+  EXPECT_EQ(evaluation.result().GetString().ToString(), "ABAC");
+  EXPECT_EQ(evaluation.pass_count(), 3);
+}
+
+TEST_F(AsyncEvaluationTest, CompletesWhenPendingCallsCantMatter) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       Plan("lookup(key) == 'X' || key == 'b'"));
+  Activation activation;
+  activation.InsertOrAssignValue("key", StringValue("b"));
+  AsyncEvaluation evaluation(*program, activation, &arena_);
+
+  ASSERT_THAT(evaluation.Resume(), IsOkAndHolds(true));
+  EXPECT_TRUE(evaluation.result().IsTrue());
+}
+
+TEST_F(AsyncEvaluationTest, ResolvedErrorsAreObserved) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       Plan("lookup(key) == 'X'"));
+  Activation activation;
+  activation.InsertOrAssignValue("key", StringValue("b"));
+  AsyncEvaluation evaluation(*program, activation, &arena_);
+
+  ASSERT_THAT(evaluation.Resume(), IsOkAndHolds(false));
+  evaluation.Resolve(0, ErrorValue(absl::NotFoundError("no such key")));
+  ASSERT_THAT(evaluation.Resume(), IsOkAndHolds(true));
+  ASSERT_TRUE(evaluation.result().IsError());
+  EXPECT_THAT(evaluation.result().GetError().ToStatus(),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(AsyncEvaluationTest, SynchronousEvaluationReportsError) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       Plan("lookup(key)"));
+  Activation activation;
+  activation.InsertOrAssignValue("key", StringValue("b"));
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena_, activation));
+  ASSERT_TRUE(result.IsError());
+  EXPECT_THAT(result.GetError().ToStatus(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(AsyncEvaluationTest, RejectsArgumentsThatCantIdentifyCalls) {
+  ASSERT_OK_AND_ASSIGN(
+      RuntimeBuilder runtime_builder,
+      CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                   RuntimeOptions{}));
+  EXPECT_THAT(RegisterAsyncFunction(runtime_builder.function_registry(),
+                                    "lookup", /*receiver_style=*/false,
+                                    {Kind::kList}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(RegisterAsyncFunction(runtime_builder.function_registry(),
+                                    "lookup", /*receiver_style=*/false,
+                                    {Kind::kInt, Kind::kTimestamp, Kind::kAny}),
+              IsOk());
+}
+
+}  // namespace
+}  // namespace cel
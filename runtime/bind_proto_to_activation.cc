@@ -19,9 +19,13 @@
 #include "absl/base/nullability.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "common/value.h"
 #include "internal/status_macros.h"
 #include "runtime/activation.h"
+#include "runtime/runtime.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -62,6 +66,52 @@ absl::StatusOr<Value> GetFieldValue(
                                        message_factory, arena);
 }
 
+absl::Status BindField(
+    const google::protobuf::FieldDescriptor* field_desc, const StructValue& struct_value,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  CEL_ASSIGN_OR_RETURN(
+      bool should_bind,
+      ShouldBindField(field_desc, struct_value, unset_field_behavior));
+  if (!should_bind) {
+    return absl::OkStatus();
+  }
+
+  CEL_ASSIGN_OR_RETURN(Value field,
+                       GetFieldValue(field_desc, struct_value, descriptor_pool,
+                                     message_factory, arena));
+
+  activation->InsertOrAssignValue(field_desc->name(), std::move(field));
+  return absl::OkStatus();
+}
+
+void BindLazyField(const google::protobuf::FieldDescriptor* field_desc,
+                   const StructValue& struct_value,
+                   BindProtoUnsetFieldBehavior unset_field_behavior,
+                   Activation* absl_nonnull activation) {
+  activation->InsertOrAssignValueProvider(
+      field_desc->name(),
+      [field_desc, struct_value, unset_field_behavior](
+          absl::string_view,
+          const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+          google::protobuf::MessageFactory* absl_nonnull message_factory,
+          google::protobuf::Arena* absl_nonnull arena)
+          -> absl::StatusOr<absl::optional<Value>> {
+        CEL_ASSIGN_OR_RETURN(
+            bool should_bind,
+            ShouldBindField(field_desc, struct_value, unset_field_behavior));
+        if (!should_bind) {
+          return absl::nullopt;
+        }
+        CEL_ASSIGN_OR_RETURN(
+            Value field, GetFieldValue(field_desc, struct_value,
+                                       descriptor_pool, message_factory, arena));
+        return field;
+      });
+}
+
 }  // namespace
 
 absl::Status BindProtoToActivation(
@@ -71,19 +121,45 @@ absl::Status BindProtoToActivation(
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
   for (int i = 0; i < descriptor.field_count(); i++) {
-    const google::protobuf::FieldDescriptor* field_desc = descriptor.field(i);
-    CEL_ASSIGN_OR_RETURN(
-        bool should_bind,
-        ShouldBindField(field_desc, struct_value, unset_field_behavior));
-    if (!should_bind) {
-      continue;
-    }
+    CEL_RETURN_IF_ERROR(BindField(descriptor.field(i), struct_value,
+                                  unset_field_behavior, descriptor_pool,
+                                  message_factory, arena, activation));
+  }
 
-    CEL_ASSIGN_OR_RETURN(
-        Value field, GetFieldValue(field_desc, struct_value, descriptor_pool,
-                                   message_factory, arena));
+  return absl::OkStatus();
+}
+
+absl::Status BindReferencedProtoToActivation(
+    const Descriptor& descriptor, const StructValue& struct_value,
+    const Program& program, BindProtoUnsetFieldBehavior unset_field_behavior,
+    BindProtoConditionalFieldBehavior conditional_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  absl::StatusOr<absl::Span<const VariableReference>> referenced_variables =
+      program.GetReferencedVariables();
+  if (absl::IsUnimplemented(referenced_variables.status())) {
+    return BindProtoToActivation(descriptor, struct_value, unset_field_behavior,
+                                 descriptor_pool, message_factory, arena,
+                                 activation);
+  }
+  CEL_RETURN_IF_ERROR(referenced_variables.status());
 
-    activation->InsertOrAssignValue(field_desc->name(), std::move(field));
+  for (const VariableReference& variable : *referenced_variables) {
+    // Other variables, including qualified names, are not context fields.
+    const google::protobuf::FieldDescriptor* field_desc =
+        descriptor.FindFieldByName(variable.name);
+    if (field_desc == nullptr) {
+      continue;
+    }
+    if (variable.conditional &&
+        conditional_field_behavior == BindProtoConditionalFieldBehavior::kLazy) {
+      BindLazyField(field_desc, struct_value, unset_field_behavior, activation);
+      continue;
+    }
+    CEL_RETURN_IF_ERROR(BindField(field_desc, struct_value,
+                                  unset_field_behavior, descriptor_pool,
+                                  message_factory, arena, activation));
   }
 
   return absl::OkStatus();
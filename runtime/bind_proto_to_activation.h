@@ -20,9 +20,12 @@
 #include "absl/base/nullability.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "common/value.h"
+#include "internal/status_macros.h"
 #include "runtime/activation.h"
+#include "runtime/runtime.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -38,6 +41,16 @@ enum class BindProtoUnsetFieldBehavior {
   kSkip
 };
 
+// Option for handling context fields that a program only reads on some
+// evaluation paths (see `VariableReference::conditional`).
+enum class BindProtoConditionalFieldBehavior {
+  // Bind the field value, like fields the program always reads.
+  kEager,
+  // Bind a value provider that reads the field the first time the program
+  // looks up the variable.
+  kLazy
+};
+
 namespace runtime_internal {
 
 // Implements binding provided the context message has already
@@ -49,12 +62,23 @@ absl::Status BindProtoToActivation(
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation);
 
+// Implements referenced-field binding provided the context message has
+// already been adapted to a suitable struct value. Binds all fields if the
+// program does not track its referenced variables.
+absl::Status BindReferencedProtoToActivation(
+    const google::protobuf::Descriptor& descriptor, const StructValue& struct_value,
+    const Program& program, BindProtoUnsetFieldBehavior unset_field_behavior,
+    BindProtoConditionalFieldBehavior conditional_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation);
+
 template <bool kBorrow, typename T>
-absl::Status BindProtoToActivationImpl(
-    const T& context, BindProtoUnsetFieldBehavior unset_field_behavior,
+absl::StatusOr<StructValue> ContextToStructValue(
+    const T& context,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
-    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+    google::protobuf::Arena* absl_nonnull arena) {
   static_assert(std::is_base_of_v<google::protobuf::Message, T>);
 
   Value parent;
@@ -70,8 +94,12 @@ absl::Status BindProtoToActivationImpl(
     return absl::InvalidArgumentError(
         absl::StrCat("context is a well-known type: ", context.GetTypeName()));
   }
-  StructValue struct_value = parent.GetStruct();
+  return parent.GetStruct();
+}
 
+template <typename T>
+absl::StatusOr<const google::protobuf::Descriptor*> GetContextDescriptor(
+    const T& context) {
   const google::protobuf::Descriptor* descriptor = context.GetDescriptor();
   ABSL_DCHECK(descriptor != nullptr);
   if (descriptor == nullptr) {
@@ -80,12 +108,44 @@ absl::Status BindProtoToActivationImpl(
     return absl::InvalidArgumentError(
         absl::StrCat("context missing descriptor: ", context.GetTypeName()));
   }
+  return descriptor;
+}
 
+template <bool kBorrow, typename T>
+absl::Status BindProtoToActivationImpl(
+    const T& context, BindProtoUnsetFieldBehavior unset_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  CEL_ASSIGN_OR_RETURN(StructValue struct_value,
+                       ContextToStructValue<kBorrow>(
+                           context, descriptor_pool, message_factory, arena));
+  CEL_ASSIGN_OR_RETURN(const google::protobuf::Descriptor* descriptor,
+                       GetContextDescriptor(context));
   return BindProtoToActivation(*descriptor, struct_value, unset_field_behavior,
                                descriptor_pool, message_factory, arena,
                                activation);
 }
 
+template <bool kBorrow, typename T>
+absl::Status BindReferencedProtoToActivationImpl(
+    const T& context, const Program& program,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    BindProtoConditionalFieldBehavior conditional_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  CEL_ASSIGN_OR_RETURN(StructValue struct_value,
+                       ContextToStructValue<kBorrow>(
+                           context, descriptor_pool, message_factory, arena));
+  CEL_ASSIGN_OR_RETURN(const google::protobuf::Descriptor* descriptor,
+                       GetContextDescriptor(context));
+  return BindReferencedProtoToActivation(
+      *descriptor, struct_value, program, unset_field_behavior,
+      conditional_field_behavior, descriptor_pool, message_factory, arena,
+      activation);
+}
+
 }  // namespace runtime_internal
 
 // Utility method, that takes a protobuf Message and interprets it as a
@@ -169,6 +229,75 @@ absl::Status BindProtoViewToActivation(
                                    activation);
 }
 
+// Like `BindProtoToActivation`, but only binds the fields of `context` that
+// `program` may read (see `Program::GetReferencedVariables`), which is
+// considerably cheaper for wide context messages of which an expression reads
+// a handful of fields. The activation must only be used to evaluate `program`.
+//
+// Fields that the program only reads on some evaluation paths are bound
+// according to `conditional_field_behavior`. With
+// `BindProtoConditionalFieldBehavior::kLazy`, they are bound as value
+// providers reading the field on first use, so evaluations that do not take
+// those paths don't pay for them.
+//
+// If the program does not track the variables it references, all fields are
+// bound.
+template <typename T>
+absl::Status BindReferencedProtoToActivation(
+    const T& context, const Program& program,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    BindProtoConditionalFieldBehavior conditional_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  return runtime_internal::BindReferencedProtoToActivationImpl<false>(
+      context, program, unset_field_behavior, conditional_field_behavior,
+      descriptor_pool, message_factory, arena, activation);
+}
+
+template <typename T>
+absl::Status BindReferencedProtoToActivation(
+    const T& context, const Program& program,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  return BindReferencedProtoToActivation(
+      context, program, BindProtoUnsetFieldBehavior::kSkip,
+      BindProtoConditionalFieldBehavior::kEager, descriptor_pool,
+      message_factory, arena, activation);
+}
+
+// Like `BindReferencedProtoToActivation`, but borrows from `context` like
+// `BindProtoViewToActivation`. This avoids copying the whole context message
+// to `arena` when the program only reads a few of its fields.
+//
+// Requires the caller to keep the context message valid and unmodified as
+// long as the activation or any derived value.
+template <typename T>
+absl::Status BindReferencedProtoViewToActivation(
+    const T& context, const Program& program,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    BindProtoConditionalFieldBehavior conditional_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  return runtime_internal::BindReferencedProtoToActivationImpl<true>(
+      context, program, unset_field_behavior, conditional_field_behavior,
+      descriptor_pool, message_factory, arena, activation);
+}
+
+template <typename T>
+absl::Status BindReferencedProtoViewToActivation(
+    const T& context, const Program& program,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  return BindReferencedProtoViewToActivation(
+      context, program, BindProtoUnsetFieldBehavior::kSkip,
+      BindProtoConditionalFieldBehavior::kEager, descriptor_pool,
+      message_factory, arena, activation);
+}
+
 }  // namespace cel
 
 #endif  // THIRD_PARTY_CEL_CPP_RUNTIME_BIND_PROTO_TO_ACTIVATION_H_
@@ -14,15 +14,31 @@
 
 #include "runtime/bind_proto_to_activation.h"
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "google/protobuf/wrappers.pb.h"
+#include "cel/expr/syntax.pb.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "common/casting.h"
 #include "common/value.h"
 #include "common/value_testing.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
 #include "internal/testing.h"
+#include "parser/parser.h"
 #include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
 #include "cel/expr/conformance/proto2/test_all_types.pb.h"
 #include "google/protobuf/arena.h"
 
@@ -32,14 +48,47 @@ namespace {
 using ::absl_testing::IsOk;
 using ::absl_testing::IsOkAndHolds;
 using ::absl_testing::StatusIs;
+using ::cel::expr::ParsedExpr;
 using ::cel::expr::conformance::proto2::TestAllTypes;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::cel::test::BoolValueIs;
 using ::cel::test::IntValueIs;
+using ::google::api::expr::parser::Parse;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::Optional;
+using ::testing::Pair;
 
 using BindProtoToActivationTest = common_internal::ValueTest<>;
 
+class BindReferencedProtoToActivationTest
+    : public common_internal::ValueTest<> {
+ protected:
+  absl::StatusOr<std::unique_ptr<Program>> CreateProgram(
+      absl::string_view expression, int max_recursion_depth = 0) {
+    RuntimeOptions options;
+    options.max_recursion_depth = max_recursion_depth;
+    CEL_ASSIGN_OR_RETURN(
+        RuntimeBuilder builder,
+        CreateStandardRuntimeBuilder(descriptor_pool(), options));
+    CEL_ASSIGN_OR_RETURN(runtime_, std::move(builder).Build());
+    CEL_ASSIGN_OR_RETURN(ParsedExpr expr, Parse(expression));
+    return ProtobufRuntimeAdapter::CreateProgram(*runtime_, expr);
+  }
+
+  std::unique_ptr<const Runtime> runtime_;
+};
+
+std::vector<std::pair<std::string, bool>> ReferencedVariables(
+    absl::Span<const VariableReference> variables) {
+  std::vector<std::pair<std::string, bool>> result;
+  for (const VariableReference& variable : variables) {
+    result.push_back({variable.name, variable.conditional});
+  }
+  return result;
+}
+
 TEST_F(BindProtoToActivationTest, BindProtoToActivation) {
   TestAllTypes test_all_types;
   test_all_types.set_single_int64(123);
@@ -274,5 +323,96 @@ TEST_F(BindProtoToActivationTest, BindProtoViewToActivationDefault) {
               IsOkAndHolds(Optional(IntValueIs(0))));
 }
 
+TEST_F(BindReferencedProtoToActivationTest, ReferencedVariables) {
+  for (int max_recursion_depth : {0, -1}) {
+    ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<Program> program,
+        CreateProgram("single_int64 in [1, 2].map(x, x + single_int32) || "
+                      "single_string == 'a' && single_int64 > 0",
+                      max_recursion_depth));
+    ASSERT_OK_AND_ASSIGN(absl::Span<const VariableReference> variables,
+                         program->GetReferencedVariables());
+    EXPECT_THAT(ReferencedVariables(variables),
+                ElementsAre(Pair("single_int64", false),
+                            Pair("single_int32", true),
+                            Pair("single_string", true)))
+        << "max_recursion_depth: " << max_recursion_depth;
+  }
+}
+
+TEST_F(BindReferencedProtoToActivationTest, BindsReferencedFields) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Program> program,
+      CreateProgram("single_int64 > 0 || single_int32 == 1"));
+  TestAllTypes test_all_types;
+  test_all_types.set_single_int64(123);
+  test_all_types.set_single_int32(1);
+  test_all_types.set_single_string("unused");
+  Activation activation;
+
+  ASSERT_THAT(BindReferencedProtoToActivation(test_all_types, *program,
+                                              descriptor_pool(),
+                                              message_factory(), arena(),
+                                              &activation),
+              IsOk());
+
+  EXPECT_THAT(activation.FindVariable("single_int64", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Optional(IntValueIs(123))));
+  EXPECT_THAT(activation.FindVariable("single_int32", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Optional(IntValueIs(1))));
+  EXPECT_THAT(activation.FindVariable("single_string", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Eq(std::nullopt)));
+  EXPECT_THAT(program->Evaluate(arena(), activation),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(BindReferencedProtoToActivationTest, BindsConditionalFieldsLazily) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Program> program,
+      CreateProgram("single_int64 > 0 || single_int32 == 1"));
+  TestAllTypes test_all_types;
+  test_all_types.set_single_int64(123);
+  test_all_types.set_single_int32(1);
+  Activation activation;
+
+  ASSERT_THAT(BindReferencedProtoViewToActivation(
+                  test_all_types, *program, BindProtoUnsetFieldBehavior::kSkip,
+                  BindProtoConditionalFieldBehavior::kLazy, descriptor_pool(),
+                  message_factory(), arena(), &activation),
+              IsOk());
+
+  // Only the conditional field is read on lookup.
+  test_all_types.set_single_int64(456);
+  test_all_types.set_single_int32(2);
+  EXPECT_THAT(activation.FindVariable("single_int64", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Optional(IntValueIs(123))));
+  EXPECT_THAT(activation.FindVariable("single_int32", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Optional(IntValueIs(2))));
+}
+
+TEST_F(BindReferencedProtoToActivationTest, LazyFieldsSkipUnsetFields) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Program> program,
+      CreateProgram("single_int64 > 0 || single_int32 == 1"));
+  TestAllTypes test_all_types;
+  test_all_types.set_single_int64(123);
+  Activation activation;
+
+  ASSERT_THAT(BindReferencedProtoToActivation(
+                  test_all_types, *program, BindProtoUnsetFieldBehavior::kSkip,
+                  BindProtoConditionalFieldBehavior::kLazy, descriptor_pool(),
+                  message_factory(), arena(), &activation),
+              IsOk());
+
+  EXPECT_THAT(activation.FindVariable("single_int32", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Eq(std::nullopt)));
+}
+
 }  // namespace
 }  // namespace cel
@@ -20,8 +20,10 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -119,6 +121,9 @@ FunctionRegistry::FindStaticOverloads(absl::string_view name,
                                       bool receiver_style,
                                       absl::Span<const cel::Kind> types) const {
   std::vector<cel::FunctionOverloadReference> matched_funcs;
+  if (parent_ != nullptr) {
+    matched_funcs = parent_->FindStaticOverloads(name, receiver_style, types);
+  }
 
   auto overloads = functions_.find(name);
   if (overloads == functions_.end()) {
@@ -139,6 +144,10 @@ FunctionRegistry::FindStaticOverloadsByArity(absl::string_view name,
                                              bool receiver_style,
                                              size_t arity) const {
   std::vector<cel::FunctionOverloadReference> matched_funcs;
+  if (parent_ != nullptr) {
+    matched_funcs =
+        parent_->FindStaticOverloadsByArity(name, receiver_style, arity);
+  }
 
   auto overloads = functions_.find(name);
   if (overloads == functions_.end()) {
@@ -159,6 +168,9 @@ std::vector<FunctionRegistry::LazyOverload> FunctionRegistry::FindLazyOverloads(
     absl::string_view name, bool receiver_style,
     absl::Span<const cel::Kind> types) const {
   std::vector<FunctionRegistry::LazyOverload> matched_funcs;
+  if (parent_ != nullptr) {
+    matched_funcs = parent_->FindLazyOverloads(name, receiver_style, types);
+  }
 
   auto overloads = functions_.find(name);
   if (overloads == functions_.end()) {
@@ -179,6 +191,10 @@ FunctionRegistry::FindLazyOverloadsByArity(absl::string_view name,
                                            bool receiver_style,
                                            size_t arity) const {
   std::vector<FunctionRegistry::LazyOverload> matched_funcs;
+  if (parent_ != nullptr) {
+    matched_funcs =
+        parent_->FindLazyOverloadsByArity(name, receiver_style, arity);
+  }
 
   auto overloads = functions_.find(name);
   if (overloads == functions_.end()) {
@@ -199,11 +215,16 @@ absl::node_hash_map<std::string, std::vector<const cel::FunctionDescriptor*>>
 FunctionRegistry::ListFunctions() const {
   absl::node_hash_map<std::string, std::vector<const cel::FunctionDescriptor*>>
       descriptor_map;
+  if (parent_ != nullptr) {
+    descriptor_map = parent_->ListFunctions();
+  }
 
   for (const auto& entry : functions_) {
-    std::vector<const cel::FunctionDescriptor*> descriptors;
+    std::vector<const cel::FunctionDescriptor*>& descriptors =
+        descriptor_map[entry.first];
     const RegistryEntry& function_entry = entry.second;
-    descriptors.reserve(function_entry.static_overloads.size() +
+    descriptors.reserve(descriptors.size() +
+                        function_entry.static_overloads.size() +
                         function_entry.lazy_overloads.size());
     for (const auto& entry : function_entry.static_overloads) {
       descriptors.push_back(entry.descriptor.get());
@@ -211,14 +232,22 @@ FunctionRegistry::ListFunctions() const {
     for (const auto& entry : function_entry.lazy_overloads) {
       descriptors.push_back(entry.descriptor.get());
     }
-    descriptor_map[entry.first] = std::move(descriptors);
   }
 
   return descriptor_map;
 }
 
+void FunctionRegistry::SetParent(const FunctionRegistry* absl_nonnull parent) {
+  ABSL_DCHECK(functions_.empty());
+  ABSL_DCHECK(parent != this);
+  parent_ = parent;
+}
+
 bool FunctionRegistry::DescriptorRegistered(
     const cel::FunctionDescriptor& descriptor) const {
+  if (parent_ != nullptr && parent_->DescriptorRegistered(descriptor)) {
+    return true;
+  }
   auto overloads = functions_.find(descriptor.name());
   if (overloads == functions_.end()) {
     return false;
@@ -239,6 +268,9 @@ bool FunctionRegistry::DescriptorRegistered(
 
 bool FunctionRegistry::ValidateNonStrictOverload(
     const cel::FunctionDescriptor& descriptor) const {
+  if (parent_ != nullptr && !parent_->ValidateNonStrictOverload(descriptor)) {
+    return false;
+  }
   auto overloads = functions_.find(descriptor.name());
   if (overloads == functions_.end()) {
     return true;
@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/status/status.h"
@@ -111,6 +112,14 @@ class FunctionRegistry {
   absl::node_hash_map<std::string, std::vector<const cel::FunctionDescriptor*>>
   ListFunctions() const;
 
+  // Layers this registry over `parent`: overloads registered with `parent`
+  // are found through this registry and cannot be registered again, without
+  // being copied.
+  //
+  // Must be called before any function is registered. `parent` must outlive
+  // this registry and must not be modified after this call.
+  void SetParent(const FunctionRegistry* absl_nonnull parent);
+
  private:
   struct StaticFunctionEntry {
     StaticFunctionEntry(const cel::FunctionDescriptor& descriptor,
@@ -153,6 +162,7 @@ class FunctionRegistry {
 
   // indexed by function name (not type checker overload id).
   absl::flat_hash_map<std::string, RegistryEntry> functions_;
+  const FunctionRegistry* absl_nullable parent_ = nullptr;
 };
 
 }  // namespace cel
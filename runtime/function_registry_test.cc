@@ -297,6 +297,53 @@ INSTANTIATE_TEST_SUITE_P(NonStrictRegistrationFailTest,
                          NonStrictRegistrationFailTest,
                          testing::Combine(testing::Bool(), testing::Bool()));
 
+TEST(FunctionRegistryTest, ParentOverloadsAreVisible) {
+  FunctionRegistry parent;
+  ASSERT_OK(parent.Register(ConstIntFunction::MakeDescriptor(),
+                            std::make_unique<ConstIntFunction>()));
+  ASSERT_OK(parent.RegisterLazyFunction({"LazyFunction", false, {}}));
+
+  FunctionRegistry registry;
+  registry.SetParent(&parent);
+  ASSERT_OK(registry.Register({"ConstFunction", false, {Kind::kInt}},
+                              std::make_unique<ConstIntFunction>()));
+
+  EXPECT_THAT(registry.FindStaticOverloadsByArity("ConstFunction", false, 0),
+              SizeIs(1));
+  EXPECT_THAT(registry.FindStaticOverloads("ConstFunction", false,
+                                           {Kind::kAny}),
+              SizeIs(1));
+  EXPECT_THAT(registry.FindLazyOverloads("LazyFunction", false, {}),
+              SizeIs(1));
+  auto registered_functions = registry.ListFunctions();
+  EXPECT_THAT(registered_functions["ConstFunction"], SizeIs(2));
+  EXPECT_THAT(registered_functions["LazyFunction"], SizeIs(1));
+
+  // The parent is not modified.
+  EXPECT_THAT(parent.ListFunctions()["ConstFunction"], SizeIs(1));
+}
+
+TEST(FunctionRegistryTest, ParentOverloadsCannotBeRedefined) {
+  FunctionRegistry parent;
+  ASSERT_OK(parent.Register(ConstIntFunction::MakeDescriptor(),
+                            std::make_unique<ConstIntFunction>()));
+  ASSERT_OK(parent.Register({"NonStrictFunction", false, {Kind::kAny},
+                             /*is_strict=*/false},
+                            std::make_unique<ConstIntFunction>()));
+
+  FunctionRegistry registry;
+  registry.SetParent(&parent);
+  EXPECT_THAT(registry.Register(ConstIntFunction::MakeDescriptor(),
+                                std::make_unique<ConstIntFunction>()),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+  EXPECT_THAT(registry.RegisterLazyFunction(ConstIntFunction::MakeDescriptor()),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+  EXPECT_THAT(
+      registry.Register({"NonStrictFunction", false, {Kind::kInt}},
+                        std::make_unique<ConstIntFunction>()),
+      StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
 }  // namespace
 
 }  // namespace cel
@@ -0,0 +1,99 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/call_key.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+
+namespace cel::runtime_internal {
+
+namespace {
+
+// Appends `size`, which prefixes a variable length value.
+void AppendSizeToCallKey(size_t size, std::string& key) {
+  AppendBytesToCallKey(static_cast<uint64_t>(size), key);
+}
+
+}  // namespace
+
+bool IsCallKeyKind(ValueKind kind) {
+  switch (kind) {
+    case ValueKind::kNull:
+    case ValueKind::kBool:
+    case ValueKind::kInt:
+    case ValueKind::kUint:
+    case ValueKind::kDouble:
+    case ValueKind::kString:
+    case ValueKind::kBytes:
+    case ValueKind::kDuration:
+    case ValueKind::kTimestamp:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool AppendArgsToCallKey(absl::Span<const Value> args, std::string& key) {
+  for (const Value& arg : args) {
+    key.push_back(static_cast<char>(arg.kind()));
+    switch (arg.kind()) {
+      case ValueKind::kNull:
+        break;
+      case ValueKind::kBool:
+        key.push_back(arg.GetBool().NativeValue() ? 1 : 0);
+        break;
+      case ValueKind::kInt:
+        AppendBytesToCallKey(arg.GetInt().NativeValue(), key);
+        break;
+      case ValueKind::kUint:
+        AppendBytesToCallKey(arg.GetUint().NativeValue(), key);
+        break;
+      case ValueKind::kDouble:
+        AppendBytesToCallKey(arg.GetDouble().NativeValue(), key);
+        break;
+      case ValueKind::kString: {
+        StringValue string = arg.GetString();
+        AppendSizeToCallKey(string.Size(), key);
+        string.AppendToString(&key);
+        break;
+      }
+      case ValueKind::kBytes: {
+        BytesValue bytes = arg.GetBytes();
+        AppendSizeToCallKey(bytes.Size(), key);
+        bytes.AppendToString(&key);
+        break;
+      }
+      case ValueKind::kDuration:
+        AppendBytesToCallKey(
+            absl::ToInt64Nanoseconds(arg.GetDuration().ToDuration()), key);
+        break;
+      case ValueKind::kTimestamp:
+        AppendBytesToCallKey(absl::ToUnixNanos(arg.GetTimestamp().ToTime()),
+                             key);
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace cel::runtime_internal
@@ -0,0 +1,53 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Canonical encoding of function call arguments, for keying calls by value.
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CALL_KEY_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CALL_KEY_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+
+namespace cel::runtime_internal {
+
+// Appends the bytes of `value`, which is trivially copyable, to `key`.
+template <typename T>
+void AppendBytesToCallKey(const T& value, std::string& key) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Appends `value` to `key`, prefixed with its length.
+inline void AppendStringToCallKey(absl::string_view value, std::string& key) {
+  AppendBytesToCallKey(static_cast<uint64_t>(value.size()), key);
+  key.append(value.data(), value.size());
+}
+
+// Returns whether arguments of `kind` can be encoded: null, bool, int, uint,
+// double, string, bytes, duration and timestamp.
+bool IsCallKeyKind(ValueKind kind);
+
+// Appends the kind and native value of each of `args` to `key`. Variable
+// length values are length prefixed, so the encoding is unambiguous. Doubles
+// are encoded bitwise, so -0.0 and 0.0 differ. Returns false, leaving `key`
+// partially appended, if an argument's kind can't be encoded.
+bool AppendArgsToCallKey(absl::Span<const Value> args, std::string& key);
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CALL_KEY_H_
@@ -0,0 +1,687 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/generated_program.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/log/absl_check.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "base/builtins.h"
+#include "base/type_provider.h"
+#include "common/kind.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/compiler/resolver.h"
+#include "eval/eval/any_unpack_cache.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/comprehension_slots.h"
+#include "eval/eval/container_access_step.h"
+#include "eval/eval/equality_steps.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/function_result_cache.h"
+#include "eval/eval/function_step.h"
+#include "eval/eval/ident_step.h"
+#include "eval/eval/logic_step.h"
+#include "eval/eval/select_step.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/internal/errors.h"
+#include "runtime/internal/runtime_friend_access.h"
+#include "runtime/internal/runtime_impl.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::runtime_internal {
+
+namespace {
+
+using ::cel::internal::down_cast;
+using ::google::api::expr::runtime::AnyUnpackCache;
+using ::google::api::expr::runtime::ArenaResidentVariableCache;
+using ::google::api::expr::runtime::AttributeTrail;
+using ::google::api::expr::runtime::ComprehensionSlots;
+using ::google::api::expr::runtime::ExecutionFrameBase;
+using ::google::api::expr::runtime::FunctionResultCache;
+
+AttributeQualifier AttributeQualifierFromValue(const Value& v) {
+  switch (v.kind()) {
+    case ValueKind::kString:
+      return AttributeQualifier::OfString(v.GetString().ToString());
+    case ValueKind::kInt64:
+      return AttributeQualifier::OfInt(v.GetInt().NativeValue());
+    case ValueKind::kUint64:
+      return AttributeQualifier::OfUint(v.GetUint().NativeValue());
+    case ValueKind::kBool:
+      return AttributeQualifier::OfBool(v.GetBool().NativeValue());
+    default:
+      // Non-matching qualifier.
+      return AttributeQualifier();
+  }
+}
+
+// Adds an evaluated element of a creation expression to `unknowns`, as the
+// creation steps do when unknown processing is enabled.
+void AccumulateUnknowns(
+    ExecutionFrameBase& frame, const Value& value, const AttributeTrail& trail,
+    google::api::expr::runtime::AttributeUtility::Accumulator& unknowns) {
+  if (!frame.unknown_processing_enabled()) {
+    return;
+  }
+  if (value.IsUnknown()) {
+    unknowns.Add(value.GetUnknown());
+  } else if (frame.attribute_utility().CheckForUnknownPartial(trail)) {
+    unknowns.Add(trail);
+  }
+}
+
+}  // namespace
+
+absl::Status GeneratedIdent::Evaluate(ExecutionFrameBase& frame, Value& result,
+                                      AttributeTrail& trail) const {
+  if (!constant_.has_value()) {
+    return google::api::expr::runtime::LookupIdent(name_, frame, result, trail);
+  }
+  CEL_ASSIGN_OR_RETURN(bool found, frame.FindVariable(name_, result));
+  if (!found) {
+    result = *constant_;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status GeneratedSelect::Apply(ExecutionFrameBase& frame, Value& result,
+                                    AttributeTrail& trail) const {
+  return google::api::expr::runtime::ApplySelect(
+      frame, field_value_, field_, test_only_, unboxing_option_,
+      enable_optional_types_, result, trail);
+}
+
+absl::Status GeneratedCall::Invoke(ExecutionFrameBase& frame,
+                                   absl::Span<Value> args,
+                                   absl::Span<AttributeTrail> arg_trails,
+                                   Value& result, AttributeTrail& trail) const {
+  ABSL_DCHECK_EQ(args.size(), arg_trails.size());
+  switch (kind_) {
+    case Kind::kOverloads: {
+      CEL_ASSIGN_OR_RETURN(
+          result, google::api::expr::runtime::InvokeFunctionOverloads(
+                      frame, expr_id_, name_, receiver_style_, overloads_,
+                      args, arg_trails));
+      return absl::OkStatus();
+    }
+    case Kind::kLazyOverloads: {
+      CEL_ASSIGN_OR_RETURN(
+          result, google::api::expr::runtime::InvokeLazyFunctionOverloads(
+                      frame, expr_id_, name_, receiver_style_,
+                      lazy_overloads_, args, arg_trails));
+      return absl::OkStatus();
+    }
+    case Kind::kNot: {
+      // The not step forwards the attribute of its operand.
+      result = std::move(args[0]);
+      trail = std::move(arg_trails[0]);
+      if (frame.unknown_processing_enabled() &&
+          frame.attribute_utility().CheckForUnknownPartial(trail)) {
+        result = frame.attribute_utility().CreateUnknownSet(trail.attribute());
+        return absl::OkStatus();
+      }
+      switch (result.kind()) {
+        case ValueKind::kBool:
+          result = BoolValue{!result.GetBool().NativeValue()};
+          break;
+        case ValueKind::kUnknown:
+        case ValueKind::kError:
+          break;
+        default:
+          result = ErrorValue(CreateNoMatchingOverloadError(builtin::kNot));
+          break;
+      }
+      return absl::OkStatus();
+    }
+    case Kind::kNotStrictlyFalse: {
+      result = std::move(args[0]);
+      trail = std::move(arg_trails[0]);
+      switch (result.kind()) {
+        case ValueKind::kBool:
+          break;
+        case ValueKind::kUnknown:
+        case ValueKind::kError:
+          result = BoolValue(true);
+          break;
+        default:
+          result = ErrorValue(CreateNoMatchingOverloadError(builtin::kNot));
+          break;
+      }
+      return absl::OkStatus();
+    }
+    case Kind::kEqual:
+    case Kind::kInequal: {
+      CEL_ASSIGN_OR_RETURN(
+          result, google::api::expr::runtime::EvaluateEquality(
+                      frame, args[0], arg_trails[0], args[1], arg_trails[1],
+                      /*negation=*/kind_ == Kind::kInequal));
+      return absl::OkStatus();
+    }
+    case Kind::kIn: {
+      CEL_ASSIGN_OR_RETURN(result, google::api::expr::runtime::EvaluateIn(
+                                       frame, args[0], arg_trails[0], args[1],
+                                       arg_trails[1]));
+      return absl::OkStatus();
+    }
+  }
+  return absl::InternalError("unexpected generated call kind");
+}
+
+GeneratedListBuilder::GeneratedListBuilder(ExecutionFrameBase& frame,
+                                           size_t size)
+    : frame_(frame),
+      builder_(NewListValueBuilder(frame.arena())),
+      unknowns_(frame.attribute_utility().CreateAccumulator()) {
+  builder_->Reserve(size);
+}
+
+absl::StatusOr<bool> GeneratedListBuilder::Add(Value& element,
+                                               const AttributeTrail& trail,
+                                               Value& result) {
+  if (element.IsError()) {
+    result = std::move(element);
+    return false;
+  }
+  if (frame_.attribute_tracking_enabled()) {
+    if (frame_.missing_attribute_errors_enabled() &&
+        frame_.attribute_utility().CheckForMissingAttribute(trail)) {
+      CEL_ASSIGN_OR_RETURN(
+          result, frame_.attribute_utility().CreateMissingAttributeError(
+                      trail.attribute()));
+      return false;
+    }
+    if (frame_.unknown_processing_enabled()) {
+      if (element.IsUnknown()) {
+        unknowns_.Add(element.GetUnknown());
+      }
+      if (frame_.attribute_utility().CheckForUnknown(trail,
+                                                     /*use_partial=*/true)) {
+        unknowns_.Add(trail);
+      }
+    }
+  }
+  // Once an element is unknown, the remaining elements are only scanned for
+  // more unknowns.
+  if (!unknowns_.IsEmpty()) {
+    return true;
+  }
+  CEL_RETURN_IF_ERROR(builder_->Add(std::move(element)));
+  return true;
+}
+
+void GeneratedListBuilder::Build(Value& result) && {
+  if (!unknowns_.IsEmpty()) {
+    result = std::move(unknowns_).Build();
+    return;
+  }
+  result = std::move(*builder_).Build();
+}
+
+GeneratedMapBuilder::GeneratedMapBuilder(ExecutionFrameBase& frame,
+                                         size_t size)
+    : frame_(frame),
+      builder_(NewMapValueBuilder(frame.arena())),
+      unknowns_(frame.attribute_utility().CreateAccumulator()) {
+  builder_->Reserve(size);
+}
+
+absl::StatusOr<bool> GeneratedMapBuilder::AddKey(Value& key,
+                                                 const AttributeTrail& trail,
+                                                 Value& result) {
+  if (key.IsError()) {
+    result = std::move(key);
+    return false;
+  }
+  AccumulateUnknowns(frame_, key, trail, unknowns_);
+  if (absl::Status status = CheckMapKey(key); !status.ok()) {
+    result = ErrorValue(std::move(status));
+    return false;
+  }
+  return true;
+}
+
+absl::StatusOr<bool> GeneratedMapBuilder::AddValue(Value& key, Value& value,
+                                                   const AttributeTrail& trail,
+                                                   Value& result) {
+  if (value.IsError()) {
+    result = std::move(value);
+    return false;
+  }
+  AccumulateUnknowns(frame_, value, trail, unknowns_);
+  // Unknowns are forwarded before any later errors.
+  if (!unknowns_.IsEmpty()) {
+    return true;
+  }
+  CEL_RETURN_IF_ERROR(builder_->Put(std::move(key), std::move(value)));
+  return true;
+}
+
+void GeneratedMapBuilder::Build(Value& result) && {
+  if (!unknowns_.IsEmpty()) {
+    result = std::move(unknowns_).Build();
+    return;
+  }
+  result = std::move(*builder_).Build();
+}
+
+GeneratedStructBuilder::GeneratedStructBuilder(ExecutionFrameBase& frame,
+                                               const GeneratedStruct& type)
+    : frame_(frame),
+      type_(type),
+      unknowns_(frame.attribute_utility().CreateAccumulator()) {}
+
+absl::StatusOr<bool> GeneratedStructBuilder::Start(Value& result) {
+  CEL_ASSIGN_OR_RETURN(builder_, frame_.type_provider().NewValueBuilder(
+                                     type_.name_, frame_.message_factory(),
+                                     frame_.arena()));
+  if (builder_ == nullptr) {
+    result = ErrorValue(absl::NotFoundError(
+        absl::StrCat("Unable to find builder: ", type_.name_)));
+    return false;
+  }
+  return true;
+}
+
+absl::StatusOr<bool> GeneratedStructBuilder::SetField(
+    size_t index, Value& value, const AttributeTrail& trail, Value& result) {
+  ABSL_DCHECK_LT(index, type_.fields_.size());
+  if (value.IsError()) {
+    result = std::move(value);
+    return false;
+  }
+  AccumulateUnknowns(frame_, value, trail, unknowns_);
+  if (!unknowns_.IsEmpty()) {
+    return true;
+  }
+  CEL_ASSIGN_OR_RETURN(
+      absl::optional<ErrorValue> error_value,
+      builder_->SetFieldByName(type_.fields_[index], std::move(value)));
+  if (error_value) {
+    result = std::move(*error_value);
+    return false;
+  }
+  return true;
+}
+
+absl::Status GeneratedStructBuilder::Build(Value& result) && {
+  if (!unknowns_.IsEmpty()) {
+    result = std::move(unknowns_).Build();
+    return absl::OkStatus();
+  }
+  CEL_ASSIGN_OR_RETURN(result, std::move(*builder_).Build());
+  return absl::OkStatus();
+}
+
+absl::StatusOr<bool> GeneratedComprehensionRange::Start(
+    ExecutionFrameBase& frame, const Value& range,
+    const AttributeTrail& range_trail, Value& result) {
+  if (frame.unknown_processing_enabled() && range.IsMap() &&
+      frame.attribute_utility().CheckForUnknownPartial(range_trail)) {
+    result = frame.attribute_utility().CreateUnknownSet(range_trail.attribute());
+    return false;
+  }
+  switch (range.kind()) {
+    case ValueKind::kList: {
+      CEL_ASSIGN_OR_RETURN(iterator_, range.GetList().NewIterator());
+      is_map_ = false;
+    } break;
+    case ValueKind::kMap: {
+      CEL_ASSIGN_OR_RETURN(iterator_, range.GetMap().NewIterator());
+      is_map_ = true;
+    } break;
+    case ValueKind::kError:
+    case ValueKind::kUnknown:
+      result = range;
+      return false;
+    default:
+      result = ErrorValue(CreateNoMatchingOverloadError("<iter_range>"));
+      return false;
+  }
+  range_trail_ = &range_trail;
+  return true;
+}
+
+absl::StatusOr<bool> GeneratedComprehensionRange::Next(
+    ExecutionFrameBase& frame, Value& iter, AttributeTrail& iter_trail) {
+  ABSL_DCHECK(iterator_ != nullptr);
+  if (!frame.unknown_processing_enabled()) {
+    CEL_ASSIGN_OR_RETURN(
+        bool ok, iterator_->Next1(frame.descriptor_pool(),
+                                  frame.message_factory(), frame.arena(), &iter));
+    if (!ok) {
+      return false;
+    }
+    CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+    return true;
+  }
+
+  // Unknown elements are identified by their index or key in the range.
+  Value* key = is_map_ ? &iter : &index_;
+  Value* value = is_map_ ? nullptr : &iter;
+  CEL_ASSIGN_OR_RETURN(
+      bool ok, iterator_->Next2(frame.descriptor_pool(), frame.message_factory(),
+                                frame.arena(), key, value));
+  if (!ok) {
+    return false;
+  }
+  CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+  iter_trail = range_trail_->Step(AttributeQualifierFromValue(*key));
+  if (frame.attribute_utility().CheckForUnknownExact(iter_trail)) {
+    iter = frame.attribute_utility().CreateUnknownSet(iter_trail.attribute());
+  }
+  return true;
+}
+
+absl::StatusOr<bool> GeneratedComprehensionRange::Next(
+    ExecutionFrameBase& frame, Value& iter, AttributeTrail& iter_trail,
+    Value& iter2, AttributeTrail& iter2_trail) {
+  ABSL_DCHECK(iterator_ != nullptr);
+  CEL_ASSIGN_OR_RETURN(
+      bool ok, iterator_->Next2(frame.descriptor_pool(), frame.message_factory(),
+                                frame.arena(), &iter, &iter2));
+  if (!ok) {
+    return false;
+  }
+  CEL_RETURN_IF_ERROR(frame.IncrementIterations());
+  if (frame.unknown_processing_enabled()) {
+    iter_trail = iter2_trail =
+        range_trail_->Step(AttributeQualifierFromValue(iter));
+    if (frame.attribute_utility().CheckForUnknownExact(iter_trail)) {
+      iter2 = frame.attribute_utility().CreateUnknownSet(iter_trail.attribute());
+    }
+  }
+  return true;
+}
+
+GeneratedProgram::GeneratedProgram(
+    const GeneratedProgramBuilder& builder,
+    std::vector<VariableReference> referenced_variables)
+    : environment_(builder.environment_),
+      options_(builder.options_),
+      enable_optional_types_(builder.enable_optional_types_),
+      referenced_variables_(std::move(referenced_variables)) {}
+
+const TypeProvider& GeneratedProgram::GetTypeProvider() const {
+  return environment_->type_registry.GetComposedTypeProvider();
+}
+
+absl::StatusOr<Value> GeneratedProgram::EvaluateImpl(
+    const ActivationInterface& activation, google::protobuf::Arena* absl_nonnull arena,
+    const EvaluateOptions& options) const {
+  ABSL_DCHECK(arena != nullptr);
+  // Comprehension variables are locals of the generated code.
+  ExecutionFrameBase frame(activation, /*callback=*/nullptr, options_,
+                           GetTypeProvider(),
+                           environment_->descriptor_pool.get(),
+                           options.message_factory != nullptr
+                               ? options.message_factory
+                               : environment_->MutableMessageFactory(),
+                           arena, options.embedder_context,
+                           ComprehensionSlots::GetEmptyInstance());
+  FunctionResultCache function_result_cache;
+  if (options_.function_memoization_max_entries > 0) {
+    function_result_cache.set_max_entries(
+        options_.function_memoization_max_entries);
+    frame.set_function_result_cache(&function_result_cache);
+  }
+  AnyUnpackCache any_unpack_cache;
+  if (options_.enable_any_unpack_cache) {
+    frame.set_any_unpack_cache(&any_unpack_cache);
+  }
+  ArenaResidentVariableCache arena_resident_variable_cache;
+  if (options_.enable_arena_resident_values) {
+    frame.set_arena_resident_variable_cache(&arena_resident_variable_cache);
+  }
+
+  Value result;
+  AttributeTrail trail;
+  absl::Status status = Evaluate(frame, result, trail);
+  if (options.function_memoization_stats != nullptr) {
+    options.function_memoization_stats->hits += function_result_cache.hits();
+    options.function_memoization_stats->misses +=
+        function_result_cache.misses();
+  }
+  CEL_RETURN_IF_ERROR(status);
+  return result;
+}
+
+void GeneratedProgram::LoadLocal(const Frame& frame, const Value& value,
+                                 const AttributeTrail& value_trail,
+                                 Value& result, AttributeTrail& trail) {
+  // A loop step may read the accumulator it is evaluated into.
+  if (&trail != &value_trail && frame.attribute_tracking_enabled()) {
+    trail = value_trail;
+  }
+  if (&result != &value) {
+    result = value;
+  }
+}
+
+void GeneratedProgram::Index(Frame& frame, const Value& container,
+                             const AttributeTrail& container_trail,
+                             const Value& key, Value& result,
+                             AttributeTrail& trail) const {
+  google::api::expr::runtime::PerformLookup(frame, container, key,
+                                            container_trail,
+                                            enable_optional_types_, result,
+                                            trail);
+}
+
+absl::Status GeneratedProgram::CombineLogic(Frame& frame, bool is_or,
+                                            Value& result, Value& rhs,
+                                            AttributeTrail& trail) {
+  return google::api::expr::runtime::CombineLogicOperands(frame, is_or, result,
+                                                          rhs, trail);
+}
+
+void GeneratedProgram::NonBoolCondition(Value& condition,
+                                        AttributeTrail& condition_trail,
+                                        Value& result, AttributeTrail& trail) {
+  if (condition.IsError() || condition.IsUnknown()) {
+    result = std::move(condition);
+    trail = std::move(condition_trail);
+    return;
+  }
+  result = ErrorValue(CreateNoMatchingOverloadError(builtin::kTernary));
+}
+
+Value GeneratedProgram::NonBoolLoopCondition(Value condition) {
+  if (condition.IsError() || condition.IsUnknown()) {
+    return condition;
+  }
+  return ErrorValue(CreateNoMatchingOverloadError("<loop_condition>"));
+}
+
+GeneratedProgramBuilder::GeneratedProgramBuilder(
+    std::shared_ptr<const RuntimeEnv> environment,
+    const RuntimeOptions& options, absl::string_view container,
+    bool enable_optional_types)
+    : environment_(std::move(environment)),
+      options_(options),
+      enable_optional_types_(enable_optional_types),
+      resolver_(container, environment_->function_registry,
+                environment_->type_registry,
+                environment_->type_registry.GetComposedTypeProvider(),
+                options.enable_qualified_type_identifiers),
+      // Mirrors the planner: an environment that registers its own `_==_`
+      // keeps it.
+      builtin_equality_(options.enable_fast_builtins &&
+                        options.enable_heterogeneous_equality &&
+                        resolver_
+                            .FindOverloads(builtin::kEqual,
+                                           /*receiver_style=*/false,
+                                           {Kind::kAny, Kind::kAny})
+                            .empty()) {}
+
+absl::StatusOr<std::unique_ptr<GeneratedProgramBuilder>>
+GeneratedProgramBuilder::Create(const Runtime& runtime) {
+  if (RuntimeFriendAccess::RuntimeTypeId(runtime) !=
+      NativeTypeId::For<RuntimeImpl>()) {
+    return absl::UnimplementedError(
+        "generated programs are only supported on the default cel::Runtime "
+        "implementation");
+  }
+  const auto& runtime_impl = down_cast<const RuntimeImpl&>(runtime);
+  const RuntimeOptions& options = runtime_impl.expr_builder().options();
+  if (!options.short_circuiting) {
+    return absl::UnimplementedError(
+        "generated programs always short-circuit logical operators and "
+        "comprehensions");
+  }
+  return absl::WrapUnique(new GeneratedProgramBuilder(
+      runtime_impl.shared_environment(), options,
+      runtime_impl.expr_builder().container(),
+      runtime_impl.expr_builder().optional_types_enabled()));
+}
+
+GeneratedIdent GeneratedProgramBuilder::Ident(int64_t expr_id,
+                                              absl::string_view name) const {
+  GeneratedIdent ident;
+  ident.constant_ = resolver_.FindConstant(name, expr_id);
+  ident.name_ = std::string(absl::StripPrefix(name, "."));
+  return ident;
+}
+
+GeneratedSelect GeneratedProgramBuilder::Select(absl::string_view field,
+                                                bool test_only) const {
+  GeneratedSelect select;
+  select.field_ = std::string(field);
+  select.field_value_ = StringValue(select.field_);
+  select.test_only_ = test_only;
+  select.unboxing_option_ = options_.enable_empty_wrapper_null_unboxing
+                                ? ProtoWrapperTypeOptions::kUnsetNull
+                                : ProtoWrapperTypeOptions::kUnsetProtoDefault;
+  select.enable_optional_types_ = enable_optional_types_;
+  return select;
+}
+
+absl::StatusOr<GeneratedCall> GeneratedProgramBuilder::Call(
+    int64_t expr_id, absl::string_view function, bool receiver_style,
+    size_t num_args) const {
+  GeneratedCall call;
+  call.expr_id_ = expr_id;
+  call.name_ = std::string(function);
+  call.receiver_style_ = receiver_style;
+
+  // The builtins the planner evaluates with dedicated steps.
+  if (options_.enable_fast_builtins && !receiver_style) {
+    if (function == builtin::kNot ||
+        function == builtin::kNotStrictlyFalse ||
+        function == builtin::kNotStrictlyFalseDeprecated) {
+      if (num_args != 1) {
+        return absl::InvalidArgumentError(
+            "unexpected number of args for builtin not operator");
+      }
+      call.kind_ = function == builtin::kNot
+                       ? GeneratedCall::Kind::kNot
+                       : GeneratedCall::Kind::kNotStrictlyFalse;
+      return call;
+    }
+    if (options_.enable_heterogeneous_equality) {
+      if (function == builtin::kIn || function == builtin::kInDeprecated ||
+          function == builtin::kInFunction) {
+        if (num_args != 2) {
+          return absl::InvalidArgumentError(
+              "unexpected number of args for builtin 'in' operator");
+        }
+        call.kind_ = GeneratedCall::Kind::kIn;
+        return call;
+      }
+      if (builtin_equality_ &&
+          (function == builtin::kEqual || function == builtin::kInequal)) {
+        if (num_args != 2) {
+          return absl::InvalidArgumentError(
+              "unexpected number of args for builtin equality operator");
+        }
+        call.kind_ = function == builtin::kEqual ? GeneratedCall::Kind::kEqual
+                                                 : GeneratedCall::Kind::kInequal;
+        return call;
+      }
+    }
+  }
+
+  // Lazily bound overloads shadow eagerly bound ones.
+  call.lazy_overloads_ =
+      resolver_.FindLazyOverloads(function, receiver_style, num_args, expr_id);
+  if (!call.lazy_overloads_.empty()) {
+    call.kind_ = GeneratedCall::Kind::kLazyOverloads;
+    return call;
+  }
+  call.overloads_ =
+      resolver_.FindOverloads(function, receiver_style, num_args, expr_id);
+  if (call.overloads_.empty() && options_.fail_on_warnings) {
+    return absl::InvalidArgumentError(
+        "No overloads provided for FunctionStep creation");
+  }
+  call.kind_ = GeneratedCall::Kind::kOverloads;
+  return call;
+}
+
+absl::StatusOr<GeneratedStruct> GeneratedProgramBuilder::Struct(
+    int64_t expr_id, absl::string_view name,
+    std::vector<std::string> fields) const {
+  CEL_ASSIGN_OR_RETURN(auto type, resolver_.FindType(name, expr_id));
+  if (!type.has_value()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid struct creation: missing type info for '", name,
+                     "'"));
+  }
+  const TypeProvider& type_provider =
+      environment_->type_registry.GetComposedTypeProvider();
+  for (const std::string& field : fields) {
+    CEL_ASSIGN_OR_RETURN(
+        auto field_type,
+        type_provider.FindStructTypeFieldByName(type->first, field));
+    if (!field_type.has_value()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid message creation: field '", field,
+                       "' not found in '", type->first, "'"));
+    }
+  }
+  GeneratedStruct result;
+  result.name_ = std::move(type->first);
+  result.fields_ = std::move(fields);
+  return result;
+}
+
+absl::Status GeneratedProgramBuilder::CheckComprehensionsEnabled() const {
+  if (!options_.enable_comprehension) {
+    return absl::InvalidArgumentError("Comprehension support is disabled");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace cel::runtime_internal
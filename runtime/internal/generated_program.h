@@ -0,0 +1,371 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Support library for programs generated ahead of time from checked
+// expressions (see //bazel:cel_cc_expression.bzl and
+// tools/cc_expression_codegen.h).
+//
+// A generated program evaluates its expression with straight-line C++ in
+// place of a planned step tree. Function overloads, enum and type constants
+// and struct types are resolved against a runtime when the program is created,
+// as the planner would, and evaluation reuses the helpers of the recursive
+// evaluation steps so results are the same as for
+// `Runtime::CreateProgram`.
+//
+// Nothing in this file is meant to be used by hand-written code.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_GENERATED_PROGRAM_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_GENERATED_PROGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "base/type_provider.h"
+#include "common/value.h"
+#include "eval/compiler/resolver.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/attribute_utility.h"
+#include "eval/eval/evaluator_core.h"
+#include "runtime/activation_interface.h"
+#include "runtime/function_overload_reference.h"
+#include "runtime/function_registry.h"
+#include "runtime/internal/runtime_env.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::runtime_internal {
+
+class GeneratedProgramBuilder;
+
+// A global variable reference. Resolves to an activation lookup, or to an enum
+// or type constant that an activation value of the same name shadows.
+class GeneratedIdent {
+ public:
+  GeneratedIdent() = default;
+
+  absl::Status Evaluate(google::api::expr::runtime::ExecutionFrameBase& frame,
+                        Value& result,
+                        google::api::expr::runtime::AttributeTrail& trail) const;
+
+ private:
+  friend class GeneratedProgramBuilder;
+
+  std::string name_;
+  absl::optional<Value> constant_;
+};
+
+// A field selection or presence test.
+class GeneratedSelect {
+ public:
+  GeneratedSelect() = default;
+
+  // Applies the selection to the operand in `result`, whose attribute is in
+  // `trail`.
+  absl::Status Apply(google::api::expr::runtime::ExecutionFrameBase& frame,
+                     Value& result,
+                     google::api::expr::runtime::AttributeTrail& trail) const;
+
+ private:
+  friend class GeneratedProgramBuilder;
+
+  std::string field_;
+  StringValue field_value_;
+  bool test_only_ = false;
+  ProtoWrapperTypeOptions unboxing_option_ =
+      ProtoWrapperTypeOptions::kUnsetProtoDefault;
+  bool enable_optional_types_ = false;
+};
+
+// A function call site, bound to the builtin evaluation or the overloads the
+// planner would choose for it.
+class GeneratedCall {
+ public:
+  GeneratedCall() = default;
+
+  // Calls the function with the evaluated arguments (the receiver first, for
+  // receiver style calls). Arguments may be moved from.
+  absl::Status Invoke(
+      google::api::expr::runtime::ExecutionFrameBase& frame,
+      absl::Span<Value> args,
+      absl::Span<google::api::expr::runtime::AttributeTrail> arg_trails,
+      Value& result, google::api::expr::runtime::AttributeTrail& trail) const;
+
+ private:
+  friend class GeneratedProgramBuilder;
+
+  enum class Kind {
+    kOverloads,
+    kLazyOverloads,
+    kNot,
+    kNotStrictlyFalse,
+    kEqual,
+    kInequal,
+    kIn,
+  };
+
+  Kind kind_ = Kind::kOverloads;
+  int64_t expr_id_ = 0;
+  std::string name_;
+  bool receiver_style_ = false;
+  std::vector<FunctionOverloadReference> overloads_;
+  std::vector<FunctionRegistry::LazyOverload> lazy_overloads_;
+};
+
+// A struct type and the fields set by a struct creation expression.
+class GeneratedStruct {
+ public:
+  GeneratedStruct() = default;
+
+ private:
+  friend class GeneratedProgramBuilder;
+  friend class GeneratedStructBuilder;
+
+  std::string name_;
+  std::vector<std::string> fields_;
+};
+
+// Builds a list from its evaluated elements, as the list creation steps.
+//
+// The `Add` methods return false once `result` holds the value of the
+// creation expression, in which case the remaining elements are not
+// evaluated.
+class GeneratedListBuilder {
+ public:
+  GeneratedListBuilder(google::api::expr::runtime::ExecutionFrameBase& frame
+                           ABSL_ATTRIBUTE_LIFETIME_BOUND,
+                       size_t size);
+
+  GeneratedListBuilder(const GeneratedListBuilder&) = delete;
+  GeneratedListBuilder& operator=(const GeneratedListBuilder&) = delete;
+
+  absl::StatusOr<bool> Add(
+      Value& element, const google::api::expr::runtime::AttributeTrail& trail,
+      Value& result);
+
+  void Build(Value& result) &&;
+
+ private:
+  google::api::expr::runtime::ExecutionFrameBase& frame_;
+  ListValueBuilderPtr builder_;
+  google::api::expr::runtime::AttributeUtility::Accumulator unknowns_;
+};
+
+// Builds a map from its evaluated entries, as the map creation steps.
+class GeneratedMapBuilder {
+ public:
+  GeneratedMapBuilder(google::api::expr::runtime::ExecutionFrameBase& frame
+                          ABSL_ATTRIBUTE_LIFETIME_BOUND,
+                      size_t size);
+
+  GeneratedMapBuilder(const GeneratedMapBuilder&) = delete;
+  GeneratedMapBuilder& operator=(const GeneratedMapBuilder&) = delete;
+
+  // Checks the key of an entry before its value is evaluated.
+  absl::StatusOr<bool> AddKey(
+      Value& key, const google::api::expr::runtime::AttributeTrail& trail,
+      Value& result);
+
+  absl::StatusOr<bool> AddValue(
+      Value& key, Value& value,
+      const google::api::expr::runtime::AttributeTrail& trail, Value& result);
+
+  void Build(Value& result) &&;
+
+ private:
+  google::api::expr::runtime::ExecutionFrameBase& frame_;
+  MapValueBuilderPtr builder_;
+  google::api::expr::runtime::AttributeUtility::Accumulator unknowns_;
+};
+
+// Builds a struct from its evaluated fields, as the struct creation steps.
+class GeneratedStructBuilder {
+ public:
+  GeneratedStructBuilder(google::api::expr::runtime::ExecutionFrameBase& frame
+                             ABSL_ATTRIBUTE_LIFETIME_BOUND,
+                         const GeneratedStruct& type
+                             ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
+  GeneratedStructBuilder(const GeneratedStructBuilder&) = delete;
+  GeneratedStructBuilder& operator=(const GeneratedStructBuilder&) = delete;
+
+  // Creates the underlying value builder, before any field is evaluated.
+  absl::StatusOr<bool> Start(Value& result);
+
+  // Sets the `index`th field of the creation expression.
+  absl::StatusOr<bool> SetField(
+      size_t index, Value& value,
+      const google::api::expr::runtime::AttributeTrail& trail, Value& result);
+
+  absl::Status Build(Value& result) &&;
+
+ private:
+  google::api::expr::runtime::ExecutionFrameBase& frame_;
+  const GeneratedStruct& type_;
+  ValueBuilderPtr builder_;
+  google::api::expr::runtime::AttributeUtility::Accumulator unknowns_;
+};
+
+// Iterates over the range of a comprehension, as the comprehension steps.
+class GeneratedComprehensionRange {
+ public:
+  GeneratedComprehensionRange() = default;
+
+  GeneratedComprehensionRange(const GeneratedComprehensionRange&) = delete;
+  GeneratedComprehensionRange& operator=(const GeneratedComprehensionRange&) =
+      delete;
+
+  // Starts iterating over the evaluated `range`. Returns false with the
+  // result of the comprehension in `result` if the range is not iterable.
+  absl::StatusOr<bool> Start(
+      google::api::expr::runtime::ExecutionFrameBase& frame, const Value& range,
+      const google::api::expr::runtime::AttributeTrail& range_trail
+          ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      Value& result);
+
+  // Advances to the next element of a list, or key of a map. Returns false at
+  // the end of the range.
+  absl::StatusOr<bool> Next(
+      google::api::expr::runtime::ExecutionFrameBase& frame, Value& iter,
+      google::api::expr::runtime::AttributeTrail& iter_trail);
+
+  // Advances to the next index and element of a list, or key and value of a
+  // map.
+  absl::StatusOr<bool> Next(
+      google::api::expr::runtime::ExecutionFrameBase& frame, Value& iter,
+      google::api::expr::runtime::AttributeTrail& iter_trail, Value& iter2,
+      google::api::expr::runtime::AttributeTrail& iter2_trail);
+
+ private:
+  const google::api::expr::runtime::AttributeTrail* range_trail_ = nullptr;
+  ValueIteratorPtr iterator_;
+  bool is_map_ = false;
+  // Scratch for list indices, when unknowns are tracked.
+  Value index_;
+};
+
+// Base class of generated programs.
+class GeneratedProgram : public Program {
+ public:
+  const TypeProvider& GetTypeProvider() const final;
+
+  absl::StatusOr<absl::Span<const VariableReference>> GetReferencedVariables()
+      const final {
+    return referenced_variables_;
+  }
+
+ protected:
+  using Frame = google::api::expr::runtime::ExecutionFrameBase;
+  using AttributeTrail = google::api::expr::runtime::AttributeTrail;
+
+  GeneratedProgram(const GeneratedProgramBuilder& builder,
+                   std::vector<VariableReference> referenced_variables);
+
+  // Evaluates the expression. Implemented by the generated code.
+  virtual absl::Status Evaluate(Frame& frame, Value& result,
+                                AttributeTrail& trail) const = 0;
+
+  // Reads a comprehension variable.
+  static void LoadLocal(const Frame& frame, const Value& value,
+                        const AttributeTrail& value_trail, Value& result,
+                        AttributeTrail& trail);
+
+  // Evaluates `container[key]` for the evaluated operands.
+  void Index(Frame& frame, const Value& container,
+             const AttributeTrail& container_trail, const Value& key,
+             Value& result, AttributeTrail& trail) const;
+
+  // Combines the operands of `_&&_` or `_||_` when the left operand in
+  // `result` did not decide the result. `rhs` was evaluated into `trail`.
+  static absl::Status CombineLogic(Frame& frame, bool is_or, Value& result,
+                                   Value& rhs, AttributeTrail& trail);
+
+  // Sets the result of a conditional whose condition is not a bool.
+  static void NonBoolCondition(Value& condition,
+                               AttributeTrail& condition_trail, Value& result,
+                               AttributeTrail& trail);
+
+  // Returns the result of a comprehension whose loop condition is not a bool.
+  static Value NonBoolLoopCondition(Value condition);
+
+ private:
+  absl::StatusOr<Value> EvaluateImpl(const ActivationInterface& activation,
+                                     google::protobuf::Arena* absl_nonnull arena,
+                                     const EvaluateOptions& options) const final;
+
+  // Keep the runtime environment alive while the program references it.
+  std::shared_ptr<const RuntimeEnv> environment_;
+  RuntimeOptions options_;
+  bool enable_optional_types_;
+  std::vector<VariableReference> referenced_variables_;
+};
+
+// Binds a generated program to a runtime, resolving its references when the
+// program is created.
+class GeneratedProgramBuilder {
+ public:
+  // Returns an error if `runtime` is not the default runtime implementation,
+  // or is configured in a way generated programs do not support.
+  static absl::StatusOr<std::unique_ptr<GeneratedProgramBuilder>> Create(
+      const Runtime& runtime ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
+  GeneratedProgramBuilder(const GeneratedProgramBuilder&) = delete;
+  GeneratedProgramBuilder& operator=(const GeneratedProgramBuilder&) = delete;
+
+  GeneratedIdent Ident(int64_t expr_id, absl::string_view name) const;
+
+  GeneratedSelect Select(absl::string_view field, bool test_only) const;
+
+  // Resolves a call with `num_args` arguments, including the receiver.
+  absl::StatusOr<GeneratedCall> Call(int64_t expr_id,
+                                     absl::string_view function,
+                                     bool receiver_style,
+                                     size_t num_args) const;
+
+  absl::StatusOr<GeneratedStruct> Struct(int64_t expr_id,
+                                         absl::string_view name,
+                                         std::vector<std::string> fields) const;
+
+  // Returns an error if the runtime disables comprehensions.
+  absl::Status CheckComprehensionsEnabled() const;
+
+ private:
+  friend class GeneratedProgram;
+
+  GeneratedProgramBuilder(std::shared_ptr<const RuntimeEnv> environment,
+                          const RuntimeOptions& options,
+                          absl::string_view container,
+                          bool enable_optional_types);
+
+  std::shared_ptr<const RuntimeEnv> environment_;
+  const RuntimeOptions& options_;
+  bool enable_optional_types_;
+  google::api::expr::runtime::Resolver resolver_;
+  // Whether `_==_` and `_!=_` are evaluated by the builtin equality step.
+  bool builtin_equality_;
+};
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_GENERATED_PROGRAM_H_
@@ -35,7 +35,7 @@ class RuntimeFriendAccess {
 
   // Return the internal type_id for the runtime instance for checked down
   // casting.
-  static NativeTypeId RuntimeTypeId(Runtime& runtime) {
+  static NativeTypeId RuntimeTypeId(const Runtime& runtime) {
     return runtime.GetNativeTypeId();
   }
 };
@@ -18,15 +18,20 @@
 
 #include "absl/base/nullability.h"
 #include "absl/log/absl_check.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/native_type.h"
 #include "common/value.h"
+#include "eval/eval/any_unpack_cache.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/comprehension_slots.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "eval/eval/evaluator_state_pool.h"
+#include "eval/eval/function_result_cache.h"
 #include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
@@ -36,11 +41,15 @@
 namespace cel::runtime_internal {
 namespace {
 
+using ::google::api::expr::runtime::AnyUnpackCache;
+using ::google::api::expr::runtime::ArenaResidentVariableCache;
 using ::google::api::expr::runtime::AttributeTrail;
 using ::google::api::expr::runtime::ComprehensionSlots;
 using ::google::api::expr::runtime::DirectExpressionStep;
+using ::google::api::expr::runtime::EvaluatorStatePool;
 using ::google::api::expr::runtime::ExecutionFrameBase;
 using ::google::api::expr::runtime::FlatExpression;
+using ::google::api::expr::runtime::FunctionResultCache;
 using ::google::api::expr::runtime::WrappedDirectStep;
 
 class ProgramImpl final : public TraceableProgram {
@@ -56,24 +65,39 @@ class ProgramImpl final : public TraceableProgram {
       EvaluationListener evaluation_listener, google::protobuf::Arena* absl_nonnull arena,
       const EvaluateOptions& options) const override {
     ABSL_DCHECK(arena != nullptr);
-    auto state =
-        impl_.MakeEvaluatorState(environment_->descriptor_pool.get(),
-                                 options.message_factory != nullptr
-                                     ? options.message_factory
-                                     : environment_->MutableMessageFactory(),
-                                 arena);
-    return impl_.EvaluateWithCallback(activation, options.embedder_context,
-                                      std::move(evaluation_listener), state);
+    EvaluatorStatePool::Lease state =
+        state_pool_.Borrow(impl_, environment_->descriptor_pool.get(),
+                           options.message_factory != nullptr
+                               ? options.message_factory
+                               : environment_->MutableMessageFactory(),
+                           arena);
+    absl::StatusOr<Value> result = impl_.EvaluateWithCallback(
+        activation, options.embedder_context, std::move(evaluation_listener),
+        *state);
+    if (options.function_memoization_stats != nullptr) {
+      options.function_memoization_stats->hits +=
+          state->function_result_cache().hits();
+      options.function_memoization_stats->misses +=
+          state->function_result_cache().misses();
+    }
+    return result;
   }
 
   const TypeProvider& GetTypeProvider() const override {
     return environment_->type_registry.GetComposedTypeProvider();
   }
 
+  absl::StatusOr<absl::Span<const VariableReference>> GetReferencedVariables()
+      const override {
+    return impl_.referenced_variables();
+  }
+
  private:
   // Keep the Runtime environment alive while programs reference it.
   std::shared_ptr<const RuntimeImpl::Environment> environment_;
   FlatExpression impl_;
+  // Reuses evaluator stacks across evaluations on the same thread.
+  EvaluatorStatePool state_pool_;
 };
 
 class RecursiveProgramImpl final : public TraceableProgram {
@@ -97,10 +121,30 @@ class RecursiveProgramImpl final : public TraceableProgram {
                                  ? options.message_factory
                                  : environment_->MutableMessageFactory(),
                              arena, options.embedder_context, slots);
+    FunctionResultCache function_result_cache;
+    if (impl_.options().function_memoization_max_entries > 0) {
+      function_result_cache.set_max_entries(
+          impl_.options().function_memoization_max_entries);
+      frame.set_function_result_cache(&function_result_cache);
+    }
+    AnyUnpackCache any_unpack_cache;
+    if (impl_.options().enable_any_unpack_cache) {
+      frame.set_any_unpack_cache(&any_unpack_cache);
+    }
+    ArenaResidentVariableCache arena_resident_variable_cache;
+    if (impl_.options().enable_arena_resident_values) {
+      frame.set_arena_resident_variable_cache(&arena_resident_variable_cache);
+    }
 
     Value result;
     AttributeTrail attribute;
-    CEL_RETURN_IF_ERROR(root_->Evaluate(frame, result, attribute));
+    absl::Status status = root_->Evaluate(frame, result, attribute);
+    if (options.function_memoization_stats != nullptr) {
+      options.function_memoization_stats->hits += function_result_cache.hits();
+      options.function_memoization_stats->misses +=
+          function_result_cache.misses();
+    }
+    CEL_RETURN_IF_ERROR(status);
 
     return result;
   }
@@ -109,6 +153,11 @@ class RecursiveProgramImpl final : public TraceableProgram {
     return environment_->type_registry.GetComposedTypeProvider();
   }
 
+  absl::StatusOr<absl::Span<const VariableReference>> GetReferencedVariables()
+      const override {
+    return impl_.referenced_variables();
+  }
+
  private:
   // Keep the Runtime environment alive while programs reference it.
   std::shared_ptr<const RuntimeImpl::Environment> environment_;
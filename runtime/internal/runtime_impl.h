@@ -48,6 +48,15 @@ class RuntimeImpl : public Runtime {
     ABSL_DCHECK(environment_->well_known_types.IsInitialized());
   }
 
+  // Constructor for a runtime derived from `parent`, sharing its planner
+  // extensions and options.
+  RuntimeImpl(absl_nonnull std::shared_ptr<Environment> environment,
+              const RuntimeImpl& parent)
+      : environment_(std::move(environment)),
+        expr_builder_(environment_, parent.expr_builder_) {
+    ABSL_DCHECK(environment_->well_known_types.IsInitialized());
+  }
+
   TypeRegistry& type_registry() ABSL_ATTRIBUTE_LIFETIME_BOUND {
     return environment_->type_registry;
   }
@@ -75,6 +84,12 @@ class RuntimeImpl : public Runtime {
     return *environment_;
   }
 
+  // Shares ownership of the environment with programs created outside of the
+  // planner (see generated_program.h).
+  std::shared_ptr<const Environment> shared_environment() const {
+    return environment_;
+  }
+
   // implement Runtime
   absl::StatusOr<std::unique_ptr<Program>> CreateProgram(
       std::unique_ptr<Ast> ast,
@@ -102,6 +117,10 @@ class RuntimeImpl : public Runtime {
       ABSL_ATTRIBUTE_LIFETIME_BOUND {
     return expr_builder_;
   }
+  const google::api::expr::runtime::FlatExprBuilder& expr_builder() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return expr_builder_;
+  }
 
  private:
   NativeTypeId GetNativeTypeId() const override {
@@ -28,6 +28,7 @@
 #include "common/type_introspector.h"
 #include "common/value.h"
 #include "common/values/value_builder.h"
+#include "internal/status_macros.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/message.h"
 
@@ -61,6 +62,12 @@ absl::StatusOr<absl::optional<Type>> RuntimeTypeProvider::FindTypeImpl(
   if (const auto it = types_.find(name); it != types_.end()) {
     return it->second;
   }
+  for (const auto& introspector : type_introspectors_) {
+    CEL_ASSIGN_OR_RETURN(auto type, introspector->FindType(name));
+    if (type.has_value()) {
+      return type;
+    }
+  }
   return std::nullopt;
 }
 
@@ -81,7 +88,19 @@ RuntimeTypeProvider::FindStructTypeFieldByNameImpl(
   if (field.has_value()) {
     return field;
   }
-  return descriptor_pool_provider_.FindStructTypeFieldByName(type, name);
+  CEL_ASSIGN_OR_RETURN(
+      field, descriptor_pool_provider_.FindStructTypeFieldByName(type, name));
+  if (field.has_value()) {
+    return field;
+  }
+  for (const auto& introspector : type_introspectors_) {
+    CEL_ASSIGN_OR_RETURN(field,
+                         introspector->FindStructTypeFieldByName(type, name));
+    if (field.has_value()) {
+      return field;
+    }
+  }
+  return std::nullopt;
 }
 
 absl::StatusOr<absl_nullable ValueBuilderPtr>
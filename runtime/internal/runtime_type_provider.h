@@ -15,6 +15,10 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_RUNTIME_TYPE_PROVIDER_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_RUNTIME_TYPE_PROVIDER_H_
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
@@ -23,6 +27,7 @@
 #include "absl/types/optional.h"
 #include "common/descriptor_pool_type_introspector.h"
 #include "common/type.h"
+#include "common/type_introspector.h"
 #include "common/type_reflector.h"
 #include "common/value.h"
 #include "google/protobuf/arena.h"
@@ -40,6 +45,21 @@ class RuntimeTypeProvider final : public TypeReflector {
 
   absl::Status RegisterType(const OpaqueType& type);
 
+  // Adds an introspector consulted for types not found in the descriptor pool.
+  void AddTypeIntrospector(
+      absl_nonnull std::shared_ptr<const TypeIntrospector> introspector) {
+    type_introspectors_.push_back(std::move(introspector));
+  }
+
+  // Registers the types registered with `other`. The types must outlive this
+  // provider.
+  void RegisterTypesFrom(const RuntimeTypeProvider& other) {
+    types_.insert(other.types_.begin(), other.types_.end());
+    type_introspectors_.insert(type_introspectors_.end(),
+                               other.type_introspectors_.begin(),
+                               other.type_introspectors_.end());
+  }
+
   absl::StatusOr<absl_nullable ValueBuilderPtr> NewValueBuilder(
       absl::string_view name,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
@@ -59,6 +79,8 @@ class RuntimeTypeProvider final : public TypeReflector {
   const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool_;
   DescriptorPoolTypeIntrospector descriptor_pool_provider_;
   absl::flat_hash_map<absl::string_view, Type> types_;
+  std::vector<absl_nonnull std::shared_ptr<const TypeIntrospector>>
+      type_introspectors_;
 };
 
 }  // namespace cel::runtime_internal
@@ -0,0 +1,76 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/standard_env_testing.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "compiler/standard_library.h"
+#include "internal/status_macros.h"
+#include "internal/testing_descriptor_pool.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel::runtime_internal {
+
+absl::StatusOr<std::unique_ptr<CompilerBuilder>> NewTestingCompilerBuilder(
+    absl::Span<const VariableDecl> variables) {
+  CEL_ASSIGN_OR_RETURN(
+      std::unique_ptr<CompilerBuilder> builder,
+      NewCompilerBuilder(internal::GetTestingDescriptorPool()));
+  CEL_RETURN_IF_ERROR(builder->AddLibrary(StandardCompilerLibrary()));
+  for (const VariableDecl& variable : variables) {
+    CEL_RETURN_IF_ERROR(builder->GetCheckerBuilder().AddVariable(variable));
+  }
+  return builder;
+}
+
+absl::StatusOr<std::unique_ptr<Compiler>> NewTestingCompiler(
+    absl::Span<const VariableDecl> variables) {
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerBuilder> builder,
+                       NewTestingCompilerBuilder(variables));
+  return builder->Build();
+}
+
+absl::StatusOr<std::unique_ptr<Runtime>> NewTestingRuntime(
+    const RuntimeOptions& options) {
+  CEL_ASSIGN_OR_RETURN(
+      RuntimeBuilder builder,
+      CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                   options));
+  return std::move(builder).Build();
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> CompileForTesting(
+    const Compiler& compiler, absl::string_view expr) {
+  CEL_ASSIGN_OR_RETURN(ValidationResult result, compiler.Compile(expr));
+  if (!result.IsValid()) {
+    return absl::InvalidArgumentError(result.FormatError());
+  }
+  return result.ReleaseAst();
+}
+
+}  // namespace cel::runtime_internal
@@ -0,0 +1,53 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compilers and runtimes with the standard library over the testing
+// descriptor pool, for tests that evaluate compiled expressions.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_STANDARD_ENV_TESTING_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_STANDARD_ENV_TESTING_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "compiler/compiler.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+
+namespace cel::runtime_internal {
+
+// Returns a compiler builder with the standard library and `variables`
+// declared, for tests that declare more.
+absl::StatusOr<std::unique_ptr<CompilerBuilder>> NewTestingCompilerBuilder(
+    absl::Span<const VariableDecl> variables);
+
+// Returns a compiler with the standard library and `variables` declared.
+absl::StatusOr<std::unique_ptr<Compiler>> NewTestingCompiler(
+    absl::Span<const VariableDecl> variables);
+
+// Returns a standard runtime configured with `options`.
+absl::StatusOr<std::unique_ptr<Runtime>> NewTestingRuntime(
+    const RuntimeOptions& options = RuntimeOptions());
+
+// Compiles `expr`, failing with the formatted issues if it is invalid.
+absl::StatusOr<std::unique_ptr<Ast>> CompileForTesting(
+    const Compiler& compiler, absl::string_view expr);
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_STANDARD_ENV_TESTING_H_
@@ -26,12 +26,14 @@
 #include "absl/log/absl_check.h"
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/variant.h"
 #include "checker/validation_result.h"
+#include "common/arena.h"
 #include "common/decl.h"
 #include "common/type.h"
 #include "common/value.h"
@@ -80,7 +82,7 @@ struct TestCase {
   bool reference_resolver_enabled = false;
 };
 
-enum Options { kDefault, kExhaustive, kFoldConstants };
+enum Options { kDefault, kExhaustive, kFoldConstants, kArenaResident };
 
 using ParamType = std::tuple<TestCase, Options>;
 
@@ -139,6 +141,9 @@ std::string TestCaseName(const testing::TestParamInfo<ParamType>& param_info) {
     case Options::kFoldConstants:
       opt = "opt";
       break;
+    case Options::kArenaResident:
+      opt = "arena";
+      break;
   }
 
   return absl::StrCat(std::get<0>(param).name, "_", opt);
@@ -166,6 +171,10 @@ absl::StatusOr<std::unique_ptr<Runtime>> ConfigureRuntimeImpl(
       options.enable_comprehension_list_append = true;
       options.short_circuiting = true;
       break;
+    case Options::kArenaResident:
+      options.enable_arena_resident_values = true;
+      options.short_circuiting = true;
+      break;
   }
   options.enable_qualified_type_identifiers = resolve_references;
   options.container = "cel.expr.conformance.proto3";
@@ -550,9 +559,41 @@ INSTANTIATE_TEST_SUITE_P(
             },
         }),
         testing::Values(Options::kDefault, Options::kExhaustive,
-                        Options::kFoldConstants)),
+                        Options::kFoldConstants, Options::kArenaResident)),
     &TestCaseName);
 
+TEST(ArenaResidentValuesTest, ResultsAreArenaOwned) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Runtime> runtime,
+                       ConfigureRuntimeImpl(false, Options::kArenaResident));
+  ASSERT_OK_AND_ASSIGN(
+      ValidationResult validation,
+      GetCompiler().Compile("condition ? string_var : "
+                            "'a long constant string that is not inlined'"));
+  ASSERT_TRUE(validation.IsValid()) << validation.FormatError();
+  ASSERT_OK_AND_ASSIGN(auto ast, validation.ReleaseAst());
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       runtime->CreateProgram(std::move(ast)));
+
+  constexpr absl::string_view kCordValue =
+      "a long cord value that is not inlined abcdef";
+  google::protobuf::Arena arena;
+  Activation activation;
+  // A reference counted input is copied to the evaluation arena on access.
+  activation.InsertOrAssignValue("string_var",
+                                 StringValue(absl::Cord(kCordValue)));
+
+  activation.InsertOrAssignValue("condition", BoolValue(true));
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  EXPECT_THAT(result, test::StringValueIs(std::string(kCordValue)));
+  EXPECT_TRUE(ArenaTraits<>::trivially_destructible(result));
+
+  activation.InsertOrAssignValue("condition", BoolValue(false));
+  ASSERT_OK_AND_ASSIGN(result, program->Evaluate(&arena, activation));
+  EXPECT_THAT(result, test::StringValueIs(
+                          "a long constant string that is not inlined"));
+  EXPECT_TRUE(ArenaTraits<>::trivially_destructible(result));
+}
+
 MATCHER_P(IsSameInstance, expected, "") {
   return std::mem_fn(&ParsedMessageValue::operator->)(&arg) == expected;
 }
@@ -1075,6 +1116,8 @@ INSTANTIATE_TEST_SUITE_P(Cases, ViewTypesMemorySafetyTest,
                                return "exhaustive";
                              case Options::kFoldConstants:
                                return "opt";
+                             case Options::kArenaResident:
+                               return "arena";
                            }
                          });
 
@@ -0,0 +1,319 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/partial_evaluation.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "base/builtins.h"
+#include "common/ast.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/internal/runtime_friend_access.h"
+#include "runtime/internal/runtime_impl.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+
+namespace {
+
+// Returns the literal for a known primitive value, or nullopt if the value
+// can't be represented as a constant.
+absl::optional<Constant> ToConstant(const Value& value) {
+  Constant constant;
+  switch (value.kind()) {
+    case ValueKind::kNull:
+      constant.set_null_value();
+      break;
+    case ValueKind::kBool:
+      constant.set_bool_value(value.GetBool().NativeValue());
+      break;
+    case ValueKind::kInt:
+      constant.set_int_value(value.GetInt().NativeValue());
+      break;
+    case ValueKind::kUint:
+      constant.set_uint_value(value.GetUint().NativeValue());
+      break;
+    case ValueKind::kDouble:
+      constant.set_double_value(value.GetDouble().NativeValue());
+      break;
+    case ValueKind::kString:
+      constant.set_string_value(value.GetString().ToString());
+      break;
+    case ValueKind::kBytes:
+      constant.set_bytes_value(value.GetBytes().ToString());
+      break;
+    case ValueKind::kDuration:
+      constant.set_duration_value(value.GetDuration().ToDuration());
+      break;
+    case ValueKind::kTimestamp:
+      constant.set_timestamp_value(value.GetTimestamp().ToTime());
+      break;
+    default:
+      return absl::nullopt;
+  }
+  return constant;
+}
+
+// Records the value of each expression node observed during evaluation.
+class ValueRecorder {
+ public:
+  absl::Status Record(int64_t expr_id, const Value& value) {
+    if (!observed_.insert(expr_id).second) {
+      // Evaluated more than once (e.g. in a comprehension), the node doesn't
+      // have a single value.
+      known_.erase(expr_id);
+      return absl::OkStatus();
+    }
+    if (absl::optional<Constant> constant = ToConstant(value);
+        constant.has_value()) {
+      known_.insert_or_assign(expr_id, *std::move(constant));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::flat_hash_map<int64_t, Constant>& known() { return known_; }
+
+ private:
+  absl::flat_hash_set<int64_t> observed_;
+  absl::flat_hash_map<int64_t, Constant> known_;
+};
+
+// Rewrites an expression tree in place, replacing known sub-expressions with
+// literals.
+class ResidualBuilder {
+ public:
+  explicit ResidualBuilder(absl::flat_hash_map<int64_t, Constant>& known)
+      : known_(known) {}
+
+  void Prune(Expr& expr) {
+    if (auto it = known_.find(expr.id()); it != known_.end()) {
+      int64_t id = expr.id();
+      expr.Clear();
+      expr.set_id(id);
+      expr.set_const_expr(std::move(it->second));
+      known_.erase(it);
+      folded_.insert(id);
+      return;
+    }
+    switch (expr.kind_case()) {
+      case ExprKindCase::kSelectExpr:
+        Prune(expr.mutable_select_expr().mutable_operand());
+        break;
+      case ExprKindCase::kCallExpr: {
+        CallExpr& call = expr.mutable_call_expr();
+        if (call.has_target()) {
+          Prune(call.mutable_target());
+        }
+        for (Expr& arg : call.mutable_args()) {
+          Prune(arg);
+        }
+        SimplifyCall(expr);
+        break;
+      }
+      case ExprKindCase::kListExpr:
+        for (ListExprElement& element :
+             expr.mutable_list_expr().mutable_elements()) {
+          Prune(element.mutable_expr());
+        }
+        break;
+      case ExprKindCase::kStructExpr:
+        for (StructExprField& field :
+             expr.mutable_struct_expr().mutable_fields()) {
+          Prune(field.mutable_value());
+        }
+        break;
+      case ExprKindCase::kMapExpr:
+        for (MapExprEntry& entry : expr.mutable_map_expr().mutable_entries()) {
+          Prune(entry.mutable_key());
+          Prune(entry.mutable_value());
+        }
+        break;
+      case ExprKindCase::kComprehensionExpr: {
+        // Only the sub-expressions evaluated once per comprehension are
+        // candidates for folding.
+        ComprehensionExpr& comprehension = expr.mutable_comprehension_expr();
+        Prune(comprehension.mutable_iter_range());
+        Prune(comprehension.mutable_accu_init());
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  // Returns true if the expression was replaced with a literal.
+  bool IsFolded(int64_t expr_id) const { return folded_.contains(expr_id); }
+
+ private:
+  static absl::optional<bool> BoolLiteral(const Expr& expr) {
+    if (!expr.has_const_expr() || !expr.const_expr().has_bool_value()) {
+      return absl::nullopt;
+    }
+    return expr.const_expr().bool_value();
+  }
+
+  // Simplifies logical operators and conditionals with known operands.
+  static void SimplifyCall(Expr& expr) {
+    CallExpr& call = expr.mutable_call_expr();
+    if (call.has_target()) {
+      return;
+    }
+    auto& args = call.mutable_args();
+    if ((call.function() == builtin::kAnd || call.function() == builtin::kOr) &&
+        args.size() == 2) {
+      // `true && e` and `false || e` are equivalent to `e`.
+      const bool identity = call.function() == builtin::kAnd;
+      for (int i = 0; i < 2; ++i) {
+        if (BoolLiteral(args[i]) == identity) {
+          Expr other = std::move(args[1 - i]);
+          expr = std::move(other);
+          return;
+        }
+      }
+    } else if (call.function() == builtin::kTernary && args.size() == 3) {
+      if (absl::optional<bool> condition = BoolLiteral(args[0]);
+          condition.has_value()) {
+        Expr branch = std::move(args[*condition ? 1 : 2]);
+        expr = std::move(branch);
+      }
+    }
+  }
+
+  absl::flat_hash_map<int64_t, Constant>& known_;
+  absl::flat_hash_set<int64_t> folded_;
+};
+
+void CollectIds(const Expr& expr, absl::flat_hash_set<int64_t>& ids) {
+  ids.insert(expr.id());
+  switch (expr.kind_case()) {
+    case ExprKindCase::kSelectExpr:
+      CollectIds(expr.select_expr().operand(), ids);
+      break;
+    case ExprKindCase::kCallExpr:
+      if (expr.call_expr().has_target()) {
+        CollectIds(expr.call_expr().target(), ids);
+      }
+      for (const Expr& arg : expr.call_expr().args()) {
+        CollectIds(arg, ids);
+      }
+      break;
+    case ExprKindCase::kListExpr:
+      for (const ListExprElement& element : expr.list_expr().elements()) {
+        CollectIds(element.expr(), ids);
+      }
+      break;
+    case ExprKindCase::kStructExpr:
+      for (const StructExprField& field : expr.struct_expr().fields()) {
+        CollectIds(field.value(), ids);
+      }
+      break;
+    case ExprKindCase::kMapExpr:
+      for (const MapExprEntry& entry : expr.map_expr().entries()) {
+        CollectIds(entry.key(), ids);
+        CollectIds(entry.value(), ids);
+      }
+      break;
+    case ExprKindCase::kComprehensionExpr: {
+      const ComprehensionExpr& comprehension = expr.comprehension_expr();
+      CollectIds(comprehension.iter_range(), ids);
+      CollectIds(comprehension.accu_init(), ids);
+      CollectIds(comprehension.loop_condition(), ids);
+      CollectIds(comprehension.loop_step(), ids);
+      CollectIds(comprehension.result(), ids);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// Drops entries for expression nodes that were removed from the tree.
+// References for folded nodes are dropped too since literals don't resolve to
+// a declaration.
+template <typename Map>
+void PruneMetadata(Map& map, const absl::flat_hash_set<int64_t>& ids,
+                   const ResidualBuilder* absl_nullable builder) {
+  absl::erase_if(map, [&](const auto& entry) {
+    return !ids.contains(entry.first) ||
+           (builder != nullptr && builder->IsFolded(entry.first));
+  });
+}
+
+}  // namespace
+
+absl::StatusOr<PartialEvaluationResult> PartiallyEvaluate(
+    const Runtime& runtime, const Ast& ast,
+    const ActivationInterface& activation,
+    google::protobuf::Arena* absl_nonnull arena) {
+  if (runtime_internal::RuntimeFriendAccess::RuntimeTypeId(runtime) ==
+      NativeTypeId::For<runtime_internal::RuntimeImpl>()) {
+    const RuntimeOptions& options =
+        static_cast<const runtime_internal::RuntimeImpl&>(runtime)
+            .expr_builder()
+            .options();
+    if (options.max_recursion_depth != 0 &&
+        !options.enable_recursive_tracing) {
+      return absl::InvalidArgumentError(
+          "partial evaluation of recursively planned programs requires "
+          "RuntimeOptions::enable_recursive_tracing");
+    }
+  }
+  CEL_ASSIGN_OR_RETURN(
+      std::unique_ptr<TraceableProgram> program,
+      runtime.CreateTraceableProgram(std::make_unique<Ast>(ast)));
+
+  ValueRecorder recorder;
+  CEL_ASSIGN_OR_RETURN(
+      Value value,
+      program->Trace(arena, activation,
+                     [&recorder](int64_t expr_id, const Value& result,
+                                 const google::protobuf::DescriptorPool* absl_nonnull,
+                                 google::protobuf::MessageFactory* absl_nonnull,
+                                 google::protobuf::Arena* absl_nonnull) {
+                       return recorder.Record(expr_id, result);
+                     }));
+
+  auto residual = std::make_unique<Ast>(ast);
+  ResidualBuilder builder(recorder.known());
+  builder.Prune(residual->mutable_root_expr());
+
+  absl::flat_hash_set<int64_t> ids;
+  CollectIds(residual->root_expr(), ids);
+  PruneMetadata(residual->mutable_reference_map(), ids, &builder);
+  PruneMetadata(residual->mutable_type_map(), ids, nullptr);
+  PruneMetadata(residual->mutable_source_info().mutable_macro_calls(), ids,
+                &builder);
+
+  return PartialEvaluationResult{std::move(value), std::move(residual)};
+}
+
+}  // namespace cel
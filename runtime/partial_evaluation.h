@@ -0,0 +1,68 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_PARTIAL_EVALUATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_PARTIAL_EVALUATION_H_
+
+#include <memory>
+
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "common/ast.h"
+#include "common/value.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+struct PartialEvaluationResult {
+  // The result of evaluating the expression against the partial activation.
+  // An UnknownValue if the result depends on unknown attributes.
+  Value value;
+
+  // The residual expression. Sub-expressions that evaluated to a known
+  // primitive value are replaced with literals, and logical operators and
+  // conditionals are simplified where one side is known. The remaining
+  // sub-expressions, reference map entries and type map entries are carried
+  // over unchanged, so a checked input produces a checked residual that can be
+  // planned with the same runtime.
+  std::unique_ptr<Ast> residual_ast;
+};
+
+// Evaluates `ast` against an activation where some attributes are marked
+// unknown (see Activation::SetUnknownPatterns) and produces a residual
+// expression that only depends on the unknown attributes.
+//
+// The runtime must be built with unknown processing enabled
+// (RuntimeOptions::unknown_processing), otherwise unknown patterns are ignored
+// and missing attributes evaluate to errors. A runtime that plans recursively
+// (RuntimeOptions::max_recursion_depth != 0) must also enable
+// RuntimeOptions::enable_recursive_tracing, otherwise an InvalidArgumentError
+// is returned. Function calls with known arguments are folded, so the
+// expression should only call deterministic functions.
+//
+// Sub-expressions of comprehension loop conditions, loop steps and results are
+// never folded, since a single expression node is evaluated once per
+// iteration.
+//
+// `value` in the result is only valid for the lifetime of `arena`.
+absl::StatusOr<PartialEvaluationResult> PartiallyEvaluate(
+    const Runtime& runtime, const Ast& ast,
+    const ActivationInterface& activation,
+    google::protobuf::Arena* absl_nonnull arena);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_PARTIAL_EVALUATION_H_
@@ -0,0 +1,175 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/partial_evaluation.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/attribute.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/expr.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "compiler/compiler.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/internal/standard_env_testing.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::IntValueIs;
+
+class PartialEvaluationTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(compiler_,
+                         runtime_internal::NewTestingCompiler(
+                             {MakeVariableDecl("tenant", StringType()),
+                              MakeVariableDecl("limit", IntType()),
+                              MakeVariableDecl("size", IntType())}));
+    RuntimeOptions options;
+    options.unknown_processing = UnknownProcessingOptions::kAttributeOnly;
+    ASSERT_OK_AND_ASSIGN(runtime_,
+                         runtime_internal::NewTestingRuntime(options));
+  }
+
+  absl::StatusOr<std::unique_ptr<Ast>> Compile(absl::string_view expr) {
+    return runtime_internal::CompileForTesting(*compiler_, expr);
+  }
+
+  // Evaluates `expr` with the tenant configuration known and `size` unknown.
+  absl::StatusOr<PartialEvaluationResult> PartiallyEvaluate(
+      absl::string_view expr) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, Compile(expr));
+    Activation activation;
+    activation.InsertOrAssignValue("tenant", StringValue("acme"));
+    activation.InsertOrAssignValue("limit", IntValue(10));
+    activation.SetUnknownPatterns({AttributePattern("size", {})});
+    return cel::PartiallyEvaluate(*runtime_, *ast, activation, &arena_);
+  }
+
+  // Plans the residual and evaluates it with `size` bound.
+  absl::StatusOr<Value> EvaluateResidual(std::unique_ptr<Ast> residual,
+                                         int64_t size) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                         runtime_->CreateProgram(std::move(residual)));
+    Activation activation;
+    activation.InsertOrAssignValue("size", IntValue(size));
+    return program->Evaluate(&arena_, activation);
+  }
+
+  std::unique_ptr<Compiler> compiler_;
+  std::unique_ptr<Runtime> runtime_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(PartialEvaluationTest, FoldsKnownBranches) {
+  ASSERT_OK_AND_ASSIGN(
+      PartialEvaluationResult result,
+      PartiallyEvaluate("tenant == 'acme' && size < limit * 2"));
+  EXPECT_TRUE(result.value.IsUnknown());
+
+  // Residual is `size < 20`.
+  const Expr& root = result.residual_ast->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  EXPECT_EQ(root.call_expr().function(), "_<_");
+  ASSERT_EQ(root.call_expr().args().size(), 2);
+  EXPECT_EQ(root.call_expr().args()[0].ident_expr().name(), "size");
+  EXPECT_EQ(root.call_expr().args()[1].const_expr().int_value(), 20);
+  EXPECT_TRUE(result.residual_ast->is_checked());
+  EXPECT_EQ(result.residual_ast->reference_map().size(), 2);
+
+  EXPECT_THAT(EvaluateResidual(std::move(result.residual_ast), 15),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(PartialEvaluationTest, FoldsKnownResult) {
+  ASSERT_OK_AND_ASSIGN(PartialEvaluationResult result,
+                       PartiallyEvaluate("tenant == 'other' && size < limit"));
+  EXPECT_THAT(result.value, BoolValueIs(false));
+
+  const Expr& root = result.residual_ast->root_expr();
+  ASSERT_TRUE(root.has_const_expr());
+  EXPECT_FALSE(root.const_expr().bool_value());
+  EXPECT_TRUE(result.residual_ast->reference_map().empty());
+}
+
+TEST_F(PartialEvaluationTest, SelectsConditionalBranch) {
+  ASSERT_OK_AND_ASSIGN(
+      PartialEvaluationResult result,
+      PartiallyEvaluate("tenant.startsWith('ac') ? size + limit : 0"));
+  EXPECT_TRUE(result.value.IsUnknown());
+
+  const Expr& root = result.residual_ast->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  EXPECT_EQ(root.call_expr().function(), "_+_");
+
+  EXPECT_THAT(EvaluateResidual(std::move(result.residual_ast), 5),
+              IsOkAndHolds(IntValueIs(15)));
+}
+
+TEST_F(PartialEvaluationTest, KeepsComprehensionBody) {
+  ASSERT_OK_AND_ASSIGN(
+      PartialEvaluationResult result,
+      PartiallyEvaluate("[limit, limit + 1].exists(i, i == size)"));
+  EXPECT_TRUE(result.value.IsUnknown());
+  ASSERT_TRUE(result.residual_ast->root_expr().has_comprehension_expr());
+
+  ASSERT_OK_AND_ASSIGN(
+      result, PartiallyEvaluate("[limit, limit + 1].exists(i, i == size)"));
+  EXPECT_THAT(EvaluateResidual(std::move(result.residual_ast), 11),
+              IsOkAndHolds(BoolValueIs(true)));
+  ASSERT_OK_AND_ASSIGN(
+      result, PartiallyEvaluate("[limit, limit + 1].exists(i, i == size)"));
+  EXPECT_THAT(EvaluateResidual(std::move(result.residual_ast), 12),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(PartialEvaluationTest, RecursivePlanningRequiresTracing) {
+  RuntimeOptions options;
+  options.unknown_processing = UnknownProcessingOptions::kAttributeOnly;
+  options.max_recursion_depth = -1;
+  ASSERT_OK_AND_ASSIGN(runtime_, runtime_internal::NewTestingRuntime(options));
+  EXPECT_THAT(PartiallyEvaluate("tenant == 'acme' && size < limit * 2"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  options.enable_recursive_tracing = true;
+  ASSERT_OK_AND_ASSIGN(runtime_, runtime_internal::NewTestingRuntime(options));
+  ASSERT_OK_AND_ASSIGN(
+      PartialEvaluationResult result,
+      PartiallyEvaluate("tenant == 'acme' && size < limit * 2"));
+  const Expr& root = result.residual_ast->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  EXPECT_EQ(root.call_expr().function(), "_<_");
+  EXPECT_EQ(root.call_expr().args()[1].const_expr().int_value(), 20);
+}
+
+}  // namespace
+}  // namespace cel
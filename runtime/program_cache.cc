@@ -0,0 +1,88 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/program_cache.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "common/ast.h"
+#include "common/ast_fingerprint.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+absl::StatusOr<std::shared_ptr<const Program>> ProgramCache::GetOrCreateProgram(
+    std::unique_ptr<Ast> ast) {
+  std::string fingerprint = StructuralFingerprint(*ast);
+  {
+    absl::MutexLock lock(mutex_);
+    if (std::shared_ptr<const Program> program = FindLocked(fingerprint);
+        program != nullptr) {
+      ++hit_count_;
+      return program;
+    }
+  }
+
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> planned,
+                       runtime_.CreateProgram(std::move(ast)));
+
+  absl::MutexLock lock(mutex_);
+  if (std::shared_ptr<const Program> program = FindLocked(fingerprint);
+      program != nullptr) {
+    return program;
+  }
+  std::shared_ptr<const Program> program = std::move(planned);
+  entries_.push_front(Entry{std::move(fingerprint), program});
+  index_[entries_.front().fingerprint] = entries_.begin();
+  while (entries_.size() > options_.max_size) {
+    index_.erase(entries_.back().fingerprint);
+    entries_.pop_back();
+  }
+  return program;
+}
+
+std::shared_ptr<const Program> ProgramCache::FindLocked(
+    absl::string_view fingerprint) {
+  auto it = index_.find(fingerprint);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->program;
+}
+
+size_t ProgramCache::size() const {
+  absl::MutexLock lock(mutex_);
+  return entries_.size();
+}
+
+size_t ProgramCache::hit_count() const {
+  absl::MutexLock lock(mutex_);
+  return hit_count_;
+}
+
+void ProgramCache::Clear() {
+  absl::MutexLock lock(mutex_);
+  index_.clear();
+  entries_.clear();
+}
+
+}  // namespace cel
@@ -0,0 +1,103 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_PROGRAM_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_PROGRAM_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "common/ast.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+struct ProgramCacheOptions {
+  // Maximum number of programs retained by the cache. The least recently used
+  // program is evicted when the limit is exceeded.
+  size_t max_size = 1024;
+};
+
+// A size bounded cache of programs planned by a single Runtime.
+//
+// Programs are keyed by the structural fingerprint of the AST (see
+// common/ast_fingerprint.h), so textually different expressions with the same
+// structure, references and types share one immutable program.
+//
+// Note: programs from the cache report the expression ids of the AST they were
+// planned from, which may differ from the ids of an equivalent AST passed to a
+// later lookup. Callers that depend on expression ids (e.g. evaluation
+// listeners or unknown function results) should not use the cache.
+//
+// Thread safe. The runtime must outlive the cache.
+class ProgramCache {
+ public:
+  explicit ProgramCache(const Runtime& runtime ABSL_ATTRIBUTE_LIFETIME_BOUND,
+                        ProgramCacheOptions options = {})
+      : runtime_(runtime), options_(options) {}
+
+  ProgramCache(const ProgramCache&) = delete;
+  ProgramCache& operator=(const ProgramCache&) = delete;
+
+  // Returns the cached program for `ast` or plans and caches a new one.
+  //
+  // Planning happens outside of the cache lock. If several threads miss on
+  // the same fingerprint concurrently, the first program inserted is kept
+  // and returned to all of them.
+  absl::StatusOr<std::shared_ptr<const Program>> GetOrCreateProgram(
+      std::unique_ptr<Ast> ast);
+
+  // Number of programs currently cached.
+  size_t size() const;
+
+  // Number of lookups served from the cache.
+  size_t hit_count() const;
+
+  void Clear();
+
+ private:
+  struct Entry {
+    std::string fingerprint;
+    std::shared_ptr<const Program> program;
+  };
+  using EntryList = std::list<Entry>;
+
+  // Returns the cached program and marks it most recently used.
+  std::shared_ptr<const Program> FindLocked(absl::string_view fingerprint)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const Runtime& runtime_;
+  const ProgramCacheOptions options_;
+
+  mutable absl::Mutex mutex_;
+  // Most recently used first.
+  EntryList entries_ ABSL_GUARDED_BY(mutex_);
+  // Keys are views of the fingerprints owned by `entries_`.
+  absl::flat_hash_map<absl::string_view, EntryList::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+  size_t hit_count_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_PROGRAM_CACHE_H_
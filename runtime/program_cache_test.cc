@@ -0,0 +1,139 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/program_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/expr.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "compiler/compiler.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/internal/standard_env_testing.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::IntValueIs;
+
+class ProgramCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(compiler_, runtime_internal::NewTestingCompiler(
+                                        {MakeVariableDecl("x", IntType())}));
+    ASSERT_OK_AND_ASSIGN(runtime_, runtime_internal::NewTestingRuntime());
+  }
+
+  absl::StatusOr<std::unique_ptr<Ast>> Compile(absl::string_view expr) {
+    return runtime_internal::CompileForTesting(*compiler_, expr);
+  }
+
+  absl::StatusOr<Value> Evaluate(const Program& program, int64_t x) {
+    Activation activation;
+    activation.InsertOrAssignValue("x", IntValue(x));
+    return program.Evaluate(&arena_, activation);
+  }
+
+  std::unique_ptr<Compiler> compiler_;
+  std::unique_ptr<Runtime> runtime_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(ProgramCacheTest, SharesStructurallyEqualPrograms) {
+  ProgramCache cache(*runtime_);
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast, Compile("x + 1"));
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Program> program,
+                       cache.GetOrCreateProgram(std::move(ast)));
+
+  ASSERT_OK_AND_ASSIGN(ast, Compile("x\n  +  1 // comment"));
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Program> same_program,
+                       cache.GetOrCreateProgram(std::move(ast)));
+
+  EXPECT_EQ(program, same_program);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.hit_count(), 1);
+  EXPECT_THAT(Evaluate(*same_program, 2), IsOkAndHolds(IntValueIs(3)));
+}
+
+TEST_F(ProgramCacheTest, DistinguishesDifferentPrograms) {
+  ProgramCache cache(*runtime_);
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast, Compile("x + 1"));
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Program> program,
+                       cache.GetOrCreateProgram(std::move(ast)));
+
+  ASSERT_OK_AND_ASSIGN(ast, Compile("x + 2"));
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Program> other_program,
+                       cache.GetOrCreateProgram(std::move(ast)));
+
+  EXPECT_NE(program, other_program);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.hit_count(), 0);
+  EXPECT_THAT(Evaluate(*program, 2), IsOkAndHolds(IntValueIs(3)));
+  EXPECT_THAT(Evaluate(*other_program, 2), IsOkAndHolds(IntValueIs(4)));
+}
+
+TEST_F(ProgramCacheTest, EvictsLeastRecentlyUsed) {
+  ProgramCache cache(*runtime_, ProgramCacheOptions{.max_size = 2});
+
+  for (absl::string_view expr : {"x + 1", "x + 2", "x + 1", "x + 3"}) {
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast, Compile(expr));
+    ASSERT_THAT(cache.GetOrCreateProgram(std::move(ast)), IsOk());
+  }
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.hit_count(), 1);
+
+  // "x + 2" was evicted, "x + 1" was retained.
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast, Compile("x + 1"));
+  ASSERT_THAT(cache.GetOrCreateProgram(std::move(ast)), IsOk());
+  EXPECT_EQ(cache.hit_count(), 2);
+  ASSERT_OK_AND_ASSIGN(ast, Compile("x + 2"));
+  ASSERT_THAT(cache.GetOrCreateProgram(std::move(ast)), IsOk());
+  EXPECT_EQ(cache.hit_count(), 2);
+
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(ProgramCacheTest, PlanningErrorsAreNotCached) {
+  ProgramCache cache(*runtime_);
+  Expr expr;
+  expr.set_id(1);
+  expr.mutable_call_expr().set_function("no_such_function");
+  auto ast = std::make_unique<Ast>(std::move(expr), SourceInfo());
+
+  EXPECT_THAT(cache.GetOrCreateProgram(std::move(ast)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(cache.size(), 0);
+}
+
+}  // namespace
+}  // namespace cel
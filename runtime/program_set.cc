@@ -0,0 +1,469 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/program_set.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "base/builtins.h"
+#include "common/ast.h"
+#include "common/ast_fingerprint.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+namespace {
+
+constexpr absl::string_view kBlock = "cel.@block";
+constexpr absl::string_view kIndexPrefix = "@index";
+
+void ForEachChild(Expr& expr, absl::FunctionRef<void(Expr&)> f) {
+  switch (expr.kind_case()) {
+    case ExprKindCase::kSelectExpr:
+      f(expr.mutable_select_expr().mutable_operand());
+      break;
+    case ExprKindCase::kCallExpr:
+      if (expr.call_expr().has_target()) {
+        f(expr.mutable_call_expr().mutable_target());
+      }
+      for (Expr& arg : expr.mutable_call_expr().mutable_args()) {
+        f(arg);
+      }
+      break;
+    case ExprKindCase::kListExpr:
+      for (ListExprElement& element :
+           expr.mutable_list_expr().mutable_elements()) {
+        f(element.mutable_expr());
+      }
+      break;
+    case ExprKindCase::kStructExpr:
+      for (StructExprField& field :
+           expr.mutable_struct_expr().mutable_fields()) {
+        f(field.mutable_value());
+      }
+      break;
+    case ExprKindCase::kMapExpr:
+      for (MapExprEntry& entry : expr.mutable_map_expr().mutable_entries()) {
+        f(entry.mutable_key());
+        f(entry.mutable_value());
+      }
+      break;
+    case ExprKindCase::kComprehensionExpr: {
+      ComprehensionExpr& comprehension = expr.mutable_comprehension_expr();
+      f(comprehension.mutable_iter_range());
+      f(comprehension.mutable_accu_init());
+      f(comprehension.mutable_loop_condition());
+      f(comprehension.mutable_loop_step());
+      f(comprehension.mutable_result());
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// Length prefixed so that adjacent strings can't run together.
+void AppendString(std::string& key, absl::string_view value) {
+  absl::StrAppend(&key, value.size(), ":", value);
+}
+
+// Merges the checked ASTs of a program set into one `cel.@block` whose
+// bindings are the subexpressions shared between them.
+//
+// Shared subexpressions are found by value numbering: two nodes get the same
+// number if they have the same kind, payload and checker reference and their
+// children have the same numbers. The checker has already rewritten qualified
+// names to identifiers and namespaced functions to global calls, so every
+// remaining select operand and call target is an ordinary value.
+class ProgramSetBuilder {
+ public:
+  absl::Status Add(const Ast& ast);
+
+  std::unique_ptr<Ast> Build();
+
+  size_t shared_subexpression_count() const { return hoisted_.size(); }
+
+ private:
+  struct Number {
+    // Number of eligible occurrences not already covered by a hoisted
+    // ancestor.
+    int count = 0;
+    size_t size = 0;
+    Expr* absl_nullable representative = nullptr;
+  };
+
+  int64_t NextId() { return next_id_++; }
+
+  absl::Status Renumber(Expr& expr,
+                        absl::flat_hash_map<int64_t, int64_t>& ids);
+
+  // Assigns value numbers to `expr` and its descendants. `shareable` is false
+  // for subtrees that may be evaluated more than once, or not as an ordinary
+  // expression, per evaluation of their program.
+  int AssignNumbers(Expr& expr, bool shareable);
+
+  void SelectShared();
+
+  void ReleaseDescendants(Expr& expr, int occurrences);
+
+  void Rewrite(Expr& expr);
+
+  void CollectIds(Expr& expr, absl::flat_hash_set<int64_t>& ids);
+
+  std::vector<Expr> roots_;
+  Ast::ReferenceMap reference_map_;
+  Ast::TypeMap type_map_;
+  std::string expr_version_;
+  int64_t next_id_ = 1;
+
+  absl::flat_hash_map<std::string, int> numbers_by_key_;
+  std::vector<Number> numbers_;
+  absl::flat_hash_map<int64_t, int> node_numbers_;
+  absl::flat_hash_set<int64_t> eligible_;
+  absl::flat_hash_set<int> hoisted_;
+  absl::flat_hash_map<int, size_t> slots_;
+  std::vector<Expr> bindings_;
+};
+
+absl::Status ProgramSetBuilder::Add(const Ast& ast) {
+  if (!ast.is_checked()) {
+    return absl::InvalidArgumentError("ProgramSet requires checked ASTs");
+  }
+  Expr root = ast.root_expr();
+  absl::flat_hash_map<int64_t, int64_t> ids;
+  CEL_RETURN_IF_ERROR(Renumber(root, ids));
+  for (const auto& [id, reference] : ast.reference_map()) {
+    if (auto it = ids.find(id); it != ids.end()) {
+      reference_map_.insert({it->second, reference});
+    }
+  }
+  for (const auto& [id, type] : ast.type_map()) {
+    if (auto it = ids.find(id); it != ids.end()) {
+      type_map_.insert({it->second, type});
+    }
+  }
+  if (expr_version_.empty()) {
+    expr_version_ = std::string(ast.expr_version());
+  }
+  roots_.push_back(std::move(root));
+  return absl::OkStatus();
+}
+
+absl::Status ProgramSetBuilder::Renumber(
+    Expr& expr, absl::flat_hash_map<int64_t, int64_t>& ids) {
+  if ((expr.has_call_expr() && expr.call_expr().function() == kBlock) ||
+      (expr.has_ident_expr() &&
+       absl::StartsWith(expr.ident_expr().name(), kIndexPrefix))) {
+    return absl::InvalidArgumentError(
+        "ProgramSet does not support ASTs using cel.@block");
+  }
+  const int64_t id = NextId();
+  ids.insert({expr.id(), id});
+  expr.set_id(id);
+  absl::Status status = absl::OkStatus();
+  ForEachChild(expr, [&](Expr& child) {
+    if (status.ok()) {
+      status = Renumber(child, ids);
+    }
+  });
+  return status;
+}
+
+int ProgramSetBuilder::AssignNumbers(Expr& expr, bool shareable) {
+  std::string key;
+  size_t size = 1;
+  auto append_child = [&](Expr& child, bool child_shareable) {
+    const int number = AssignNumbers(child, child_shareable);
+    size += numbers_[number].size;
+    absl::StrAppend(&key, number, ",");
+  };
+  const Reference* reference = nullptr;
+  if (auto it = reference_map_.find(expr.id()); it != reference_map_.end()) {
+    reference = &it->second;
+  }
+  bool eligible = false;
+  absl::StrAppend(&key, static_cast<int>(expr.kind_case()), "|");
+  switch (expr.kind_case()) {
+    case ExprKindCase::kConstant:
+      AppendString(key, ConstantFingerprint(expr.const_expr()));
+      break;
+    case ExprKindCase::kIdentExpr:
+      AppendString(key, expr.ident_expr().name());
+      break;
+    case ExprKindCase::kSelectExpr:
+      AppendString(key, expr.select_expr().field());
+      absl::StrAppend(&key, expr.select_expr().test_only() ? "t" : "f");
+      append_child(expr.mutable_select_expr().mutable_operand(), shareable);
+      eligible = true;
+      break;
+    case ExprKindCase::kCallExpr: {
+      CallExpr& call = expr.mutable_call_expr();
+      AppendString(key, call.function());
+      if (call.has_target()) {
+        absl::StrAppend(&key, "t");
+        append_child(call.mutable_target(), shareable);
+      }
+      for (Expr& arg : call.mutable_args()) {
+        append_child(arg, shareable);
+      }
+      eligible = true;
+      break;
+    }
+    case ExprKindCase::kListExpr:
+      for (ListExprElement& element :
+           expr.mutable_list_expr().mutable_elements()) {
+        absl::StrAppend(&key, element.optional() ? "?" : "");
+        append_child(element.mutable_expr(), shareable);
+      }
+      eligible = !expr.list_expr().elements().empty();
+      break;
+    case ExprKindCase::kStructExpr:
+      AppendString(key, expr.struct_expr().name());
+      for (StructExprField& field :
+           expr.mutable_struct_expr().mutable_fields()) {
+        AppendString(key, field.name());
+        absl::StrAppend(&key, field.optional() ? "?" : "");
+        append_child(field.mutable_value(), shareable);
+      }
+      eligible = !expr.struct_expr().fields().empty();
+      break;
+    case ExprKindCase::kMapExpr:
+      for (MapExprEntry& entry : expr.mutable_map_expr().mutable_entries()) {
+        absl::StrAppend(&key, entry.optional() ? "?" : "");
+        append_child(entry.mutable_key(), shareable);
+        append_child(entry.mutable_value(), shareable);
+      }
+      eligible = !expr.map_expr().entries().empty();
+      break;
+    case ExprKindCase::kComprehensionExpr: {
+      ComprehensionExpr& comprehension = expr.mutable_comprehension_expr();
+      AppendString(key, comprehension.iter_var());
+      AppendString(key, comprehension.iter_var2());
+      AppendString(key, comprehension.accu_var());
+      append_child(comprehension.mutable_iter_range(), shareable);
+      // The accumulator initializer is kept in place so that the planner
+      // still recognizes the shape of macros like cel.bind.
+      append_child(comprehension.mutable_accu_init(), false);
+      append_child(comprehension.mutable_loop_condition(), false);
+      append_child(comprehension.mutable_loop_step(), false);
+      append_child(comprehension.mutable_result(), false);
+      eligible = true;
+      break;
+    }
+    default:
+      break;
+  }
+  if (reference != nullptr) {
+    absl::StrAppend(&key, "|");
+    AppendString(key, reference->name());
+    for (const std::string& overload_id : reference->overload_id()) {
+      AppendString(key, overload_id);
+    }
+    if (reference->has_value()) {
+      AppendString(key, ConstantFingerprint(reference->value()));
+    }
+  }
+
+  auto [it, inserted] = numbers_by_key_.insert({key, numbers_.size()});
+  if (inserted) {
+    numbers_.push_back(Number{0, size, nullptr});
+  }
+  const int number = it->second;
+  node_numbers_.insert({expr.id(), number});
+  if (shareable && eligible) {
+    eligible_.insert(expr.id());
+    Number& info = numbers_[number];
+    ++info.count;
+    if (info.representative == nullptr) {
+      info.representative = &expr;
+    }
+  }
+  return number;
+}
+
+// Hoists the largest repeated subexpressions first. Once a subexpression is
+// hoisted, the occurrences of its descendants in the other copies disappear,
+// so a descendant is only hoisted on its own if it also occurs elsewhere.
+void ProgramSetBuilder::SelectShared() {
+  std::vector<int> candidates;
+  for (int number = 0; number < static_cast<int>(numbers_.size()); ++number) {
+    if (numbers_[number].count >= 2) {
+      candidates.push_back(number);
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+    return numbers_[a].size > numbers_[b].size;
+  });
+  for (int number : candidates) {
+    const Number& info = numbers_[number];
+    if (info.count < 2) {
+      continue;
+    }
+    hoisted_.insert(number);
+    ForEachChild(*info.representative, [&](Expr& child) {
+      ReleaseDescendants(child, info.count - 1);
+    });
+  }
+}
+
+void ProgramSetBuilder::ReleaseDescendants(Expr& expr, int occurrences) {
+  if (eligible_.contains(expr.id())) {
+    numbers_[node_numbers_[expr.id()]].count -= occurrences;
+  }
+  ForEachChild(expr,
+               [&](Expr& child) { ReleaseDescendants(child, occurrences); });
+}
+
+// Replaces hoisted subexpressions with references to their binding. Bindings
+// are appended after the bindings they reference, as `cel.@block` requires.
+void ProgramSetBuilder::Rewrite(Expr& expr) {
+  if (!eligible_.contains(expr.id())) {
+    ForEachChild(expr, [&](Expr& child) { Rewrite(child); });
+    return;
+  }
+  const int number = node_numbers_[expr.id()];
+  if (!hoisted_.contains(number)) {
+    ForEachChild(expr, [&](Expr& child) { Rewrite(child); });
+    return;
+  }
+  const int64_t original_id = expr.id();
+  size_t slot;
+  if (auto it = slots_.find(number); it != slots_.end()) {
+    slot = it->second;
+  } else {
+    Expr binding = std::move(expr);
+    ForEachChild(binding, [&](Expr& child) { Rewrite(child); });
+    slot = bindings_.size();
+    bindings_.push_back(std::move(binding));
+    slots_.insert({number, slot});
+  }
+  expr.Clear();
+  expr.set_id(NextId());
+  expr.mutable_ident_expr().set_name(absl::StrCat(kIndexPrefix, slot));
+  if (auto it = type_map_.find(original_id); it != type_map_.end()) {
+    TypeSpec type = it->second;
+    type_map_.insert({expr.id(), std::move(type)});
+  }
+}
+
+void ProgramSetBuilder::CollectIds(Expr& expr,
+                                   absl::flat_hash_set<int64_t>& ids) {
+  ids.insert(expr.id());
+  ForEachChild(expr, [&](Expr& child) { CollectIds(child, ids); });
+}
+
+std::unique_ptr<Ast> ProgramSetBuilder::Build() {
+  for (Expr& root : roots_) {
+    AssignNumbers(root, /*shareable=*/true);
+  }
+  SelectShared();
+  for (Expr& root : roots_) {
+    Rewrite(root);
+  }
+
+  Expr results;
+  results.set_id(NextId());
+  results.mutable_call_expr().set_function(builtin::kRuntimeCollectResults);
+  results.mutable_call_expr().set_args(std::move(roots_));
+
+  Expr root;
+  if (bindings_.empty()) {
+    root = std::move(results);
+  } else {
+    root.set_id(NextId());
+    CallExpr& block = root.mutable_call_expr();
+    block.set_function(kBlock);
+    Expr& list = block.add_args();
+    list.set_id(NextId());
+    for (Expr& binding : bindings_) {
+      list.mutable_list_expr().add_elements().set_expr(std::move(binding));
+    }
+    block.add_args() = std::move(results);
+  }
+
+  absl::flat_hash_set<int64_t> ids;
+  CollectIds(root, ids);
+  absl::erase_if(reference_map_,
+                 [&](const auto& entry) { return !ids.contains(entry.first); });
+  absl::erase_if(type_map_,
+                 [&](const auto& entry) { return !ids.contains(entry.first); });
+
+  auto ast = std::make_unique<Ast>(std::move(root), SourceInfo(),
+                                   std::move(reference_map_),
+                                   std::move(type_map_), expr_version_);
+  ast->set_is_checked(true);
+  return ast;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<ProgramSet>> ProgramSet::Create(
+    const Runtime& runtime, std::vector<std::unique_ptr<Ast>> asts) {
+  if (asts.empty()) {
+    return absl::InvalidArgumentError("ProgramSet requires at least one AST");
+  }
+  ProgramSetBuilder builder;
+  for (const std::unique_ptr<Ast>& ast : asts) {
+    CEL_RETURN_IF_ERROR(builder.Add(*ast));
+  }
+  const size_t size = asts.size();
+  asts.clear();
+  std::unique_ptr<Ast> combined = builder.Build();
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                       runtime.CreateProgram(std::move(combined)));
+  return absl::WrapUnique(new ProgramSet(runtime, std::move(program), size,
+                                         builder.shared_subexpression_count()));
+}
+
+absl::StatusOr<std::vector<Value>> ProgramSet::Evaluate(
+    const ActivationInterface& activation,
+    google::protobuf::Arena* absl_nonnull arena) const {
+  CEL_ASSIGN_OR_RETURN(Value results, program_->Evaluate(arena, activation));
+  if (!results.IsList()) {
+    return absl::InternalError(
+        absl::StrCat("unexpected ProgramSet result: ", results.DebugString()));
+  }
+  const ListValue list = results.GetList();
+  std::vector<Value> values(size_);
+  for (size_t i = 0; i < size_; ++i) {
+    CEL_RETURN_IF_ERROR(list.Get(i, runtime_.GetDescriptorPool(),
+                                 runtime_.GetMessageFactory(), arena,
+                                 &values[i]));
+  }
+  return values;
+}
+
+}  // namespace cel
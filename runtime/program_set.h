@@ -0,0 +1,97 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_PROGRAM_SET_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_PROGRAM_SET_H_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "common/ast.h"
+#include "common/value.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+// Evaluates a group of checked expressions against a single activation as one
+// program.
+//
+// Subexpressions that occur more than once across the group, or more than once
+// within one expression, are hoisted into shared bindings of a `cel.@block`
+// and evaluated at most once per evaluation. Bindings are lazily initialized,
+// so a shared subexpression is only evaluated if some expression reaches it,
+// and each expression observes the same value, error or unknown it would if
+// evaluated on its own.
+//
+// Only subexpressions evaluated at most once per evaluation of their enclosing
+// expression are shared: nothing inside a comprehension loop condition, loop
+// step or result is hoisted.
+//
+// Thread safe. The runtime must outlive the set.
+class ProgramSet {
+ public:
+  // Plans `asts` together. The ASTs must be checked and must not already use
+  // `cel.@block`.
+  static absl::StatusOr<std::unique_ptr<ProgramSet>> Create(
+      const Runtime& runtime ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      std::vector<std::unique_ptr<Ast>> asts);
+
+  ProgramSet(const ProgramSet&) = delete;
+  ProgramSet& operator=(const ProgramSet&) = delete;
+
+  // Returns the result of each expression, in the order they were given.
+  //
+  // Each expression observes the same result it would if evaluated on its
+  // own: CEL errors and unknowns are returned per expression, each expression
+  // gets its own `comprehension_max_iterations` budget, and a non-OK status
+  // raised while evaluating an expression, such as from a failing function
+  // implementation or an exceeded iteration budget, is returned as an error
+  // value for that expression only. A shared subexpression is only charged to
+  // the budget of the expression that first evaluates it.
+  absl::StatusOr<std::vector<Value>> Evaluate(
+      const ActivationInterface& activation,
+      google::protobuf::Arena* absl_nonnull arena) const;
+
+  // Number of expressions in the set.
+  size_t size() const { return size_; }
+
+  // Number of distinct subexpressions shared between or within expressions.
+  size_t shared_subexpression_count() const {
+    return shared_subexpression_count_;
+  }
+
+ private:
+  ProgramSet(const Runtime& runtime, std::unique_ptr<Program> program,
+             size_t size, size_t shared_subexpression_count)
+      : runtime_(runtime),
+        program_(std::move(program)),
+        size_(size),
+        shared_subexpression_count_(shared_subexpression_count) {}
+
+  const Runtime& runtime_;
+  std::unique_ptr<Program> program_;
+  size_t size_;
+  size_t shared_subexpression_count_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_PROGRAM_SET_H_
@@ -0,0 +1,187 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/program_set.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/source.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "compiler/compiler.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "parser/parser_interface.h"
+#include "runtime/activation.h"
+#include "runtime/internal/standard_env_testing.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+class ProgramSetTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(
+        compiler_,
+        runtime_internal::NewTestingCompiler(
+            {MakeVariableDecl("claims", MapType(StringType(), StringType())),
+             MakeVariableDecl("size", IntType())}));
+    ASSERT_OK_AND_ASSIGN(runtime_, runtime_internal::NewTestingRuntime());
+  }
+
+  absl::StatusOr<std::unique_ptr<Ast>> Compile(absl::string_view expr) {
+    return runtime_internal::CompileForTesting(*compiler_, expr);
+  }
+
+  absl::StatusOr<std::unique_ptr<ProgramSet>> CreateSet(
+      const std::vector<absl::string_view>& exprs) {
+    std::vector<std::unique_ptr<Ast>> asts;
+    for (absl::string_view expr : exprs) {
+      CEL_ASSIGN_OR_RETURN(asts.emplace_back(), Compile(expr));
+    }
+    return ProgramSet::Create(*runtime_, std::move(asts));
+  }
+
+  absl::StatusOr<Value> EvaluateAlone(absl::string_view expr,
+                                      const Activation& activation) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, Compile(expr));
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                         runtime_->CreateProgram(std::move(ast)));
+    return program->Evaluate(&arena_, activation);
+  }
+
+  std::unique_ptr<Compiler> compiler_;
+  std::unique_ptr<Runtime> runtime_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(ProgramSetTest, SharesSubexpressions) {
+  const std::vector<absl::string_view> exprs = {
+      "claims.sub.startsWith('user:') && size > 10",
+      "claims.sub.startsWith('user:') || claims.sub == 'admin'",
+      "size(claims.sub) + size > 0",
+      "[1, 2, 3].all(x, x < size) && size * 2 > 4",
+  };
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<ProgramSet> set, CreateSet(exprs));
+  EXPECT_EQ(set->size(), 4);
+  // claims.sub.startsWith('user:') and claims.sub.
+  EXPECT_EQ(set->shared_subexpression_count(), 2);
+
+  Activation activation;
+  auto claims = NewMapValueBuilder(&arena_);
+  ASSERT_THAT(claims->Put(StringValue("sub"), StringValue("user:alice")),
+              IsOk());
+  activation.InsertOrAssignValue("claims", std::move(*claims).Build());
+  activation.InsertOrAssignValue("size", IntValue(20));
+  ASSERT_OK_AND_ASSIGN(std::vector<Value> results,
+                       set->Evaluate(activation, &arena_));
+  ASSERT_THAT(results, SizeIs(exprs.size()));
+  for (size_t i = 0; i < exprs.size(); ++i) {
+    ASSERT_OK_AND_ASSIGN(Value expected, EvaluateAlone(exprs[i], activation));
+    EXPECT_EQ(results[i].DebugString(), expected.DebugString()) << exprs[i];
+  }
+}
+
+TEST_F(ProgramSetTest, ReportsErrorsPerProgram) {
+  const std::vector<absl::string_view> exprs = {
+      "10 / size > 1",
+      "size == 0 || 10 / size > 1",
+      "size + 1",
+  };
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<ProgramSet> set, CreateSet(exprs));
+
+  Activation activation;
+  activation.InsertOrAssignValue("size", IntValue(0));
+  ASSERT_OK_AND_ASSIGN(std::vector<Value> results,
+                       set->Evaluate(activation, &arena_));
+  ASSERT_THAT(results, SizeIs(3));
+  ASSERT_TRUE(results[0].IsError());
+  EXPECT_THAT(results[0].GetError().ToStatus(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_TRUE(results[1].IsTrue());
+  EXPECT_EQ(results[2].GetInt().NativeValue(), 1);
+}
+
+TEST_F(ProgramSetTest, BudgetsIterationsPerProgram) {
+  const std::vector<absl::string_view> exprs = {
+      "[1, 2, 3, 4, 5, 6].all(x, x > 0)",
+      "[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10].exists(x, x == size)",
+      "[1, 2, 3, 4, 5, 6].exists(x, x == 6)",
+      "size > 0 && [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10].exists(x, x == size)",
+      "size + 1",
+  };
+  Activation activation;
+  activation.InsertOrAssignValue("size", IntValue(20));
+
+  for (int max_recursion_depth : {0, -1}) {
+    SCOPED_TRACE(max_recursion_depth);
+    RuntimeOptions options;
+    options.comprehension_max_iterations = 10;
+    options.max_recursion_depth = max_recursion_depth;
+    ASSERT_OK_AND_ASSIGN(runtime_,
+                         runtime_internal::NewTestingRuntime(options));
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<ProgramSet> set, CreateSet(exprs));
+
+    // Together the expressions exceed the budget. On their own, only the
+    // second and fourth do.
+    ASSERT_OK_AND_ASSIGN(std::vector<Value> results,
+                         set->Evaluate(activation, &arena_));
+    ASSERT_THAT(results, SizeIs(exprs.size()));
+    EXPECT_TRUE(results[0].IsTrue());
+    ASSERT_TRUE(results[1].IsError());
+    EXPECT_THAT(results[1].GetError().ToStatus(),
+                StatusIs(absl::StatusCode::kInternal,
+                         HasSubstr("Iteration budget exceeded")));
+    EXPECT_THAT(EvaluateAlone(exprs[1], activation),
+                StatusIs(absl::StatusCode::kInternal,
+                         HasSubstr("Iteration budget exceeded")));
+    EXPECT_TRUE(results[2].IsTrue());
+    ASSERT_TRUE(results[3].IsError());
+    EXPECT_THAT(results[3].GetError().ToStatus(),
+                StatusIs(absl::StatusCode::kInternal,
+                         HasSubstr("Iteration budget exceeded")));
+    EXPECT_EQ(results[4].GetInt().NativeValue(), 21);
+  }
+}
+
+TEST_F(ProgramSetTest, RejectsUncheckedAsts) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Source> source,
+                       compiler_->GetParser().PrepareSource("1 + 2"));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast,
+                       compiler_->GetParser().Parse(*source));
+  std::vector<std::unique_ptr<Ast>> asts;
+  asts.push_back(std::move(ast));
+  EXPECT_THAT(ProgramSet::Create(*runtime_, std::move(asts)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,290 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/rule_index.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "base/builtins.h"
+#include "common/ast.h"
+#include "common/ast_fingerprint.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+namespace {
+
+// Guard literals and attribute values are normalized to a common key so that
+// numerically equal int, uint and double values compare equal, matching
+// heterogeneous equality. Producing extra candidates is harmless since the
+// rule itself is still evaluated.
+std::string IntKey(int64_t value) { return absl::StrCat("i", value); }
+
+std::string UintKey(uint64_t value) {
+  if (value <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+    return IntKey(static_cast<int64_t>(value));
+  }
+  return absl::StrCat("u", value);
+}
+
+absl::optional<std::string> LiteralKey(const Constant& constant) {
+  switch (constant.kind_case()) {
+    case ConstantKindCase::kBool:
+      return constant.bool_value() ? "b1" : "b0";
+    case ConstantKindCase::kInt:
+      return IntKey(constant.int_value());
+    case ConstantKindCase::kUint:
+      return UintKey(constant.uint_value());
+    case ConstantKindCase::kString:
+      return absl::StrCat("s", constant.string_value());
+    default:
+      return absl::nullopt;
+  }
+}
+
+absl::optional<std::string> ValueKey(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kBool:
+      return value.GetBool().NativeValue() ? "b1" : "b0";
+    case ValueKind::kInt:
+      return IntKey(value.GetInt().NativeValue());
+    case ValueKind::kUint:
+      return UintKey(value.GetUint().NativeValue());
+    case ValueKind::kDouble: {
+      double number = value.GetDouble().NativeValue();
+      if (std::trunc(number) != number) {
+        return absl::nullopt;
+      }
+      if (number >= -0x1p63 && number < 0x1p63) {
+        return IntKey(static_cast<int64_t>(number));
+      }
+      if (number >= 0 && number < 0x1p64) {
+        return UintKey(static_cast<uint64_t>(number));
+      }
+      return absl::nullopt;
+    }
+    case ValueKind::kString:
+      return absl::StrCat("s", value.GetString().ToString());
+    default:
+      return absl::nullopt;
+  }
+}
+
+// Appends the operands of the top-level conjunction.
+void CollectConjuncts(const Expr& expr, std::vector<const Expr*>& conjuncts) {
+  if (expr.has_call_expr() && !expr.call_expr().has_target() &&
+      expr.call_expr().function() == builtin::kAnd &&
+      expr.call_expr().args().size() == 2) {
+    CollectConjuncts(expr.call_expr().args()[0], conjuncts);
+    CollectConjuncts(expr.call_expr().args()[1], conjuncts);
+    return;
+  }
+  conjuncts.push_back(&expr);
+}
+
+// Returns true for a variable or a chain of field selections on a variable.
+bool IsAttributePath(const Expr& expr) {
+  const Expr* current = &expr;
+  while (current->has_select_expr()) {
+    if (current->select_expr().test_only()) {
+      return false;
+    }
+    current = &current->select_expr().operand();
+  }
+  return current->has_ident_expr();
+}
+
+absl::optional<std::string> ConstantKey(const Expr& expr) {
+  if (!expr.has_const_expr()) {
+    return absl::nullopt;
+  }
+  return LiteralKey(expr.const_expr());
+}
+
+struct Guard {
+  const Expr* absl_nonnull attribute;
+  std::vector<std::string> keys;
+};
+
+absl::optional<Guard> AsGuard(const Expr& expr) {
+  if (!expr.has_call_expr() || expr.call_expr().has_target() ||
+      expr.call_expr().args().size() != 2) {
+    return absl::nullopt;
+  }
+  const CallExpr& call = expr.call_expr();
+  const Expr& lhs = call.args()[0];
+  const Expr& rhs = call.args()[1];
+  if (call.function() == builtin::kEqual) {
+    if (IsAttributePath(lhs)) {
+      if (absl::optional<std::string> key = ConstantKey(rhs); key) {
+        return Guard{&lhs, {*std::move(key)}};
+      }
+    }
+    if (IsAttributePath(rhs)) {
+      if (absl::optional<std::string> key = ConstantKey(lhs); key) {
+        return Guard{&rhs, {*std::move(key)}};
+      }
+    }
+    return absl::nullopt;
+  }
+  if ((call.function() == builtin::kIn ||
+       call.function() == builtin::kInDeprecated ||
+       call.function() == builtin::kInFunction) &&
+      IsAttributePath(lhs) && rhs.has_list_expr()) {
+    Guard guard{&lhs, {}};
+    for (const ListExprElement& element : rhs.list_expr().elements()) {
+      absl::optional<std::string> key = ConstantKey(element.expr());
+      if (element.optional() || !key) {
+        return absl::nullopt;
+      }
+      guard.keys.push_back(*std::move(key));
+    }
+    return guard;
+  }
+  return absl::nullopt;
+}
+
+absl::optional<Guard> FindGuard(const Expr& root) {
+  std::vector<const Expr*> conjuncts;
+  CollectConjuncts(root, conjuncts);
+  for (const Expr* conjunct : conjuncts) {
+    if (absl::optional<Guard> guard = AsGuard(*conjunct); guard) {
+      return guard;
+    }
+  }
+  return absl::nullopt;
+}
+
+// Returns an AST for the attribute path, carrying over its checker metadata.
+std::unique_ptr<Ast> MakeAttributeAst(const Ast& ast, const Expr& attribute) {
+  Ast::ReferenceMap reference_map;
+  Ast::TypeMap type_map;
+  const Expr* current = &attribute;
+  while (true) {
+    if (const Reference* reference = ast.GetReference(current->id());
+        reference != nullptr) {
+      reference_map.insert({current->id(), *reference});
+    }
+    if (auto it = ast.type_map().find(current->id());
+        it != ast.type_map().end()) {
+      type_map.insert(*it);
+    }
+    if (!current->has_select_expr()) {
+      break;
+    }
+    current = &current->select_expr().operand();
+  }
+  auto attribute_ast = std::make_unique<Ast>(
+      attribute, SourceInfo(), std::move(reference_map), std::move(type_map),
+      std::string(ast.expr_version()));
+  attribute_ast->set_is_checked(ast.is_checked());
+  return attribute_ast;
+}
+
+}  // namespace
+
+absl::Status RuleIndex::AddRule(std::string id, std::unique_ptr<Ast> ast) {
+  absl::optional<Guard> guard = FindGuard(ast->root_expr());
+
+  std::unique_ptr<Program> attribute_program;
+  size_t attribute = attributes_.size();
+  std::string fingerprint;
+  if (guard.has_value()) {
+    std::unique_ptr<Ast> attribute_ast =
+        MakeAttributeAst(*ast, *guard->attribute);
+    fingerprint = StructuralFingerprint(*attribute_ast);
+    if (auto it = attribute_index_.find(fingerprint);
+        it != attribute_index_.end()) {
+      attribute = it->second;
+    } else {
+      CEL_ASSIGN_OR_RETURN(attribute_program,
+                           runtime_.CreateProgram(std::move(attribute_ast)));
+    }
+  }
+
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                       runtime_.CreateProgram(std::move(ast)));
+
+  const size_t rule = rules_.size();
+  rules_.push_back(Rule{std::move(id), std::move(program), guard.has_value()});
+  if (!guard.has_value()) {
+    return absl::OkStatus();
+  }
+  if (attribute_program != nullptr) {
+    attributes_.push_back(Attribute{std::move(attribute_program), {}});
+    attribute_index_.insert({std::move(fingerprint), attribute});
+  }
+  for (std::string& key : guard->keys) {
+    attributes_[attribute].rules[std::move(key)].push_back(rule);
+  }
+  ++indexed_rule_count_;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<RuleIndexResult> RuleIndex::Evaluate(
+    const ActivationInterface& activation,
+    google::protobuf::Arena* absl_nonnull arena) const {
+  std::vector<bool> candidates(rules_.size(), false);
+  for (const Attribute& attribute : attributes_) {
+    CEL_ASSIGN_OR_RETURN(Value value,
+                         attribute.program->Evaluate(arena, activation));
+    // Errors, unknowns and values that can't equal a guard literal leave the
+    // guarded rules unselected.
+    absl::optional<std::string> key = ValueKey(value);
+    if (!key.has_value()) {
+      continue;
+    }
+    if (auto it = attribute.rules.find(*key); it != attribute.rules.end()) {
+      for (size_t rule : it->second) {
+        candidates[rule] = true;
+      }
+    }
+  }
+
+  RuleIndexResult result;
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    const Rule& rule = rules_[i];
+    if (rule.indexed && !candidates[i]) {
+      continue;
+    }
+    CEL_ASSIGN_OR_RETURN(Value value, rule.program->Evaluate(arena, activation));
+    if (value.IsTrue()) {
+      result.matched.push_back(rule.id);
+    } else if (value.IsError()) {
+      result.errors.push_back({rule.id, value.GetError().ToStatus()});
+    }
+  }
+  return result;
+}
+
+}  // namespace cel
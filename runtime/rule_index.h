@@ -0,0 +1,112 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RULE_INDEX_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_RULE_INDEX_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+struct RuleIndexResult {
+  // Ids of the rules that evaluated to true, in the order they were added.
+  std::vector<absl::string_view> matched;
+
+  // Ids of the evaluated rules that produced an error, with the error. Rules
+  // skipped by the index are not reported, even if evaluating them would have
+  // produced an error.
+  std::vector<std::pair<absl::string_view, absl::Status>> errors;
+};
+
+// Evaluates a set of independent boolean rules against a single activation,
+// skipping rules that are guarded by an attribute comparison that can't
+// match.
+//
+// When a rule is added, the top-level conjunction of its expression is
+// searched for a guard of the form `attr == <literal>`, `<literal> == attr`
+// or `attr in [<literal>, ...]`, where `attr` is a variable or a field
+// selection path and the literals are bool, int, uint or string constants.
+// Rules with a guard are indexed by the guard's attribute and literals. At
+// evaluation time each distinct guard attribute is evaluated once, and only
+// the rules indexed under its value are evaluated, along with all rules that
+// have no indexable guard.
+//
+// Skipping is exact: a rule whose guard is false, an error or unknown can
+// never evaluate to true, since `false && x` is false and an error or unknown
+// conjunct otherwise propagates.
+//
+// Thread compatible. Rules must not be added concurrently with evaluation. The
+// runtime must outlive the index.
+class RuleIndex {
+ public:
+  explicit RuleIndex(const Runtime& runtime ABSL_ATTRIBUTE_LIFETIME_BOUND)
+      : runtime_(runtime) {}
+
+  RuleIndex(const RuleIndex&) = delete;
+  RuleIndex& operator=(const RuleIndex&) = delete;
+
+  // Plans and adds a rule. `ast` should evaluate to a bool.
+  absl::Status AddRule(std::string id, std::unique_ptr<Ast> ast);
+
+  absl::StatusOr<RuleIndexResult> Evaluate(
+      const ActivationInterface& activation,
+      google::protobuf::Arena* absl_nonnull arena) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
+
+  size_t rule_count() const { return rules_.size(); }
+
+  // Number of rules with an indexable guard.
+  size_t indexed_rule_count() const { return indexed_rule_count_; }
+
+ private:
+  struct Rule {
+    std::string id;
+    std::unique_ptr<Program> program;
+    bool indexed = false;
+  };
+
+  // A guard attribute shared by one or more rules.
+  struct Attribute {
+    std::unique_ptr<Program> program;
+    // Rule indices keyed by the normalized guard literal.
+    absl::flat_hash_map<std::string, std::vector<size_t>> rules;
+  };
+
+  const Runtime& runtime_;
+  std::vector<Rule> rules_;
+  std::vector<Attribute> attributes_;
+  // Attribute indices keyed by the structural fingerprint of the attribute
+  // expression.
+  absl::flat_hash_map<std::string, size_t> attribute_index_;
+  size_t indexed_rule_count_ = 0;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_RULE_INDEX_H_
@@ -0,0 +1,138 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/rule_index.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "compiler/compiler.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/internal/standard_env_testing.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+
+class RuleIndexTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(compiler_,
+                         runtime_internal::NewTestingCompiler(
+                             {MakeVariableDecl("kind", StringType()),
+                              MakeVariableDecl("region", StringType()),
+                              MakeVariableDecl("size", IntType())}));
+    ASSERT_OK_AND_ASSIGN(runtime_, runtime_internal::NewTestingRuntime());
+  }
+
+  absl::StatusOr<std::unique_ptr<Ast>> Compile(absl::string_view expr) {
+    return runtime_internal::CompileForTesting(*compiler_, expr);
+  }
+
+  absl::Status AddRule(RuleIndex& index, absl::string_view id,
+                       absl::string_view expr) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, Compile(expr));
+    return index.AddRule(std::string(id), std::move(ast));
+  }
+
+  std::unique_ptr<Compiler> compiler_;
+  std::unique_ptr<Runtime> runtime_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(RuleIndexTest, IndexesGuards) {
+  RuleIndex index(*runtime_);
+  ASSERT_THAT(AddRule(index, "bucket", "kind == 'bucket' && size > 10"),
+              IsOk());
+  ASSERT_THAT(AddRule(index, "object", "kind == 'object' && size > 10"),
+              IsOk());
+  ASSERT_THAT(AddRule(index, "bucket_region",
+                      "size > 0 && 'bucket' == kind && region == 'us'"),
+              IsOk());
+  ASSERT_THAT(AddRule(index, "region", "region in ['us', 'eu'] && size > 0"),
+              IsOk());
+  ASSERT_THAT(AddRule(index, "size", "size == 20"), IsOk());
+  ASSERT_THAT(AddRule(index, "large", "size > 100 || kind == 'bucket'"),
+              IsOk());
+  EXPECT_EQ(index.rule_count(), 6);
+  EXPECT_EQ(index.indexed_rule_count(), 5);
+
+  Activation activation;
+  activation.InsertOrAssignValue("kind", StringValue("bucket"));
+  activation.InsertOrAssignValue("region", StringValue("eu"));
+  activation.InsertOrAssignValue("size", IntValue(20));
+  ASSERT_OK_AND_ASSIGN(RuleIndexResult result,
+                       index.Evaluate(activation, &arena_));
+  EXPECT_THAT(result.matched,
+              ElementsAre("bucket", "region", "size", "large"));
+  EXPECT_THAT(result.errors, IsEmpty());
+
+  activation.InsertOrAssignValue("kind", StringValue("object"));
+  activation.InsertOrAssignValue("region", StringValue("us"));
+  ASSERT_OK_AND_ASSIGN(result, index.Evaluate(activation, &arena_));
+  EXPECT_THAT(result.matched, ElementsAre("object", "region", "size"));
+}
+
+TEST_F(RuleIndexTest, ReportsErrorsFromEvaluatedRules) {
+  RuleIndex index(*runtime_);
+  ASSERT_THAT(AddRule(index, "div", "kind == 'bucket' && 10 / size > 1"),
+              IsOk());
+  ASSERT_THAT(AddRule(index, "skipped", "kind == 'object' && 10 / size > 1"),
+              IsOk());
+
+  Activation activation;
+  activation.InsertOrAssignValue("kind", StringValue("bucket"));
+  activation.InsertOrAssignValue("size", IntValue(0));
+  ASSERT_OK_AND_ASSIGN(RuleIndexResult result,
+                       index.Evaluate(activation, &arena_));
+  EXPECT_THAT(result.matched, IsEmpty());
+  EXPECT_THAT(result.errors,
+              ElementsAre(Pair(
+                  "div", StatusIs(absl::StatusCode::kInvalidArgument))));
+}
+
+TEST_F(RuleIndexTest, MissingGuardAttributeSkipsRules) {
+  RuleIndex index(*runtime_);
+  ASSERT_THAT(AddRule(index, "bucket", "kind == 'bucket' && size > 10"),
+              IsOk());
+  ASSERT_THAT(AddRule(index, "size", "size > 10"), IsOk());
+
+  Activation activation;
+  activation.InsertOrAssignValue("size", IntValue(20));
+  ASSERT_OK_AND_ASSIGN(RuleIndexResult result,
+                       index.Evaluate(activation, &arena_));
+  EXPECT_THAT(result.matched, ElementsAre("size"));
+  EXPECT_THAT(result.errors, IsEmpty());
+}
+
+}  // namespace
+}  // namespace cel
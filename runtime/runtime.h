@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -27,6 +28,7 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/native_type.h"
@@ -45,6 +47,15 @@ class RuntimeFriendAccess;
 
 class EmbedderContext;
 
+// Counters for memoized deterministic function calls, see
+// `RuntimeOptions::function_memoization_max_entries`.
+struct FunctionMemoizationStats {
+  // Calls answered from the memoized results.
+  uint64_t hits = 0;
+  // Memoizable calls that invoked the function.
+  uint64_t misses = 0;
+};
+
 // Options for the Program::Evaluate call.
 struct EvaluateOptions {
   // Optional message factory to use for the duration of the Evaluate call.
@@ -55,6 +66,24 @@ struct EvaluateOptions {
   // This is used to access custom data in extension functions.
   // This is only propagated to functions that are marked as context sensitive.
   const EmbedderContext* absl_nullable embedder_context = nullptr;
+
+  // Optional counters incremented with the memoization hits and misses of the
+  // Evaluate call.
+  FunctionMemoizationStats* absl_nullable function_memoization_stats = nullptr;
+};
+
+// A variable that a program may read from the activation. See
+// `Program::GetReferencedVariables`.
+struct VariableReference {
+  // The variable name as looked up in the activation, e.g. `request` or
+  // `google.rpc.context` for a qualified name resolved by the type checker.
+  std::string name;
+
+  // Whether the variable is only read on some evaluation paths: every
+  // reference is in a short-circuited operand of `_&&_`, `_||_`, `or` or
+  // `orValue`, in a branch of `_?_:_`, or in the loop condition or step of a
+  // comprehension.
+  bool conditional = false;
 };
 
 // Representation of an evaluable CEL expression.
@@ -100,6 +129,22 @@ class Program {
 
   virtual const TypeProvider& GetTypeProvider() const = 0;
 
+  // Returns the variables the program may read from the activation, in order
+  // of first reference. Variables that are not listed are never looked up, so
+  // callers may skip binding them (see `BindReferencedProtoToActivation`).
+  //
+  // Comprehension variables and `cel.bind` / `cel.@block` locals are not
+  // included. Names that resolve to enum or type constants at plan time are
+  // included, since an activation value of the same name would shadow them.
+  //
+  // Returns an Unimplemented error if the program does not track its
+  // referenced variables.
+  virtual absl::StatusOr<absl::Span<const VariableReference>>
+  GetReferencedVariables() const {
+    return absl::UnimplementedError(
+        "program does not track referenced variables");
+  }
+
  protected:
   virtual absl::StatusOr<Value> EvaluateImpl(
       const ActivationInterface& activation,
@@ -39,6 +39,8 @@ class RuntimeBuilder;
 absl::StatusOr<RuntimeBuilder> CreateRuntimeBuilder(
     absl_nonnull std::shared_ptr<const google::protobuf::DescriptorPool>,
     const RuntimeOptions&);
+absl::StatusOr<RuntimeBuilder> CreateDerivedRuntimeBuilder(
+    absl_nonnull std::shared_ptr<const Runtime>);
 
 // RuntimeBuilder provides mutable accessors to configure a new runtime.
 //
@@ -74,6 +76,8 @@ class RuntimeBuilder {
   friend absl::StatusOr<RuntimeBuilder> CreateRuntimeBuilder(
       absl_nonnull std::shared_ptr<const google::protobuf::DescriptorPool>,
       const RuntimeOptions&);
+  friend absl::StatusOr<RuntimeBuilder> CreateDerivedRuntimeBuilder(
+      absl_nonnull std::shared_ptr<const Runtime>);
 
   // Constructor for a new runtime builder.
   //
@@ -19,18 +19,24 @@
 
 #include "absl/base/nullability.h"
 #include "absl/log/absl_check.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "common/native_type.h"
 #include "internal/noop_delete.h"
 #include "internal/status_macros.h"
 #include "runtime/internal/runtime_env.h"
+#include "runtime/internal/runtime_friend_access.h"
 #include "runtime/internal/runtime_impl.h"
+#include "runtime/runtime.h"
 #include "runtime/runtime_builder.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
 
 namespace cel {
 
 using ::cel::runtime_internal::RuntimeEnv;
+using ::cel::runtime_internal::RuntimeFriendAccess;
 using ::cel::runtime_internal::RuntimeImpl;
 
 absl::StatusOr<RuntimeBuilder> CreateRuntimeBuilder(
@@ -65,4 +71,36 @@ absl::StatusOr<RuntimeBuilder> CreateRuntimeBuilder(
                         std::move(runtime_impl));
 }
 
+absl::StatusOr<RuntimeBuilder> CreateDerivedRuntimeBuilder(
+    absl_nonnull std::shared_ptr<const Runtime> parent) {
+  ABSL_DCHECK(parent != nullptr);
+  if (RuntimeFriendAccess::RuntimeTypeId(*parent) !=
+      NativeTypeId::For<RuntimeImpl>()) {
+    return absl::InvalidArgumentError(
+        "cannot derive from a runtime of an unsupported implementation");
+  }
+  const auto& parent_impl = static_cast<const RuntimeImpl&>(*parent);
+  const RuntimeEnv& parent_environment = parent_impl.environment();
+
+  // The message factory is aliased to the parent runtime, which keeps it (and
+  // the parent's registries) alive.
+  auto environment = std::make_shared<RuntimeEnv>(
+      parent_environment.descriptor_pool,
+      std::shared_ptr<google::protobuf::MessageFactory>(
+          parent, parent_environment.MutableMessageFactory()));
+  CEL_RETURN_IF_ERROR(environment->Initialize());
+  environment->function_registry.SetParent(
+      &parent_environment.function_registry);
+  environment->type_registry.InheritRegistrations(
+      parent_environment.type_registry);
+
+  auto runtime_impl =
+      std::make_unique<RuntimeImpl>(std::move(environment), parent_impl);
+  auto& type_registry = runtime_impl->type_registry();
+  auto& function_registry = runtime_impl->function_registry();
+
+  return RuntimeBuilder(type_registry, function_registry,
+                        std::move(runtime_impl));
+}
+
 }  // namespace cel
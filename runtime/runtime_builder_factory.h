@@ -20,6 +20,7 @@
 #include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
 #include "absl/status/statusor.h"
+#include "runtime/runtime.h"
 #include "runtime/runtime_builder.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/descriptor.h"
@@ -60,6 +61,20 @@ absl::StatusOr<RuntimeBuilder> CreateRuntimeBuilder(
     absl_nonnull std::shared_ptr<const google::protobuf::DescriptorPool> descriptor_pool,
     const RuntimeOptions& options);
 
+// Create a builder for a runtime that extends `parent`.
+//
+// The new runtime shares the descriptor pool, message factory, options and
+// extensions of `parent`, and can call every function registered with it.
+// Functions and types added through the returned builder are layered on top
+// without copying the parent's registrations, so deriving a runtime with a
+// handful of additional functions from a fully configured standard runtime
+// is cheap. The derived runtime keeps `parent` alive.
+//
+// Returns an error if `parent` was not created by one of the builders in this
+// library.
+absl::StatusOr<RuntimeBuilder> CreateDerivedRuntimeBuilder(
+    absl_nonnull std::shared_ptr<const Runtime> parent);
+
 }  // namespace cel
 
 #endif  // THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_BUILDER_FACTORY_H_
@@ -0,0 +1,162 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/runtime_builder_factory.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/options.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/function_adapter.h"
+#include "runtime/optional_types.h"
+#include "runtime/reference_resolver.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::cel::expr::ParsedExpr;
+using ::cel::extensions::ProtobufRuntimeAdapter;
+using ::google::api::expr::parser::Parse;
+using ::google::api::expr::parser::ParserOptions;
+using ::testing::Not;
+
+absl::StatusOr<Value> Evaluate(const Runtime& runtime,
+                               absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(ParsedExpr expr,
+                       Parse(expression, "<input>",
+                             ParserOptions{.enable_optional_syntax = true}));
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(runtime, expr));
+  google::protobuf::Arena arena;
+  Activation activation;
+  CEL_ASSIGN_OR_RETURN(Value result, program->Evaluate(&arena, activation));
+  if (result.IsError()) {
+    return result.GetError().ToStatus();
+  }
+  return result;
+}
+
+absl::StatusOr<std::shared_ptr<const Runtime>> BuildParentRuntime() {
+  RuntimeOptions options;
+  options.enable_qualified_type_identifiers = true;
+  CEL_ASSIGN_OR_RETURN(
+      RuntimeBuilder builder,
+      CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                   options));
+  CEL_RETURN_IF_ERROR(extensions::EnableOptionalTypes(builder));
+  CEL_RETURN_IF_ERROR(
+      EnableReferenceResolver(builder, ReferenceResolverEnabled::kAlways));
+  return std::move(builder).Build();
+}
+
+absl::Status RegisterTenantFunction(RuntimeBuilder& builder) {
+  return UnaryFunctionAdapter<int64_t, int64_t>::RegisterGlobalOverload(
+      "tenant_fn", [](int64_t x) { return x + 1; },
+      builder.function_registry());
+}
+
+TEST(CreateDerivedRuntimeBuilderTest, ExtendsParent) {
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Runtime> parent,
+                       BuildParentRuntime());
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder builder,
+                       CreateDerivedRuntimeBuilder(parent));
+  ASSERT_THAT(RegisterTenantFunction(builder), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<const Runtime> child,
+                       std::move(builder).Build());
+
+  // Standard functions, optional types and the reference resolver are
+  // inherited from the parent.
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      Evaluate(*child, "optional.of(tenant_fn(1)).value() == 2 && "
+                       "[1, 2].exists(x, x == 2)"));
+  EXPECT_TRUE(result.IsTrue());
+
+  // The parent is unaffected.
+  EXPECT_THAT(Evaluate(*parent, "tenant_fn(1) == 2"), Not(IsOk()));
+}
+
+TEST(CreateDerivedRuntimeBuilderTest, KeepsParentAlive) {
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Runtime> parent,
+                       BuildParentRuntime());
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder builder,
+                       CreateDerivedRuntimeBuilder(parent));
+  ASSERT_THAT(RegisterTenantFunction(builder), IsOk());
+  parent.reset();
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<const Runtime> child,
+                       std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate(*child, "tenant_fn(1) + size('ab') == 4"));
+  EXPECT_TRUE(result.IsTrue());
+}
+
+TEST(CreateDerivedRuntimeBuilderTest, DerivesFromDerivedRuntime) {
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Runtime> parent,
+                       BuildParentRuntime());
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder child_builder,
+                       CreateDerivedRuntimeBuilder(parent));
+  ASSERT_THAT(RegisterTenantFunction(child_builder), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Runtime> child,
+                       std::move(child_builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder grandchild_builder,
+                       CreateDerivedRuntimeBuilder(child));
+  ASSERT_THAT(UnaryFunctionAdapter<int64_t, int64_t>::RegisterGlobalOverload(
+                  "twice", [](int64_t x) { return x * 2; },
+                  grandchild_builder.function_registry()),
+              IsOk());
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<const Runtime> grandchild,
+                       std::move(grandchild_builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate(*grandchild, "twice(tenant_fn(1)) == 4"));
+  EXPECT_TRUE(result.IsTrue());
+}
+
+TEST(CreateDerivedRuntimeBuilderTest, RejectsRedefinedOverloads) {
+  ASSERT_OK_AND_ASSIGN(std::shared_ptr<const Runtime> parent,
+                       BuildParentRuntime());
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder builder,
+                       CreateDerivedRuntimeBuilder(parent));
+  EXPECT_THAT(
+      (UnaryFunctionAdapter<int64_t, const StringValue&>::
+           RegisterGlobalOverload(
+               "size", [](const StringValue&) -> int64_t { return 0; },
+               builder.function_registry())),
+      StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+}  // namespace
+}  // namespace cel
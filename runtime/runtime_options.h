@@ -17,7 +17,9 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_OPTIONS_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_OPTIONS_H_
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "absl/base/attributes.h"
 
@@ -43,6 +45,10 @@ enum class ProtoWrapperTypeOptions {
   kUnsetNull,
 };
 
+// Value of `RuntimeOptions::max_recursion_depth` that has the planner choose
+// between recursive and stack machine planning for each subexpression.
+inline constexpr int kAdaptiveRecursionDepth = -2;
+
 // LINT.IfChange
 // Interpreter options for controlling evaluation and builtin functions.
 //
@@ -156,6 +162,10 @@ struct RuntimeOptions {
   // -1 means unbounded.
   // 0 means disabled (using a heap-based stack machine instead), which is the
   // default.
+  // `kAdaptiveRecursionDepth` plans shallow subexpressions recursively and
+  // embeds them in a stack machine program, choosing per subexpression based
+  // on its depth, comprehensions and tracing support. Planning never fails
+  // because of the depth of the expression.
   int max_recursion_depth = 0;
 
   // Enable tracing support for recursively planned programs.
@@ -174,9 +184,18 @@ struct RuntimeOptions {
   // overloads have been added for these functions, and will attempt to use them
   // if they exist.
   //
-  // Currently applies to !_, @not_strictly_false, _==_, _!=_, @in
+  // Currently applies to !_, @not_strictly_false, _==_, _!=_, and @in.
   bool enable_fast_builtins = true;
 
+  // Enable typed implementations for checked calls to standard operators.
+  //
+  // Applies to _+_, _-_, _*_, _<_, _<=_, _>_, _>=_ calls that the type checker
+  // resolved to a single same-typed numeric (or, for comparisons, string,
+  // duration or timestamp) overload. The typed implementation replaces the
+  // registered overload with that signature, so this must stay disabled if
+  // the standard overloads are replaced by custom ones.
+  bool enable_typed_binary_operators = false;
+
   // When enabled, string(double) will format the double with enough precision
   // to ensure that the original double value can be recovered exactly.
   //
@@ -201,6 +220,67 @@ struct RuntimeOptions {
   // not what the planner expected (e.g. a map that was declared as a proto or
   // a different message with matching field names).
   bool enable_typed_field_access = false;
+
+  // When enabled, values produced during evaluation are kept arena resident so
+  // that copying them is a trivial copy without reference count updates.
+  //
+  // The planner allocates constants on the program's arena, and values loaded
+  // from the activation or returned by extension functions that would require
+  // reference counting are copied to the evaluation arena. Each activation
+  // variable is copied once per evaluation, however often it is referenced,
+  // except in comprehensions split across threads (see
+  // `comprehension_parallelism`), which copy it on each reference. Values read
+  // from message fields are not copied, so they may still be reference
+  // counted.
+  //
+  // Evaluation results may then borrow from both the program and the
+  // evaluation arena, so both must outlive all results. Intended for
+  // request-scoped evaluations where that is already the case.
+  bool enable_arena_resident_values = false;
+
+  // Maximum number of results of deterministic function calls memoized per
+  // evaluation. Only functions whose descriptor is marked `is_deterministic`
+  // are memoized, keyed by their scalar argument values.
+  //
+  // 0 disables memoization, which is the default.
+  size_t function_memoization_max_entries = 0;
+
+  // Number of threads used to evaluate a large `all()`, `exists()`, `map()` or
+  // `filter()` over a list. The list is split into chunks that are evaluated
+  // concurrently and merged in order, so results, errors and short-circuiting
+  // match sequential evaluation.
+  //
+  // Only applies to the standard macro shapes whose loop step does not
+  // otherwise read the accumulator. When the program is otherwise planned for
+  // the stack machine (see `max_recursion_depth`), such comprehensions are
+  // planned recursively, unless they reference a cel.bind() or cel.@block()
+  // variable declared outside of them. Evaluation is sequential when unknown
+  // processing is enabled, or when an evaluation listener or embedder context
+  // is supplied.
+  //
+  // Threads are borrowed from a process-wide pool bounded by the hardware
+  // concurrency; the evaluating thread takes part, and evaluates every chunk
+  // itself if no thread is available.
+  //
+  // Extension functions and the activation must support concurrent calls.
+  // Values are allocated concurrently on the evaluation arena.
+  //
+  // 1 disables parallel evaluation, which is the default.
+  int comprehension_parallelism = 1;
+
+  // Minimum list size for parallel comprehension evaluation.
+  int parallel_comprehension_min_size = 16384;
+
+  // When enabled, the values of `google.protobuf.Any` message fields are
+  // memoized for the duration of an evaluation, so that selecting several
+  // fields through the same `Any` unpacks its payload once.
+  bool enable_any_unpack_cache = false;
+
+  // Type URLs of `google.protobuf.Any` payloads that are unpacked when a
+  // message is bound from the activation, rather than on first access, e.g.
+  // "type.googleapis.com/my.pkg.AuditDetails". Only the `Any` fields of the
+  // bound message itself are unpacked. Requires `enable_any_unpack_cache`.
+  std::vector<std::string> eager_any_unpack_type_urls;
 };
 // LINT.ThenChange(//depot/google3/eval/public/cel_options.h)
 
@@ -26,6 +26,8 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "base/builtins.h"
 #include "common/source.h"
@@ -35,6 +37,7 @@
 #include "extensions/protobuf/runtime_adapter.h"
 #include "internal/testing.h"
 #include "parser/macro_registry.h"
+#include "parser/options.h"
 #include "parser/parser.h"
 #include "parser/standard_macros.h"
 #include "runtime/activation.h"
@@ -72,10 +75,17 @@ const cel::MacroRegistry& GetMacros() {
   return *macros;
 }
 
-absl::StatusOr<ParsedExpr> ParseWithTestMacros(absl::string_view expression) {
+absl::StatusOr<ParsedExpr> ParseWithTestMacros(
+    absl::string_view expression,
+    const ParserOptions& options = ParserOptions()) {
   auto src = cel::NewSource(expression, "<input>");
   ABSL_CHECK_OK(src.status());
-  return Parse(**src, GetMacros());
+  return Parse(**src, GetMacros(), options);
+}
+
+// Returns `terms` additions of 1, nested `terms` deep.
+std::string DeepSum(int terms) {
+  return absl::StrJoin(std::vector<std::string>(terms, "1"), " + ");
 }
 
 TEST(StandardRuntimeTest, RecursionLimitExceeded) {
@@ -144,6 +154,88 @@ TEST(StandardRuntimeTest, RecursionLimitTracksLazyExpressions) {
                        HasSubstr("Maximum recursion depth of 8 exceeded")));
 }
 
+TEST(StandardRuntimeTest, AdaptiveRecursionSmallExpression) {
+  RuntimeOptions opts;
+  opts.max_recursion_depth = kAdaptiveRecursionDepth;
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), opts));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       ParseWithTestMacros("[1, 2, 3].exists(x, x + 1 == 3)"));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  EXPECT_TRUE(runtime_internal::TestOnly_IsRecursiveImpl(program.get()));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
+TEST(StandardRuntimeTest, AdaptiveRecursionDeepExpression) {
+  RuntimeOptions opts;
+  opts.max_recursion_depth = kAdaptiveRecursionDepth;
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), opts));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      ParseWithTestMacros(absl::StrCat(DeepSum(200), " == 200"),
+                          ParserOptions{.max_recursion_depth = 256}));
+
+  // Planned without hitting a recursion limit, with the deep part of the
+  // expression on the stack machine.
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  EXPECT_FALSE(runtime_internal::TestOnly_IsRecursiveImpl(program.get()));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
+TEST(StandardRuntimeTest, AdaptiveRecursionTracksLazyExpressions) {
+  RuntimeOptions opts;
+  opts.max_recursion_depth = kAdaptiveRecursionDepth;
+  opts.enable_recursive_tracing = true;
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), opts));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      ParseWithTestMacros(
+          absl::StrCat("cel.bind(a, ", DeepSum(24),
+                       ", cel.bind(b, a + a, [b].all(x, x == a + 24)))"),
+          ParserOptions{.max_recursion_depth = 64}));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
 struct EvaluateResultTestCase {
   std::string name;
   std::string expression;
@@ -224,6 +316,34 @@ TEST_P(StandardRuntimeTest, Recursive) {
       << test_case.expression;
 }
 
+TEST_P(StandardRuntimeTest, AdaptiveRecursion) {
+  RuntimeOptions opts;
+  opts.max_recursion_depth = kAdaptiveRecursionDepth;
+  const EvaluateResultTestCase& test_case = GetTestCase();
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), opts));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       ParseWithTestMacros(test_case.expression));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  if (test_case.activation_builder != nullptr) {
+    ASSERT_THAT(test_case.activation_builder(activation), IsOk());
+  }
+
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  EXPECT_THAT(result, BoolValueIs(test_case.expected_result))
+      << test_case.expression;
+}
+
 TEST_P(StandardRuntimeTest, FastBuiltins) {
   RuntimeOptions opts;
   opts.enable_fast_builtins = true;
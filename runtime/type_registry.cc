@@ -21,11 +21,13 @@
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "common/value.h"
 #include "runtime/internal/legacy_runtime_type_provider.h"
+#include "runtime/typed_field_accessor.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
 
@@ -51,6 +53,36 @@ void TypeRegistry::RegisterEnum(absl::string_view enum_name,
       Enumeration{std::string(enum_name), std::move(enumerators)};
 }
 
+absl::Status TypeRegistry::RegisterTypedFieldAccessor(
+    const TypedFieldAccessor& accessor) {
+  if (accessor.field->containing_type() !=
+      accessor.prototype->GetDescriptor()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("typed field accessor for ", accessor.field->full_name(),
+                     " has a prototype of type ",
+                     accessor.prototype->GetDescriptor()->full_name()));
+  }
+  if (!typed_field_accessors_.insert({accessor.field, accessor}).second) {
+    return absl::AlreadyExistsError(absl::StrCat(
+        "typed field accessor already registered for ",
+        accessor.field->full_name()));
+  }
+  return absl::OkStatus();
+}
+
+void TypeRegistry::InheritRegistrations(const TypeRegistry& other) {
+  type_provider_.RegisterTypesFrom(other.type_provider_);
+  enum_types_ = other.enum_types_;
+  typed_field_accessors_ = other.typed_field_accessors_;
+  std::shared_ptr<const absl::flat_hash_map<std::string, Value>> table;
+  {
+    absl::ReaderMutexLock lock(other.enum_value_table_mutex_);
+    table = other.enum_value_table_;
+  }
+  absl::MutexLock lock(enum_value_table_mutex_);
+  enum_value_table_ = std::move(table);
+}
+
 std::shared_ptr<const absl::flat_hash_map<std::string, Value>>
 TypeRegistry::GetEnumValueTable() const {
   {
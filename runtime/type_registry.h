@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/base/nullability.h"
@@ -28,9 +29,11 @@
 #include "absl/synchronization/mutex.h"
 #include "base/type_provider.h"
 #include "common/type.h"
+#include "common/type_introspector.h"
 #include "common/value.h"
 #include "runtime/internal/legacy_runtime_type_provider.h"
 #include "runtime/internal/runtime_type_provider.h"
+#include "runtime/typed_field_accessor.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
 
@@ -86,6 +89,17 @@ class TypeRegistry {
     return type_provider_.RegisterType(type);
   }
 
+  // Registers an introspector for struct types not described by the
+  // descriptor pool, e.g. custom struct values backed by another format.
+  //
+  // This is consulted at plan time: when typed field access is enabled,
+  // selections of fields resolved by the introspector access the field by
+  // number on custom struct values of the resolved type.
+  void RegisterTypeIntrospector(
+      absl_nonnull std::shared_ptr<const TypeIntrospector> introspector) {
+    type_provider_.AddTypeIntrospector(std::move(introspector));
+  }
+
   // Register a custom enum type.
   //
   // This adds the enum to the set consulted at plan time to identify constant
@@ -98,6 +112,28 @@ class TypeRegistry {
     return enum_types_;
   }
 
+  // Registers a direct accessor for a field of a generated message class.
+  // Returns an error if the field already has an accessor.
+  //
+  // This is consulted at plan time, so accessors must be registered before
+  // programs are created.
+  absl::Status RegisterTypedFieldAccessor(const TypedFieldAccessor& accessor);
+
+  // Returns the accessor registered for `field`, or nullptr. The result is
+  // invalidated by later registrations, so callers keep a copy.
+  const TypedFieldAccessor* absl_nullable FindTypedFieldAccessor(
+      const google::protobuf::FieldDescriptor* absl_nonnull field) const {
+    auto it = typed_field_accessors_.find(field);
+    return it == typed_field_accessors_.end() ? nullptr : &it->second;
+  }
+
+  // Copies the custom types, type introspectors, enums and typed field
+  // accessors registered with `other`, which must use the same descriptor pool
+  // and outlive this registry.
+  //
+  // Used when deriving a runtime from an existing one.
+  void InheritRegistrations(const TypeRegistry& other);
+
   // Returns the effective type provider.
   const TypeProvider& GetComposedTypeProvider() const { return type_provider_; }
 
@@ -119,6 +155,8 @@ class TypeRegistry {
   absl_nonnull std::shared_ptr<runtime_internal::LegacyRuntimeTypeProvider>
       legacy_type_provider_;
   absl::flat_hash_map<std::string, Enumeration> enum_types_;
+  absl::flat_hash_map<const google::protobuf::FieldDescriptor*, TypedFieldAccessor>
+      typed_field_accessors_;
 
   // memoized fully qualified enumerator names.
   //
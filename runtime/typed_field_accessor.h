@@ -0,0 +1,61 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_TYPED_FIELD_ACCESSOR_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_TYPED_FIELD_ACCESSOR_H_
+
+#include "absl/base/nullability.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+
+// Reads a field of a generated message class directly through its generated
+// accessors, instead of through `google::protobuf::Reflection`.
+//
+// Accessors are usually generated with the `cel_cc_typed_field_accessors`
+// build rule and registered with `TypeRegistry::RegisterTypedFieldAccessor`.
+// When `RuntimeOptions::enable_typed_field_access` is set, field selections
+// and `has()` tests on a type-checked operand of the field's message type use
+// the accessor whenever the runtime message is an instance of the generated
+// class.
+struct TypedFieldAccessor {
+  // The field read by this accessor, from the generated descriptor pool.
+  const google::protobuf::FieldDescriptor* absl_nonnull field;
+
+  // Default instance of the generated class. The accessor only applies to
+  // messages that share its reflection, i.e. instances of that class.
+  const google::protobuf::Message* absl_nonnull prototype;
+
+  // Stores the CEL value of `field` in `message` into `result`. `message` is
+  // an instance of the generated class.
+  void (*absl_nonnull get)(const google::protobuf::Message& message,
+                           google::protobuf::Arena* absl_nonnull arena,
+                           Value* absl_nonnull result);
+
+  // Returns whether `field` is set in `message`, with the semantics of a CEL
+  // `has()` test. `message` is an instance of the generated class.
+  bool (*absl_nonnull has)(const google::protobuf::Message& message);
+
+  // Returns whether `message` is an instance of the generated class.
+  bool Matches(const google::protobuf::Message& message) const {
+    return message.GetReflection() == prototype->GetReflection();
+  }
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_TYPED_FIELD_ACCESSOR_H_
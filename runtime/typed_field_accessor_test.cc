@@ -0,0 +1,198 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/typed_field_accessor.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/value.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "compiler/standard_library.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "runtime/test_all_types_typed_field_accessors.h"
+#include "runtime/type_registry.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::cel::expr::conformance::proto3::TestAllTypes;
+
+void GetSentinel(const google::protobuf::Message& message, google::protobuf::Arena* arena,
+                 Value* result) {
+  *result = IntValue(42);
+}
+
+bool HasNever(const google::protobuf::Message& message) { return false; }
+
+TypedFieldAccessor SentinelAccessor() {
+  return TypedFieldAccessor{
+      TestAllTypes::descriptor()->FindFieldByName("single_int64"),
+      &TestAllTypes::default_instance(), &GetSentinel, &HasNever};
+}
+
+class TypedFieldAccessorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<CompilerBuilder> builder,
+        NewCompilerBuilder(google::protobuf::DescriptorPool::generated_pool()));
+    ASSERT_THAT(builder->AddLibrary(StandardCompilerLibrary()), IsOk());
+    builder->GetCheckerBuilder().set_container(
+        "cel.expr.conformance.proto3");
+    ASSERT_OK_AND_ASSIGN(compiler_, builder->Build());
+  }
+
+  absl::StatusOr<Value> Evaluate(const Runtime& runtime,
+                                 absl::string_view expr) {
+    CEL_ASSIGN_OR_RETURN(ValidationResult result, compiler_->Compile(expr));
+    if (!result.IsValid()) {
+      return absl::InvalidArgumentError(result.FormatError());
+    }
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, result.ReleaseAst());
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                         runtime.CreateProgram(std::move(ast)));
+    Activation activation;
+    return program->Evaluate(&arena_, activation);
+  }
+
+  std::unique_ptr<Compiler> compiler_;
+  google::protobuf::Arena arena_;
+};
+
+absl::StatusOr<std::unique_ptr<const Runtime>> BuildRuntime(
+    bool enable_typed_field_access,
+    absl::Status (*register_accessors)(TypeRegistry&)) {
+  RuntimeOptions options;
+  options.enable_typed_field_access = enable_typed_field_access;
+  CEL_ASSIGN_OR_RETURN(
+      RuntimeBuilder builder,
+      CreateStandardRuntimeBuilder(
+          google::protobuf::DescriptorPool::generated_pool(), options));
+  CEL_RETURN_IF_ERROR(register_accessors(builder.type_registry()));
+  return std::move(builder).Build();
+}
+
+absl::Status RegisterSentinel(TypeRegistry& registry) {
+  return registry.RegisterTypedFieldAccessor(SentinelAccessor());
+}
+
+TEST(TypeRegistryTypedFieldAccessorTest, RejectsDuplicates) {
+  TypeRegistry registry;
+  ASSERT_THAT(registry.RegisterTypedFieldAccessor(SentinelAccessor()), IsOk());
+  EXPECT_THAT(registry.RegisterTypedFieldAccessor(SentinelAccessor()),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+
+  const TypedFieldAccessor* accessor = registry.FindTypedFieldAccessor(
+      TestAllTypes::descriptor()->FindFieldByName("single_int64"));
+  ASSERT_NE(accessor, nullptr);
+  EXPECT_TRUE(accessor->Matches(TestAllTypes::default_instance()));
+  EXPECT_EQ(registry.FindTypedFieldAccessor(
+                TestAllTypes::descriptor()->FindFieldByName("single_int32")),
+            nullptr);
+}
+
+TEST(TypeRegistryTypedFieldAccessorTest, RejectsMismatchedPrototype) {
+  TypeRegistry registry;
+  TypedFieldAccessor accessor = SentinelAccessor();
+  accessor.prototype = &TestAllTypes::NestedMessage::default_instance();
+  EXPECT_THAT(registry.RegisterTypedFieldAccessor(accessor),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(TypedFieldAccessorTest, UsedForTypedSelect) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, BuildRuntime(true, &RegisterSentinel));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate(*runtime, "TestAllTypes{single_int64: 5}"
+                                          ".single_int64 == 42"));
+  EXPECT_TRUE(result.IsTrue());
+  ASSERT_OK_AND_ASSIGN(
+      result, Evaluate(*runtime, "has(TestAllTypes{single_int64: 5}"
+                                 ".single_int64)"));
+  EXPECT_TRUE(result.IsFalse());
+  // Fields without an accessor still use reflection.
+  ASSERT_OK_AND_ASSIGN(result,
+                       Evaluate(*runtime, "TestAllTypes{single_int32: 5}"
+                                          ".single_int32 == 5"));
+  EXPECT_TRUE(result.IsTrue());
+}
+
+TEST_F(TypedFieldAccessorTest, IgnoredWithoutTypedFieldAccess) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, BuildRuntime(false, &RegisterSentinel));
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate(*runtime, "TestAllTypes{single_int64: 5}"
+                                          ".single_int64 == 5"));
+  EXPECT_TRUE(result.IsTrue());
+}
+
+class GeneratedTypedFieldAccessorTest
+    : public TypedFieldAccessorTest,
+      public testing::WithParamInterface<std::string> {};
+
+// Generated accessors must agree with reflection.
+TEST_P(GeneratedTypedFieldAccessorTest, MatchesReflection) {
+  ASSERT_OK_AND_ASSIGN(
+      auto generated,
+      BuildRuntime(true, &expr::conformance::proto3::
+                             RegisterTestAllTypesTypedFieldAccessors));
+  ASSERT_OK_AND_ASSIGN(
+      auto reflection,
+      BuildRuntime(true, [](TypeRegistry&) { return absl::OkStatus(); }));
+  ASSERT_OK_AND_ASSIGN(Value expected, Evaluate(*reflection, GetParam()));
+  ASSERT_OK_AND_ASSIGN(Value actual, Evaluate(*generated, GetParam()));
+  EXPECT_EQ(actual.DebugString(), expected.DebugString());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    GeneratedTypedFieldAccessorTest, GeneratedTypedFieldAccessorTest,
+    testing::Values(
+        "TestAllTypes{single_int32: -3}.single_int32",
+        "TestAllTypes{single_uint64: 7u}.single_uint64",
+        "TestAllTypes{single_double: 1.5}.single_double",
+        "TestAllTypes{single_float: 2.5}.single_float",
+        "TestAllTypes{single_bool: true}.single_bool",
+        "TestAllTypes{single_string: 'abc'}.single_string",
+        "TestAllTypes{single_bytes: b'abc'}.single_bytes",
+        "TestAllTypes{standalone_enum: TestAllTypes.NestedEnum.BAR}"
+        ".standalone_enum",
+        "TestAllTypes{}.null_value",
+        "has(TestAllTypes{}.null_value)",
+        "TestAllTypes{}.single_string",
+        "has(TestAllTypes{}.single_int64)",
+        "has(TestAllTypes{single_int64: 1}.single_int64)",
+        "has(TestAllTypes{single_double: -0.0}.single_double)",
+        "has(TestAllTypes{single_string: ''}.single_string)"));
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,853 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/cc_expression_codegen.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/types/span.h"
+#include "base/builtins.h"
+#include "common/ast.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "common/reference.h"
+#include "internal/status_macros.h"
+
+namespace cel {
+namespace {
+
+constexpr absl::string_view kPreamble =
+    "// Generated by cel_cc_expression. DO NOT EDIT.\n";
+
+constexpr absl::string_view kBlock = "cel.@block";
+constexpr absl::string_view kOptionalSelect = "_?._";
+constexpr absl::string_view kOptionalIndex = "_[?_]";
+constexpr absl::string_view kOptionalOr = "or";
+constexpr absl::string_view kOptionalOrValue = "orValue";
+constexpr absl::string_view kNullValueEnum =
+    "google.protobuf.NullValue.NULL_VALUE";
+
+// Mirrors the planner, which evaluates the initializer of a `cel.bind` lazily
+// at its first reference.
+bool IsBind(const ComprehensionExpr& comprehension) {
+  return comprehension.loop_condition().const_expr().has_bool_value() &&
+         !comprehension.loop_condition().const_expr().bool_value() &&
+         comprehension.iter_var() == "#unused" &&
+         comprehension.iter_var2().empty() &&
+         comprehension.iter_range().has_list_expr() &&
+         comprehension.iter_range().list_expr().elements().empty();
+}
+
+std::string Quote(absl::string_view value) {
+  return absl::StrCat("\"", absl::CHexEscape(value), "\"");
+}
+
+// Returns a C++ string view of `value`, which may contain NUL bytes.
+std::string QuoteView(absl::string_view value) {
+  return absl::StrCat("absl::string_view(", Quote(value), ", ", value.size(),
+                      ")");
+}
+
+std::string DoubleLiteral(double value) {
+  if (std::isnan(value)) {
+    return "std::numeric_limits<double>::quiet_NaN()";
+  }
+  if (std::isinf(value)) {
+    return value > 0 ? "std::numeric_limits<double>::infinity()"
+                     : "-std::numeric_limits<double>::infinity()";
+  }
+  std::string literal = absl::StrFormat("%.17g", value);
+  if (literal.find_first_of(".e") == std::string::npos) {
+    absl::StrAppend(&literal, ".0");
+  }
+  return literal;
+}
+
+absl::StatusOr<std::string> ConstantValue(const Constant& constant) {
+  switch (constant.kind_case()) {
+    case ConstantKindCase::kNull:
+      return "::cel::NullValue()";
+    case ConstantKindCase::kBool:
+      return constant.bool_value() ? "::cel::BoolValue(true)"
+                                   : "::cel::BoolValue(false)";
+    case ConstantKindCase::kInt:
+      if (constant.int_value() == std::numeric_limits<int64_t>::min()) {
+        return "::cel::IntValue(std::numeric_limits<int64_t>::min())";
+      }
+      return absl::StrCat("::cel::IntValue(int64_t{", constant.int_value(),
+                          "})");
+    case ConstantKindCase::kUint:
+      return absl::StrCat("::cel::UintValue(uint64_t{", constant.uint_value(),
+                          "u})");
+    case ConstantKindCase::kDouble:
+      return absl::StrCat("::cel::DoubleValue(",
+                          DoubleLiteral(constant.double_value()), ")");
+    case ConstantKindCase::kString:
+      return absl::StrCat("::cel::StringValue::WrapUnsafe(",
+                          QuoteView(constant.string_value()), ")");
+    case ConstantKindCase::kBytes:
+      return absl::StrCat("::cel::BytesValue::WrapUnsafe(",
+                          QuoteView(constant.bytes_value()), ")");
+    case ConstantKindCase::kDuration:
+    case ConstantKindCase::kTimestamp:
+      return absl::UnimplementedError(
+          "duration and timestamp literals are not supported");
+    default:
+      return absl::InvalidArgumentError("unspecified constant");
+  }
+}
+
+// Emits the body and members of the program class of one expression.
+//
+// Each subexpression is emitted as the statements of its recursive evaluation
+// step, writing the same result value and attribute trail, so that generated
+// programs observe the same evaluation order and produce the same values as
+// the interpreter.
+class ExpressionGenerator {
+ public:
+  explicit ExpressionGenerator(const Ast& ast)
+      : reference_map_(ast.reference_map()) {}
+
+  absl::Status Generate(const Expr& root) {
+    indent_ = 4;
+    return Emit(root, "result", "trail");
+  }
+
+  const std::string& body() const { return body_; }
+  const std::string& members() const { return members_; }
+  const std::string& initializers() const { return initializers_; }
+  bool has_comprehensions() const { return has_comprehensions_; }
+
+  std::string ReferencedVariables() const {
+    std::vector<std::string> variables;
+    for (const auto& [name, conditional] : referenced_variables_) {
+      variables.push_back(absl::StrCat("{", Quote(name), ", ",
+                                       conditional ? "true" : "false", "}"));
+    }
+    return absl::StrCat("{", absl::StrJoin(variables, ", "), "}");
+  }
+
+ private:
+  enum class ScopeArg { kNone, kLoop, kResult };
+
+  struct Scope {
+    const ComprehensionExpr* comprehension;
+    std::string suffix;
+    bool bind;
+    ScopeArg arg = ScopeArg::kNone;
+    bool referenced = false;
+  };
+
+  template <typename... Args>
+  void Line(const Args&... args) {
+    absl::StrAppend(&body_, std::string(indent_, ' '), args..., "\n");
+  }
+
+  std::string NextSuffix() { return absl::StrCat(next_suffix_++); }
+
+  const Reference* FindReference(int64_t expr_id) const {
+    auto it = reference_map_.find(expr_id);
+    return it == reference_map_.end() ? nullptr : &it->second;
+  }
+
+  void RecordVariable(absl::string_view name) {
+    bool conditional = conditional_depth_ > 0;
+    auto [it, inserted] = referenced_variable_indices_.try_emplace(
+        name, referenced_variables_.size());
+    if (inserted) {
+      referenced_variables_.push_back({std::string(name), conditional});
+    } else if (!conditional) {
+      referenced_variables_[it->second].second = false;
+    }
+  }
+
+  absl::Status Emit(const Expr& expr, absl::string_view r,
+                    absl::string_view t) {
+    // Fold the references recorded by the type checker, as the reference
+    // resolver does.
+    if (const Reference* reference = FindReference(expr.id());
+        reference != nullptr) {
+      if (reference->has_variable() && reference->variable().has_value()) {
+        const Constant& value = reference->variable().value();
+        if (value.has_int_value()) {
+          return EmitConstant(value, r);
+        }
+        if (expr.has_ident_expr() &&
+            !(value.has_null_value() &&
+              expr.ident_expr().name() == kNullValueEnum)) {
+          return EmitConstant(value, r);
+        }
+      }
+      if (!reference->name().empty() &&
+          (expr.has_ident_expr() ||
+           (expr.has_select_expr() && !expr.select_expr().test_only()))) {
+        return EmitIdent(expr.id(), reference->name(), r, t);
+      }
+    }
+
+    switch (expr.kind_case()) {
+      case ExprKindCase::kConstant:
+        return EmitConstant(expr.const_expr(), r);
+      case ExprKindCase::kIdentExpr:
+        return EmitIdent(expr.id(), expr.ident_expr().name(), r, t);
+      case ExprKindCase::kSelectExpr:
+        return EmitSelect(expr, r, t);
+      case ExprKindCase::kCallExpr:
+        return EmitCall(expr, r, t);
+      case ExprKindCase::kListExpr:
+        return EmitList(expr, r);
+      case ExprKindCase::kMapExpr:
+        return EmitMap(expr, r);
+      case ExprKindCase::kStructExpr:
+        return EmitStruct(expr, r);
+      case ExprKindCase::kComprehensionExpr:
+        return EmitComprehension(expr, r, t);
+      default:
+        return absl::InvalidArgumentError(
+            absl::StrCat("unspecified expression: ", expr.id()));
+    }
+  }
+
+  absl::Status EmitConstant(const Constant& constant, absl::string_view r) {
+    CEL_ASSIGN_OR_RETURN(std::string value, ConstantValue(constant));
+    Line(r, " = ", value, ";");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitIdent(int64_t expr_id, absl::string_view name,
+                         absl::string_view r, absl::string_view t) {
+    if (name.empty()) {
+      return absl::InvalidArgumentError(
+          "Invalid expression: identifier 'name' must not be empty");
+    }
+    for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
+      const ComprehensionExpr& comprehension = *it->comprehension;
+      if (it->arg == ScopeArg::kLoop && !it->bind) {
+        if (comprehension.iter_var() == name) {
+          Line("LoadLocal(frame, iter_", it->suffix, ", iter_", it->suffix,
+               "_trail, ", r, ", ", t, ");");
+          return absl::OkStatus();
+        }
+        if (comprehension.iter_var2() == name) {
+          Line("LoadLocal(frame, iter2_", it->suffix, ", iter2_", it->suffix,
+               "_trail, ", r, ", ", t, ");");
+          return absl::OkStatus();
+        }
+      }
+      if (it->arg != ScopeArg::kNone && comprehension.accu_var() == name) {
+        if (it->bind) {
+          it->referenced = true;
+          Line("CEL_RETURN_IF_ERROR(bind_", it->suffix, "_init());");
+          Line(r, " = bind_", it->suffix, ";");
+          Line(t, " = bind_", it->suffix, "_trail;");
+          return absl::OkStatus();
+        }
+        Line("LoadLocal(frame, accu_", it->suffix, ", accu_", it->suffix,
+             "_trail, ", r, ", ", t, ");");
+        return absl::OkStatus();
+      }
+    }
+    if (absl::StartsWith(name, "@index") || absl::StartsWith(name, "@it:") ||
+        absl::StartsWith(name, "@it2:") || absl::StartsWith(name, "@ac:")) {
+      return absl::UnimplementedError(
+          absl::StrCat("unsupported reference to ", name));
+    }
+
+    RecordVariable(absl::StripPrefix(name, "."));
+    std::string member = absl::StrCat("ident_", NextSuffix(), "_");
+    absl::StrAppend(&members_,
+                    "  ::cel::runtime_internal::GeneratedIdent ", member,
+                    ";\n");
+    absl::StrAppend(&initializers_, "    program->", member,
+                    " = builder->Ident(", expr_id, ", ", Quote(name), ");\n");
+    Line("CEL_RETURN_IF_ERROR(", member, ".Evaluate(frame, ", r, ", ", t,
+         "));");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitSelect(const Expr& expr, absl::string_view r,
+                          absl::string_view t) {
+    const SelectExpr& select = expr.select_expr();
+    if (!select.has_operand()) {
+      return absl::InvalidArgumentError(
+          "Invalid expression: select 'operand' must be set");
+    }
+    CEL_RETURN_IF_ERROR(Emit(select.operand(), r, t));
+    std::string member = absl::StrCat("select_", NextSuffix(), "_");
+    absl::StrAppend(&members_,
+                    "  ::cel::runtime_internal::GeneratedSelect ", member,
+                    ";\n");
+    absl::StrAppend(&initializers_, "    program->", member,
+                    " = builder->Select(", Quote(select.field()), ", ",
+                    select.test_only() ? "true" : "false", ");\n");
+    Line("CEL_RETURN_IF_ERROR(", member, ".Apply(frame, ", r, ", ", t, "));");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitCall(const Expr& expr, absl::string_view r,
+                        absl::string_view t) {
+    const CallExpr& call = expr.call_expr();
+    absl::string_view function = call.function();
+    if (function == kBlock || function == builtin::kRuntimeCollectResults ||
+        function == kOptionalSelect || function == kOptionalIndex ||
+        (call.has_target() &&
+         (function == kOptionalOr || function == kOptionalOrValue))) {
+      return absl::UnimplementedError(
+          absl::StrCat("unsupported function: ", function));
+    }
+    if (!call.has_target()) {
+      if (function == builtin::kAnd || function == builtin::kOr) {
+        return EmitLogic(call, function == builtin::kOr, r, t);
+      }
+      if (function == builtin::kTernary) {
+        return EmitTernary(call, r, t);
+      }
+    }
+    if (function == builtin::kIndex) {
+      return EmitIndex(call, r, t);
+    }
+
+    std::vector<const Expr*> args;
+    if (call.has_target()) {
+      args.push_back(&call.target());
+    }
+    for (const Expr& arg : call.args()) {
+      args.push_back(&arg);
+    }
+    std::string suffix = NextSuffix();
+    std::string member = absl::StrCat("call_", suffix, "_");
+    absl::StrAppend(&members_, "  ::cel::runtime_internal::GeneratedCall ",
+                    member, ";\n");
+    absl::StrAppend(&initializers_, "    CEL_ASSIGN_OR_RETURN(program->",
+                    member, ", builder->Call(", expr.id(), ", ",
+                    Quote(function), ", ",
+                    call.has_target() ? "true" : "false", ", ", args.size(),
+                    "));\n");
+    if (args.empty()) {
+      Line("CEL_RETURN_IF_ERROR(", member, ".Invoke(frame, {}, {}, ", r, ", ",
+           t, "));");
+      return absl::OkStatus();
+    }
+    Line("{");
+    indent_ += 2;
+    Line("::cel::Value args_", suffix, "[", args.size(), "];");
+    Line("AttributeTrail trails_", suffix, "[", args.size(), "];");
+    for (size_t i = 0; i < args.size(); ++i) {
+      CEL_RETURN_IF_ERROR(Emit(*args[i], absl::StrCat("args_", suffix, "[", i,
+                                                      "]"),
+                               absl::StrCat("trails_", suffix, "[", i, "]")));
+    }
+    Line("CEL_RETURN_IF_ERROR(", member, ".Invoke(frame, absl::MakeSpan(args_",
+         suffix, "), absl::MakeSpan(trails_", suffix, "), ", r, ", ", t,
+         "));");
+    indent_ -= 2;
+    Line("}");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitLogic(const CallExpr& call, bool is_or, absl::string_view r,
+                         absl::string_view t) {
+    if (call.args().size() != 2) {
+      return absl::UnimplementedError(
+          absl::StrCat("unsupported number of args for ", call.function()));
+    }
+    CEL_RETURN_IF_ERROR(Emit(call.args()[0], r, t));
+    std::string rhs = absl::StrCat("rhs_", NextSuffix());
+    Line("if (!", r, is_or ? ".IsTrue()) {" : ".IsFalse()) {");
+    indent_ += 2;
+    Line("::cel::Value ", rhs, ";");
+    ++conditional_depth_;
+    CEL_RETURN_IF_ERROR(Emit(call.args()[1], rhs, t));
+    --conditional_depth_;
+    Line("CEL_RETURN_IF_ERROR(CombineLogic(frame, ", is_or ? "true" : "false",
+         ", ", r, ", ", rhs, ", ", t, "));");
+    indent_ -= 2;
+    Line("}");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitTernary(const CallExpr& call, absl::string_view r,
+                           absl::string_view t) {
+    if (call.args().size() != 3) {
+      return absl::InvalidArgumentError("invalid ternary");
+    }
+    std::string condition = absl::StrCat("condition_", NextSuffix());
+    std::string condition_trail = absl::StrCat(condition, "_trail");
+    Line("{");
+    indent_ += 2;
+    Line("::cel::Value ", condition, ";");
+    Line("AttributeTrail ", condition_trail, ";");
+    CEL_RETURN_IF_ERROR(Emit(call.args()[0], condition, condition_trail));
+    ++conditional_depth_;
+    Line("if (", condition, ".IsTrue()) {");
+    indent_ += 2;
+    CEL_RETURN_IF_ERROR(Emit(call.args()[1], r, t));
+    indent_ -= 2;
+    Line("} else if (", condition, ".IsFalse()) {");
+    indent_ += 2;
+    CEL_RETURN_IF_ERROR(Emit(call.args()[2], r, t));
+    indent_ -= 2;
+    --conditional_depth_;
+    Line("} else {");
+    Line("  NonBoolCondition(", condition, ", ", condition_trail, ", ", r,
+         ", ", t, ");");
+    Line("}");
+    indent_ -= 2;
+    Line("}");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitIndex(const CallExpr& call, absl::string_view r,
+                         absl::string_view t) {
+    const Expr* container;
+    const Expr* key;
+    if (call.args().size() == 2 && !call.has_target()) {
+      container = &call.args()[0];
+      key = &call.args()[1];
+    } else if (call.args().size() == 1 && call.has_target()) {
+      container = &call.target();
+      key = &call.args()[0];
+    } else {
+      return absl::InvalidArgumentError(
+          "unexpected number of args for builtin index operator");
+    }
+    std::string suffix = NextSuffix();
+    Line("{");
+    indent_ += 2;
+    Line("::cel::Value container_", suffix, ";");
+    Line("AttributeTrail container_", suffix, "_trail;");
+    CEL_RETURN_IF_ERROR(Emit(*container, absl::StrCat("container_", suffix),
+                             absl::StrCat("container_", suffix, "_trail")));
+    Line("::cel::Value key_", suffix, ";");
+    Line("AttributeTrail key_", suffix, "_trail;");
+    CEL_RETURN_IF_ERROR(Emit(*key, absl::StrCat("key_", suffix),
+                             absl::StrCat("key_", suffix, "_trail")));
+    Line("Index(frame, container_", suffix, ", container_", suffix,
+         "_trail, key_", suffix, ", ", r, ", ", t, ");");
+    indent_ -= 2;
+    Line("}");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitList(const Expr& expr, absl::string_view r) {
+    const auto& elements = expr.list_expr().elements();
+    std::string suffix = NextSuffix();
+    std::string builder = absl::StrCat("list_", suffix);
+    Line("do {");
+    indent_ += 2;
+    Line("::cel::runtime_internal::GeneratedListBuilder ", builder,
+         "(frame, ", elements.size(), ");");
+    for (size_t i = 0; i < elements.size(); ++i) {
+      if (elements[i].optional()) {
+        return absl::UnimplementedError("optional list elements");
+      }
+      std::string element = absl::StrCat("element_", suffix, "_", i);
+      Line("{");
+      indent_ += 2;
+      Line("::cel::Value ", element, ";");
+      Line("AttributeTrail ", element, "_trail;");
+      CEL_RETURN_IF_ERROR(Emit(elements[i].expr(), element,
+                               absl::StrCat(element, "_trail")));
+      Line("CEL_ASSIGN_OR_RETURN(bool added, ", builder, ".Add(", element,
+           ", ", element, "_trail, ", r, "));");
+      Line("if (!added) break;");
+      indent_ -= 2;
+      Line("}");
+    }
+    Line("std::move(", builder, ").Build(", r, ");");
+    indent_ -= 2;
+    Line("} while (false);");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitMap(const Expr& expr, absl::string_view r) {
+    const auto& entries = expr.map_expr().entries();
+    std::string suffix = NextSuffix();
+    std::string builder = absl::StrCat("map_", suffix);
+    Line("do {");
+    indent_ += 2;
+    Line("::cel::runtime_internal::GeneratedMapBuilder ", builder, "(frame, ",
+         entries.size(), ");");
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (entries[i].optional()) {
+        return absl::UnimplementedError("optional map entries");
+      }
+      std::string key = absl::StrCat("key_", suffix, "_", i);
+      std::string value = absl::StrCat("value_", suffix, "_", i);
+      Line("{");
+      indent_ += 2;
+      Line("::cel::Value ", key, ";");
+      Line("AttributeTrail ", key, "_trail;");
+      CEL_RETURN_IF_ERROR(
+          Emit(entries[i].key(), key, absl::StrCat(key, "_trail")));
+      Line("CEL_ASSIGN_OR_RETURN(bool key_added, ", builder, ".AddKey(", key,
+           ", ", key, "_trail, ", r, "));");
+      Line("if (!key_added) break;");
+      Line("::cel::Value ", value, ";");
+      Line("AttributeTrail ", value, "_trail;");
+      CEL_RETURN_IF_ERROR(
+          Emit(entries[i].value(), value, absl::StrCat(value, "_trail")));
+      Line("CEL_ASSIGN_OR_RETURN(bool value_added, ", builder, ".AddValue(",
+           key, ", ", value, ", ", value, "_trail, ", r, "));");
+      Line("if (!value_added) break;");
+      indent_ -= 2;
+      Line("}");
+    }
+    Line("std::move(", builder, ").Build(", r, ");");
+    indent_ -= 2;
+    Line("} while (false);");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitStruct(const Expr& expr, absl::string_view r) {
+    const StructExpr& struct_expr = expr.struct_expr();
+    std::string suffix = NextSuffix();
+    std::string member = absl::StrCat("struct_", suffix, "_");
+    std::string builder = absl::StrCat("builder_", suffix);
+    std::vector<std::string> fields;
+    for (const auto& field : struct_expr.fields()) {
+      if (field.optional()) {
+        return absl::UnimplementedError("optional struct fields");
+      }
+      fields.push_back(Quote(field.name()));
+    }
+    absl::StrAppend(&members_, "  ::cel::runtime_internal::GeneratedStruct ",
+                    member, ";\n");
+    absl::StrAppend(&initializers_, "    CEL_ASSIGN_OR_RETURN(program->",
+                    member, ", builder->Struct(", expr.id(), ", ",
+                    Quote(struct_expr.name()), ", {",
+                    absl::StrJoin(fields, ", "), "}));\n");
+    Line("do {");
+    indent_ += 2;
+    Line("::cel::runtime_internal::GeneratedStructBuilder ", builder,
+         "(frame, ", member, ");");
+    Line("CEL_ASSIGN_OR_RETURN(bool started, ", builder, ".Start(", r, "));");
+    Line("if (!started) break;");
+    for (size_t i = 0; i < struct_expr.fields().size(); ++i) {
+      std::string value = absl::StrCat("field_", suffix, "_", i);
+      Line("{");
+      indent_ += 2;
+      Line("::cel::Value ", value, ";");
+      Line("AttributeTrail ", value, "_trail;");
+      CEL_RETURN_IF_ERROR(Emit(struct_expr.fields()[i].value(), value,
+                               absl::StrCat(value, "_trail")));
+      Line("CEL_ASSIGN_OR_RETURN(bool set, ", builder, ".SetField(", i, ", ",
+           value, ", ", value, "_trail, ", r, "));");
+      Line("if (!set) break;");
+      indent_ -= 2;
+      Line("}");
+    }
+    Line("CEL_RETURN_IF_ERROR(std::move(", builder, ").Build(", r, "));");
+    indent_ -= 2;
+    Line("} while (false);");
+    return absl::OkStatus();
+  }
+
+  absl::Status EmitComprehension(const Expr& expr, absl::string_view r,
+                                 absl::string_view t) {
+    const ComprehensionExpr& comprehension = expr.comprehension_expr();
+    if (!comprehension.has_iter_range() || !comprehension.has_accu_init() ||
+        !comprehension.has_loop_condition() ||
+        !comprehension.has_loop_step() || !comprehension.has_result()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid comprehension: ", expr.id()));
+    }
+    has_comprehensions_ = true;
+    std::string suffix = NextSuffix();
+    scopes_.push_back(Scope{&comprehension, suffix, IsBind(comprehension)});
+    absl::Status status = scopes_.back().bind
+                              ? EmitBind(comprehension, suffix, r, t)
+                              : EmitLoop(comprehension, suffix, r, t);
+    scopes_.pop_back();
+    return status;
+  }
+
+  // Emits the loop of a comprehension.
+  absl::Status EmitLoop(const ComprehensionExpr& comprehension,
+                        absl::string_view suffix, absl::string_view r,
+                        absl::string_view t) {
+    std::string range = absl::StrCat("range_", suffix);
+    std::string loop = absl::StrCat("loop_", suffix);
+    std::string accu = absl::StrCat("accu_", suffix);
+    std::string iter = absl::StrCat("iter_", suffix);
+    std::string iter2 = absl::StrCat("iter2_", suffix);
+    std::string condition = absl::StrCat("condition_", suffix);
+    std::string skip_result = absl::StrCat("skip_result_", suffix);
+    bool two_variable = !comprehension.iter_var2().empty();
+
+    Line("do {");
+    indent_ += 2;
+    Line("::cel::Value ", range, ";");
+    Line("AttributeTrail ", range, "_trail;");
+    CEL_RETURN_IF_ERROR(
+        Emit(comprehension.iter_range(), range, absl::StrCat(range, "_trail")));
+    Line("::cel::runtime_internal::GeneratedComprehensionRange ", loop, ";");
+    Line("CEL_ASSIGN_OR_RETURN(bool started, ", loop, ".Start(frame, ", range,
+         ", ", range, "_trail, ", r, "));");
+    Line("if (!started) break;");
+    Line("::cel::Value ", accu, ";");
+    Line("AttributeTrail ", accu, "_trail;");
+    CEL_RETURN_IF_ERROR(
+        Emit(comprehension.accu_init(), accu, absl::StrCat(accu, "_trail")));
+    Line("::cel::Value ", iter, ";");
+    Line("AttributeTrail ", iter, "_trail;");
+    if (two_variable) {
+      Line("::cel::Value ", iter2, ";");
+      Line("AttributeTrail ", iter2, "_trail;");
+    }
+    Line("::cel::Value ", condition, ";");
+    Line("AttributeTrail ", condition, "_trail;");
+    Line("bool ", skip_result, " = false;");
+    Line("while (true) {");
+    indent_ += 2;
+    if (two_variable) {
+      Line("CEL_ASSIGN_OR_RETURN(bool next, ", loop, ".Next(frame, ", iter,
+           ", ", iter, "_trail, ", iter2, ", ", iter2, "_trail));");
+    } else {
+      Line("CEL_ASSIGN_OR_RETURN(bool next, ", loop, ".Next(frame, ", iter,
+           ", ", iter, "_trail));");
+    }
+    Line("if (!next) break;");
+    // The loop is not entered for an empty range.
+    ++conditional_depth_;
+    scopes_.back().arg = ScopeArg::kLoop;
+    CEL_RETURN_IF_ERROR(Emit(comprehension.loop_condition(), condition,
+                             absl::StrCat(condition, "_trail")));
+    Line("if (!", condition, ".IsBool()) {");
+    Line("  ", r, " = NonBoolLoopCondition(std::move(", condition, "));");
+    Line("  ", skip_result, " = true;");
+    Line("  break;");
+    Line("}");
+    Line("if (", condition, ".IsFalse()) break;");
+    CEL_RETURN_IF_ERROR(
+        Emit(comprehension.loop_step(), accu, absl::StrCat(accu, "_trail")));
+    --conditional_depth_;
+    indent_ -= 2;
+    Line("}");
+    Line("if (", skip_result, ") break;");
+    scopes_.back().arg = ScopeArg::kResult;
+    CEL_RETURN_IF_ERROR(Emit(comprehension.result(), r, t));
+    indent_ -= 2;
+    Line("} while (false);");
+    return absl::OkStatus();
+  }
+
+  // Emits a `cel.bind`, whose initializer is evaluated at the first reference
+  // to the bound variable, if any.
+  absl::Status EmitBind(const ComprehensionExpr& comprehension,
+                        absl::string_view suffix, absl::string_view r,
+                        absl::string_view t) {
+    std::string bind = absl::StrCat("bind_", suffix);
+    std::string body;
+    body.swap(body_);
+    indent_ += 6;
+    CEL_RETURN_IF_ERROR(Emit(comprehension.accu_init(), bind,
+                             absl::StrCat(bind, "_trail")));
+    indent_ -= 6;
+    std::string init;
+    init.swap(body_);
+
+    indent_ += 2;
+    scopes_.back().arg = ScopeArg::kResult;
+    CEL_RETURN_IF_ERROR(Emit(comprehension.result(), r, t));
+    indent_ -= 2;
+    std::string result;
+    result.swap(body_);
+    body_.swap(body);
+
+    Line("{");
+    if (scopes_.back().referenced) {
+      indent_ += 2;
+      Line("::cel::Value ", bind, ";");
+      Line("AttributeTrail ", bind, "_trail;");
+      Line("bool ", bind, "_done = false;");
+      Line("auto ", bind, "_init = [&]() -> absl::Status {");
+      Line("  if (!", bind, "_done) {");
+      absl::StrAppend(&body_, init);
+      Line("    ", bind, "_done = true;");
+      Line("  }");
+      Line("  return absl::OkStatus();");
+      Line("};");
+      indent_ -= 2;
+    }
+    absl::StrAppend(&body_, result);
+    Line("}");
+    return absl::OkStatus();
+  }
+
+  const Ast::ReferenceMap& reference_map_;
+  std::string body_;
+  std::string members_;
+  std::string initializers_;
+  int indent_ = 0;
+  size_t next_suffix_ = 0;
+  std::vector<Scope> scopes_;
+  bool has_comprehensions_ = false;
+  // Variables read from the activation, with whether they are only read on
+  // some evaluation paths. Mirrors the planner.
+  std::vector<std::pair<std::string, bool>> referenced_variables_;
+  absl::flat_hash_map<std::string, size_t> referenced_variable_indices_;
+  int conditional_depth_ = 0;
+};
+
+struct FunctionName {
+  std::string namespace_name;
+  std::string function;
+};
+
+absl::StatusOr<FunctionName> SplitFunctionName(absl::string_view name) {
+  std::vector<std::string> parts =
+      absl::StrSplit(absl::StripPrefix(name, "::"), "::");
+  for (const std::string& part : parts) {
+    if (part.empty() || absl::ascii_isdigit(part[0]) ||
+        !absl::c_all_of(part, [](char c) {
+          return absl::ascii_isalnum(c) || c == '_';
+        })) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("invalid function name: ", name));
+    }
+  }
+  FunctionName result;
+  result.function = parts.back();
+  parts.pop_back();
+  result.namespace_name = absl::StrJoin(parts, "::");
+  return result;
+}
+
+std::string OpenNamespace(absl::string_view namespace_name) {
+  return namespace_name.empty()
+             ? ""
+             : absl::StrCat("namespace ", namespace_name, " {\n\n");
+}
+
+std::string CloseNamespace(absl::string_view namespace_name) {
+  return namespace_name.empty()
+             ? ""
+             : absl::StrCat("}  // namespace ", namespace_name, "\n\n");
+}
+
+std::string SourceComment(absl::string_view source) {
+  if (source.empty()) {
+    return "";
+  }
+  std::string comment = "// Creates a program evaluating:\n//\n";
+  for (absl::string_view line : absl::StrSplit(source, '\n')) {
+    absl::StrAppend(&comment, "//   ", line, "\n");
+  }
+  return comment;
+}
+
+}  // namespace
+
+absl::StatusOr<CcExpressionSources> GenerateCcExpressions(
+    absl::Span<const CcExpression> expressions,
+    absl::string_view header_include) {
+  const std::string guard = absl::StrCat(
+      absl::AsciiStrToUpper(absl::StrReplaceAll(
+          header_include, {{"/", "_"}, {".", "_"}, {"-", "_"}})),
+      "_");
+
+  CcExpressionSources sources;
+  sources.header = absl::StrCat(
+      kPreamble, "\n#ifndef ", guard, "\n#define ", guard, "\n\n",
+      "#include <memory>\n\n", "#include \"absl/status/statusor.h\"\n",
+      "#include \"runtime/runtime.h\"\n\n");
+  sources.source = absl::StrCat(
+      kPreamble, "\n#include \"", header_include, "\"\n\n",
+      "#include <cstdint>\n", "#include <limits>\n", "#include <memory>\n",
+      "#include <utility>\n", "#include <vector>\n\n",
+      "#include \"absl/memory/memory.h\"\n",
+      "#include \"absl/status/status.h\"\n",
+      "#include \"absl/status/statusor.h\"\n",
+      "#include \"absl/strings/string_view.h\"\n",
+      "#include \"absl/types/span.h\"\n", "#include \"common/value.h\"\n",
+      "#include \"internal/status_macros.h\"\n",
+      "#include \"runtime/internal/generated_program.h\"\n",
+      "#include \"runtime/runtime.h\"\n");
+
+  for (const CcExpression& expression : expressions) {
+    if (expression.ast == nullptr || !expression.ast->is_checked()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat(expression.function_name,
+                       ": expression must be type checked"));
+    }
+    CEL_ASSIGN_OR_RETURN(FunctionName name,
+                         SplitFunctionName(expression.function_name));
+    ExpressionGenerator generator(*expression.ast);
+    if (absl::Status status = generator.Generate(expression.ast->root_expr());
+        !status.ok()) {
+      return absl::Status(status.code(),
+                          absl::StrCat(expression.function_name, ": ",
+                                       status.message()));
+    }
+
+    absl::StrAppend(&sources.header, OpenNamespace(name.namespace_name),
+                    SourceComment(expression.source),
+                    "absl::StatusOr<std::unique_ptr<::cel::Program>> ",
+                    name.function, "(const ::cel::Runtime& runtime);\n\n",
+                    CloseNamespace(name.namespace_name));
+
+    const std::string class_name = absl::StrCat(name.function, "Program");
+    absl::StrAppend(
+        &sources.source, "\n", OpenNamespace(name.namespace_name),
+        "namespace {\n\n", "class ", class_name,
+        " final : public ::cel::runtime_internal::GeneratedProgram {\n",
+        " public:\n",
+        "  static absl::StatusOr<std::unique_ptr<::cel::Program>> Create(\n",
+        "      const ::cel::Runtime& runtime) {\n",
+        "    CEL_ASSIGN_OR_RETURN(\n", "        auto builder,\n",
+        "        ::cel::runtime_internal::GeneratedProgramBuilder::Create("
+        "runtime));\n",
+        generator.has_comprehensions()
+            ? "    CEL_RETURN_IF_ERROR(builder->CheckComprehensionsEnabled());\n"
+            : "",
+        "    auto program = absl::WrapUnique(new ", class_name,
+        "(\n        *builder, std::vector<::cel::VariableReference>",
+        generator.ReferencedVariables(), "));\n", generator.initializers(),
+        "    return program;\n", "  }\n\n", " private:\n",
+        "  using GeneratedProgram::GeneratedProgram;\n\n",
+        "  absl::Status Evaluate(Frame& frame, ::cel::Value& result,\n",
+        "                        AttributeTrail& trail) const override {\n",
+        generator.body(), "    return absl::OkStatus();\n", "  }\n",
+        generator.members().empty() ? "" : "\n", generator.members(), "};\n\n",
+        "}  // namespace\n\n",
+        "absl::StatusOr<std::unique_ptr<::cel::Program>> ", name.function,
+        "(const ::cel::Runtime& runtime) {\n", "  return ", class_name,
+        "::Create(runtime);\n", "}\n\n", CloseNamespace(name.namespace_name));
+  }
+  absl::StrAppend(&sources.header, "#endif  // ", guard, "\n");
+  return sources;
+}
+
+}  // namespace cel
@@ -0,0 +1,72 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_TOOLS_CC_EXPRESSION_CODEGEN_H_
+#define THIRD_PARTY_CEL_CPP_TOOLS_CC_EXPRESSION_CODEGEN_H_
+
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/ast.h"
+
+namespace cel {
+
+// A checked expression to generate C++ for.
+struct CcExpression {
+  // Fully qualified name of the generated function, e.g.
+  // `example::CreateIsAdminProgram`.
+  std::string function_name;
+  // The type-checked expression.
+  const Ast* absl_nonnull ast;
+  // The expression text, quoted in the generated header. May be empty.
+  std::string source;
+};
+
+struct CcExpressionSources {
+  std::string header;
+  std::string source;
+};
+
+// Generates C++ implementing `expressions`, for a header included as
+// `header_include`. Used by the `cel_cc_expression` build rule.
+//
+// For each expression the header declares
+//
+//   absl::StatusOr<std::unique_ptr<cel::Program>> <function_name>(
+//       const cel::Runtime& runtime);
+//
+// which returns a program evaluating the expression with straight-line C++ in
+// place of a planned step tree. The program is a drop-in replacement for
+// `runtime.CreateProgram(ast)`: functions, enum and type constants and struct
+// types are resolved against `runtime` when the program is created, and
+// evaluation results (including errors and unknowns) are the same as the
+// interpreter's. References recorded by the type checker are folded at
+// generation time, as with `cel::EnableReferenceResolver`; AST transforms and
+// program optimizers of `runtime` are not applied.
+//
+// `runtime` must be the default runtime implementation, with short-circuiting
+// enabled.
+//
+// Returns an Unimplemented error for expressions using optional syntax,
+// `cel.@block` or duration and timestamp literals.
+absl::StatusOr<CcExpressionSources> GenerateCcExpressions(
+    absl::Span<const CcExpression> expressions,
+    absl::string_view header_include);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_TOOLS_CC_EXPRESSION_CODEGEN_H_
@@ -0,0 +1,154 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/cc_expression_codegen.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/expr.h"
+#include "common/type.h"
+#include "compiler/compiler.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/internal/standard_env_testing.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::AllOf;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+class CcExpressionCodegenTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(
+        compiler_,
+        runtime_internal::NewTestingCompiler(
+            {MakeVariableDecl("x", BoolType()),
+             MakeVariableDecl("y", BoolType()),
+             MakeVariableDecl("xs", ListType(&arena_, IntType()))}));
+  }
+
+  absl::StatusOr<CcExpressionSources> Generate(absl::string_view expr) {
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast,
+                         runtime_internal::CompileForTesting(*compiler_, expr));
+    return GenerateCcExpressions(
+        {CcExpression{"example::CreateTestProgram", ast.get(),
+                      std::string(expr)}},
+        "example/test_program.h");
+  }
+
+  google::protobuf::Arena arena_;
+  std::unique_ptr<Compiler> compiler_;
+};
+
+TEST_F(CcExpressionCodegenTest, DeclaresFunction) {
+  ASSERT_OK_AND_ASSIGN(CcExpressionSources sources, Generate("1 + 2"));
+
+  EXPECT_THAT(sources.header,
+              AllOf(HasSubstr("#ifndef EXAMPLE_TEST_PROGRAM_H_"),
+                    HasSubstr("namespace example {"), HasSubstr("//   1 + 2"),
+                    HasSubstr("absl::StatusOr<std::unique_ptr<::cel::Program>> "
+                              "CreateTestProgram(const ::cel::Runtime& "
+                              "runtime);")));
+  EXPECT_THAT(sources.source,
+              AllOf(HasSubstr("#include \"example/test_program.h\""),
+                    HasSubstr("class CreateTestProgramProgram final"),
+                    HasSubstr("builder->Call("),
+                    HasSubstr("::cel::IntValue(int64_t{1})"),
+                    HasSubstr("::cel::IntValue(int64_t{2})")));
+}
+
+TEST_F(CcExpressionCodegenTest, EscapesStringLiterals) {
+  ASSERT_OK_AND_ASSIGN(CcExpressionSources sources,
+                       Generate(R"cel('a"\x00z' == "" && b'\xff' != b'')cel"));
+
+  EXPECT_THAT(sources.source,
+              AllOf(HasSubstr("::cel::StringValue::WrapUnsafe(absl::string_view("
+                              "\"a\\\"\\x00z\", 4))"),
+                    HasSubstr("::cel::BytesValue::WrapUnsafe(absl::string_view("
+                              "\"\\xff\", 1))")));
+}
+
+TEST_F(CcExpressionCodegenTest, ShortCircuitsLogicalOperators) {
+  ASSERT_OK_AND_ASSIGN(CcExpressionSources sources, Generate("x && y"));
+
+  EXPECT_THAT(sources.source,
+              AllOf(HasSubstr("if (!result.IsFalse()) {"),
+                    HasSubstr("CombineLogic(frame, false, result"),
+                    HasSubstr("{\"x\", false}, {\"y\", true}")));
+}
+
+TEST_F(CcExpressionCodegenTest, GeneratesComprehensionLoops) {
+  ASSERT_OK_AND_ASSIGN(CcExpressionSources sources,
+                       Generate("xs.exists(i, i > 1)"));
+
+  EXPECT_THAT(
+      sources.source,
+      AllOf(HasSubstr("CEL_RETURN_IF_ERROR(builder->CheckComprehensionsEnabled"
+                      "());"),
+            HasSubstr("::cel::runtime_internal::GeneratedComprehensionRange"),
+            HasSubstr("NonBoolLoopCondition"), HasSubstr("{\"xs\", false}")));
+  // Comprehension variables are locals, not activation lookups.
+  EXPECT_THAT(sources.source, Not(HasSubstr("\"i\"")));
+}
+
+TEST_F(CcExpressionCodegenTest, RejectsUncheckedExpressions) {
+  Expr expr;
+  expr.mutable_const_expr().set_int_value(1);
+  Ast ast(std::move(expr), SourceInfo());
+
+  EXPECT_THAT(GenerateCcExpressions({CcExpression{"Create", &ast, ""}},
+                                    "test.h"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("must be type checked")));
+}
+
+TEST_F(CcExpressionCodegenTest, RejectsOptionalSyntax) {
+  Expr expr;
+  expr.mutable_call_expr().set_function("_?._");
+  Ast ast(std::move(expr), SourceInfo());
+  ast.set_is_checked(true);
+
+  EXPECT_THAT(GenerateCcExpressions({CcExpression{"Create", &ast, ""}},
+                                    "test.h"),
+              StatusIs(absl::StatusCode::kUnimplemented, HasSubstr("_?._")));
+}
+
+TEST_F(CcExpressionCodegenTest, RejectsInvalidFunctionNames) {
+  Expr expr;
+  expr.mutable_const_expr().set_int_value(1);
+  Ast ast(std::move(expr), SourceInfo());
+  ast.set_is_checked(true);
+
+  EXPECT_THAT(
+      GenerateCcExpressions({CcExpression{"example::1Create", &ast, ""}},
+                            "test.h"),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("invalid function name")));
+}
+
+}  // namespace
+}  // namespace cel
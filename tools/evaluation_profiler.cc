@@ -0,0 +1,435 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/evaluation_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "common/ast.h"
+#include "common/expr.h"
+#include "common/navigable_ast.h"
+#include "common/source.h"
+#include "common/value.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+namespace {
+
+// Raw counters for a single node.
+struct Sample {
+  int64_t count = 0;
+  int64_t nanos = 0;
+  int64_t arena_bytes = 0;
+};
+
+using SampleMap = absl::flat_hash_map<int64_t, Sample>;
+
+std::string NodeLabel(const Ast& ast, const NavigableAstNode& node) {
+  const Expr& expr = *node.expr();
+  std::string label;
+  switch (node.node_kind()) {
+    case NodeKind::kConstant:
+      label = "const";
+      break;
+    case NodeKind::kIdent:
+      label = expr.ident_expr().name();
+      break;
+    case NodeKind::kSelect:
+      label = expr.select_expr().test_only()
+                  ? absl::StrCat("has(.", expr.select_expr().field(), ")")
+                  : absl::StrCat(".", expr.select_expr().field());
+      break;
+    case NodeKind::kCall:
+      label = expr.call_expr().function();
+      break;
+    case NodeKind::kList:
+      label = "[]";
+      break;
+    case NodeKind::kMap:
+      label = "{}";
+      break;
+    case NodeKind::kStruct:
+      label = absl::StrCat(expr.struct_expr().name(), "{}");
+      break;
+    case NodeKind::kComprehension:
+      label = "comprehension";
+      break;
+    default:
+      label = "unspecified";
+      break;
+  }
+  SourceLocation location = ast.ComputeSourceLocation(expr.id());
+  if (location.line > 0) {
+    absl::StrAppend(&label, "@", location.line, ":", location.column);
+  }
+  return label;
+}
+
+class EvaluationProfilerImpl;
+
+// Per-evaluation recorder.
+//
+// Accumulates samples locally so the shared profile is only locked once per
+// evaluation.
+class EvaluationRecorder {
+ public:
+  EvaluationRecorder(EvaluationProfilerImpl* absl_nonnull profiler,
+                     const google::protobuf::Arena* absl_nullable arena)
+      : profiler_(profiler),
+        arena_(arena),
+        last_nanos_(absl::GetCurrentTimeNanos()),
+        last_arena_bytes_(ArenaBytes()) {}
+
+  void Record(int64_t expr_id) {
+    int64_t now = absl::GetCurrentTimeNanos();
+    int64_t arena_bytes = ArenaBytes();
+    Sample& sample = samples_[expr_id];
+    sample.count++;
+    sample.nanos += now - last_nanos_;
+    sample.arena_bytes += arena_bytes - last_arena_bytes_;
+    last_arena_bytes_ = arena_bytes;
+    // Exclude the bookkeeping above from the next node's time.
+    last_nanos_ = absl::GetCurrentTimeNanos();
+  }
+
+  EvaluationProfilerImpl& profiler() { return *profiler_; }
+  const SampleMap& samples() const { return samples_; }
+
+ private:
+  int64_t ArenaBytes() const {
+    if (arena_ == nullptr) {
+      return 0;
+    }
+    return static_cast<int64_t>(arena_->SpaceUsed());
+  }
+
+  EvaluationProfilerImpl* absl_nonnull profiler_;
+  const google::protobuf::Arena* absl_nullable arena_;
+  int64_t last_nanos_;
+  int64_t last_arena_bytes_;
+  SampleMap samples_;
+};
+
+class EvaluationProfilerImpl : public EvaluationProfiler {
+ public:
+  EvaluationProfilerImpl(const Ast& ast,
+                         const EvaluationProfilerOptions& options)
+      : ast_(ast),
+        sampling_interval_(std::max(options.sampling_interval, 1)),
+        track_arena_bytes_(options.track_arena_bytes) {}
+
+  // Builds the node tables. This should be called by the factory function
+  // (synchronously) before the profiler is shared.
+  void Init();
+
+  TraceableProgram::EvaluationListener MakeListener(
+      const google::protobuf::Arena* absl_nullable arena) override;
+
+  int64_t sampled_evaluation_count() const override {
+    absl::MutexLock lock(mu_);
+    return sampled_evaluations_;
+  }
+
+  NodeStats StatsForNode(int64_t expr_id) const override;
+
+  FunctionStats StatsForFunction(absl::string_view overload_id) const override;
+
+  std::string FormatFoldedStacks() const override;
+
+  std::string FormatReport() const override;
+
+  void Reset() override {
+    absl::MutexLock lock(mu_);
+    samples_.clear();
+    sampled_evaluations_ = 0;
+  }
+
+  void Merge(const EvaluationRecorder& recorder);
+
+ private:
+  // Sums self time over the subtree rooted at node.
+  int64_t CumulativeNanos(const NavigableAstNode& node) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const Sample* absl_nullable FindSample(int64_t expr_id) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto it = samples_.find(expr_id);
+    if (it == samples_.end()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  const Ast ast_;
+  NavigableAst navigable_ast_;
+  // Frame names and checker-resolved overloads by expr id. Immutable after
+  // Init.
+  absl::flat_hash_map<int64_t, std::string> labels_;
+  absl::flat_hash_map<int64_t, std::string> overloads_;
+  const int sampling_interval_;
+  const bool track_arena_bytes_;
+  std::atomic<int64_t> evaluation_counter_{0};
+
+  mutable absl::Mutex mu_;
+  SampleMap samples_ ABSL_GUARDED_BY(mu_);
+  int64_t sampled_evaluations_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+// Listener handed to TraceableProgram::Trace. Flushes the recorded samples to
+// the profiler when the evaluation is done with it.
+class SampledListener {
+ public:
+  explicit SampledListener(std::unique_ptr<EvaluationRecorder> recorder)
+      : recorder_(std::move(recorder)) {}
+
+  SampledListener(SampledListener&&) = default;
+  SampledListener& operator=(SampledListener&&) = default;
+
+  ~SampledListener() {
+    if (recorder_ != nullptr) {
+      recorder_->profiler().Merge(*recorder_);
+    }
+  }
+
+  absl::Status operator()(int64_t expr_id, const Value&,
+                          const google::protobuf::DescriptorPool* absl_nonnull,
+                          google::protobuf::MessageFactory* absl_nonnull,
+                          google::protobuf::Arena* absl_nonnull) {
+    recorder_->Record(expr_id);
+    return absl::OkStatus();
+  }
+
+ private:
+  std::unique_ptr<EvaluationRecorder> recorder_;
+};
+
+void EvaluationProfilerImpl::Init() {
+  navigable_ast_ = NavigableAst::Build(ast_.root_expr());
+  for (const NavigableAstNode& node :
+       navigable_ast_.Root().DescendantsPreorder()) {
+    int64_t expr_id = node.expr()->id();
+    labels_[expr_id] = NodeLabel(ast_, node);
+    if (node.node_kind() != NodeKind::kCall) {
+      continue;
+    }
+    const Reference* reference = ast_.GetReference(expr_id);
+    if (reference != nullptr && !reference->overload_id().empty()) {
+      overloads_[expr_id] = absl::StrJoin(reference->overload_id(), "|");
+    }
+  }
+}
+
+TraceableProgram::EvaluationListener EvaluationProfilerImpl::MakeListener(
+    const google::protobuf::Arena* absl_nullable arena) {
+  int64_t n = evaluation_counter_.fetch_add(1, std::memory_order_relaxed);
+  if (n % sampling_interval_ != 0) {
+    return nullptr;
+  }
+  return SampledListener(std::make_unique<EvaluationRecorder>(
+      this, track_arena_bytes_ ? arena : nullptr));
+}
+
+void EvaluationProfilerImpl::Merge(const EvaluationRecorder& recorder) {
+  absl::MutexLock lock(mu_);
+  sampled_evaluations_++;
+  for (const auto& [expr_id, sample] : recorder.samples()) {
+    Sample& aggregate = samples_[expr_id];
+    aggregate.count += sample.count;
+    aggregate.nanos += sample.nanos;
+    aggregate.arena_bytes += sample.arena_bytes;
+  }
+}
+
+int64_t EvaluationProfilerImpl::CumulativeNanos(
+    const NavigableAstNode& node) const {
+  int64_t nanos = 0;
+  for (const NavigableAstNode& descendant : node.DescendantsPreorder()) {
+    if (const Sample* sample = FindSample(descendant.expr()->id());
+        sample != nullptr) {
+      nanos += sample->nanos;
+    }
+  }
+  return nanos;
+}
+
+EvaluationProfiler::NodeStats EvaluationProfilerImpl::StatsForNode(
+    int64_t expr_id) const {
+  NodeStats stats;
+  absl::MutexLock lock(mu_);
+  const Sample* sample = FindSample(expr_id);
+  if (sample == nullptr) {
+    return stats;
+  }
+  stats.evaluation_count = sample->count;
+  stats.self_time = absl::Nanoseconds(sample->nanos);
+  stats.self_arena_bytes = sample->arena_bytes;
+  const NavigableAstNode* node = navigable_ast_.FindId(expr_id);
+  stats.cumulative_time = absl::Nanoseconds(
+      node != nullptr ? CumulativeNanos(*node) : sample->nanos);
+  return stats;
+}
+
+EvaluationProfiler::FunctionStats EvaluationProfilerImpl::StatsForFunction(
+    absl::string_view overload_id) const {
+  FunctionStats stats;
+  absl::MutexLock lock(mu_);
+  for (const auto& [expr_id, overload] : overloads_) {
+    if (overload != overload_id) {
+      continue;
+    }
+    if (const Sample* sample = FindSample(expr_id); sample != nullptr) {
+      stats.call_count += sample->count;
+      stats.self_time += absl::Nanoseconds(sample->nanos);
+      stats.self_arena_bytes += sample->arena_bytes;
+    }
+  }
+  return stats;
+}
+
+std::string EvaluationProfilerImpl::FormatFoldedStacks() const {
+  std::string out;
+  std::vector<absl::string_view> frames;
+  absl::MutexLock lock(mu_);
+  for (const NavigableAstNode& node :
+       navigable_ast_.Root().DescendantsPreorder()) {
+    const Sample* sample = FindSample(node.expr()->id());
+    if (sample == nullptr || sample->count == 0) {
+      continue;
+    }
+    frames.clear();
+    for (const NavigableAstNode* frame = &node; frame != nullptr;
+         frame = frame->parent()) {
+      frames.push_back(labels_.at(frame->expr()->id()));
+    }
+    std::reverse(frames.begin(), frames.end());
+    absl::StrAppend(&out, absl::StrJoin(frames, ";"), " ", sample->nanos,
+                    "\n");
+  }
+  return out;
+}
+
+std::string EvaluationProfilerImpl::FormatReport() const {
+  struct Row {
+    std::string name;
+    int64_t count;
+    int64_t self_nanos;
+    int64_t cumulative_nanos;
+    int64_t arena_bytes;
+  };
+
+  std::vector<Row> node_rows;
+  absl::flat_hash_map<absl::string_view, Row> function_rows;
+  int64_t total_nanos = 0;
+  int64_t sampled_evaluations;
+  {
+    absl::MutexLock lock(mu_);
+    sampled_evaluations = sampled_evaluations_;
+    for (const NavigableAstNode& node :
+         navigable_ast_.Root().DescendantsPreorder()) {
+      int64_t expr_id = node.expr()->id();
+      const Sample* sample = FindSample(expr_id);
+      if (sample == nullptr) {
+        continue;
+      }
+      total_nanos += sample->nanos;
+      node_rows.push_back(Row{absl::StrCat(labels_.at(expr_id), " #", expr_id),
+                              sample->count, sample->nanos,
+                              CumulativeNanos(node), sample->arena_bytes});
+      if (auto it = overloads_.find(expr_id); it != overloads_.end()) {
+        Row& row = function_rows[it->second];
+        row.name = it->second;
+        row.count += sample->count;
+        row.self_nanos += sample->nanos;
+        row.cumulative_nanos += node_rows.back().cumulative_nanos;
+        row.arena_bytes += sample->arena_bytes;
+      }
+    }
+  }
+
+  auto by_self_time = [](const Row& lhs, const Row& rhs) {
+    if (lhs.self_nanos != rhs.self_nanos) {
+      return lhs.self_nanos > rhs.self_nanos;
+    }
+    return lhs.name < rhs.name;
+  };
+  auto percent = [total_nanos](int64_t nanos) {
+    return total_nanos == 0 ? 0.0 : 100.0 * nanos / total_nanos;
+  };
+  auto append_rows = [&](std::string& out, std::vector<Row>& rows) {
+    std::sort(rows.begin(), rows.end(), by_self_time);
+    absl::StrAppendFormat(&out, "%12s %7s %12s %7s %10s %12s  %s\n", "flat(ns)",
+                          "flat%", "cum(ns)", "cum%", "calls", "arena(B)",
+                          "name");
+    for (const Row& row : rows) {
+      absl::StrAppendFormat(&out, "%12d %6.2f%% %12d %6.2f%% %10d %12d  %s\n",
+                            row.self_nanos, percent(row.self_nanos),
+                            row.cumulative_nanos,
+                            percent(row.cumulative_nanos), row.count,
+                            row.arena_bytes, row.name);
+    }
+  };
+
+  std::string out = absl::StrFormat(
+      "Sampled evaluations: %d\nTotal time: %dns\n\nNodes:\n",
+      sampled_evaluations, total_nanos);
+  append_rows(out, node_rows);
+
+  std::vector<Row> functions;
+  functions.reserve(function_rows.size());
+  for (auto& [name, row] : function_rows) {
+    functions.push_back(std::move(row));
+  }
+  absl::StrAppend(&out, "\nFunctions:\n");
+  append_rows(out, functions);
+  return out;
+}
+
+}  // namespace
+
+absl::StatusOr<Value> EvaluationProfiler::Evaluate(
+    const TraceableProgram& program, google::protobuf::Arena* absl_nonnull arena,
+    const ActivationInterface& activation, const EvaluateOptions& options) {
+  return program.Trace(arena, activation, MakeListener(arena), options);
+}
+
+std::unique_ptr<EvaluationProfiler> CreateEvaluationProfiler(
+    const Ast& ast, const EvaluationProfilerOptions& options) {
+  auto profiler = std::make_unique<EvaluationProfilerImpl>(ast, options);
+  profiler->Init();
+  return profiler;
+}
+
+}  // namespace cel
@@ -0,0 +1,130 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_TOOLS_EVALUATION_PROFILER_H_
+#define THIRD_PARTY_CEL_CPP_TOOLS_EVALUATION_PROFILER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/ast.h"
+#include "common/value.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+struct EvaluationProfilerOptions {
+  // Profile one out of every `sampling_interval` evaluations. Evaluations that
+  // are not sampled run without a listener and do not pay any profiling cost.
+  //
+  // 1 profiles every evaluation. Values less than 1 are treated as 1.
+  int sampling_interval = 100;
+
+  // Whether to attribute evaluation arena growth to AST nodes. This requires
+  // querying the arena after every step in sampled evaluations.
+  bool track_arena_bytes = true;
+};
+
+// Utility for collecting a step-level profile of a CEL program over multiple
+// evaluations.
+//
+// The profiler attributes wall time, evaluation arena growth and evaluation
+// counts to AST nodes (by expr id) and to the function overloads resolved by
+// the type checker. Results are aggregated across all sampled evaluations.
+//
+// Profiles are collected with the `TraceableProgram` listener interface, so
+// recursively planned programs must enable `enable_recursive_tracing` to be
+// profiled. Time is attributed to the node whose result was produced, so the
+// cost of non-AST steps (jumps, comprehension bookkeeping) is attributed to
+// the next node that completes.
+//
+// The default implementation is thread safe.
+class EvaluationProfiler {
+ public:
+  struct NodeStats {
+    // Number of sampled evaluations of the node.
+    int64_t evaluation_count = 0;
+    // Time spent producing the node's result, excluding its dependencies.
+    absl::Duration self_time = absl::ZeroDuration();
+    // Time spent producing the node's result, including its dependencies.
+    absl::Duration cumulative_time = absl::ZeroDuration();
+    // Arena growth while producing the node's result, excluding its
+    // dependencies.
+    int64_t self_arena_bytes = 0;
+  };
+
+  struct FunctionStats {
+    int64_t call_count = 0;
+    absl::Duration self_time = absl::ZeroDuration();
+    int64_t self_arena_bytes = 0;
+  };
+
+  virtual ~EvaluationProfiler() = default;
+
+  // Returns a listener that profiles a single evaluation, or an empty listener
+  // if this evaluation is not sampled.
+  //
+  // The collected samples are merged into the profile when the listener is
+  // destroyed. `arena` should be the arena passed to the evaluation.
+  virtual TraceableProgram::EvaluationListener MakeListener(
+      const google::protobuf::Arena* absl_nullable arena) = 0;
+
+  // Convenience for evaluating `program` with the listener from
+  // `MakeListener`.
+  absl::StatusOr<Value> Evaluate(
+      const TraceableProgram& program, google::protobuf::Arena* absl_nonnull arena,
+      const ActivationInterface& activation,
+      const EvaluateOptions& options = {});
+
+  // Number of evaluations that have been profiled.
+  virtual int64_t sampled_evaluation_count() const = 0;
+
+  virtual NodeStats StatsForNode(int64_t expr_id) const = 0;
+
+  // Returns aggregated stats for the function overload. If the checker did
+  // not narrow a call to a single overload, the candidate overload ids are
+  // joined with '|'.
+  virtual FunctionStats StatsForFunction(
+      absl::string_view overload_id) const = 0;
+
+  // Formats the profile as folded stacks (one `frame;frame;frame value` line
+  // per AST node) suitable for flamegraph.pl, speedscope or `pprof`'s
+  // collapsed importer. Values are self time in nanoseconds. Frames are named
+  // after the node and its source position, e.g. `_&&_@1:10`.
+  virtual std::string FormatFoldedStacks() const = 0;
+
+  // Formats the profile as a table modeled on `pprof -top` output, ordered by
+  // self time, with one row per AST node followed by one row per function
+  // overload.
+  virtual std::string FormatReport() const = 0;
+
+  // Clears all collected samples.
+  virtual void Reset() = 0;
+};
+
+// Creates a profiler for programs planned from `ast`. The profiler keeps a copy
+// of the AST to map expr ids back to source positions.
+std::unique_ptr<EvaluationProfiler> CreateEvaluationProfiler(
+    const Ast& ast, const EvaluationProfilerOptions& options = {});
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_TOOLS_EVALUATION_PROFILER_H_
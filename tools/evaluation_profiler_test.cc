@@ -0,0 +1,165 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/evaluation_profiler.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "compiler/compiler.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/internal/standard_env_testing.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::cel::test::BoolValueIs;
+using ::testing::Ge;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Not;
+
+struct TestProgram {
+  std::unique_ptr<Ast> ast;
+  std::unique_ptr<TraceableProgram> program;
+};
+
+absl::StatusOr<TestProgram> Compile(absl::string_view expr) {
+  CEL_ASSIGN_OR_RETURN(
+      std::unique_ptr<Compiler> compiler,
+      runtime_internal::NewTestingCompiler({MakeVariableDecl("x", IntType())}));
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast,
+                       runtime_internal::CompileForTesting(*compiler, expr));
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Runtime> runtime,
+                       runtime_internal::NewTestingRuntime());
+
+  TestProgram test_program;
+  test_program.ast = std::make_unique<Ast>(*ast);
+  CEL_ASSIGN_OR_RETURN(test_program.program,
+                       runtime->CreateTraceableProgram(std::move(ast)));
+  return test_program;
+}
+
+TEST(EvaluationProfiler, AttributesToNodes) {
+  ASSERT_OK_AND_ASSIGN(TestProgram test_program,
+                       Compile("x + 1 < 10 && 'foo'.startsWith('f')"));
+  auto profiler = CreateEvaluationProfiler(
+      *test_program.ast, EvaluationProfilerOptions{.sampling_interval = 1});
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(2));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(profiler->Evaluate(*test_program.program, &arena, activation),
+                IsOkAndHolds(BoolValueIs(true)));
+  }
+
+  EXPECT_EQ(profiler->sampled_evaluation_count(), 3);
+
+  int64_t root_id = test_program.ast->root_expr().id();
+  EvaluationProfiler::NodeStats root_stats = profiler->StatsForNode(root_id);
+  EXPECT_EQ(root_stats.evaluation_count, 3);
+  EXPECT_THAT(root_stats.cumulative_time, Ge(root_stats.self_time));
+
+  EvaluationProfiler::FunctionStats add_stats =
+      profiler->StatsForFunction("add_int64");
+  EXPECT_EQ(add_stats.call_count, 3);
+  EXPECT_EQ(profiler->StatsForFunction("starts_with_string").call_count, 3);
+  EXPECT_EQ(profiler->StatsForFunction("no_such_overload").call_count, 0);
+}
+
+TEST(EvaluationProfiler, Sampling) {
+  ASSERT_OK_AND_ASSIGN(TestProgram test_program, Compile("x * 2 == 4"));
+  auto profiler = CreateEvaluationProfiler(
+      *test_program.ast, EvaluationProfilerOptions{.sampling_interval = 2});
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(2));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_THAT(profiler->Evaluate(*test_program.program, &arena, activation),
+                IsOkAndHolds(BoolValueIs(true)));
+  }
+
+  EXPECT_EQ(profiler->sampled_evaluation_count(), 2);
+  EXPECT_EQ(
+      profiler->StatsForNode(test_program.ast->root_expr().id())
+          .evaluation_count,
+      2);
+
+  // Unsampled evaluations get an empty listener so they take the untraced
+  // evaluation path.
+  EXPECT_TRUE(profiler->MakeListener(&arena));
+  EXPECT_FALSE(profiler->MakeListener(&arena));
+}
+
+TEST(EvaluationProfiler, ComprehensionCounts) {
+  ASSERT_OK_AND_ASSIGN(TestProgram test_program,
+                       Compile("[1, 2, 3, 4].all(i, i > 0)"));
+  auto profiler = CreateEvaluationProfiler(
+      *test_program.ast, EvaluationProfilerOptions{.sampling_interval = 1});
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  EXPECT_THAT(profiler->Evaluate(*test_program.program, &arena, activation),
+              IsOkAndHolds(BoolValueIs(true)));
+
+  EXPECT_EQ(profiler->StatsForFunction("greater_int64").call_count, 4);
+}
+
+TEST(EvaluationProfiler, FormatFoldedStacks) {
+  ASSERT_OK_AND_ASSIGN(TestProgram test_program, Compile("x + 1 < 10"));
+  auto profiler = CreateEvaluationProfiler(
+      *test_program.ast, EvaluationProfilerOptions{.sampling_interval = 1});
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(2));
+  ASSERT_THAT(profiler->Evaluate(*test_program.program, &arena, activation),
+              IsOk());
+
+  std::string folded = profiler->FormatFoldedStacks();
+  EXPECT_THAT(folded, HasSubstr("_<_@1:"));
+  EXPECT_THAT(folded, HasSubstr("_<_@1:6;_+_@1:2;x@1:0 "));
+
+  std::string report = profiler->FormatReport();
+  EXPECT_THAT(report, HasSubstr("Sampled evaluations: 1"));
+  EXPECT_THAT(report, HasSubstr("add_int64"));
+  EXPECT_THAT(report, HasSubstr("less_int64"));
+
+  profiler->Reset();
+  EXPECT_EQ(profiler->sampled_evaluation_count(), 0);
+  EXPECT_THAT(profiler->FormatFoldedStacks(), IsEmpty());
+  EXPECT_THAT(profiler->FormatReport(), Not(HasSubstr("add_int64")));
+}
+
+}  // namespace
+}  // namespace cel
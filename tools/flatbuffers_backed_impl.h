@@ -46,6 +46,9 @@ class FlatBuffersMapImpl : public CelMap {
 
 // Factory method to instantiate a CelValue on the arena for flatbuffer object
 // from a reflection schema.
+//
+// New code should prefer `cel::FlatBuffersSchema` (tools/flatbuffers_value.h),
+// which exposes the object as a struct value with precomputed field lookups.
 const CelMap* CreateFlatBuffersBackedObject(const uint8_t* flatbuf,
                                             const reflection::Schema& schema,
                                             google::protobuf::Arena* arena);
@@ -0,0 +1,867 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/flatbuffers_value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "common/native_type.h"
+#include "common/type.h"
+#include "common/type_introspector.h"
+#include "common/value.h"
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/reflection.h"
+#include "internal/status_macros.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+
+namespace flatbuffers_internal {
+
+struct FieldInfo {
+  absl::string_view name;
+  // Null if the field has a type which is not supported.
+  const reflection::Field* absl_nullable field = nullptr;
+  reflection::BaseType base_type = reflection::None;
+  reflection::BaseType element = reflection::None;
+  // The table type of tables and vectors of tables.
+  const ObjectInfo* absl_nullable object = nullptr;
+  // The string key field of vectors of tables exposed as maps.
+  const reflection::Field* absl_nullable key = nullptr;
+  Type type;
+};
+
+struct ObjectInfo {
+  absl::string_view name;
+  // Indexed by field id.
+  std::vector<FieldInfo> fields;
+  absl::flat_hash_map<absl::string_view, const FieldInfo* absl_nonnull>
+      fields_by_name;
+};
+
+}  // namespace flatbuffers_internal
+
+namespace {
+
+using ::cel::flatbuffers_internal::FieldInfo;
+using ::cel::flatbuffers_internal::ObjectInfo;
+
+struct TableContent {
+  const flatbuffers::Table* absl_nonnull table;
+  const ObjectInfo* absl_nonnull object;
+};
+
+// A vector field of a table. `vector` is null when the field is absent.
+struct VectorContent {
+  const flatbuffers::VectorOfAny* absl_nullable vector;
+  const FieldInfo* absl_nonnull field;
+};
+
+absl::string_view ToStringView(const flatbuffers::String* absl_nullable value) {
+  if (value == nullptr) {
+    return absl::string_view();
+  }
+  return absl::string_view(value->c_str(), value->size());
+}
+
+template <typename T>
+const flatbuffers::Vector<T>* absl_nonnull AsVector(
+    const flatbuffers::VectorOfAny* absl_nonnull vector) {
+  return reinterpret_cast<const flatbuffers::Vector<T>*>(vector);
+}
+
+size_t VectorSize(const VectorContent& content) {
+  return content.vector == nullptr ? 0 : content.vector->size();
+}
+
+const flatbuffers::Table* absl_nonnull GetTable(const VectorContent& content,
+                                                size_t index) {
+  return AsVector<flatbuffers::Offset<flatbuffers::Table>>(content.vector)
+      ->Get(index);
+}
+
+absl::string_view GetKey(const VectorContent& content, size_t index) {
+  return ToStringView(
+      flatbuffers::GetFieldS(*GetTable(content, index), *content.field->key));
+}
+
+Value TableValue(const flatbuffers::Table* absl_nonnull table,
+                 const ObjectInfo& object);
+
+Value VectorValue(const flatbuffers::VectorOfAny* absl_nullable vector,
+                  const FieldInfo& field);
+
+Value FieldValue(const flatbuffers::Table& table, const FieldInfo& field) {
+  const reflection::Field& f = *field.field;
+  switch (field.base_type) {
+    case reflection::Byte:
+      return IntValue(flatbuffers::GetFieldI<int8_t>(table, f));
+    case reflection::Short:
+      return IntValue(flatbuffers::GetFieldI<int16_t>(table, f));
+    case reflection::Int:
+      return IntValue(flatbuffers::GetFieldI<int32_t>(table, f));
+    case reflection::Long:
+      return IntValue(flatbuffers::GetFieldI<int64_t>(table, f));
+    case reflection::UByte:
+      return UintValue(flatbuffers::GetFieldI<uint8_t>(table, f));
+    case reflection::UShort:
+      return UintValue(flatbuffers::GetFieldI<uint16_t>(table, f));
+    case reflection::UInt:
+      return UintValue(flatbuffers::GetFieldI<uint32_t>(table, f));
+    case reflection::ULong:
+      return UintValue(flatbuffers::GetFieldI<uint64_t>(table, f));
+    case reflection::Float:
+      return DoubleValue(flatbuffers::GetFieldF<float>(table, f));
+    case reflection::Double:
+      return DoubleValue(flatbuffers::GetFieldF<double>(table, f));
+    case reflection::Bool:
+      return BoolValue(flatbuffers::GetFieldI<uint8_t>(table, f) != 0);
+    case reflection::String:
+      return StringValue::WrapUnsafe(
+          ToStringView(flatbuffers::GetFieldS(table, f)));
+    case reflection::Obj: {
+      const flatbuffers::Table* nested = flatbuffers::GetFieldT(table, f);
+      if (nested == nullptr) {
+        return NullValue();
+      }
+      return TableValue(nested, *field.object);
+    }
+    case reflection::Vector:
+      return VectorValue(flatbuffers::GetFieldAnyV(table, f), field);
+    default:
+      // Filtered out when indexing the schema.
+      return ErrorValue(absl::InternalError(
+          absl::StrCat("unsupported flatbuffers field: ", field.name)));
+  }
+}
+
+template <typename T>
+bool IsNonDefaultInteger(const flatbuffers::Table& table,
+                         const reflection::Field& field) {
+  return flatbuffers::GetFieldI<T>(table, field) !=
+         static_cast<T>(field.default_integer());
+}
+
+template <typename T>
+bool IsNonDefaultReal(const flatbuffers::Table& table,
+                      const reflection::Field& field) {
+  return flatbuffers::GetFieldF<T>(table, field) !=
+         static_cast<T>(field.default_real());
+}
+
+bool HasField(const flatbuffers::Table& table, const FieldInfo& field) {
+  const reflection::Field& f = *field.field;
+  switch (field.base_type) {
+    case reflection::Byte:
+      return IsNonDefaultInteger<int8_t>(table, f);
+    case reflection::Short:
+      return IsNonDefaultInteger<int16_t>(table, f);
+    case reflection::Int:
+      return IsNonDefaultInteger<int32_t>(table, f);
+    case reflection::Long:
+      return IsNonDefaultInteger<int64_t>(table, f);
+    case reflection::Bool:
+    case reflection::UByte:
+      return IsNonDefaultInteger<uint8_t>(table, f);
+    case reflection::UShort:
+      return IsNonDefaultInteger<uint16_t>(table, f);
+    case reflection::UInt:
+      return IsNonDefaultInteger<uint32_t>(table, f);
+    case reflection::ULong:
+      return IsNonDefaultInteger<uint64_t>(table, f);
+    case reflection::Float:
+      return IsNonDefaultReal<float>(table, f);
+    case reflection::Double:
+      return IsNonDefaultReal<double>(table, f);
+    case reflection::String:
+      return !ToStringView(flatbuffers::GetFieldS(table, f)).empty();
+    case reflection::Obj:
+      return flatbuffers::GetFieldT(table, f) != nullptr;
+    case reflection::Vector: {
+      const flatbuffers::VectorOfAny* vector =
+          flatbuffers::GetFieldAnyV(table, f);
+      return vector != nullptr && vector->size() != 0;
+    }
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+T GetElement(const VectorContent& content, size_t index) {
+  return AsVector<T>(content.vector)->Get(index);
+}
+
+Value ElementValue(const VectorContent& content, size_t index) {
+  switch (content.field->element) {
+    case reflection::Short:
+      return IntValue(GetElement<int16_t>(content, index));
+    case reflection::Int:
+      return IntValue(GetElement<int32_t>(content, index));
+    case reflection::Long:
+      return IntValue(GetElement<int64_t>(content, index));
+    case reflection::UShort:
+      return UintValue(GetElement<uint16_t>(content, index));
+    case reflection::UInt:
+      return UintValue(GetElement<uint32_t>(content, index));
+    case reflection::ULong:
+      return UintValue(GetElement<uint64_t>(content, index));
+    case reflection::Float:
+      return DoubleValue(GetElement<float>(content, index));
+    case reflection::Double:
+      return DoubleValue(GetElement<double>(content, index));
+    case reflection::Bool:
+      return BoolValue(GetElement<uint8_t>(content, index) != 0);
+    case reflection::String:
+      return StringValue::WrapUnsafe(ToStringView(
+          GetElement<flatbuffers::Offset<flatbuffers::String>>(content,
+                                                               index)));
+    case reflection::Obj:
+      return TableValue(GetTable(content, index), *content.field->object);
+    default:
+      // Filtered out when indexing the schema.
+      return ErrorValue(absl::InternalError(absl::StrCat(
+          "unsupported flatbuffers vector field: ", content.field->name)));
+  }
+}
+
+// Binary search on the key field, which FlatBuffers keeps sorted.
+const flatbuffers::Table* absl_nullable FindByKey(const VectorContent& content,
+                                                  absl::string_view key) {
+  size_t low = 0;
+  size_t high = VectorSize(content);
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (GetKey(content, mid) < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low < VectorSize(content) && GetKey(content, low) == key) {
+    return GetTable(content, low);
+  }
+  return nullptr;
+}
+
+const FieldInfo* absl_nullable FindFieldByName(const ObjectInfo& object,
+                                               absl::string_view name) {
+  auto it = object.fields_by_name.find(name);
+  return it == object.fields_by_name.end() ? nullptr : it->second;
+}
+
+const FieldInfo* absl_nullable FindFieldByNumber(const ObjectInfo& object,
+                                                 int64_t number) {
+  if (number < 1 || number > static_cast<int64_t>(object.fields.size())) {
+    return nullptr;
+  }
+  const FieldInfo& field = object.fields[number - 1];
+  return field.field == nullptr ? nullptr : &field;
+}
+
+// Table dispatcher.
+
+NativeTypeId TableGetTypeId(const CustomStructValueDispatcher* absl_nonnull,
+                            CustomStructValueContent) {
+  return NativeTypeId::For<TableContent>();
+}
+
+google::protobuf::Arena* absl_nullable TableGetArena(
+    const CustomStructValueDispatcher* absl_nonnull, CustomStructValueContent) {
+  return nullptr;
+}
+
+absl::string_view TableGetTypeName(
+    const CustomStructValueDispatcher* absl_nonnull,
+    CustomStructValueContent content) {
+  return content.To<TableContent>().object->name;
+}
+
+std::string TableDebugString(const CustomStructValueDispatcher* absl_nonnull,
+                             CustomStructValueContent content) {
+  const TableContent table = content.To<TableContent>();
+  std::string out = absl::StrCat(table.object->name, "{");
+  bool first = true;
+  for (const FieldInfo& field : table.object->fields) {
+    if (field.field == nullptr || !HasField(*table.table, field)) {
+      continue;
+    }
+    absl::StrAppend(&out, first ? "" : ", ", field.name, ": ",
+                    FieldValue(*table.table, field).DebugString());
+    first = false;
+  }
+  out.push_back('}');
+  return out;
+}
+
+bool TableIsZeroValue(const CustomStructValueDispatcher* absl_nonnull,
+                      CustomStructValueContent content) {
+  const TableContent table = content.To<TableContent>();
+  for (const FieldInfo& field : table.object->fields) {
+    if (field.field != nullptr && HasField(*table.table, field)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+absl::Status TableGetFieldByName(
+    const CustomStructValueDispatcher* absl_nonnull,
+    CustomStructValueContent content, absl::string_view name,
+    ProtoWrapperTypeOptions, const google::protobuf::DescriptorPool* absl_nonnull,
+    google::protobuf::MessageFactory* absl_nonnull, google::protobuf::Arena* absl_nonnull,
+    Value* absl_nonnull result) {
+  const TableContent table = content.To<TableContent>();
+  const FieldInfo* field = FindFieldByName(*table.object, name);
+  if (field == nullptr) {
+    *result = NoSuchFieldError(name);
+    return absl::OkStatus();
+  }
+  *result = FieldValue(*table.table, *field);
+  return absl::OkStatus();
+}
+
+absl::Status TableGetFieldByNumber(
+    const CustomStructValueDispatcher* absl_nonnull,
+    CustomStructValueContent content, int64_t number, ProtoWrapperTypeOptions,
+    const google::protobuf::DescriptorPool* absl_nonnull,
+    google::protobuf::MessageFactory* absl_nonnull, google::protobuf::Arena* absl_nonnull,
+    Value* absl_nonnull result) {
+  const TableContent table = content.To<TableContent>();
+  const FieldInfo* field = FindFieldByNumber(*table.object, number);
+  if (field == nullptr) {
+    *result = NoSuchFieldError(absl::StrCat(number));
+    return absl::OkStatus();
+  }
+  *result = FieldValue(*table.table, *field);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<bool> TableHasFieldByName(
+    const CustomStructValueDispatcher* absl_nonnull,
+    CustomStructValueContent content, absl::string_view name) {
+  const TableContent table = content.To<TableContent>();
+  const FieldInfo* field = FindFieldByName(*table.object, name);
+  if (field == nullptr) {
+    return NoSuchFieldError(name).NativeValue();
+  }
+  return HasField(*table.table, *field);
+}
+
+absl::StatusOr<bool> TableHasFieldByNumber(
+    const CustomStructValueDispatcher* absl_nonnull,
+    CustomStructValueContent content, int64_t number) {
+  const TableContent table = content.To<TableContent>();
+  const FieldInfo* field = FindFieldByNumber(*table.object, number);
+  if (field == nullptr) {
+    return NoSuchFieldError(absl::StrCat(number)).NativeValue();
+  }
+  return HasField(*table.table, *field);
+}
+
+absl::Status TableForEachField(
+    const CustomStructValueDispatcher* absl_nonnull,
+    CustomStructValueContent content,
+    absl::FunctionRef<absl::StatusOr<bool>(absl::string_view, const Value&)>
+        callback,
+    const google::protobuf::DescriptorPool* absl_nonnull,
+    google::protobuf::MessageFactory* absl_nonnull, google::protobuf::Arena* absl_nonnull) {
+  const TableContent table = content.To<TableContent>();
+  for (const FieldInfo& field : table.object->fields) {
+    if (field.field == nullptr || !HasField(*table.table, field)) {
+      continue;
+    }
+    CEL_ASSIGN_OR_RETURN(bool ok,
+                         callback(field.name, FieldValue(*table.table, field)));
+    if (!ok) {
+      break;
+    }
+  }
+  return absl::OkStatus();
+}
+
+CustomStructValue TableClone(
+    const CustomStructValueDispatcher* absl_nonnull dispatcher,
+    CustomStructValueContent content, google::protobuf::Arena* absl_nonnull) {
+  // The buffer is not owned, so there is nothing to copy.
+  return UnsafeCustomStructValue(dispatcher, content);
+}
+
+ABSL_CONST_INIT const CustomStructValueDispatcher table_dispatcher = {
+    .get_type_id = &TableGetTypeId,
+    .get_arena = &TableGetArena,
+    .get_type_name = &TableGetTypeName,
+    .debug_string = &TableDebugString,
+    .is_zero_value = &TableIsZeroValue,
+    .get_field_by_name = &TableGetFieldByName,
+    .get_field_by_number = &TableGetFieldByNumber,
+    .has_field_by_name = &TableHasFieldByName,
+    .has_field_by_number = &TableHasFieldByNumber,
+    .for_each_field = &TableForEachField,
+    .clone = &TableClone,
+};
+
+Value TableValue(const flatbuffers::Table* absl_nonnull table,
+                 const ObjectInfo& object) {
+  return UnsafeCustomStructValue(
+      &table_dispatcher,
+      CustomValueContent::From(TableContent{.table = table, .object = &object}));
+}
+
+// Vector dispatchers, shared by the plain vectors, the keys of keyed vectors
+// and keyed vectors.
+
+NativeTypeId VectorGetTypeId(const CustomListValueDispatcher* absl_nonnull,
+                             CustomListValueContent) {
+  return NativeTypeId::For<VectorContent>();
+}
+
+google::protobuf::Arena* absl_nullable VectorGetArena(
+    const CustomListValueDispatcher* absl_nonnull, CustomListValueContent) {
+  return nullptr;
+}
+
+std::string VectorDebugString(
+    const CustomListValueDispatcher* absl_nonnull dispatcher,
+    CustomListValueContent content) {
+  const VectorContent vector = content.To<VectorContent>();
+  std::string out = "[";
+  for (size_t i = 0; i < VectorSize(vector); ++i) {
+    absl::StrAppend(&out, i == 0 ? "" : ", ",
+                    ElementValue(vector, i).DebugString());
+  }
+  out.push_back(']');
+  return out;
+}
+
+bool VectorIsZeroValue(const CustomListValueDispatcher* absl_nonnull,
+                       CustomListValueContent content) {
+  return VectorSize(content.To<VectorContent>()) == 0;
+}
+
+size_t VectorGetSize(const CustomListValueDispatcher* absl_nonnull,
+                     CustomListValueContent content) {
+  return VectorSize(content.To<VectorContent>());
+}
+
+absl::Status VectorGet(const CustomListValueDispatcher* absl_nonnull,
+                       CustomListValueContent content, size_t index,
+                       const google::protobuf::DescriptorPool* absl_nonnull,
+                       google::protobuf::MessageFactory* absl_nonnull,
+                       google::protobuf::Arena* absl_nonnull, Value* absl_nonnull result) {
+  const VectorContent vector = content.To<VectorContent>();
+  if (index >= VectorSize(vector)) {
+    *result = IndexOutOfBoundsError(index);
+    return absl::OkStatus();
+  }
+  *result = ElementValue(vector, index);
+  return absl::OkStatus();
+}
+
+CustomListValue VectorClone(
+    const CustomListValueDispatcher* absl_nonnull dispatcher,
+    CustomListValueContent content, google::protobuf::Arena* absl_nonnull) {
+  return UnsafeCustomListValue(dispatcher, content);
+}
+
+ABSL_CONST_INIT const CustomListValueDispatcher vector_dispatcher = {
+    .get_type_id = &VectorGetTypeId,
+    .get_arena = &VectorGetArena,
+    .debug_string = &VectorDebugString,
+    .is_zero_value = &VectorIsZeroValue,
+    .size = &VectorGetSize,
+    .get = &VectorGet,
+    .clone = &VectorClone,
+};
+
+absl::Status KeysGet(const CustomListValueDispatcher* absl_nonnull,
+                     CustomListValueContent content, size_t index,
+                     const google::protobuf::DescriptorPool* absl_nonnull,
+                     google::protobuf::MessageFactory* absl_nonnull,
+                     google::protobuf::Arena* absl_nonnull, Value* absl_nonnull result) {
+  const VectorContent vector = content.To<VectorContent>();
+  if (index >= VectorSize(vector)) {
+    *result = IndexOutOfBoundsError(index);
+    return absl::OkStatus();
+  }
+  *result = StringValue::WrapUnsafe(GetKey(vector, index));
+  return absl::OkStatus();
+}
+
+ABSL_CONST_INIT const CustomListValueDispatcher keys_dispatcher = {
+    .get_type_id = &VectorGetTypeId,
+    .get_arena = &VectorGetArena,
+    .is_zero_value = &VectorIsZeroValue,
+    .size = &VectorGetSize,
+    .get = &KeysGet,
+    .clone = &VectorClone,
+};
+
+NativeTypeId KeyedVectorGetTypeId(const CustomMapValueDispatcher* absl_nonnull,
+                                  CustomMapValueContent) {
+  return NativeTypeId::For<VectorContent>();
+}
+
+google::protobuf::Arena* absl_nullable KeyedVectorGetArena(
+    const CustomMapValueDispatcher* absl_nonnull, CustomMapValueContent) {
+  return nullptr;
+}
+
+std::string KeyedVectorDebugString(
+    const CustomMapValueDispatcher* absl_nonnull,
+    CustomMapValueContent content) {
+  const VectorContent vector = content.To<VectorContent>();
+  std::string out = "{";
+  for (size_t i = 0; i < VectorSize(vector); ++i) {
+    absl::StrAppend(
+        &out, i == 0 ? "" : ", ",
+        StringValue::WrapUnsafe(GetKey(vector, i)).DebugString(), ": ",
+        TableValue(GetTable(vector, i), *vector.field->object).DebugString());
+  }
+  out.push_back('}');
+  return out;
+}
+
+bool KeyedVectorIsZeroValue(const CustomMapValueDispatcher* absl_nonnull,
+                            CustomMapValueContent content) {
+  return VectorSize(content.To<VectorContent>()) == 0;
+}
+
+size_t KeyedVectorSize(const CustomMapValueDispatcher* absl_nonnull,
+                       CustomMapValueContent content) {
+  return VectorSize(content.To<VectorContent>());
+}
+
+absl::StatusOr<bool> KeyedVectorFind(
+    const CustomMapValueDispatcher* absl_nonnull,
+    CustomMapValueContent content, const Value& key,
+    const google::protobuf::DescriptorPool* absl_nonnull,
+    google::protobuf::MessageFactory* absl_nonnull, google::protobuf::Arena* absl_nonnull,
+    Value* absl_nonnull result) {
+  if (!key.IsString()) {
+    return false;
+  }
+  const VectorContent vector = content.To<VectorContent>();
+  std::string scratch;
+  const flatbuffers::Table* table =
+      FindByKey(vector, key.GetString().ToStringView(&scratch));
+  if (table == nullptr) {
+    return false;
+  }
+  *result = TableValue(table, *vector.field->object);
+  return true;
+}
+
+absl::StatusOr<bool> KeyedVectorHas(
+    const CustomMapValueDispatcher* absl_nonnull,
+    CustomMapValueContent content, const Value& key,
+    const google::protobuf::DescriptorPool* absl_nonnull,
+    google::protobuf::MessageFactory* absl_nonnull, google::protobuf::Arena* absl_nonnull) {
+  if (!key.IsString()) {
+    return false;
+  }
+  std::string scratch;
+  return FindByKey(content.To<VectorContent>(),
+                   key.GetString().ToStringView(&scratch)) != nullptr;
+}
+
+absl::Status KeyedVectorListKeys(
+    const CustomMapValueDispatcher* absl_nonnull,
+    CustomMapValueContent content, const google::protobuf::DescriptorPool* absl_nonnull,
+    google::protobuf::MessageFactory* absl_nonnull, google::protobuf::Arena* absl_nonnull,
+    ListValue* absl_nonnull result) {
+  *result = UnsafeCustomListValue(&keys_dispatcher, content);
+  return absl::OkStatus();
+}
+
+CustomMapValue KeyedVectorClone(
+    const CustomMapValueDispatcher* absl_nonnull dispatcher,
+    CustomMapValueContent content, google::protobuf::Arena* absl_nonnull) {
+  return UnsafeCustomMapValue(dispatcher, content);
+}
+
+ABSL_CONST_INIT const CustomMapValueDispatcher keyed_vector_dispatcher = {
+    .get_type_id = &KeyedVectorGetTypeId,
+    .get_arena = &KeyedVectorGetArena,
+    .debug_string = &KeyedVectorDebugString,
+    .is_zero_value = &KeyedVectorIsZeroValue,
+    .size = &KeyedVectorSize,
+    .find = &KeyedVectorFind,
+    .has = &KeyedVectorHas,
+    .list_keys = &KeyedVectorListKeys,
+    .clone = &KeyedVectorClone,
+};
+
+Value VectorValue(const flatbuffers::VectorOfAny* absl_nullable vector,
+                  const FieldInfo& field) {
+  switch (field.element) {
+    case reflection::Byte:
+    case reflection::UByte: {
+      if (vector == nullptr) {
+        return BytesValue();
+      }
+      return BytesValue::WrapUnsafe(absl::string_view(
+          reinterpret_cast<const char*>(vector->Data()), vector->size()));
+    }
+    default:
+      break;
+  }
+  CustomValueContent content =
+      CustomValueContent::From(VectorContent{.vector = vector, .field = &field});
+  if (field.key != nullptr) {
+    return UnsafeCustomMapValue(&keyed_vector_dispatcher, content);
+  }
+  return UnsafeCustomListValue(&vector_dispatcher, content);
+}
+
+// Schema indexing.
+
+// Detects a "key" field of the type string.
+const reflection::Field* absl_nullable FindStringKeyField(
+    const reflection::Object& object) {
+  for (const reflection::Field* field : *object.fields()) {
+    if (field->key() && field->type()->base_type() == reflection::String) {
+      return field;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the CEL type of a scalar or string, or nullopt if unsupported.
+absl::optional<Type> ScalarType(reflection::BaseType base_type) {
+  switch (base_type) {
+    case reflection::Bool:
+      return BoolType();
+    case reflection::Byte:
+    case reflection::Short:
+    case reflection::Int:
+    case reflection::Long:
+      return IntType();
+    case reflection::UByte:
+    case reflection::UShort:
+    case reflection::UInt:
+    case reflection::ULong:
+      return UintType();
+    case reflection::Float:
+    case reflection::Double:
+      return DoubleType();
+    case reflection::String:
+      return StringType();
+    default:
+      return absl::nullopt;
+  }
+}
+
+Type TableType(const ObjectInfo& object) {
+  return StructType(common_internal::MakeBasicStructType(object.name));
+}
+
+}  // namespace
+
+FlatBuffersSchema::FlatBuffersSchema() = default;
+
+FlatBuffersSchema::~FlatBuffersSchema() = default;
+
+absl::StatusOr<absl_nonnull std::unique_ptr<FlatBuffersSchema>>
+FlatBuffersSchema::Create(const reflection::Schema& schema) {
+  if (schema.objects() == nullptr) {
+    return absl::InvalidArgumentError("flatbuffers schema has no objects");
+  }
+  auto result = absl::WrapUnique(new FlatBuffersSchema());
+  const auto& objects = *schema.objects();
+  // Sized up front: fields refer to the tables they contain.
+  result->objects_.resize(objects.size());
+  for (flatbuffers::uoffset_t i = 0; i < objects.size(); ++i) {
+    ObjectInfo& info = result->objects_[i];
+    info.name = ToStringView(objects.Get(i)->name());
+    result->objects_by_name_.insert({info.name, &info});
+    if (objects.Get(i) == schema.root_table()) {
+      result->root_ = &info;
+    }
+  }
+  for (flatbuffers::uoffset_t i = 0; i < objects.size(); ++i) {
+    const reflection::Object& object = *objects.Get(i);
+    ObjectInfo& info = result->objects_[i];
+    if (object.is_struct()) {
+      // Structs are only reachable through struct fields, which are not
+      // supported.
+      continue;
+    }
+    for (const reflection::Field* field : *object.fields()) {
+      if (field->id() >= info.fields.size()) {
+        info.fields.resize(field->id() + 1);
+      }
+    }
+    for (const reflection::Field* field : *object.fields()) {
+      FieldInfo& field_info = info.fields[field->id()];
+      field_info.name = ToStringView(field->name());
+      field_info.base_type = field->type()->base_type();
+      field_info.element = field->type()->element();
+
+      const ObjectInfo* nested = nullptr;
+      const reflection::Object* nested_object = nullptr;
+      if (field_info.base_type == reflection::Obj ||
+          (field_info.base_type == reflection::Vector &&
+           field_info.element == reflection::Obj)) {
+        const int32_t index = field->type()->index();
+        if (index < 0 || static_cast<size_t>(index) >= objects.size()) {
+          return absl::InvalidArgumentError(absl::StrCat(
+              "flatbuffers field refers to an unknown object: ", info.name, ".",
+              field_info.name));
+        }
+        nested_object = objects.Get(index);
+        if (nested_object->is_struct()) {
+          continue;
+        }
+        nested = &result->objects_[index];
+      }
+
+      if (field_info.base_type == reflection::Obj) {
+        field_info.object = nested;
+        field_info.type = TableType(*nested);
+      } else if (field_info.base_type == reflection::Vector) {
+        if (field_info.element == reflection::Byte ||
+            field_info.element == reflection::UByte) {
+          field_info.type = BytesType();
+        } else if (nested != nullptr) {
+          field_info.object = nested;
+          field_info.key = FindStringKeyField(*nested_object);
+          if (field_info.key != nullptr) {
+            field_info.type =
+                MapType(&result->arena_, StringType(), TableType(*nested));
+          } else {
+            field_info.type = ListType(&result->arena_, TableType(*nested));
+          }
+        } else if (absl::optional<Type> element =
+                       ScalarType(field_info.element);
+                   element.has_value()) {
+          field_info.type = ListType(&result->arena_, *element);
+        } else {
+          continue;
+        }
+      } else if (absl::optional<Type> type = ScalarType(field_info.base_type);
+                 type.has_value()) {
+        field_info.type = *type;
+      } else {
+        // Unions, arrays, etc.
+        continue;
+      }
+      field_info.field = field;
+      info.fields_by_name.insert({field_info.name, &field_info});
+    }
+  }
+  if (result->root_ == nullptr) {
+    return absl::InvalidArgumentError("flatbuffers schema has no root table");
+  }
+  return result;
+}
+
+const ObjectInfo* absl_nullable FlatBuffersSchema::FindObject(
+    absl::string_view name) const {
+  auto it = objects_by_name_.find(name);
+  return it == objects_by_name_.end() ? nullptr : it->second;
+}
+
+Value FlatBuffersSchema::WrapRoot(const uint8_t* absl_nonnull buffer) const {
+  return TableValue(flatbuffers::GetAnyRoot(buffer), *root_);
+}
+
+absl::StatusOr<Value> FlatBuffersSchema::Wrap(
+    const flatbuffers::Table* absl_nonnull table,
+    absl::string_view type_name) const {
+  const ObjectInfo* object = FindObject(type_name);
+  if (object == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("flatbuffers table type not found: ", type_name));
+  }
+  return TableValue(table, *object);
+}
+
+class FlatBuffersTypeIntrospector final : public TypeIntrospector {
+ public:
+  explicit FlatBuffersTypeIntrospector(const FlatBuffersSchema& schema)
+      : schema_(schema) {}
+
+ protected:
+  absl::StatusOr<absl::optional<Type>> FindTypeImpl(
+      absl::string_view name) const override {
+    const ObjectInfo* object = schema_.FindObject(name);
+    if (object == nullptr) {
+      return absl::nullopt;
+    }
+    return TableType(*object);
+  }
+
+  absl::StatusOr<absl::optional<StructTypeField>> FindStructTypeFieldByNameImpl(
+      absl::string_view type, absl::string_view name) const override {
+    const ObjectInfo* object = schema_.FindObject(type);
+    if (object == nullptr) {
+      return absl::nullopt;
+    }
+    const FieldInfo* field = FindFieldByName(*object, name);
+    if (field == nullptr) {
+      return absl::nullopt;
+    }
+    return MakeField(*object, *field);
+  }
+
+  absl::StatusOr<absl::optional<std::vector<StructTypeFieldListing>>>
+  ListFieldsForStructTypeImpl(absl::string_view type) const override {
+    const ObjectInfo* object = schema_.FindObject(type);
+    if (object == nullptr) {
+      return absl::nullopt;
+    }
+    std::vector<StructTypeFieldListing> fields;
+    for (const FieldInfo& field : object->fields) {
+      if (field.field != nullptr) {
+        fields.push_back({field.name, MakeField(*object, field)});
+      }
+    }
+    return fields;
+  }
+
+ private:
+  static StructTypeField MakeField(const ObjectInfo& object,
+                                   const FieldInfo& field) {
+    return common_internal::BasicStructTypeField(
+        field.name, static_cast<int32_t>(&field - object.fields.data()) + 1,
+        field.type);
+  }
+
+  const FlatBuffersSchema& schema_;
+};
+
+absl_nonnull std::unique_ptr<TypeIntrospector>
+FlatBuffersSchema::NewTypeIntrospector() const {
+  return std::make_unique<FlatBuffersTypeIntrospector>(*this);
+}
+
+}  // namespace cel
@@ -0,0 +1,110 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_TOOLS_FLATBUFFERS_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_TOOLS_FLATBUFFERS_VALUE_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/type_introspector.h"
+#include "common/value.h"
+#include "flatbuffers/reflection.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+namespace flatbuffers_internal {
+struct ObjectInfo;
+}  // namespace flatbuffers_internal
+
+// Exposes FlatBuffers tables as CEL struct values, without parsing or copying
+// the buffer.
+//
+// Field lookups are resolved against the reflection schema once, when the
+// `FlatBuffersSchema` is created: each table type gets a table of its fields
+// indexed by name and by field id. Accessing a field then reads straight from
+// the table's vtable. When the schema is also registered with the type checker
+// and the runtime (see `NewTypeIntrospector`), field selections on type-checked
+// expressions are resolved to field numbers at plan time and skip the by-name
+// lookup altogether.
+//
+// Values share the underlying buffer: strings and bytes are views into it,
+// vectors are lists (or, for vectors of tables with a string key field, maps)
+// reading elements on demand, and nested tables are struct values. The buffer,
+// which may be memory-mapped, and the schema must outlive all values created
+// from them, including the results of evaluating programs over those values.
+//
+// Field values follow the legacy `CreateFlatBuffersBackedObject` adapter:
+// signed integers (and enums) are `int`, unsigned integers are `uint`,
+// floating point numbers are `double`, absent tables are `null`, and vectors of
+// `byte` or `ubyte` are `bytes`. Unions, structs and arrays are not supported
+// and are not visible as fields. `has()` follows proto3 semantics: scalars are
+// present when not equal to their default, strings and vectors when non-empty,
+// and tables when set.
+class FlatBuffersSchema final {
+ public:
+  // Indexes `schema`, which must be verified and outlive the returned object.
+  static absl::StatusOr<absl_nonnull std::unique_ptr<FlatBuffersSchema>> Create(
+      const reflection::Schema& schema);
+
+  FlatBuffersSchema(const FlatBuffersSchema&) = delete;
+  FlatBuffersSchema& operator=(const FlatBuffersSchema&) = delete;
+
+  ~FlatBuffersSchema();
+
+  // Returns the root table of `buffer` as a struct value. `buffer` must hold a
+  // verified buffer whose root type is the schema's root table.
+  Value WrapRoot(const uint8_t* absl_nonnull buffer) const;
+
+  // Returns `table` as a struct value of the table type named `type_name`, or
+  // an error if the schema has no such table type. `table` must be a verified
+  // table of that type.
+  absl::StatusOr<Value> Wrap(const flatbuffers::Table* absl_nonnull table,
+                             absl::string_view type_name) const;
+
+  // Returns a type introspector describing the schema's table types as struct
+  // types, for the type checker (`TypeCheckerBuilder::AddTypeProvider`) and
+  // the runtime (`TypeRegistry::RegisterTypeIntrospector`). The schema must
+  // outlive the introspector.
+  //
+  // Field numbers are the FlatBuffers field ids plus one, as CEL reserves zero
+  // for fields without a number.
+  absl_nonnull std::unique_ptr<TypeIntrospector> NewTypeIntrospector() const;
+
+ private:
+  friend class FlatBuffersTypeIntrospector;
+
+  FlatBuffersSchema();
+
+  const flatbuffers_internal::ObjectInfo* absl_nullable FindObject(
+      absl::string_view name) const;
+
+  // Owns the list and map types of fields.
+  google::protobuf::Arena arena_;
+  std::vector<flatbuffers_internal::ObjectInfo> objects_;
+  absl::flat_hash_map<absl::string_view,
+                      const flatbuffers_internal::ObjectInfo* absl_nonnull>
+      objects_by_name_;
+  const flatbuffers_internal::ObjectInfo* absl_nullable root_ = nullptr;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_TOOLS_FLATBUFFERS_VALUE_H_
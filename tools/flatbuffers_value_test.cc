@@ -0,0 +1,265 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/flatbuffers_value.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "compiler/standard_library.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/reflection.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+
+constexpr char kReflectionBufferPath[] =
+    "tools/testdata/"
+    "flatbuffers.bfbs";
+
+constexpr absl::string_view kTestBuffer = "google.api.expr.TestBuffer";
+
+constexpr char kTestJson[] = R"({
+  f_byte: -1,
+  f_ubyte: 1,
+  f_short: -2,
+  f_ushort: 2,
+  f_int: -3,
+  f_uint: 3,
+  f_long: -4,
+  f_ulong: 4,
+  f_float: 5.0,
+  f_double: 6.0,
+  f_bool: false,
+  f_string: "test",
+  f_obj: {f_string: "nested", f_int: 8},
+  r_byte: [-97],
+  r_ubyte: [97, 98, 99],
+  r_int: [1, 2, 3],
+  r_ulong: [4],
+  r_double: [6.0],
+  r_bool: [false, true],
+  r_string: ["a", "b"],
+  r_obj: [{f_int: 16}, {f_string: "x"}],
+  r_indexed: [{f_string: "b", f_int: 2}, {f_string: "a", f_int: 1}]
+})";
+
+class FlatBuffersValueTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(
+        flatbuffers::LoadFile(kReflectionBufferPath, true, &schema_file_));
+    flatbuffers::Verifier verifier(
+        reinterpret_cast<const uint8_t*>(schema_file_.data()),
+        schema_file_.size());
+    ASSERT_TRUE(reflection::VerifySchemaBuffer(verifier));
+    ASSERT_TRUE(parser_.Deserialize(
+        reinterpret_cast<const uint8_t*>(schema_file_.data()),
+        schema_file_.size()));
+    ASSERT_OK_AND_ASSIGN(
+        schema_,
+        FlatBuffersSchema::Create(*reflection::GetSchema(schema_file_.data())));
+  }
+
+  Value Load(const char* json) {
+    EXPECT_TRUE(parser_.Parse(json));
+    return schema_->WrapRoot(parser_.builder_.GetBufferPointer());
+  }
+
+  absl::StatusOr<Value> Evaluate(absl::string_view expr, const Value& buffer) {
+    CEL_ASSIGN_OR_RETURN(
+        std::unique_ptr<CompilerBuilder> compiler_builder,
+        NewCompilerBuilder(google::protobuf::DescriptorPool::generated_pool()));
+    CEL_RETURN_IF_ERROR(
+        compiler_builder->AddLibrary(StandardCompilerLibrary()));
+    compiler_builder->GetCheckerBuilder().AddTypeProvider(
+        schema_->NewTypeIntrospector());
+    StructType buffer_type = common_internal::MakeBasicStructType(kTestBuffer);
+    CEL_RETURN_IF_ERROR(compiler_builder->GetCheckerBuilder().AddVariable(
+        MakeVariableDecl("buf", buffer_type)));
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Compiler> compiler,
+                         compiler_builder->Build());
+    CEL_ASSIGN_OR_RETURN(ValidationResult result, compiler->Compile(expr));
+    if (!result.IsValid()) {
+      return absl::InvalidArgumentError(result.FormatError());
+    }
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, result.ReleaseAst());
+
+    RuntimeOptions options;
+    options.enable_typed_field_access = true;
+    CEL_ASSIGN_OR_RETURN(
+        RuntimeBuilder runtime_builder,
+        CreateStandardRuntimeBuilder(
+            google::protobuf::DescriptorPool::generated_pool(), options));
+    runtime_builder.type_registry().RegisterTypeIntrospector(
+        schema_->NewTypeIntrospector());
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<const Runtime> runtime,
+                         std::move(runtime_builder).Build());
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                         runtime->CreateProgram(std::move(ast)));
+    Activation activation;
+    activation.InsertOrAssignValue("buf", buffer);
+    return program->Evaluate(&arena_, activation);
+  }
+
+  Value GetField(const Value& value, absl::string_view name) {
+    Value field;
+    EXPECT_THAT(value.GetStruct().GetFieldByName(
+                    name, ProtoWrapperTypeOptions::kUnsetNull,
+                    google::protobuf::DescriptorPool::generated_pool(),
+                    google::protobuf::MessageFactory::generated_factory(), &arena_,
+                    &field),
+                IsOk());
+    return field;
+  }
+
+  std::string schema_file_;
+  flatbuffers::Parser parser_;
+  std::unique_ptr<FlatBuffersSchema> schema_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(FlatBuffersValueTest, FieldsByName) {
+  Value value = Load(kTestJson);
+  ASSERT_TRUE(value.IsStruct());
+  EXPECT_EQ(value.GetStruct().GetTypeName(), kTestBuffer);
+
+  Value field = GetField(value, "f_string");
+  ASSERT_TRUE(field.IsString());
+  EXPECT_EQ(field.GetString().ToString(), "test");
+
+  field = GetField(value, "f_unknown");
+  ASSERT_TRUE(field.IsError());
+  EXPECT_THAT(field.GetError().ToStatus(),
+              StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(value.GetStruct().HasFieldByName("f_unknown"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(FlatBuffersValueTest, StringsAreViewsIntoTheBuffer) {
+  Value field = GetField(Load(kTestJson), "f_string");
+  ASSERT_TRUE(field.IsString());
+  std::string scratch;
+  absl::string_view view = field.GetString().ToStringView(&scratch);
+  const char* begin =
+      reinterpret_cast<const char*>(parser_.builder_.GetBufferPointer());
+  EXPECT_GE(view.data(), begin);
+  EXPECT_LT(view.data(), begin + parser_.builder_.GetSize());
+}
+
+TEST_F(FlatBuffersValueTest, UnknownTypeName) {
+  Load(kTestJson);
+  EXPECT_THAT(schema_->Wrap(flatbuffers::GetAnyRoot(
+                                parser_.builder_.GetBufferPointer()),
+                            "google.api.expr.Unknown"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+class FlatBuffersValueExpressionTest
+    : public FlatBuffersValueTest,
+      public testing::WithParamInterface<std::string> {};
+
+TEST_P(FlatBuffersValueExpressionTest, EvaluatesToTrue) {
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate(GetParam(), Load(kTestJson)));
+  EXPECT_TRUE(result.IsTrue()) << result.DebugString();
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FlatBuffersValueExpressionTest, FlatBuffersValueExpressionTest,
+    testing::Values(
+        "buf.f_byte == -1 && buf.f_short == -2 && buf.f_int == -3 && "
+        "buf.f_long == -4",
+        "buf.f_ubyte == 1u && buf.f_ushort == 2u && buf.f_uint == 3u && "
+        "buf.f_ulong == 4u",
+        "buf.f_float == 5.0 && buf.f_double == 6.0",
+        "!buf.f_bool && buf.f_string == 'test'",
+        "buf.f_obj.f_string == 'nested' && buf.f_obj.f_int == 8",
+        "buf.r_byte == b'\\x9f' && buf.r_ubyte == b'abc'",
+        "buf.r_int == [1, 2, 3] && buf.r_ulong == [4u] && "
+        "buf.r_double == [6.0] && buf.r_bool == [false, true]",
+        "buf.r_string == ['a', 'b'] && buf.r_string.exists(s, s == 'b')",
+        "size(buf.r_obj) == 2 && buf.r_obj[0].f_int == 16 && "
+        "buf.r_obj[1].f_string == 'x'",
+        "buf.r_short == [] && size(buf.r_uint) == 0",
+        "buf.r_indexed['a'].f_int == 1 && buf.r_indexed['b'].f_int == 2",
+        "'a' in buf.r_indexed && !('c' in buf.r_indexed)",
+        "buf.r_indexed.all(k, k in ['a', 'b'])",
+        "has(buf.f_int) && has(buf.f_obj) && has(buf.r_obj) && "
+        "has(buf.f_string)",
+        "has(buf.f_bool) && !has(buf.r_short) && !has(buf.r_obj[1].f_int)"));
+
+TEST_F(FlatBuffersValueTest, Defaults) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      Evaluate("buf.f_short == 150 && buf.f_bool && buf.f_int == 0 && "
+               "buf.f_string == '' && buf.f_obj == null && "
+               "buf.r_ubyte == b'' && size(buf.r_indexed) == 0 && "
+               "!has(buf.f_short) && !has(buf.f_obj)",
+               Load("{}")));
+  EXPECT_TRUE(result.IsTrue()) << result.DebugString();
+}
+
+TEST_F(FlatBuffersValueTest, TypeCheckerRejectsUnknownFields) {
+  EXPECT_THAT(Evaluate("buf.f_unknown", Load("{}")),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(FlatBuffersValueTest, FieldNumbersAreFieldIdsPlusOne) {
+  std::unique_ptr<TypeIntrospector> introspector =
+      schema_->NewTypeIntrospector();
+  ASSERT_OK_AND_ASSIGN(auto field, introspector->FindStructTypeFieldByName(
+                                       kTestBuffer, "f_byte"));
+  ASSERT_TRUE(field.has_value());
+  EXPECT_EQ(field->number(), 1);
+
+  Value value = Load(kTestJson);
+  Value by_number;
+  ASSERT_THAT(value.GetStruct().GetFieldByNumber(
+                  field->number(), ProtoWrapperTypeOptions::kUnsetNull,
+                  google::protobuf::DescriptorPool::generated_pool(),
+                  google::protobuf::MessageFactory::generated_factory(), &arena_,
+                  &by_number),
+              IsOk());
+  EXPECT_EQ(by_number.DebugString(), "-1");
+  EXPECT_THAT(value.GetStruct().HasFieldByNumber(0),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace cel